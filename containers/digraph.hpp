@@ -503,6 +503,24 @@ namespace stlplus
     // exceptions: wrong_object,null_dereference,end_dereference
     path_vector shortest_paths(iterator from, arc_select_fn = 0);
 
+    ////////////////////////////////////////////////////////////////////////////////
+    // Bulk building
+
+    // internal use only - had to make them public because they need to be
+    // accessed by the persistence routines, which could not be made friends
+    // these build a graph when the node count and arc list are known up front,
+    // so they work on the raw nodes and arcs and do no ownership checking
+
+    // append a node with default data to the node list
+    digraph_node<NT,AT>* _node_append(void);
+    // append an arc with default data to the arc list
+    // the arc is not added to the outputs of from or the inputs of to - see _arc_connect
+    digraph_arc<NT,AT>* _arc_append(digraph_node<NT,AT>* from, digraph_node<NT,AT>* to);
+    // reserve the exact number of inputs and outputs that a node will have
+    void _node_reserve(digraph_node<NT,AT>* node, unsigned inputs, unsigned outputs);
+    // add every arc from first to the end of the arc list to the outputs and inputs of its end nodes
+    void _arc_connect(digraph_arc<NT,AT>* first);
+
   private:
     friend class digraph_iterator<NT,AT,NT&,NT*>;
     friend class digraph_iterator<NT,AT,const NT&,const NT*>;
@@ -44,7 +44,11 @@ namespace stlplus
     digraph_node<NT,AT>* m_next;
     std::vector<digraph_arc<NT,AT>*> m_inputs;
     std::vector<digraph_arc<NT,AT>*> m_outputs;
-    digraph_node(const digraph<NT,AT>* owner, const NT& d = NT()) :
+    digraph_node(const digraph<NT,AT>* owner) :
+      m_master(owner,this), m_data(), m_prev(0), m_next(0)
+      {
+      }
+    digraph_node(const digraph<NT,AT>* owner, const NT& d) :
       m_master(owner,this), m_data(d), m_prev(0), m_next(0)
       {
       }
@@ -65,7 +69,11 @@ namespace stlplus
     digraph_arc<NT,AT>* m_next;
     digraph_node<NT,AT>* m_from;
     digraph_node<NT,AT>* m_to;
-    digraph_arc(const digraph<NT,AT>* owner, digraph_node<NT,AT>* from = 0, digraph_node<NT,AT>* to = 0, const AT& d = AT()) :
+    digraph_arc(const digraph<NT,AT>* owner, digraph_node<NT,AT>* from = 0, digraph_node<NT,AT>* to = 0) :
+      m_master(owner,this), m_data(), m_prev(0), m_next(0), m_from(from), m_to(to)
+      {
+      }
+    digraph_arc(const digraph<NT,AT>* owner, digraph_node<NT,AT>* from, digraph_node<NT,AT>* to, const AT& d) :
       m_master(owner,this), m_data(d), m_prev(0), m_next(0), m_from(from), m_to(to)
       {
       }
@@ -1585,5 +1593,51 @@ namespace stlplus
   }
 
   ////////////////////////////////////////////////////////////////////////////////
+  // Bulk building
+
+  template<typename NT, typename AT>
+  digraph_node<NT,AT>* digraph<NT,AT>::_node_append(void)
+  {
+    digraph_node<NT,AT>* new_node = new digraph_node<NT,AT>(this);
+    new_node->m_prev = m_nodes_end;
+    if (!m_nodes_end)
+      m_nodes_begin = new_node;
+    else
+      m_nodes_end->m_next = new_node;
+    m_nodes_end = new_node;
+    return new_node;
+  }
+
+  template<typename NT, typename AT>
+  digraph_arc<NT,AT>* digraph<NT,AT>::_arc_append(digraph_node<NT,AT>* from, digraph_node<NT,AT>* to)
+  {
+    digraph_arc<NT,AT>* new_arc = new digraph_arc<NT,AT>(this, from, to);
+    new_arc->m_prev = m_arcs_end;
+    if (!m_arcs_end)
+      m_arcs_begin = new_arc;
+    else
+      m_arcs_end->m_next = new_arc;
+    m_arcs_end = new_arc;
+    return new_arc;
+  }
+
+  template<typename NT, typename AT>
+  void digraph<NT,AT>::_node_reserve(digraph_node<NT,AT>* node, unsigned inputs, unsigned outputs)
+  {
+    node->m_inputs.reserve(inputs);
+    node->m_outputs.reserve(outputs);
+  }
+
+  template<typename NT, typename AT>
+  void digraph<NT,AT>::_arc_connect(digraph_arc<NT,AT>* first)
+  {
+    for (digraph_arc<NT,AT>* arc = first; arc; arc = arc->m_next)
+    {
+      arc->m_from->m_outputs.push_back(arc);
+      arc->m_to->m_inputs.push_back(arc);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
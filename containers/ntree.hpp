@@ -469,6 +469,18 @@ namespace stlplus
     void swap(const iterator& node, unsigned child1, unsigned child2);
 
     //////////////////////////////////////////////////////////////////////////////
+    // bulk building
+
+    // internal use only - had to make them public because they need to be
+    // accessed by the persistence routines, which could not be made friends
+    // these build a tree when the child counts are known up front, so work on the raw nodes and do no ownership checking
+
+    // append a node with default data as the last child of parent, or as the root if parent is null
+    ntree_node<T>* _node_append(ntree_node<T>* parent);
+    // reserve the exact number of children that a node will have
+    void _node_reserve(ntree_node<T>* node, unsigned children);
+
+    //////////////////////////////////////////////////////////////////////////////
 
   private:
     ntree_node<T>* m_root;
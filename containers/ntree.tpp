@@ -25,7 +25,12 @@ namespace stlplus
     std::vector<ntree_node<T>*> m_children;
 
   public:
-    ntree_node(const ntree<T>* owner, const T& data = T()) :
+    ntree_node(const ntree<T>* owner) :
+      m_master(owner,this), m_data(), m_parent(0)
+      {
+      }
+
+    ntree_node(const ntree<T>* owner, const T& data) :
       m_master(owner,this), m_data(data), m_parent(0)
       {
       }
@@ -1051,5 +1056,32 @@ namespace stlplus
   }
 
   ////////////////////////////////////////////////////////////////////////////////
+  // bulk building
+
+  template<typename T>
+  ntree_node<T>* ntree<T>::_node_append(ntree_node<T>* parent)
+  {
+    ntree_node<T>* new_node = new ntree_node<T>(this);
+    if (!parent)
+    {
+      // a new root replaces the whole tree
+      erase();
+      m_root = new_node;
+    }
+    else
+    {
+      parent->m_children.push_back(new_node);
+      new_node->m_parent = parent;
+    }
+    return new_node;
+  }
+
+  template<typename T>
+  void ntree<T>::_node_reserve(ntree_node<T>* node, unsigned children)
+  {
+    node->m_children.reserve(children);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
@@ -13,6 +13,11 @@
 
 #include "persistent_contexts.hpp"
 #include "persistent_shortcuts.hpp"
+#include "persistent_archive.hpp"
+#include "persistent_snapshot.hpp"
+#include "persistent_record.hpp"
+#include "persistent_checksum.hpp"
+#include "persistent_arena.hpp"
 #include "persistent_basic.hpp"
 #include "persistent_pointers.hpp"
 #include "persistent_stl.hpp"
@@ -64,5 +64,21 @@
 #endif
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+// Byte order
+// Define STLPLUS_LITTLE_ENDIAN or STLPLUS_BIG_ENDIAN where the byte order is known at compile time
+// If neither is defined, the byte order is tested at run time
+////////////////////////////////////////////////////////////////////////////////
+
+// gcc and clang predefine the byte order
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define STLPLUS_LITTLE_ENDIAN 1
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define STLPLUS_BIG_ENDIAN 1
+// Windows only runs on little-endian processors
+#elif defined(_WIN32)
+#define STLPLUS_LITTLE_ENDIAN 1
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 #endif
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_archive.hpp"
+#include "persistent_int.hpp"
+#include <fstream>
+#ifdef STLPLUS_HAS_CXX11
+#include <thread>
+#include <mutex>
+#include <exception>
+#endif
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Job runner
+  // runs a numbered set of independent jobs on a pool of threads
+  // if any job throws, the exception from the lowest-numbered failing job is rethrown once all threads are finished
+
+  class archive_job
+  {
+  public:
+    virtual ~archive_job(void) {}
+    virtual void run(unsigned index) = 0;
+  };
+
+#ifdef STLPLUS_HAS_CXX11
+
+  class archive_pool
+  {
+  public:
+    archive_pool(archive_job& job, unsigned jobs) :
+      m_job(job), m_jobs(jobs), m_next(0), m_errors(jobs)
+      {
+      }
+
+    void work(void)
+      {
+        for (;;)
+        {
+          unsigned index = 0;
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_next == m_jobs) return;
+            index = m_next++;
+          }
+          try
+          {
+            m_job.run(index);
+          }
+          catch(...)
+          {
+            m_errors[index] = std::current_exception();
+          }
+        }
+      }
+
+    void rethrow(void) const
+      {
+        for (unsigned i = 0; i < m_jobs; i++)
+          if (m_errors[i])
+            std::rethrow_exception(m_errors[i]);
+      }
+
+  private:
+    archive_job& m_job;
+    unsigned m_jobs;
+    unsigned m_next;
+    std::mutex m_mutex;
+    std::vector<std::exception_ptr> m_errors;
+  };
+
+  static void run_jobs(archive_job& job, unsigned jobs, unsigned threads)
+  {
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    if (threads > jobs)
+      threads = jobs;
+    if (threads <= 1)
+    {
+      for (unsigned i = 0; i < jobs; i++)
+        job.run(i);
+      return;
+    }
+    archive_pool pool(job, jobs);
+    // the calling thread is one of the workers
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++)
+      workers.push_back(std::thread(&archive_pool::work, &pool));
+    pool.work();
+    for (unsigned t = 0; t < workers.size(); t++)
+      workers[t].join();
+    pool.rethrow();
+  }
+
+#else
+
+  static void run_jobs(archive_job& job, unsigned jobs, unsigned)
+  {
+    for (unsigned i = 0; i < jobs; i++)
+      job.run(i);
+  }
+
+#endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // dump side
+
+  class dump_archive_job : public archive_job
+  {
+  public:
+    dump_archive_job(const std::vector<dump_section*>& sections) :
+      m_sections(sections), m_results(sections.size())
+      {
+      }
+
+    void run(unsigned index)
+      {
+        m_sections[index]->dump(m_results[index]);
+      }
+
+    const std::string& result(unsigned index) const
+      {
+        return m_results[index];
+      }
+
+  private:
+    const std::vector<dump_section*>& m_sections;
+    std::vector<std::string> m_results;
+  };
+
+  dump_archive::dump_archive(void)
+  {
+  }
+
+  dump_archive::~dump_archive(void)
+  {
+    for (unsigned i = 0; i < m_sections.size(); i++)
+      delete m_sections[i];
+  }
+
+  unsigned dump_archive::size(void) const
+  {
+    return static_cast<unsigned>(m_sections.size());
+  }
+
+  void dump_archive::dump(std::ostream& device, unsigned threads) const
+  {
+    // encode all the sections
+    dump_archive_job job(m_sections);
+    run_jobs(job, size(), threads);
+    // now write the table followed by the sections
+    {
+      dump_context context(device);
+      dump_unsigned(context, size());
+      for (unsigned i = 0; i < size(); i++)
+        dump_size_t(context, job.result(i).size());
+    }
+    for (unsigned i = 0; i < size(); i++)
+    {
+      const std::string& section = job.result(i);
+      if (!device.write(section.data(), section.size()))
+        throw persistent_dump_failed(std::string("output device error"));
+    }
+  }
+
+  void dump_archive::dump_to_file(const std::string& filename, unsigned threads) const
+  {
+    std::ofstream output(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    dump(output, threads);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // restore side
+
+  class restore_archive_job : public archive_job
+  {
+  public:
+    restore_archive_job(const std::vector<restore_section*>& sections) :
+      m_sections(sections), m_sources(sections.size())
+      {
+      }
+
+    void run(unsigned index)
+      {
+        m_sections[index]->restore(m_sources[index]);
+      }
+
+    std::string& source(unsigned index)
+      {
+        return m_sources[index];
+      }
+
+  private:
+    const std::vector<restore_section*>& m_sections;
+    std::vector<std::string> m_sources;
+  };
+
+  restore_archive::restore_archive(void)
+  {
+  }
+
+  restore_archive::~restore_archive(void)
+  {
+    for (unsigned i = 0; i < m_sections.size(); i++)
+      delete m_sections[i];
+  }
+
+  unsigned restore_archive::size(void) const
+  {
+    return static_cast<unsigned>(m_sections.size());
+  }
+
+  void restore_archive::restore(std::istream& device, unsigned threads)
+  {
+    // read the section table
+    std::vector<size_t> sizes;
+    {
+      restore_context context(device);
+      unsigned count = 0;
+      restore_unsigned(context, count);
+      if (count < size())
+        throw persistent_restore_failed(std::string("archive has too few sections"));
+      sizes.resize(count);
+      for (unsigned i = 0; i < count; i++)
+        restore_size_t(context, sizes[i]);
+    }
+    // read the sections that are wanted - any extra ones are left unread
+    restore_archive_job job(m_sections);
+    for (unsigned i = 0; i < size(); i++)
+    {
+      std::string& section = job.source(i);
+      section.resize(sizes[i]);
+      if (sizes[i] > 0 && !device.read(&section[0], sizes[i]))
+        throw persistent_restore_failed(std::string("device error or premature end of file"));
+    }
+    // and decode them
+    run_jobs(job, size(), threads);
+  }
+
+  void restore_archive::restore_from_file(const std::string& filename, unsigned threads)
+  {
+    std::ifstream input(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    restore(input, threads);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -0,0 +1,129 @@
+#ifndef STLPLUS_PERSISTENT_ARCHIVE
+#define STLPLUS_PERSISTENT_ARCHIVE
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Multi-section archives. An archive is a set of independent data
+//   structures (sections), each dumped with its own dump_context. Because the
+//   sections share no state, they can be dumped and restored concurrently,
+//   one section per thread. The dumped sections are concatenated after a
+//   section table giving the size of each one.
+
+//   Sections are identified by the order in which they are added. The restore
+//   side must add the same sections in the same order. It may add fewer
+//   sections than were dumped, in which case the extra ones are ignored.
+
+//   Since each section has its own context, pointers cannot be shared between
+//   sections and each section has its own installer for polymorphic types.
+
+//   Concurrency requires C++11 threads. Without them, the sections are simply
+//   dumped and restored one after the other. A thread count of zero means use
+//   one thread per core.
+
+//   format: table {size}*count section*count
+//   - the table is a persistent dump of the section count
+//   - each section is a complete persistent dump
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_contexts.hpp"
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Internals - type-independent interfaces to one section of an archive
+
+  class dump_section
+  {
+  public:
+    virtual ~dump_section(void) {}
+    // exceptions: persistent_dump_failed
+    virtual void dump(std::string& result) const = 0;
+  };
+
+  class restore_section
+  {
+  public:
+    virtual ~restore_section(void) {}
+    // exceptions: persistent_restore_failed
+    virtual void restore(const std::string& source) = 0;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // dump side
+
+  class dump_archive
+  {
+  public:
+    dump_archive(void);
+    ~dump_archive(void);
+
+    // add a section - the data is not copied so must remain valid until the dump is complete
+    // returns the index of the section
+    template<typename T, class D>
+    unsigned add(const T& data, D dump_fn, dump_context::installer installer);
+
+    // number of sections added so far
+    unsigned size(void) const;
+
+    // dump all the sections to the device, which must be in binary mode
+    // exceptions: persistent_dump_failed
+    void dump(std::ostream& device, unsigned threads = 0) const;
+    // exceptions: persistent_dump_failed
+    void dump_to_file(const std::string& filename, unsigned threads = 0) const;
+
+  private:
+    std::vector<dump_section*> m_sections;
+
+    // disallow copying by making assignment and copy constructor private
+    dump_archive(const dump_archive&);
+    dump_archive& operator=(const dump_archive&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // restore side
+
+  class restore_archive
+  {
+  public:
+    restore_archive(void);
+    ~restore_archive(void);
+
+    // add a section - the data is restored in place when restore is called
+    // returns the index of the section
+    template<typename T, class R>
+    unsigned add(T& data, R restore_fn, restore_context::installer installer);
+
+    // number of sections added so far
+    unsigned size(void) const;
+
+    // restore all the sections from the device, which must be in binary mode
+    // exceptions: persistent_restore_failed
+    void restore(std::istream& device, unsigned threads = 0);
+    // exceptions: persistent_restore_failed
+    void restore_from_file(const std::string& filename, unsigned threads = 0);
+
+  private:
+    std::vector<restore_section*> m_sections;
+
+    // disallow copying by making assignment and copy constructor private
+    restore_archive(const restore_archive&);
+    restore_archive& operator=(const restore_archive&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
+
+  ////////////////////////////////////////////////////////////////////////////////
+#include "persistent_archive.tpp"
+#endif
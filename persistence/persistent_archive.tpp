@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_shortcuts.hpp"
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // the sections bind the data to its dump or restore functions
+
+  template<typename T, class D>
+  class dump_section_of : public dump_section
+  {
+  public:
+    dump_section_of(const T& data, D dump_fn, dump_context::installer installer) :
+      m_data(&data), m_dump_fn(dump_fn), m_installer(installer)
+      {
+      }
+
+    void dump(std::string& result) const
+      {
+        dump_to_string(*m_data, result, m_dump_fn, m_installer);
+      }
+
+  private:
+    const T* m_data;
+    D m_dump_fn;
+    dump_context::installer m_installer;
+  };
+
+  template<typename T, class R>
+  class restore_section_of : public restore_section
+  {
+  public:
+    restore_section_of(T& data, R restore_fn, restore_context::installer installer) :
+      m_data(&data), m_restore_fn(restore_fn), m_installer(installer)
+      {
+      }
+
+    void restore(const std::string& source)
+      {
+        restore_from_string(source, *m_data, m_restore_fn, m_installer);
+      }
+
+  private:
+    T* m_data;
+    R m_restore_fn;
+    restore_context::installer m_installer;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  unsigned dump_archive::add(const T& data, D dump_fn, dump_context::installer installer)
+  {
+    m_sections.push_back(new dump_section_of<T,D>(data, dump_fn, installer));
+    return static_cast<unsigned>(m_sections.size()-1);
+  }
+
+  template<typename T, class R>
+  unsigned restore_archive::add(T& data, R restore_fn, restore_context::installer installer)
+  {
+    m_sections.push_back(new restore_section_of<T,R>(data, restore_fn, installer));
+    return static_cast<unsigned>(m_sections.size()-1);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_arena.hpp"
+#include <vector>
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // every allocation is preceded by a header which links the objects into a list
+  // in reverse order of creation, so that the arena can destroy them all
+
+  class restore_arena_header
+  {
+  public:
+    restore_arena::destroy_function m_destroy;
+    restore_arena_header* m_previous;
+  };
+
+  // all allocations are rounded up to a multiple of the size of the most strictly aligned basic type
+  union restore_arena_alignment
+  {
+    long double m_long_double;
+    double m_double;
+    long m_long;
+    void* m_pointer;
+    void (*m_function)(void);
+  };
+
+  static size_t restore_arena_round(size_t size)
+  {
+    const size_t alignment = sizeof(restore_arena_alignment);
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  class restore_arena_body
+  {
+  public:
+    size_t m_block_size;
+    std::vector<void*> m_blocks;
+    char* m_next;
+    size_t m_remaining;
+    restore_arena_header* m_last;
+    size_t m_objects;
+    size_t m_bytes;
+
+    restore_arena_body(size_t block_size) :
+      m_block_size(restore_arena_round(block_size)), m_next(0), m_remaining(0), m_last(0), m_objects(0), m_bytes(0)
+      {
+      }
+
+    ~restore_arena_body(void)
+      {
+        release();
+      }
+
+    void* new_block(size_t size)
+      {
+        // make sure there's room to record the block before allocating it
+        m_blocks.reserve(m_blocks.size()+1);
+        void* block = ::operator new(size);
+        m_blocks.push_back(block);
+        m_bytes += size;
+        return block;
+      }
+
+    void* allocate(size_t size)
+      {
+        size_t total = restore_arena_round(sizeof(restore_arena_header)) + restore_arena_round(size);
+        char* memory = 0;
+        if (total <= m_remaining)
+        {
+          memory = m_next;
+          m_next += total;
+          m_remaining -= total;
+        }
+        else if (total > m_block_size / 4)
+        {
+          // large objects get a block to themselves so that the current block isn't wasted
+          memory = (char*)new_block(total);
+        }
+        else
+        {
+          memory = (char*)new_block(m_block_size);
+          m_next = memory + total;
+          m_remaining = m_block_size - total;
+        }
+        restore_arena_header* header = (restore_arena_header*)memory;
+        header->m_destroy = 0;
+        header->m_previous = 0;
+        return memory + restore_arena_round(sizeof(restore_arena_header));
+      }
+
+    void destroy_with(void* memory, restore_arena::destroy_function destroy)
+      {
+        m_objects++;
+        if (!destroy) return;
+        restore_arena_header* header = (restore_arena_header*)((char*)memory - restore_arena_round(sizeof(restore_arena_header)));
+        header->m_destroy = destroy;
+        header->m_previous = m_last;
+        m_last = header;
+      }
+
+    void release(void)
+      {
+        // destroy the objects, newest first
+        while (m_last)
+        {
+          restore_arena_header* header = m_last;
+          m_last = header->m_previous;
+          header->m_destroy((char*)header + restore_arena_round(sizeof(restore_arena_header)));
+        }
+        for (unsigned i = 0; i < m_blocks.size(); i++)
+          ::operator delete(m_blocks[i]);
+        m_blocks.clear();
+        m_next = 0;
+        m_remaining = 0;
+        m_objects = 0;
+        m_bytes = 0;
+      }
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  restore_arena::restore_arena(size_t block_size) : m_body(0)
+  {
+    m_body = new restore_arena_body(block_size);
+  }
+
+  restore_arena::~restore_arena(void)
+  {
+    delete m_body;
+  }
+
+  void restore_arena::release(void)
+  {
+    m_body->release();
+  }
+
+  size_t restore_arena::objects(void) const
+  {
+    return m_body->m_objects;
+  }
+
+  size_t restore_arena::bytes(void) const
+  {
+    return m_body->m_bytes;
+  }
+
+  void* restore_arena::allocate(size_t size)
+  {
+    return m_body->allocate(size);
+  }
+
+  void restore_arena::destroy_with(void* memory, destroy_function destroy)
+  {
+    m_body->destroy_with(memory, destroy);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  restore_arena_suspend::restore_arena_suspend(restore_context& context) :
+    m_context(context), m_arena(context.arena())
+  {
+    m_context.set_arena(0);
+  }
+
+  restore_arena_suspend::~restore_arena_suspend(void)
+  {
+    m_context.set_arena(m_arena);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -0,0 +1,127 @@
+#ifndef STLPLUS_PERSISTENT_ARENA
+#define STLPLUS_PERSISTENT_ARENA
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Arena allocation for restores. Restoring a large pointer-based structure
+//   normally allocates every object separately with new, which is slow and
+//   leaves the heap fragmented. If a restore_context is given an arena, the
+//   objects restored through pointers are instead allocated from large blocks
+//   owned by the arena, and are all destroyed together when the arena is
+//   released or destroyed.
+
+//   The arena owns the objects, not the restored data structure, so it must
+//   outlive the data structure, and pointers into the arena must never be
+//   deleted. This means that arena restores are only suitable for data
+//   structures whose pointers do not own the objects they point to. For the
+//   same reason, a restore into a pointer does not delete its previous value
+//   in arena mode.
+
+//   - restore_pointer allocates its objects in the arena
+//   - restore_callback allocates its objects in the arena if the class was
+//     registered with an arena create callback such as create_in_arena<T>,
+//     otherwise it creates them with the normal create callback and the arena
+//     takes ownership of them
+//   - restore_interface clones the sample object and the arena takes
+//     ownership of the clone
+//   - restore_shared_ptr and its variants allocate in the arena and give the
+//     shared pointer a deleter that does nothing
+//   - the simple_ptr and smart_ptr restores always allocate on the heap,
+//     because those classes always delete the objects they point to. This
+//     also applies to anything restored as part of the pointed-to object.
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_contexts.hpp"
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Internals
+
+  class restore_arena_body;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  class restore_arena
+  {
+  public:
+    // called to destroy an object when the arena is released
+    typedef void (*destroy_function)(void*);
+
+    // memory is allocated from the system in blocks of at least this size
+    explicit restore_arena(size_t block_size = 1024*1024);
+    // releases all the objects
+    ~restore_arena(void);
+
+    // create a default-constructed object in the arena
+    // exceptions: std::bad_alloc or any exception thrown by the constructor
+    template<typename T>
+    T* create(void);
+
+    // take ownership of an object allocated with new, so that it is deleted when the arena is released
+    // exceptions: std::bad_alloc
+    template<typename T>
+    void adopt(T* object);
+
+    // destroy all the objects in the reverse order of their creation and free the memory
+    void release(void);
+
+    // the number of objects owned by the arena
+    size_t objects(void) const;
+
+    // the number of bytes of memory allocated from the system
+    size_t bytes(void) const;
+
+    // low-level allocation of uninitialised memory with space for a destroy function
+    // call destroy_with once the object has been constructed - the destroy function can be null
+    // exceptions: std::bad_alloc
+    void* allocate(size_t size);
+    void destroy_with(void* memory, destroy_function destroy);
+
+  private:
+    restore_arena_body* m_body;
+
+    // disallow copying by making assignment and copy constructor private
+    restore_arena(const restore_arena&);
+    restore_arena& operator=(const restore_arena&);
+  };
+
+  // an arena create callback for restore_context::register_callback
+  template<typename T>
+  void* create_in_arena(restore_arena& arena);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // switches off arena allocation in a restore context for the lifetime of this object
+  // used by the restores of pointer classes that always delete the objects they point to
+
+  class restore_arena_suspend
+  {
+  public:
+    restore_arena_suspend(restore_context& context);
+    ~restore_arena_suspend(void);
+
+  private:
+    restore_context& m_context;
+    restore_arena* m_arena;
+
+    // disallow copying by making assignment and copy constructor private
+    restore_arena_suspend(const restore_arena_suspend&);
+    restore_arena_suspend& operator=(const restore_arena_suspend&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
+
+  ////////////////////////////////////////////////////////////////////////////////
+#include "persistent_arena.tpp"
+#endif
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include <new>
+#ifdef STLPLUS_HAS_CXX11
+#include <type_traits>
+#endif
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // destroy functions used by the arena
+
+  template<typename T>
+  void restore_arena_destroy(void* object)
+  {
+    ((T*)object)->~T();
+  }
+
+  template<typename T>
+  void restore_arena_delete(void* holder)
+  {
+    delete *(T**)holder;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T>
+  T* restore_arena::create(void)
+  {
+    void* memory = allocate(sizeof(T));
+    // if the constructor throws, the memory is simply left unused until the arena is released
+    T* result = new(memory) T();
+#ifdef STLPLUS_HAS_CXX11
+    // objects that don't need destroying are still counted but aren't visited by the release
+    if (std::is_trivially_destructible<T>::value)
+    {
+      destroy_with(memory, 0);
+      return result;
+    }
+#endif
+    destroy_with(memory, restore_arena_destroy<T>);
+    return result;
+  }
+
+  template<typename T>
+  void restore_arena::adopt(T* object)
+  {
+    if (!object) return;
+    // the arena holds a pointer to the object which is deleted through that pointer
+    void* holder = 0;
+    try
+    {
+      holder = allocate(sizeof(T*));
+    }
+    catch(...)
+    {
+      delete object;
+      throw;
+    }
+    *(T**)holder = object;
+    destroy_with(holder, restore_arena_delete<T>);
+  }
+
+  template<typename T>
+  void* create_in_arena(restore_arena& arena)
+  {
+    return arena.create<T>();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
+#include "persistent_arena.hpp"
 
 namespace stlplus
 {
@@ -53,11 +54,11 @@ namespace stlplus
     try
     {
       // first delete any previous object pointed to since the restore creates the object of the right subclass
-      if (data)
-      {
+      // in arena mode the previous object belongs to the arena
+      restore_arena* arena = context.arena();
+      if (data && !arena)
         delete data;
-        data = 0;
-      }
+      data = 0;
       // get the magic key
       unsigned magic = 0;
       restore_unsigned(context,magic);
@@ -79,7 +80,20 @@ namespace stlplus
         // then call the restore callback to get the contents
         // this will throw persistent_illegal_type if not recognised - this is caught below
         restore_context::callback_data callbacks = context.lookup_callback(key);
-        data = (T*)callbacks.first();
+        if (!arena)
+          data = (T*)callbacks.first();
+        else
+        {
+          // allocate in the arena if possible, otherwise hand the new object over to the arena
+          restore_context::arena_create_callback arena_create = context.lookup_arena_callback(key);
+          if (arena_create)
+            data = (T*)arena_create(*arena);
+          else
+          {
+            data = (T*)callbacks.first();
+            arena->adopt(data);
+          }
+        }
         // add this pointer to the set of already seen objects
         // note that the address is mapped before it is dumped so that self-referential structures dump correctly
         context.pointer_add(magic,data);
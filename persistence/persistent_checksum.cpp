@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_checksum.hpp"
+#include <string.h>
+
+// the CRC32 instructions are used where the compiler can generate them
+// on x86 this is decided at run time since not all processors have SSE4.2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STLPLUS_CRC32C_X86 1
+#include <nmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define STLPLUS_CRC32C_X86 1
+#include <nmmintrin.h>
+#include <intrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define STLPLUS_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // portable version
+  // this uses the slicing-by-8 method, which processes 8 bytes per step using 8 tables
+  // the bytes are combined explicitly so the result does not depend on byte order or alignment
+
+  // the reversed Castagnoli polynomial
+  static const unsigned crc32c_polynomial = 0x82F63B78;
+
+  static unsigned crc32c_table [8][256];
+
+  static unsigned crc32c_portable(unsigned crc, const unsigned char* data, size_t size)
+  {
+    crc = ~crc;
+    for ( ; size >= 8; data += 8, size -= 8)
+    {
+      unsigned low = crc ^ ((unsigned)data[0] | ((unsigned)data[1] << 8) | ((unsigned)data[2] << 16) | ((unsigned)data[3] << 24));
+      unsigned high = (unsigned)data[4] | ((unsigned)data[5] << 8) | ((unsigned)data[6] << 16) | ((unsigned)data[7] << 24);
+      crc =
+        crc32c_table[7][low & 0xff] ^ crc32c_table[6][(low >> 8) & 0xff] ^
+        crc32c_table[5][(low >> 16) & 0xff] ^ crc32c_table[4][low >> 24] ^
+        crc32c_table[3][high & 0xff] ^ crc32c_table[2][(high >> 8) & 0xff] ^
+        crc32c_table[1][(high >> 16) & 0xff] ^ crc32c_table[0][high >> 24];
+    }
+    for ( ; size > 0; data++, size--)
+      crc = crc32c_table[0][(crc ^ *data) & 0xff] ^ (crc >> 8);
+    return ~crc;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // hardware versions
+
+#if defined(STLPLUS_CRC32C_X86)
+
+#if defined(__GNUC__) || defined(__clang__)
+  __attribute__((target("sse4.2")))
+#endif
+  static unsigned crc32c_hardware(unsigned crc, const unsigned char* data, size_t size)
+  {
+    crc = ~crc;
+#if defined(__x86_64__) || defined(_M_X64)
+    for ( ; size >= 8; data += 8, size -= 8)
+    {
+#if defined(_MSC_VER)
+      unsigned __int64 word;
+#else
+      unsigned long long word;
+#endif
+      memcpy(&word, data, 8);
+      crc = (unsigned)_mm_crc32_u64(crc, word);
+    }
+#endif
+    for ( ; size >= 4; data += 4, size -= 4)
+    {
+      unsigned word;
+      memcpy(&word, data, 4);
+      crc = _mm_crc32_u32(crc, word);
+    }
+    for ( ; size > 0; data++, size--)
+      crc = _mm_crc32_u8(crc, *data);
+    return ~crc;
+  }
+
+  static bool crc32c_hardware_present(void)
+  {
+#if defined(_MSC_VER)
+    int info [4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+  }
+
+#elif defined(STLPLUS_CRC32C_ARM)
+
+  static unsigned crc32c_hardware(unsigned crc, const unsigned char* data, size_t size)
+  {
+    crc = ~crc;
+    for ( ; size >= 8; data += 8, size -= 8)
+    {
+      unsigned long long word;
+      memcpy(&word, data, 8);
+      crc = __crc32cd(crc, word);
+    }
+    for ( ; size > 0; data++, size--)
+      crc = __crc32cb(crc, *data);
+    return ~crc;
+  }
+
+  static bool crc32c_hardware_present(void)
+  {
+    return true;
+  }
+
+#endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // the tables and the choice of version are set up during static initialisation
+  // so that there is no race when checksums are first calculated on several threads at once
+
+  typedef unsigned (*crc32c_function)(unsigned, const unsigned char*, size_t);
+
+  class crc32c_selector
+  {
+  public:
+    crc32c_function m_function;
+
+    crc32c_selector(void) : m_function(crc32c_portable)
+      {
+        for (unsigned i = 0; i < 256; i++)
+        {
+          unsigned crc = i;
+          for (unsigned bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ crc32c_polynomial : crc >> 1;
+          crc32c_table[0][i] = crc;
+        }
+        for (unsigned i = 0; i < 256; i++)
+          for (unsigned slice = 1; slice < 8; slice++)
+            crc32c_table[slice][i] = crc32c_table[0][crc32c_table[slice-1][i] & 0xff] ^ (crc32c_table[slice-1][i] >> 8);
+#if defined(STLPLUS_CRC32C_X86) || defined(STLPLUS_CRC32C_ARM)
+        if (crc32c_hardware_present())
+          m_function = crc32c_hardware;
+#endif
+      }
+  };
+
+  static crc32c_selector crc32c_selected;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  unsigned crc32c(unsigned crc, const unsigned char* data, size_t size)
+  {
+    return crc32c_selected.m_function(crc, data, size);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
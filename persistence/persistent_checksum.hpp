@@ -0,0 +1,54 @@
+#ifndef STLPLUS_PERSISTENT_CHECKSUM
+#define STLPLUS_PERSISTENT_CHECKSUM
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Integrity checking of dumps using a CRC32C (Castagnoli) checksum. This is
+//   opt-in - a checked dump must be restored with restore_checked, and the
+//   normal dump functions do not use checksums.
+
+//   The checksum is calculated by the context as the dump is written and
+//   again as it is read by the restore, then written as a 4-byte trailer
+//   after the checked data. A corrupt dump is therefore detected by the
+//   restore itself rather than needing a separate pass over the file first.
+//   However, the corruption is only reported when the end of the checked data
+//   is reached, so the restore function may fail first on the corrupt data.
+
+//   See persistent_shortcuts.hpp for the checked versions of the
+//   dump_to/restore_from functions, which check the whole of a dump.
+
+//   The checksum uses the CRC32 instructions of processors that have them
+//   (SSE4.2 on x86, the CRC extension on ARMv8), otherwise a portable
+//   table-driven version.
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_contexts.hpp"
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  // exceptions: persistent_dump_failed
+  template<typename T, typename D>
+  void dump_checked(dump_context&, const T& data, D dump_fn);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, typename R>
+  void restore_checked(restore_context&, T& data, R restore_fn);
+
+  // update a running CRC32C checksum with a block of data - the checksum of no data is zero
+  // so a checksum is calculated in pieces by starting with zero and passing each result to the next call
+  unsigned crc32c(unsigned crc, const unsigned char* data, size_t size);
+
+} // end namespace stlplus
+
+  ////////////////////////////////////////////////////////////////////////////////
+#include "persistent_checksum.tpp"
+#endif
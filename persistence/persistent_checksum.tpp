@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, typename D>
+  void dump_checked(dump_context& context, const T& data, D dump_fn)
+  {
+    context.begin_checksum();
+    dump_fn(context,data);
+    context.end_checksum();
+  }
+
+  template<typename T, typename R>
+  void restore_checked(restore_context& context, T& data, R restore_fn)
+  {
+    context.begin_checksum();
+    restore_fn(context,data);
+    context.end_checksum();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_compression.hpp"
+#include <string.h>
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Codec parameters
+
+  // The codec is a byte-oriented LZ77 variant in the same family as LZ4. The
+  // packed data is a sequence of tokens of the form:
+  //
+  //   token [literal_length*] literals [offset match_length*]
+  //
+  // - the token's high nibble is the number of literals and the low nibble is
+  //   the match length minus the minimum match
+  // - a nibble of 15 means the length continues in following bytes, each
+  //   byte being added to it, until a byte less than 255 is seen
+  // - the offset is a 16-bit little-endian distance back into the output
+  // - the last token in a block may have no match, it is recognised because
+  //   the packed data ends after its literals
+
+  static const size_t block_size = 65536;
+  static const size_t min_match = 4;
+  static const size_t max_offset = 65535;
+  static const unsigned hash_bits = 14;
+  static const unsigned char signature[4] = {'S', 'L', 'Z', 1};
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // block codec
+
+  static inline unsigned read32(const unsigned char* data)
+  {
+    unsigned result;
+    memcpy(&result, data, sizeof(result));
+    return result;
+  }
+
+  static inline unsigned hash32(unsigned value)
+  {
+    return (value * 2654435761U) >> (32 - hash_bits);
+  }
+
+  // write a length continuation, returns false if there's no room
+  static inline bool put_length(unsigned char*& out, const unsigned char* out_end, size_t length)
+  {
+    for (;;)
+    {
+      if (out == out_end) return false;
+      if (length < 255)
+      {
+        *out++ = (unsigned char)length;
+        return true;
+      }
+      *out++ = 255;
+      length -= 255;
+    }
+  }
+
+  static inline bool get_length(const unsigned char*& in, const unsigned char* in_end, size_t& length)
+  {
+    for (;;)
+    {
+      if (in == in_end) return false;
+      unsigned char byte = *in++;
+      length += byte;
+      if (byte < 255) return true;
+    }
+  }
+
+  // write one token with its literals and optional match
+  static inline bool put_sequence(unsigned char*& out, const unsigned char* out_end,
+                                  const unsigned char* literals, size_t literal_length,
+                                  size_t offset, size_t match_length)
+  {
+    if (out == out_end) return false;
+    unsigned char* token = out++;
+    *token = (unsigned char)((literal_length < 15 ? literal_length : 15) << 4);
+    if (literal_length >= 15 && !put_length(out, out_end, literal_length - 15))
+      return false;
+    if ((size_t)(out_end - out) < literal_length) return false;
+    memcpy(out, literals, literal_length);
+    out += literal_length;
+    if (match_length != 0)
+    {
+      size_t code = match_length - min_match;
+      *token |= (unsigned char)(code < 15 ? code : 15);
+      if (out_end - out < 2) return false;
+      *out++ = (unsigned char)(offset & 0xff);
+      *out++ = (unsigned char)(offset >> 8);
+      if (code >= 15 && !put_length(out, out_end, code - 15))
+        return false;
+    }
+    return true;
+  }
+
+  size_t compress_block(const unsigned char* data, size_t size, unsigned char* packed, size_t available)
+  {
+    std::vector<unsigned> table(1 << hash_bits, 0);
+    unsigned char* out = packed;
+    const unsigned char* out_end = packed + available;
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i + min_match <= size)
+    {
+      unsigned value = read32(data + i);
+      unsigned& slot = table[hash32(value)];
+      size_t candidate = slot;
+      slot = (unsigned)i;
+      if (candidate < i && i - candidate <= max_offset && read32(data + candidate) == value)
+      {
+        // extend the match as far as it goes
+        size_t length = min_match;
+        while (i + length < size && data[candidate + length] == data[i + length])
+          length++;
+        if (!put_sequence(out, out_end, data + anchor, i - anchor, i - candidate, length))
+          return 0;
+        i += length;
+        anchor = i;
+      }
+      else
+      {
+        // skip faster through data that isn't compressing
+        i += 1 + ((i - anchor) >> 6);
+      }
+    }
+    if (anchor < size && !put_sequence(out, out_end, data + anchor, size - anchor, 0, 0))
+      return 0;
+    return out - packed;
+  }
+
+  bool decompress_block(const unsigned char* packed, size_t packed_size, unsigned char* data, size_t size)
+  {
+    const unsigned char* in = packed;
+    const unsigned char* in_end = packed + packed_size;
+    unsigned char* out = data;
+    unsigned char* out_end = data + size;
+    while (in != in_end)
+    {
+      unsigned char token = *in++;
+      size_t literal_length = token >> 4;
+      if (literal_length == 15 && !get_length(in, in_end, literal_length))
+        return false;
+      if ((size_t)(in_end - in) < literal_length || (size_t)(out_end - out) < literal_length)
+        return false;
+      memcpy(out, in, literal_length);
+      in += literal_length;
+      out += literal_length;
+      // the last sequence has no match part
+      if (in == in_end) break;
+      if (in_end - in < 2) return false;
+      size_t offset = in[0] | ((size_t)in[1] << 8);
+      in += 2;
+      size_t match_length = token & 15;
+      if (match_length == 15 && !get_length(in, in_end, match_length))
+        return false;
+      match_length += min_match;
+      if (offset == 0 || offset > (size_t)(out - data) || (size_t)(out_end - out) < match_length)
+        return false;
+      const unsigned char* from = out - offset;
+      if (offset >= match_length)
+      {
+        memcpy(out, from, match_length);
+        out += match_length;
+      }
+      else
+      {
+        // overlapping match - this repeats the last offset bytes so must be copied byte by byte
+        for (size_t j = 0; j < match_length; j++)
+          *out++ = *from++;
+      }
+    }
+    return out == out_end;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // block framing
+
+  static void put_size(unsigned char* data, size_t size)
+  {
+    for (unsigned i = 0; i < 4; i++)
+      data[i] = (unsigned char)((size >> (8*i)) & 0xff);
+  }
+
+  static size_t get_size(const unsigned char* data)
+  {
+    size_t result = 0;
+    for (unsigned i = 0; i < 4; i++)
+      result |= (size_t)data[i] << (8*i);
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // compressing stream buffer
+
+  compress_streambuf::compress_streambuf(std::ostream& device) :
+    m_device(&device), m_raw(block_size), m_packed(block_size + 8), m_started(false), m_finished(false)
+  {
+    setp(&m_raw[0], &m_raw[0] + m_raw.size());
+  }
+
+  compress_streambuf::~compress_streambuf(void)
+  {
+    try
+    {
+      finish();
+    }
+    catch(...)
+    {
+    }
+  }
+
+  void compress_streambuf::write_block(void)
+  {
+    if (!m_started)
+    {
+      m_device->write((const char*)signature, sizeof(signature));
+      m_started = true;
+    }
+    size_t raw_size = pptr() - pbase();
+    if (raw_size == 0) return;
+    // try to compress into the space after the header, giving up if the result is no smaller
+    size_t packed_size = compress_block((const unsigned char*)pbase(), raw_size, &m_packed[8], raw_size - 1);
+    if (packed_size == 0)
+    {
+      packed_size = raw_size;
+      memcpy(&m_packed[8], pbase(), raw_size);
+    }
+    put_size(&m_packed[0], raw_size);
+    put_size(&m_packed[4], packed_size);
+    if (!m_device->write((const char*)&m_packed[0], packed_size + 8))
+      throw persistent_dump_failed(std::string("output device error"));
+    setp(&m_raw[0], &m_raw[0] + m_raw.size());
+  }
+
+  compress_streambuf::int_type compress_streambuf::overflow(int_type ch)
+  {
+    if (m_finished)
+      return traits_type::eof();
+    write_block();
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  int compress_streambuf::sync(void)
+  {
+    if (m_finished)
+      return 0;
+    write_block();
+    return m_device->flush() ? 0 : -1;
+  }
+
+  void compress_streambuf::finish(void)
+  {
+    if (m_finished) return;
+    write_block();
+    m_finished = true;
+    // the end marker is an empty block
+    unsigned char marker[8];
+    put_size(marker, 0);
+    put_size(marker+4, 0);
+    if (!m_device->write((const char*)marker, sizeof(marker)) || !m_device->flush())
+      throw persistent_dump_failed(std::string("output device error"));
+    setp(0, 0);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // decompressing stream buffer
+
+  decompress_streambuf::decompress_streambuf(std::istream& device) :
+    m_device(&device), m_raw(block_size), m_packed(block_size), m_started(false), m_finished(false)
+  {
+    setg(&m_raw[0], &m_raw[0], &m_raw[0]);
+  }
+
+  decompress_streambuf::~decompress_streambuf(void)
+  {
+  }
+
+  bool decompress_streambuf::read_block(void)
+  {
+    if (!m_started)
+    {
+      unsigned char header[sizeof(signature)];
+      if (!m_device->read((char*)header, sizeof(header)))
+        return false;
+      if (memcmp(header, signature, sizeof(signature)) != 0)
+        throw persistent_restore_failed(std::string("not a compressed stream or unsupported compression format"));
+      m_started = true;
+    }
+    unsigned char sizes[8];
+    if (!m_device->read((char*)sizes, sizeof(sizes)))
+      return false;
+    size_t raw_size = get_size(sizes);
+    size_t packed_size = get_size(sizes+4);
+    if (raw_size == 0)
+    {
+      m_finished = true;
+      return false;
+    }
+    if (raw_size > m_raw.size() || packed_size > raw_size)
+      throw persistent_restore_failed(std::string("corrupt compressed block header"));
+    if (packed_size == raw_size)
+    {
+      // stored block so read it directly
+      if (!m_device->read(&m_raw[0], raw_size))
+        return false;
+    }
+    else
+    {
+      if (!m_device->read((char*)&m_packed[0], packed_size))
+        return false;
+      if (!decompress_block(&m_packed[0], packed_size, (unsigned char*)&m_raw[0], raw_size))
+        throw persistent_restore_failed(std::string("corrupt compressed block"));
+    }
+    setg(&m_raw[0], &m_raw[0], &m_raw[0] + raw_size);
+    return true;
+  }
+
+  decompress_streambuf::int_type decompress_streambuf::underflow(void)
+  {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+    if (m_finished || !read_block())
+      return traits_type::eof();
+    return traits_type::to_int_type(*gptr());
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // streams
+  // the badbit exception is enabled so that the codec's exceptions propagate to the caller
+  // rather than being reduced to a generic device error
+
+  compressed_ostream::compressed_ostream(std::ostream& device) :
+    std::ostream(0), m_buffer(device)
+  {
+    rdbuf(&m_buffer);
+    exceptions(std::ios_base::badbit);
+  }
+
+  compressed_ostream::~compressed_ostream(void)
+  {
+  }
+
+  void compressed_ostream::finish(void)
+  {
+    m_buffer.finish();
+  }
+
+  compressed_istream::compressed_istream(std::istream& device) :
+    std::istream(0), m_buffer(device)
+  {
+    rdbuf(&m_buffer);
+    exceptions(std::ios_base::badbit);
+  }
+
+  compressed_istream::~compressed_istream(void)
+  {
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -0,0 +1,146 @@
+#ifndef STLPLUS_PERSISTENT_COMPRESSION
+#define STLPLUS_PERSISTENT_COMPRESSION
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Compressed IOStream devices for use with the persistence contexts
+
+//   A compressed_ostream wraps any binary output device and compresses
+//   everything written to it using a small, fast LZ77-style codec built into
+//   STLplus. A compressed_istream wraps a binary input device and decompresses
+//   the data again. They can be passed to dump_context/restore_context in
+//   place of the raw device, or see persistent_shortcuts.hpp for the
+//   compressed versions of the dump_to/restore_from functions.
+
+//   The data is split into blocks which are compressed independently, so only
+//   one block is ever held in memory on either side and the device can be
+//   streamed. Blocks that do not compress are stored as-is, so the worst-case
+//   overhead is a few bytes per block.
+
+//   format: signature {raw_size packed_size data}* 0 0
+//   - the signature is the four bytes "SLZ" followed by the format version
+//   - the sizes are 32-bit little-endian integers
+//   - if packed_size == raw_size then the block is stored uncompressed
+//   - a block with a raw_size of zero marks the end of the compressed data
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_exceptions.hpp"
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // stream buffers that do the work - not normally used directly
+
+  class compress_streambuf : public std::streambuf
+  {
+  public:
+    // device must be in binary mode
+    compress_streambuf(std::ostream& device);
+    ~compress_streambuf(void);
+
+    // write any part-filled block followed by the end marker
+    // the buffer cannot be written to after this
+    // exceptions: persistent_dump_failed
+    void finish(void);
+
+  protected:
+    int_type overflow(int_type ch);
+    int sync(void);
+
+  private:
+    std::ostream* m_device;
+    std::vector<char> m_raw;
+    std::vector<unsigned char> m_packed;
+    bool m_started;
+    bool m_finished;
+
+    void write_block(void);
+
+    // disallow copying by making assignment and copy constructor private
+    compress_streambuf(const compress_streambuf&);
+    compress_streambuf& operator=(const compress_streambuf&);
+  };
+
+  class decompress_streambuf : public std::streambuf
+  {
+  public:
+    // device must be in binary mode
+    decompress_streambuf(std::istream& device);
+    ~decompress_streambuf(void);
+
+  protected:
+    int_type underflow(void);
+
+  private:
+    std::istream* m_device;
+    std::vector<char> m_raw;
+    std::vector<unsigned char> m_packed;
+    bool m_started;
+    bool m_finished;
+
+    bool read_block(void);
+
+    // disallow copying by making assignment and copy constructor private
+    decompress_streambuf(const decompress_streambuf&);
+    decompress_streambuf& operator=(const decompress_streambuf&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // compressing output stream
+
+  class compressed_ostream : public std::ostream
+  {
+  public:
+    // device must be in binary mode
+    compressed_ostream(std::ostream& device);
+    ~compressed_ostream(void);
+
+    // complete the compressed stream - this should be called once the dump
+    // is complete, otherwise the destructor will do it but any errors will be lost
+    // exceptions: persistent_dump_failed
+    void finish(void);
+
+  private:
+    compress_streambuf m_buffer;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // decompressing input stream
+
+  class compressed_istream : public std::istream
+  {
+  public:
+    // device must be in binary mode
+    // a corrupt compressed stream causes persistent_restore_failed to be thrown by the read operation
+    compressed_istream(std::istream& device);
+    ~compressed_istream(void);
+
+  private:
+    decompress_streambuf m_buffer;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // low-level access to the codec for a single block of data
+  // the compress function returns the packed size or zero if the data will not fit in the available space
+  // the decompress function returns false if the packed data is corrupt
+
+  size_t compress_block(const unsigned char* data, size_t size, unsigned char* packed, size_t available);
+  bool decompress_block(const unsigned char* packed, size_t packed_size, unsigned char* data, size_t size);
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
+
+////////////////////////////////////////////////////////////////////////////////
+#endif
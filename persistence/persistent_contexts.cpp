@@ -8,9 +8,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_contexts.hpp"
 #include "persistent.hpp"
+#include "persistent_int.hpp"
+#include "persistent_checksum.hpp"
 #include <map>
+#include <vector>
+#include <typeinfo>
 #include <string>
+#include <sstream>
 #include <stdio.h>
+#include <string.h>
 
 namespace stlplus
 {
@@ -42,12 +48,91 @@ namespace stlplus
 
   static bool little_endian(void)
   {
-    // TODO - find a compile-time way of doing this
+#if defined(STLPLUS_LITTLE_ENDIAN)
+    return true;
+#elif defined(STLPLUS_BIG_ENDIAN)
+    return false;
+#else
     int sample = 1;
     char* sample_bytes = (char*)&sample;
     return sample_bytes[0] != 0;
+#endif
   }
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // order type_info objects in the same way as C++11's type_index, so that they can
+  // be used as map keys without building a string from the type name each time
+
+  class type_info_less
+  {
+  public:
+    bool operator()(const std::type_info* left, const std::type_info* right) const
+      {
+        return left->before(*right) != 0;
+      }
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // the running checksum of a section of a dump or restore - see persistent_checksum.hpp
+  // device data is collected into blocks so that single bytes are not checksummed one at a time
+  // string data is checksummed in one go at the end since it is all in memory anyway
+
+  class checksum_accumulator
+  {
+  public:
+    enum {block_size = 1024};
+    bool m_active;
+    unsigned m_crc;
+    size_t m_count;
+    size_t m_start;
+    unsigned char m_block[block_size];
+
+    checksum_accumulator(void) : m_active(false), m_crc(0), m_count(0), m_start(0) {}
+
+    // the start is the position in the string at which the checksum starts
+    void start(size_t start)
+      {
+        m_active = true;
+        m_crc = 0;
+        m_count = 0;
+        m_start = start;
+      }
+
+    void add(unsigned char data)
+      {
+        m_block[m_count++] = data;
+        if (m_count == block_size)
+          flush();
+      }
+
+    void add(const unsigned char* data, size_t size)
+      {
+        if (size < block_size - m_count)
+        {
+          memcpy(m_block + m_count, data, size);
+          m_count += size;
+        }
+        else
+        {
+          flush();
+          m_crc = crc32c(m_crc, data, size);
+        }
+      }
+
+    void flush(void)
+      {
+        m_crc = crc32c(m_crc, m_block, m_count);
+        m_count = 0;
+      }
+
+    unsigned finish(void)
+      {
+        flush();
+        m_active = false;
+        return m_crc;
+      }
+  };
+
   ////////////////////////////////////////////////////////////////////////////////
   // dump context classes
   ////////////////////////////////////////////////////////////////////////////////
@@ -56,21 +141,46 @@ namespace stlplus
   {
   public:
     typedef std::map<const void*,unsigned> magic_map;
-    typedef std::map<std::string,dump_context::callback_data> callback_map;
-    typedef std::map<std::string,unsigned> interface_map;
+    typedef std::map<const std::type_info*,dump_context::callback_data,type_info_less> callback_map;
+    typedef std::map<const std::type_info*,unsigned,type_info_less> interface_map;
+
+    // an unfinished record holds back its contents until its size is known
+    // in a counting context the contents are only counted
+    class record
+    {
+    public:
+      std::string m_data;
+      size_t m_size;
+      record(void) : m_size(0) {}
+    };
 
     unsigned m_max_key;
     unsigned char m_version;
     bool m_little_endian;
+    // output goes to the device if there is one, otherwise to the string if there is one, otherwise it is just counted
     std::ostream* m_device;
+    std::string* m_string;
+    size_t m_size;
+    mutable std::ostream* m_dummy;
+    std::vector<record> m_records;
+    checksum_accumulator m_checksum;
     magic_map m_pointers;
     magic_map m_objects;
     callback_map m_callbacks;
     interface_map m_interfaces;
-
-    dump_context_body(std::ostream& device, unsigned char version)  :
-      m_max_key(0), m_version(version), m_little_endian(stlplus::little_endian()), m_device(&device)
+    // direct-mapped caches of recent lookups, indexed by the address of the type_info
+    // a hit only needs an address comparison, whereas the maps compare type names
+    enum {type_cache_size = 16};
+    mutable const std::type_info* m_callback_types[type_cache_size];
+    mutable dump_context::callback_data m_callback_cache[type_cache_size];
+    mutable const std::type_info* m_interface_types[type_cache_size];
+    mutable unsigned m_interface_cache[type_cache_size];
+
+    dump_context_body(std::ostream* device, std::string* result, unsigned char version)  :
+      m_max_key(0), m_version(version), m_little_endian(stlplus::little_endian()),
+      m_device(device), m_string(result), m_size(0), m_dummy(0)
       {
+        clear_type_caches();
         // write the version number as a single byte
         put(version);
         // map a null pointer onto magic number zero
@@ -80,15 +190,130 @@ namespace stlplus
           throw persistent_dump_failed(std::string("wrong version: ") + to_string(m_version));
       }
 
+    ~dump_context_body(void)
+      {
+        delete m_dummy;
+      }
+
     void put(unsigned char data)
       {
-        if (!m_device->put(data))
-          throw persistent_dump_failed(std::string("output device error"));
+        if (!m_records.empty())
+        {
+          record& current = m_records.back();
+          if (m_device || m_string)
+            current.m_data.push_back((char)data);
+          current.m_size++;
+        }
+        else
+        {
+          if (m_device)
+          {
+            if (!m_device->put(data))
+              throw persistent_dump_failed(std::string("output device error"));
+            if (m_checksum.m_active)
+              m_checksum.add(data);
+          }
+          else if (m_string)
+            m_string->push_back((char)data);
+          m_size++;
+        }
+      }
+
+    void put(const unsigned char* data, size_t size)
+      {
+        if (!m_records.empty())
+        {
+          record& current = m_records.back();
+          if (m_device || m_string)
+            current.m_data.append((const char*)data, size);
+          current.m_size += size;
+        }
+        else
+        {
+          if (m_device)
+          {
+            if (!m_device->write((const char*)data, size))
+              throw persistent_dump_failed(std::string("output device error"));
+            if (m_checksum.m_active)
+              m_checksum.add(data, size);
+          }
+          else if (m_string)
+            m_string->append((const char*)data, size);
+          m_size += size;
+        }
+      }
+
+    void begin_record(void)
+      {
+        m_records.push_back(record());
+      }
+
+    // take the innermost record so that its size can be written before its contents
+    void end_record(record& finished)
+      {
+        if (m_records.empty())
+          throw persistent_dump_failed(std::string("end of record without a matching start"));
+        finished.m_data.swap(m_records.back().m_data);
+        finished.m_size = m_records.back().m_size;
+        m_records.pop_back();
+      }
+
+    void put_record(const record& finished)
+      {
+        if (!m_records.empty())
+        {
+          record& current = m_records.back();
+          current.m_data.append(finished.m_data);
+          current.m_size += finished.m_size;
+        }
+        else
+        {
+          if (m_device)
+          {
+            if (!m_device->write(finished.m_data.data(), finished.m_data.size()))
+              throw persistent_dump_failed(std::string("output device error"));
+            if (m_checksum.m_active)
+              m_checksum.add((const unsigned char*)finished.m_data.data(), finished.m_data.size());
+          }
+          else if (m_string)
+            m_string->append(finished.m_data);
+          m_size += finished.m_size;
+        }
+      }
+
+    // a checksum covers whole records, so cannot start or end inside one
+    void begin_checksum(void)
+      {
+        if (m_checksum.m_active)
+          throw persistent_dump_failed(std::string("checksum already started"));
+        if (!m_records.empty())
+          throw persistent_dump_failed(std::string("checksum started inside a record"));
+        m_checksum.start(m_string ? m_string->size() : 0);
+      }
+
+    unsigned end_checksum(void)
+      {
+        if (!m_checksum.m_active)
+          throw persistent_dump_failed(std::string("end of checksum without a matching start"));
+        if (!m_records.empty())
+          throw persistent_dump_failed(std::string("checksum ended inside a record"));
+        if (m_string)
+          m_checksum.add((const unsigned char*)m_string->data() + m_checksum.m_start, m_string->size() - m_checksum.m_start);
+        return m_checksum.finish();
+      }
+
+    size_t size(void) const
+      {
+        return m_size;
       }
 
     const std::ostream& device(void) const
       {
-        return *m_device;
+        if (m_device)
+          return *m_device;
+        if (!m_dummy)
+          m_dummy = new std::ostringstream(std::ios_base::out | std::ios_base::binary);
+        return *m_dummy;
       }
 
     unsigned char version(void) const
@@ -129,47 +354,69 @@ namespace stlplus
         return std::pair<bool,unsigned>(true,found->second);
       }
 
+    static unsigned type_cache_slot(const std::type_info& info)
+      {
+        return (unsigned)(((size_t)&info) >> 4) % type_cache_size;
+      }
+
+    void clear_type_caches(void)
+      {
+        for (unsigned i = 0; i < type_cache_size; i++)
+        {
+          m_callback_types[i] = 0;
+          m_interface_types[i] = 0;
+        }
+      }
+
     unsigned register_callback(const std::type_info& info, dump_context::dump_callback callback)
       {
-        std::string key = info.name();
         unsigned data = ++m_max_key;
-        m_callbacks[key] = std::make_pair(data,callback);
+        m_callbacks[&info] = std::make_pair(data,callback);
+        clear_type_caches();
         return data;
       }
 
     bool is_callback(const std::type_info& info) const
       {
-        return m_callbacks.find(info.name()) != m_callbacks.end();
+        return m_callbacks.find(&info) != m_callbacks.end();
       }
 
     dump_context::callback_data lookup_callback(const std::type_info& info) const
       {
-        std::string key = info.name();
-        callback_map::const_iterator found = m_callbacks.find(key);
+        unsigned slot = type_cache_slot(info);
+        if (m_callback_types[slot] == &info)
+          return m_callback_cache[slot];
+        callback_map::const_iterator found = m_callbacks.find(&info);
         if (found == m_callbacks.end())
-          throw persistent_illegal_type(key);
+          throw persistent_illegal_type(std::string(info.name()));
+        m_callback_types[slot] = &info;
+        m_callback_cache[slot] = found->second;
         return found->second;
       }
 
     unsigned register_interface(const std::type_info& info)
       {
-        std::string key = info.name();
         unsigned data = ++m_max_key;
-        m_interfaces[key] = data;
+        m_interfaces[&info] = data;
+        clear_type_caches();
         return data;
       }
 
     bool is_interface(const std::type_info& info) const
       {
-        return m_interfaces.find(info.name()) != m_interfaces.end();
+        return m_interfaces.find(&info) != m_interfaces.end();
       }
 
     unsigned lookup_interface(const std::type_info& info) const
       {
-        std::string key = info.name();
-        interface_map::const_iterator found = m_interfaces.find(key);
+        unsigned slot = type_cache_slot(info);
+        if (m_interface_types[slot] == &info)
+          return m_interface_cache[slot];
+        interface_map::const_iterator found = m_interfaces.find(&info);
         if (found == m_interfaces.end())
-          throw persistent_illegal_type(key);
+          throw persistent_illegal_type(std::string(info.name()));
+        m_interface_types[slot] = &info;
+        m_interface_cache[slot] = found->second;
         return found->second;
       }
   };
@@ -178,7 +425,17 @@ namespace stlplus
 
   dump_context::dump_context(std::ostream& device, unsigned char version)  : m_body(0)
   {
-    m_body = new dump_context_body(device,version);
+    m_body = new dump_context_body(&device,0,version);
+  }
+
+  dump_context::dump_context(std::string& result, unsigned char version)  : m_body(0)
+  {
+    m_body = new dump_context_body(0,&result,version);
+  }
+
+  dump_context::dump_context(unsigned char version)  : m_body(0)
+  {
+    m_body = new dump_context_body(0,0,version);
   }
 
   dump_context::~dump_context(void)
@@ -191,6 +448,42 @@ namespace stlplus
     m_body->put(data);
   }
 
+  void dump_context::put(const unsigned char* data, size_t size)
+  {
+    m_body->put(data, size);
+  }
+
+  size_t dump_context::size(void) const
+  {
+    return m_body->size();
+  }
+
+  void dump_context::begin_record(void)
+  {
+    m_body->begin_record();
+  }
+
+  void dump_context::end_record(void)
+  {
+    dump_context_body::record finished;
+    m_body->end_record(finished);
+    dump_size_t(*this, finished.m_size);
+    m_body->put_record(finished);
+  }
+
+  void dump_context::begin_checksum(void)
+  {
+    m_body->begin_checksum();
+  }
+
+  void dump_context::end_checksum(void)
+  {
+    // the checksum is written most-significant byte first, like the other integer types
+    unsigned crc = m_body->end_checksum();
+    for (int shift = 24; shift >= 0; shift -= 8)
+      m_body->put((unsigned char)(crc >> shift));
+  }
+
   const std::ostream& dump_context::device(void) const
   {
     return m_body->device();
@@ -259,24 +552,43 @@ namespace stlplus
   {
   public:
     typedef persistent* persistent_ptr;
-    typedef std::map<unsigned,void*> magic_map;
-    typedef std::map<unsigned,restore_context::callback_data> callback_map;
-    typedef std::map<unsigned,persistent_ptr> interface_map;
+    // the dump allocates magic numbers in sequence, so they index a vector of (seen,address) pairs
+    // a magic number far beyond the end of the vector can only come from a corrupt or unusual dump, so
+    // rather than growing the vector to reach it, it is kept in a sparse map
+    typedef std::vector<std::pair<bool,void*> > magic_map;
+    typedef std::map<unsigned,void*> sparse_magic_map;
+    // callbacks and interfaces share the key space, so both are indexed directly by key
+    // with null entries for the keys that belong to the other kind
+    typedef std::vector<restore_context::callback_data> callback_map;
+    typedef std::vector<restore_context::arena_create_callback> arena_callback_map;
+    typedef std::vector<persistent_ptr> interface_map;
 
     unsigned m_max_key;
     unsigned char m_version;
     bool m_little_endian;
+    // input comes from the device if there is one, otherwise from the string
     std::istream* m_device;
+    const std::string* m_string;
+    size_t m_position;
+    mutable std::istream* m_dummy;
+    // the positions of the ends of the records being read, innermost last
+    std::vector<size_t> m_record_ends;
+    checksum_accumulator m_checksum;
+    restore_arena* m_arena;
     magic_map m_pointers;
     magic_map m_objects;
+    sparse_magic_map m_sparse_pointers;
+    sparse_magic_map m_sparse_objects;
     callback_map m_callbacks;
+    arena_callback_map m_arena_callbacks;
     interface_map m_interfaces;
 
-    restore_context_body(std::istream& device)  :
-      m_max_key(0), m_little_endian(stlplus::little_endian()), m_device(&device)
+    restore_context_body(std::istream* device, const std::string* source)  :
+      m_max_key(0), m_little_endian(stlplus::little_endian()),
+      m_device(device), m_string(source), m_position(0), m_dummy(0), m_arena(0)
       {
         // map a null pointer onto magic number zero
-        m_pointers[0] = 0;
+        pointer_add(0,0);
         // get the dump version and see if we support it
         m_version = (unsigned char)get();
         if (m_version != 1 && m_version != 2)
@@ -289,11 +601,16 @@ namespace stlplus
         // I used to use smart_ptr_clone for storing them but I want to disconnect as many dependencies as possible
         for (unsigned i = 0; i < m_interfaces.size(); i++)
           delete m_interfaces[i];
+        delete m_dummy;
       }
 
     const std::istream& device(void) const
       {
-        return *m_device;
+        if (m_device)
+          return *m_device;
+        if (!m_dummy)
+          m_dummy = new std::istringstream(std::ios_base::in | std::ios_base::binary);
+        return *m_dummy;
       }
 
     unsigned char version(void) const
@@ -308,82 +625,210 @@ namespace stlplus
 
     int get(void)
       {
-        int result = m_device->get();
-        if (!m_device->good())
-          throw persistent_restore_failed(std::string("device error or premature end of file"));
+        int result = 0;
+        if (!m_device)
+        {
+          if (m_position == m_string->size())
+            throw persistent_restore_failed(std::string("device error or premature end of file"));
+          result = (unsigned char)(*m_string)[m_position];
+        }
+        else
+        {
+          result = m_device->get();
+          if (!m_device->good())
+            throw persistent_restore_failed(std::string("device error or premature end of file"));
+          if (m_checksum.m_active)
+            m_checksum.add((unsigned char)result);
+        }
+        m_position++;
         return result;
       }
 
-    std::pair<bool,void*> pointer_map(unsigned magic)
+    void get(unsigned char* data, size_t size)
       {
-        magic_map::iterator found = m_pointers.find(magic);
-        if (found == m_pointers.end())
+        if (!m_device)
         {
-          // this magic number has never been seen before
-          return std::pair<bool,void*>(false,(void*)0);
+          if (size > m_string->size() - m_position)
+            throw persistent_restore_failed(std::string("device error or premature end of file"));
+          m_string->copy((char*)data, size, m_position);
+          m_position += size;
+        }
+        else
+        {
+          if (size > 0 && !m_device->read((char*)data, size))
+            throw persistent_restore_failed(std::string("device error or premature end of file"));
+          m_position += size;
+          if (m_checksum.m_active)
+            m_checksum.add(data, size);
         }
+      }
+
+    void skip(size_t size)
+      {
+        if (!m_device)
+        {
+          if (size > m_string->size() - m_position)
+            throw persistent_restore_failed(std::string("device error or premature end of file"));
+        }
+        else if (m_checksum.m_active)
+        {
+          // skipped data must still be checksummed, so read it in blocks
+          unsigned char buffer [checksum_accumulator::block_size];
+          while (size > 0)
+          {
+            size_t block = size < sizeof(buffer) ? size : sizeof(buffer);
+            get(buffer, block);
+            size -= block;
+          }
+        }
+        else if (size > 0)
+        {
+          m_device->ignore((std::streamsize)size);
+          if ((size_t)m_device->gcount() != size || !m_device->good())
+            throw persistent_restore_failed(std::string("device error or premature end of file"));
+        }
+        m_position += size;
+      }
+
+    void begin_record(size_t size)
+      {
+        if (!m_record_ends.empty() && size > m_record_ends.back() - m_position)
+          throw persistent_restore_failed(std::string("record is larger than the record containing it"));
+        m_record_ends.push_back(m_position + size);
+      }
+
+    bool end_of_record(void) const
+      {
+        return m_record_ends.empty() || m_position >= m_record_ends.back();
+      }
+
+    void end_record(void)
+      {
+        if (m_record_ends.empty())
+          throw persistent_restore_failed(std::string("end of record without a matching start"));
+        size_t end = m_record_ends.back();
+        if (m_position > end)
+          throw persistent_restore_failed(std::string("restore read past the end of a record"));
+        m_record_ends.pop_back();
+        skip(end - m_position);
+      }
+
+    void begin_checksum(void)
+      {
+        if (m_checksum.m_active)
+          throw persistent_restore_failed(std::string("checksum already started"));
+        m_checksum.start(m_position);
+      }
+
+    unsigned end_checksum(void)
+      {
+        if (!m_checksum.m_active)
+          throw persistent_restore_failed(std::string("end of checksum without a matching start"));
+        if (!m_device)
+          m_checksum.add((const unsigned char*)m_string->data() + m_checksum.m_start, m_position - m_checksum.m_start);
+        return m_checksum.finish();
+      }
+
+    // the largest gap in the magic numbers that is filled in by growing the vector
+    static const unsigned magic_gap = 4096;
+
+    static std::pair<bool,void*> magic_lookup(const magic_map& map, const sparse_magic_map& sparse, unsigned magic)
+      {
+        // a magic number that has never been seen before maps to false
+        if (magic < map.size() && map[magic].first)
+          return map[magic];
+        if (sparse.empty())
+          return std::pair<bool,void*>(false,(void*)0);
+        sparse_magic_map::const_iterator found = sparse.find(magic);
+        if (found == sparse.end())
+          return std::pair<bool,void*>(false,(void*)0);
         return std::pair<bool,void*>(true,found->second);
       }
 
+    static void magic_add(magic_map& map, sparse_magic_map& sparse, unsigned magic, void* new_pointer)
+      {
+        // there can be gaps in the magic numbers, for example where records have been skipped
+        // a large gap would make a huge vector, and the largest magic number would make it wrap round to zero size
+        if (magic >= map.size())
+        {
+          if (magic - map.size() >= magic_gap)
+          {
+            sparse[magic] = new_pointer;
+            return;
+          }
+          map.resize(magic+1, std::pair<bool,void*>(false,(void*)0));
+        }
+        map[magic] = std::pair<bool,void*>(true,new_pointer);
+      }
+
+    std::pair<bool,void*> pointer_map(unsigned magic)
+      {
+        return magic_lookup(m_pointers, m_sparse_pointers, magic);
+      }
+
     void pointer_add(unsigned magic, void* new_pointer)
       {
-        m_pointers[magic] = new_pointer;
+        magic_add(m_pointers, m_sparse_pointers, magic, new_pointer);
       }
 
     std::pair<bool,void*> object_map(unsigned magic)
       {
-        magic_map::iterator found = m_objects.find(magic);
-        if (found == m_objects.end())
-        {
-          // this magic number has never been seen before
-          return std::pair<bool,void*>(false,(void*)0);
-        }
-        return std::pair<bool,void*>(true,found->second);
+        return magic_lookup(m_objects, m_sparse_objects, magic);
       }
 
     void object_add(unsigned magic, void* new_pointer)
       {
-        m_objects[magic] = new_pointer;
+        magic_add(m_objects, m_sparse_objects, magic, new_pointer);
       }
 
-    unsigned register_callback(restore_context::create_callback create, restore_context::restore_callback restore)
+    unsigned register_callback(restore_context::create_callback create, restore_context::restore_callback restore,
+                               restore_context::arena_create_callback arena_create)
       {
         unsigned key = ++m_max_key;
+        m_callbacks.resize(key+1, restore_context::callback_data(0,0));
         m_callbacks[key] = std::make_pair(create,restore);
+        m_arena_callbacks.resize(key+1, 0);
+        m_arena_callbacks[key] = arena_create;
         return key;
       }
 
     bool is_callback(unsigned key) const
       {
-        return m_callbacks.find(key) != m_callbacks.end();
+        return key < m_callbacks.size() && m_callbacks[key].second != 0;
       }
 
     restore_context::callback_data lookup_callback(unsigned key) const
       {
-        callback_map::const_iterator found = m_callbacks.find(key);
-        if (found == m_callbacks.end())
+        if (!is_callback(key))
           throw persistent_illegal_type(key);
-        return found->second;
+        return m_callbacks[key];
+      }
+
+    restore_context::arena_create_callback lookup_arena_callback(unsigned key) const
+      {
+        if (!is_callback(key))
+          throw persistent_illegal_type(key);
+        return m_arena_callbacks[key];
       }
 
     unsigned register_interface(persistent* sample)
       {
         unsigned key = ++m_max_key;
+        m_interfaces.resize(key+1, 0);
         m_interfaces[key] = sample;
         return key;
       }
 
     bool is_interface(unsigned key) const
       {
-        return m_interfaces.find(key) != m_interfaces.end();
+        return key < m_interfaces.size() && m_interfaces[key] != 0;
       }
 
     persistent* lookup_interface(unsigned key) const
       {
-        interface_map::const_iterator found = m_interfaces.find(key);
-        if (found == m_interfaces.end())
+        if (!is_interface(key))
           throw persistent_illegal_type(key);
-        return found->second;
+        return m_interfaces[key];
       }
   };
 
@@ -392,7 +837,13 @@ namespace stlplus
   restore_context::restore_context(std::istream& device)  :
     m_body(0)
   {
-    m_body = new restore_context_body(device);
+    m_body = new restore_context_body(&device,0);
+  }
+
+  restore_context::restore_context(const std::string& source)  :
+    m_body(0)
+  {
+    m_body = new restore_context_body(0,&source);
   }
 
   restore_context::~restore_context(void)
@@ -420,6 +871,58 @@ namespace stlplus
     return m_body->get();
   }
 
+  void restore_context::get(unsigned char* data, size_t size)
+  {
+    m_body->get(data, size);
+  }
+
+  void restore_context::skip(size_t size)
+  {
+    m_body->skip(size);
+  }
+
+  void restore_context::begin_record(void)
+  {
+    size_t size = 0;
+    restore_size_t(*this, size);
+    m_body->begin_record(size);
+  }
+
+  bool restore_context::end_of_record(void) const
+  {
+    return m_body->end_of_record();
+  }
+
+  void restore_context::end_record(void)
+  {
+    m_body->end_record();
+  }
+
+  void restore_context::begin_checksum(void)
+  {
+    m_body->begin_checksum();
+  }
+
+  void restore_context::end_checksum(void)
+  {
+    unsigned crc = m_body->end_checksum();
+    unsigned dumped = 0;
+    for (unsigned i = 0; i < 4; i++)
+      dumped = (dumped << 8) | (unsigned)m_body->get();
+    if (dumped != crc)
+      throw persistent_restore_failed(std::string("checksum error - the dump is corrupt"));
+  }
+
+  void restore_context::set_arena(restore_arena* arena)
+  {
+    m_body->m_arena = arena;
+  }
+
+  restore_arena* restore_context::arena(void) const
+  {
+    return m_body->m_arena;
+  }
+
   std::pair<bool,void*> restore_context::pointer_map(unsigned magic)
   {
     return m_body->pointer_map(magic);
@@ -442,7 +945,13 @@ namespace stlplus
 
   unsigned restore_context::register_callback(restore_context::create_callback create, restore_context::restore_callback restore)
   {
-    return m_body->register_callback(create,restore);
+    return m_body->register_callback(create,restore,0);
+  }
+
+  unsigned restore_context::register_callback(restore_context::create_callback create, restore_context::restore_callback restore,
+                                              restore_context::arena_create_callback arena_create)
+  {
+    return m_body->register_callback(create,restore,arena_create);
   }
 
   bool restore_context::is_callback(unsigned key) const
@@ -455,6 +964,11 @@ namespace stlplus
     return m_body->lookup_callback(key);
   }
 
+  restore_context::arena_create_callback restore_context::lookup_arena_callback(unsigned key) const
+  {
+    return m_body->lookup_arena_callback(key);
+  }
+
   unsigned restore_context::register_interface(persistent* sample)
   {
     return m_body->register_interface(sample);
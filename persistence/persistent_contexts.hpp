@@ -14,6 +14,7 @@
 #include "persistence_fixes.hpp"
 #include "persistent.hpp"
 #include <iostream>
+#include <string>
 #include <map>
 #include <typeinfo>
 
@@ -27,6 +28,7 @@ namespace stlplus
 
   class dump_context_body;
   class restore_context_body;
+  class restore_arena;
 
   ////////////////////////////////////////////////////////////////////////////////
   // The format version number currently supported
@@ -47,13 +49,46 @@ namespace stlplus
     // device must be in binary mode
     // exceptions: persistent_dump_failed
     dump_context(std::ostream& device, unsigned char version = PersistentVersion) ;
+
+    // dump directly into a string, appending to any existing contents
+    // exceptions: persistent_dump_failed
+    dump_context(std::string& result, unsigned char version = PersistentVersion) ;
+
+    // counting context - nothing is written, but size() reports how many bytes would have been
+    // exceptions: persistent_dump_failed
+    explicit dump_context(unsigned char version = PersistentVersion) ;
+
     ~dump_context(void);
 
     // low level output used to dump a byte
     // exceptions: persistent_dump_failed
     void put(unsigned char data) ;
 
+    // low level output used to dump a block of bytes
+    // exceptions: persistent_dump_failed
+    void put(const unsigned char* data, size_t size) ;
+
+    // the number of bytes dumped so far, including the version number
+    // the contents of an unfinished record are not counted until the record is finished
+    size_t size(void) const;
+
+    // framed records - see persistent_record.hpp
+    // output between begin_record and end_record is held back, then written with a size prefix
+    // records can be nested
+    void begin_record(void);
+    // exceptions: persistent_dump_failed
+    void end_record(void) ;
+
+    // integrity checking - see persistent_checksum.hpp
+    // output between begin_checksum and end_checksum is checksummed and the checksum written after it
+    // checksums cannot be nested and cannot start or end inside a record
+    // exceptions: persistent_dump_failed
+    void begin_checksum(void) ;
+    // exceptions: persistent_dump_failed
+    void end_checksum(void) ;
+
     // access the device, for example to check the error status
+    // for string and counting contexts this is a dummy device that is never written
     const std::ostream& device(void) const;
 
     // recover the version number of the dumped output
@@ -108,13 +143,44 @@ namespace stlplus
     // device must be in binary mode
     // exceptions: persistent_restore_failed
     restore_context(std::istream& device) ;
+
+    // restore directly from a string, which must remain unchanged for the lifetime of the context
+    // exceptions: persistent_restore_failed
+    restore_context(const std::string& source) ;
+
     ~restore_context(void);
 
     // low level input used to restore a byte
     // exceptions: persistent_restore_failed
     int get(void) ;
 
+    // low level input used to restore a block of bytes
+    // exceptions: persistent_restore_failed
+    void get(unsigned char* data, size_t size) ;
+
+    // low level input used to discard a block of bytes
+    // exceptions: persistent_restore_failed
+    void skip(size_t size) ;
+
+    // framed records - see persistent_record.hpp
+    // begin_record reads the size prefix of a record
+    // exceptions: persistent_restore_failed
+    void begin_record(void) ;
+    // test whether the innermost record has been completely read
+    bool end_of_record(void) const;
+    // end_record skips any part of the record that has not been read
+    // exceptions: persistent_restore_failed
+    void end_record(void) ;
+
+    // integrity checking - see persistent_checksum.hpp
+    // end_checksum reads the dumped checksum and compares it with the checksum of the input since begin_checksum
+    // exceptions: persistent_restore_failed
+    void begin_checksum(void) ;
+    // exceptions: persistent_restore_failed
+    void end_checksum(void) ;
+
     // access the device, for example to check the error status
+    // for string contexts this is a dummy device that is never read
     const std::istream& device(void) const;
 
     // access the version number of the input being restored
@@ -124,6 +190,11 @@ namespace stlplus
     // this is used in dump/restore of integers
     bool little_endian(void) const;
 
+    // Arena allocation of restored objects - see persistent_arena.hpp
+    // the arena must outlive the restored data, a null arena means allocate with new
+    void set_arena(restore_arena* arena);
+    restore_arena* arena(void) const;
+
     // Assist functions for Pointers
     std::pair<bool,void*> pointer_map(unsigned magic);
     void pointer_add(unsigned magic, void* new_pointer);
@@ -138,6 +209,12 @@ namespace stlplus
     typedef std::pair<create_callback, restore_callback> callback_data;
     // exceptions: persistent_illegal_type
     callback_data lookup_callback(unsigned) const ;
+    // optionally also give a create callback for arena allocation, such as create_in_arena<T>
+    typedef void* (*arena_create_callback)(restore_arena&);
+    unsigned register_callback(create_callback,restore_callback,arena_create_callback);
+    // returns null if the class was registered without an arena create callback
+    // exceptions: persistent_illegal_type
+    arena_create_callback lookup_arena_callback(unsigned) const ;
 
     // Assist functions for Polymorphous classes using the interface approach
     unsigned register_interface(persistent*);
@@ -29,6 +29,23 @@ namespace stlplus
   template<typename NT, typename AT, typename RN, typename RA>
   void restore_digraph(restore_context&, digraph<NT,AT>& data, RN restore_node, RA restore_arc);
 
+  // incremental (delta) dumps
+  // dump only the differences between the base - typically the contents at the last dump - and the data
+  // on restore, the differences are applied to a graph which must already contain the base, for example
+  // by restoring a full dump and then each delta dump in turn
+  // nodes and arcs are matched by their position in the graph's node and arc lists, so deltas are
+  // smallest when nodes and arcs are modified in place or added, which appends them to the lists
+  // the node and arc types must have an operator==
+  // iterators into the graph cannot be dumped as part of a delta
+
+  // exceptions: persistent_dump_failed
+  template<typename NT, typename AT, typename DN, typename DA>
+  void dump_digraph_delta(dump_context&, const digraph<NT,AT>& base, const digraph<NT,AT>& data, DN dump_node, DA dump_arc);
+
+  // exceptions: persistent_restore_failed
+  template<typename NT, typename AT, typename RN, typename RA>
+  void restore_digraph_delta(restore_context&, digraph<NT,AT>& data, RN restore_node, RA restore_arc);
+
   // node iterator
 
   // exceptions: persistent_dump_failed
@@ -8,6 +8,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
 #include "persistent_xref.hpp"
+#include <map>
+#include <vector>
 
 namespace stlplus
 {
@@ -64,38 +66,239 @@ namespace stlplus
     restore_unsigned(context,magic);
     context.object_add(magic,&data);
     // restore the nodes
+    // the graph is built in bulk since the node count and arc list are known up front
+    // node magic keys are allocated in increasing order by the dump, so the nodes
+    // are indexed by their offset from the first key to avoid a lookup per arc end
+    // there can be gaps where the node data contains pointers, but a large gap can only
+    // come from a corrupt or unusual dump, so rather than growing the index to reach it,
+    // that node is kept in a sparse map as the restore_context does
+    const unsigned magic_gap = 4096;
     unsigned nodes = 0;
     restore_unsigned(context, nodes);
+    std::vector<digraph_node<NT,AT>*> node_vector;
+    std::vector<unsigned> node_index;
+    std::map<unsigned,unsigned> sparse_index;
+    unsigned first_magic = 0;
+    unsigned last_magic = 0;
     for (unsigned n = 0; n < nodes; n++)
     {
       unsigned node_magic = 0;
       restore_unsigned(context,node_magic);
+      if (n == 0)
+        first_magic = node_magic;
+      else if (node_magic <= last_magic)
+        throw persistent_restore_failed("digraph: node keys out of order");
+      last_magic = node_magic;
       // create a new node and map the magic key onto the new address
-      typename digraph<NT,AT>::iterator node = data.insert(NT());
-      context.pointer_add(node_magic,node.node());
+      digraph_node<NT,AT>* node = data._node_append();
+      context.pointer_add(node_magic,node);
+      unsigned offset = node_magic - first_magic;
+      if (offset - node_index.size() < magic_gap)
+      {
+        node_index.resize(offset + 1, nodes);
+        node_index.back() = n;
+      }
+      else
+        sparse_index[node_magic] = n;
+      node_vector.push_back(node);
       // now restore the user's data
-      restore_node(context,*node);
+      restore_node(context,node->m_data);
     }
     // restore the arcs
+    // they are appended to the arc list first and only connected to their nodes
+    // once the fanin and fanout of every node is known so that these can be reserved exactly
     unsigned arcs = 0;
     restore_unsigned(context, arcs);
-    for (unsigned a = 0; a < arcs; a++)
+    std::vector<unsigned> fanin(nodes, 0);
+    std::vector<unsigned> fanout(nodes, 0);
+    digraph_arc<NT,AT>* first = 0;
+    try
+    {
+      for (unsigned a = 0; a < arcs; a++)
+      {
+        unsigned arc_magic = 0;
+        restore_unsigned(context,arc_magic);
+        // restore the from and to cross-references, which must be nodes of this graph
+        unsigned ends [2] = {0, 0};
+        for (unsigned e = 0; e < 2; e++)
+        {
+          unsigned end_magic = 0;
+          restore_unsigned(context,end_magic);
+          if (end_magic >= first_magic && end_magic - first_magic < node_index.size() &&
+              node_index[end_magic - first_magic] != nodes)
+            ends[e] = node_index[end_magic - first_magic];
+          else
+          {
+            std::map<unsigned,unsigned>::const_iterator found = sparse_index.find(end_magic);
+            if (found == sparse_index.end())
+              throw persistent_restore_failed("digraph: arc refers to a node not in this graph");
+            ends[e] = found->second;
+          }
+        }
+        fanout[ends[0]]++;
+        fanin[ends[1]]++;
+        // create an arc with these from/to pointers
+        digraph_arc<NT,AT>* arc = data._arc_append(node_vector[ends[0]], node_vector[ends[1]]);
+        if (!first) first = arc;
+        context.pointer_add(arc_magic,arc);
+        // restore the user data
+        restore_arc(context,arc->m_data);
+      }
+    }
+    catch(...)
+    {
+      // leave the graph consistent
+      data._arc_connect(first);
+      throw;
+    }
+    for (unsigned n = 0; n < nodes; n++)
+      data._node_reserve(node_vector[n], fanin[n], fanout[n]);
+    data._arc_connect(first);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // delta format:
+  //   base_nodes nodes changed_nodes {index node}* {node}*(nodes - base_nodes)
+  //   base_arcs arcs changed_arcs {index from to arc}* {from to arc}*(arcs - base_arcs)
+  // where from and to are node indexes
+
+  template<typename NT, typename AT, typename DN, typename DA>
+  void dump_digraph_delta(dump_context& context, const digraph<NT,AT>& base, const digraph<NT,AT>& data,
+                          DN dump_node, DA dump_arc)
+  {
+    typedef typename digraph<NT,AT>::const_iterator const_iterator;
+    typedef typename digraph<NT,AT>::const_arc_iterator const_arc_iterator;
+    // number the nodes of both graphs so that arcs can be compared by their end-points
+    std::map<const void*,unsigned> base_index;
+    std::map<const void*,unsigned> data_index;
+    unsigned n = 0;
+    for (const_iterator i = base.begin(); i != base.end(); i++)
+      base_index[i.node()] = n++;
+    n = 0;
+    for (const_iterator i = data.begin(); i != data.end(); i++)
+      data_index[i.node()] = n++;
+    // nodes
+    std::vector<std::pair<unsigned,const_iterator> > changed_nodes;
+    const_iterator b = base.begin();
+    const_iterator d = data.begin();
+    for (n = 0; b != base.end() && d != data.end(); b++, d++, n++)
+      if (!(*b == *d))
+        changed_nodes.push_back(std::make_pair(n,d));
+    dump_unsigned(context,base.size());
+    dump_unsigned(context,data.size());
+    dump_unsigned(context,(unsigned)changed_nodes.size());
+    for (unsigned i = 0; i < changed_nodes.size(); i++)
+    {
+      dump_unsigned(context,changed_nodes[i].first);
+      dump_node(context,*changed_nodes[i].second);
+    }
+    for (; d != data.end(); d++)
+      dump_node(context,*d);
+    // arcs
+    std::vector<std::pair<unsigned,const_arc_iterator> > changed_arcs;
+    const_arc_iterator ba = base.arc_begin();
+    const_arc_iterator da = data.arc_begin();
+    for (n = 0; ba != base.arc_end() && da != data.arc_end(); ba++, da++, n++)
+    {
+      if (base_index[base.arc_from(ba).node()] != data_index[data.arc_from(da).node()] ||
+          base_index[base.arc_to(ba).node()] != data_index[data.arc_to(da).node()] ||
+          !(*ba == *da))
+        changed_arcs.push_back(std::make_pair(n,da));
+    }
+    dump_unsigned(context,base.arc_size());
+    dump_unsigned(context,data.arc_size());
+    dump_unsigned(context,(unsigned)changed_arcs.size());
+    for (unsigned i = 0; i < changed_arcs.size(); i++)
+    {
+      const_arc_iterator arc = changed_arcs[i].second;
+      dump_unsigned(context,changed_arcs[i].first);
+      dump_unsigned(context,data_index[data.arc_from(arc).node()]);
+      dump_unsigned(context,data_index[data.arc_to(arc).node()]);
+      dump_arc(context,*arc);
+    }
+    for (; da != data.arc_end(); da++)
+    {
+      dump_unsigned(context,data_index[data.arc_from(da).node()]);
+      dump_unsigned(context,data_index[data.arc_to(da).node()]);
+      dump_arc(context,*da);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename NT, typename AT, typename RN, typename RA>
+  void restore_digraph_delta(restore_context& context, digraph<NT,AT>& data,
+                             RN restore_node, RA restore_arc)
+  {
+    typedef typename digraph<NT,AT>::iterator iterator;
+    typedef typename digraph<NT,AT>::arc_iterator arc_iterator;
+    // nodes - changed nodes are updated and new nodes appended, but removed nodes
+    // are left until the arcs are updated, by which time they have no arcs left
+    unsigned base_nodes = 0;
+    restore_unsigned(context,base_nodes);
+    if (base_nodes != data.size())
+      throw persistent_restore_failed("digraph: delta does not match the base graph");
+    unsigned data_nodes = 0;
+    restore_unsigned(context,data_nodes);
+    std::vector<iterator> nodes;
+    nodes.reserve(base_nodes > data_nodes ? base_nodes : data_nodes);
+    for (iterator i = data.begin(); i != data.end(); i++)
+      nodes.push_back(i);
+    unsigned changed = 0;
+    restore_unsigned(context,changed);
+    for (unsigned c = 0; c < changed; c++)
+    {
+      unsigned index = 0;
+      restore_unsigned(context,index);
+      if (index >= nodes.size())
+        throw persistent_restore_failed("digraph: node index out of range in delta");
+      restore_node(context,*nodes[index]);
+    }
+    for (unsigned n = base_nodes; n < data_nodes; n++)
+    {
+      iterator node = data.insert(NT());
+      nodes.push_back(node);
+      restore_node(context,*node);
+    }
+    // arcs - changed arcs are reconnected and updated, then removed arcs are erased and new ones appended
+    unsigned base_arcs = 0;
+    restore_unsigned(context,base_arcs);
+    if (base_arcs != data.arc_size())
+      throw persistent_restore_failed("digraph: delta does not match the base graph");
+    unsigned data_arcs = 0;
+    restore_unsigned(context,data_arcs);
+    std::vector<arc_iterator> arcs;
+    arcs.reserve(base_arcs);
+    for (arc_iterator a = data.arc_begin(); a != data.arc_end(); a++)
+      arcs.push_back(a);
+    restore_unsigned(context,changed);
+    for (unsigned c = 0; c < changed; c++)
+    {
+      unsigned index = 0, from = 0, to = 0;
+      restore_unsigned(context,index);
+      restore_unsigned(context,from);
+      restore_unsigned(context,to);
+      if (index >= arcs.size() || from >= data_nodes || to >= data_nodes)
+        throw persistent_restore_failed("digraph: arc index out of range in delta");
+      if (data.arc_from(arcs[index]) != nodes[from] || data.arc_to(arcs[index]) != nodes[to])
+        data.arc_move(arcs[index],nodes[from],nodes[to]);
+      restore_arc(context,*arcs[index]);
+    }
+    for (unsigned a = data_arcs; a < base_arcs; a++)
+      data.arc_erase(arcs[a]);
+    for (unsigned a = base_arcs; a < data_arcs; a++)
     {
-      unsigned arc_magic = 0;
-      restore_unsigned(context,arc_magic);
-      // restore the from and to cross-references
-      digraph_node<NT,AT>* from = 0;
-      digraph_node<NT,AT>* to = 0;
-      restore_xref(context,from);
-      restore_xref(context,to);
-      // create an arc with these from/to pointers
-      digraph_arc_iterator<NT,AT,AT&,AT*> arc =
-        data.arc_insert(digraph_iterator<NT,AT,NT&,NT*>(from),
-                        digraph_iterator<NT,AT,NT&,NT*>(to));
-      context.pointer_add(arc_magic,arc.node());
-      // restore the user data
+      unsigned from = 0, to = 0;
+      restore_unsigned(context,from);
+      restore_unsigned(context,to);
+      if (from >= data_nodes || to >= data_nodes)
+        throw persistent_restore_failed("digraph: arc index out of range in delta");
+      arc_iterator arc = data.arc_insert(nodes[from],nodes[to]);
       restore_arc(context,*arc);
     }
+    // finally remove the nodes that are no longer in the graph
+    for (unsigned n = data_nodes; n < base_nodes; n++)
+      data.erase(nodes[n]);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,35 @@
+#ifndef STLPLUS_PERSISTENT_FIXED_INF
+#define STLPLUS_PERSISTENT_FIXED_INF
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Persistence of stlplus fixed-width integer type - fixed_inf
+
+//   The dump format is the same as for inf, so a fixed_inf can be restored as
+//   an inf and vice versa - a restored value too large for the width is wrapped round
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_contexts.hpp"
+#include "fixed_inf.hpp"
+
+namespace stlplus
+{
+
+  // exceptions: persistent_dump_failed
+  template<unsigned Bits>
+  void dump_fixed_inf(dump_context&, const fixed_inf<Bits>& data) ;
+
+  // exceptions: persistent_restore_failed
+  template<unsigned Bits>
+  void restore_fixed_inf(restore_context&, fixed_inf<Bits>& data) ;
+
+} // end namespace stlplus
+
+  ////////////////////////////////////////////////////////////////////////////////
+#include "persistent_fixed_inf.tpp"
+#endif
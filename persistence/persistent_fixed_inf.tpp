@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_inf.hpp"
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // format: the same as inf, which handles the versions
+
+  template<unsigned Bits>
+  void dump_fixed_inf(dump_context& context, const fixed_inf<Bits>& data)
+  {
+    dump_inf(context, data.to_inf());
+  }
+
+  template<unsigned Bits>
+  void restore_fixed_inf(restore_context& context, fixed_inf<Bits>& data)
+  {
+    inf value;
+    restore_inf(context, value);
+    data = value;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
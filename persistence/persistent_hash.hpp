@@ -27,6 +27,20 @@ namespace stlplus
   template<typename K, typename T, typename H, typename E, typename RK, typename RT>
   void restore_hash(restore_context&, hash<K,T,H,E>& data, RK key_restore_fn, RT val_restore_fn);
 
+  // incremental (delta) dumps
+  // dump only the differences between the base - typically the contents at the last dump - and the data
+  // on restore, the differences are applied to a hash which must already contain the base, for example
+  // by restoring a full dump and then each delta dump in turn
+  // the value type must have an operator==
+
+  // exceptions: persistent_dump_failed
+  template<typename K, typename T, typename H, typename E, typename DK, typename DT>
+  void dump_hash_delta(dump_context&, const hash<K,T,H,E>& base, const hash<K,T,H,E>& data, DK key_dump_fn, DT val_dump_fn);
+
+  // exceptions: persistent_restore_failed
+  template<typename K, typename T, typename H, typename E, typename RK, typename RT>
+  void restore_hash_delta(restore_context&, hash<K,T,H,E>& data, RK key_restore_fn, RT val_restore_fn);
+
 } // end namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
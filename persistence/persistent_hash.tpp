@@ -7,6 +7,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
+#include <vector>
 
 namespace stlplus
 {
@@ -31,6 +32,62 @@ namespace stlplus
     unsigned size = 0;
     restore_unsigned(context,size);
     for (unsigned j = 0; j < size; j++)
+    {
+      K key;
+      key_fn(context,key);
+      // insert the key with a default value and then restore the value in place
+      val_fn(context,data.insert(key)->second);
+      // size the table for the stored size so that a table which doesn't auto-rehash isn't overloaded
+      // the stored size comes from the dump, so the table is only grown as far as the elements actually restored
+      if (data.loading() > 1.0f)
+        data.rehash(size < 2 * data.size() ? size : 2 * data.size());
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // format: erase_count {key}* update_count {key value}*
+  // updates cover both changed values and new keys
+
+  template<typename K, typename T, typename H, typename E, typename DK, typename DT>
+  void dump_hash_delta(dump_context& context, const hash<K,T,H,E>& base, const hash<K,T,H,E>& data, DK key_fn, DT val_fn)
+  {
+    typedef typename hash<K,T,H,E>::const_iterator const_iterator;
+    std::vector<const_iterator> erased;
+    for (const_iterator b = base.begin(); b != base.end(); b++)
+      if (!data.present(b->first))
+        erased.push_back(b);
+    std::vector<const_iterator> updated;
+    for (const_iterator d = data.begin(); d != data.end(); d++)
+    {
+      const T* old_value = base.at_pointer(d->first);
+      if (!old_value || !(*old_value == d->second))
+        updated.push_back(d);
+    }
+    dump_unsigned(context,(unsigned)erased.size());
+    for (unsigned i = 0; i < erased.size(); i++)
+      key_fn(context,erased[i]->first);
+    dump_unsigned(context,(unsigned)updated.size());
+    for (unsigned i = 0; i < updated.size(); i++)
+    {
+      key_fn(context,updated[i]->first);
+      val_fn(context,updated[i]->second);
+    }
+  }
+
+  template<typename K, typename T, typename H, typename E, typename RK, typename RT>
+  void restore_hash_delta(restore_context& context, hash<K,T,H,E>& data, RK key_fn, RT val_fn)
+  {
+    unsigned erased = 0;
+    restore_unsigned(context,erased);
+    for (unsigned j = 0; j < erased; j++)
+    {
+      K key;
+      key_fn(context,key);
+      data.erase(key);
+    }
+    unsigned updated = 0;
+    restore_unsigned(context,updated);
+    for (unsigned j = 0; j < updated; j++)
     {
       K key;
       key_fn(context,key);
@@ -8,15 +8,6 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
 
-////////////////////////////////////////////////////////////////////////////////
-// Macro for mapping either endian data onto little-endian addressing to make
-// my life easier in writing this code! I think better in little-endian mode
-// so the macro does nothing in that mode but maps little-endian onto
-// big-endian addressing in big-endian mode
-// TODO - make this compile-time configurable so it's more efficient
-
-#define INDEX(index) ((context.little_endian()) ? (index) : ((bytes) - (index) - 1))
-
 ////////////////////////////////////////////////////////////////////////////////
 // Integer types
 // format: {size}{byte}*size
@@ -34,96 +25,143 @@
 // In fact, the standard does not even specify the size of char (true! And
 // mind-numbingly stupid...). However, to be able to do anything at all, I've
 // had to assume that a char is 1 byte.
+//
+// The bytes are written most significant first. They are extracted from the
+// value with shifts rather than by addressing the integer's memory, so the
+// code does not depend on the byte order of the platform. Each integer is
+// encoded into a small buffer which is then written in one go.
+
+// the number of bytes needed to represent an unsigned value
+// leading zero bytes are skipped - this may reduce the data to zero bytes long
+template<typename U>
+static unsigned unsigned_bytes(U data)
+{
+  unsigned bytes = 0;
+  for (; data != 0; bytes++)
+    data >>= 8;
+  return bytes;
+}
 
-static void dump_unsigned(stlplus::dump_context& context, unsigned bytes, unsigned char* data)
-
+// the number of bytes needed to represent a signed value
+// leading all-zero or all-one bytes are skipped but only if doing so does not change the sign
+// so this is never less than one byte
+template<typename S, typename U>
+static unsigned signed_bytes(S data)
 {
-  // first skip zero bytes - this may reduce the data to zero bytes long
-  unsigned i = bytes;
-  while(i >= 1 && data[INDEX(i-1)] == 0)
-    i--;
-  // put the remaining size
-  context.put((unsigned char)i);
-  // and put the bytes
-  while(i--)
-    context.put(data[INDEX(i)]);
+  // a negative number has the same length as its ones-complement, which is positive
+  U magnitude = data < 0 ? (U)~(U)data : (U)data;
+  unsigned bytes = 1;
+  for (magnitude >>= 7; magnitude != 0; bytes++)
+    magnitude >>= 8;
+  return bytes;
 }
 
-static void dump_signed(stlplus::dump_context& context, unsigned bytes, unsigned char* data)
+// encode the size and the low-order bytes of the value into the buffer, returning the length used
+template<typename U>
+static unsigned encode_integer(unsigned char* buffer, U data, unsigned bytes)
+{
+  buffer[0] = (unsigned char)bytes;
+  for (unsigned i = 1; i <= bytes; i++)
+    buffer[i] = (unsigned char)(data >> (8 * (bytes - i)));
+  return bytes + 1;
+}
 
+template<typename U>
+static void dump_unsigned(stlplus::dump_context& context, U data)
 {
-  // first skip all-zero or all-one bytes but only if doing so does not change the sign
-  unsigned i = bytes;
-  if (data[INDEX(i-1)] < 128)
-  {
-    // positive number so discard leading zeros but only if the following byte is positive
-    while(i >= 2 && data[INDEX(i-1)] == 0 && data[INDEX(i-2)] < 128)
-      i--;
-  }
-  else
-  {
-    // negative number so discard leading ones but only if the following byte is negative
-    while(i >= 2 && data[INDEX(i-1)] == 255 && data[INDEX(i-2)] >= 128)
-      i--;
-  }
-  // put the remaining size
-  context.put((unsigned char)i);
-  // and put the bytes
-  while(i--)
-    context.put(data[INDEX(i)]);
+  unsigned char buffer[sizeof(U)+1];
+  context.put(buffer, encode_integer(buffer, data, unsigned_bytes(data)));
 }
 
-static void restore_unsigned(stlplus::restore_context& context, unsigned bytes, unsigned char* data)
+template<typename S, typename U>
+static void dump_signed(stlplus::dump_context& context, S data)
+{
+  unsigned char buffer[sizeof(S)+1];
+  context.put(buffer, encode_integer(buffer, (U)data, signed_bytes<S,U>(data)));
+}
 
+// restore the bytes of an integer, throwing if they don't fit
+template<typename U>
+static U restore_bytes(stlplus::restore_context& context, unsigned bytes, unsigned char* buffer)
 {
-  // get the dumped size from the file
-  unsigned dumped_bytes = (unsigned)context.get();
-  // zero fill any empty space
-  unsigned i = bytes;
-  for (; i > dumped_bytes; i--)
-    data[INDEX(i-1)] = 0;
-  // restore the dumped bytes but discard any that don't fit
-  while(i--)
-  {
-    int ch = context.get();
-    if (i < bytes)
-      data[INDEX(i)] = (unsigned char)ch;
-    else
-      throw stlplus::persistent_restore_failed(std::string("integer overflow"));
-  }
+  if (bytes > sizeof(U))
+    throw stlplus::persistent_restore_failed(std::string("integer overflow"));
+  context.get(buffer, bytes);
+  U data = 0;
+  for (unsigned i = 0; i < bytes; i++)
+    data = (U)((data << 8) | buffer[i]);
+  return data;
 }
 
-static void restore_signed(stlplus::restore_context& context, unsigned bytes, unsigned char* data)
+template<typename U>
+static void restore_unsigned(stlplus::restore_context& context, U& data)
+{
+  // get the dumped size from the file - any empty space is zero filled by the shifts
+  unsigned bytes = (unsigned)context.get();
+  unsigned char buffer[sizeof(U)];
+  data = restore_bytes<U>(context, bytes, buffer);
+}
 
+template<typename S, typename U>
+static void restore_signed(stlplus::restore_context& context, S& data)
 {
   // get the dumped size from the file
-  unsigned dumped_bytes = (unsigned)context.get();
-  // restore the dumped bytes but discard any that don't fit
-  unsigned i = dumped_bytes;
-  while(i--)
-  {
-    int ch = context.get();
-    if (i < bytes)
-      data[INDEX(i)] = (unsigned char)ch;
-    else
-      throw stlplus::persistent_restore_failed(std::string("integer overflow"));
-  }
-  // sign extend if the dumped integer was smaller
-  if (dumped_bytes < bytes)
+  unsigned bytes = (unsigned)context.get();
+  unsigned char buffer[sizeof(S)];
+  U value = restore_bytes<U>(context, bytes, buffer);
+  // sign extend if the dumped integer was smaller and negative
+  if (bytes > 0 && bytes < sizeof(S) && buffer[0] >= 128)
+    value |= (U)((U)~(U)0 << (8 * bytes));
+  data = (S)value;
+}
+
+// arrays are encoded into a larger buffer which is written whenever it fills
+template<typename U>
+static void dump_unsigned_array(stlplus::dump_context& context, const U* data, size_t size)
+{
+  unsigned char buffer[1024];
+  unsigned used = 0;
+  for (size_t i = 0; i < size; i++)
   {
-    if (data[INDEX(dumped_bytes-1)] < 128)
+    if (used + sizeof(U) + 1 > sizeof(buffer))
     {
-      // positive so zero fill
-      for (i = dumped_bytes; i < bytes; i++)
-        data[INDEX(i)] = 0;
+      context.put(buffer, used);
+      used = 0;
     }
-    else
+    used += encode_integer(buffer + used, data[i], unsigned_bytes(data[i]));
+  }
+  context.put(buffer, used);
+}
+
+template<typename S, typename U>
+static void dump_signed_array(stlplus::dump_context& context, const S* data, size_t size)
+{
+  unsigned char buffer[1024];
+  unsigned used = 0;
+  for (size_t i = 0; i < size; i++)
+  {
+    if (used + sizeof(S) + 1 > sizeof(buffer))
     {
-      // negative so one fill
-      for (i = dumped_bytes; i < bytes; i++)
-        data[INDEX(i)] = 0xff;
+      context.put(buffer, used);
+      used = 0;
     }
+    used += encode_integer(buffer + used, (U)data[i], signed_bytes<S,U>(data[i]));
   }
+  context.put(buffer, used);
+}
+
+template<typename U>
+static void restore_unsigned_array(stlplus::restore_context& context, U* data, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    ::restore_unsigned(context, data[i]);
+}
+
+template<typename S, typename U>
+static void restore_signed_array(stlplus::restore_context& context, S* data, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    ::restore_signed<S,U>(context, data[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -162,72 +200,146 @@ void stlplus::restore_unsigned_char(restore_context& context, unsigned char& dat
 
 void stlplus::dump_short(stlplus::dump_context& context, const short& data)
 {
-  ::dump_signed(context, sizeof(short), (unsigned char*)&data);
+  ::dump_signed<short,unsigned short>(context, data);
 }
 
 void stlplus::restore_short(restore_context& context, short& data)
 {
-  ::restore_signed(context, sizeof(short),(unsigned char*)&data);
+  ::restore_signed<short,unsigned short>(context, data);
 }
 
 void stlplus::dump_unsigned_short(stlplus::dump_context& context, const unsigned short& data)
 {
-  ::dump_unsigned(context, sizeof(unsigned short), (unsigned char*)&data);
+  ::dump_unsigned(context, data);
 }
 
 void stlplus::restore_unsigned_short(restore_context& context, unsigned short& data)
 {
-  ::restore_unsigned(context, sizeof(unsigned short),(unsigned char*)&data);
+  ::restore_unsigned(context, data);
 }
 
 void stlplus::dump_int(stlplus::dump_context& context, const int& data)
 {
-  ::dump_signed(context, sizeof(int), (unsigned char*)&data);
+  ::dump_signed<int,unsigned int>(context, data);
 }
 
 void stlplus::restore_int(restore_context& context, int& data)
 {
-  ::restore_signed(context, sizeof(int),(unsigned char*)&data);
+  ::restore_signed<int,unsigned int>(context, data);
 }
 
 void stlplus::dump_unsigned(stlplus::dump_context& context, const unsigned& data)
 {
-  ::dump_unsigned(context, sizeof(unsigned), (unsigned char*)&data);
+  ::dump_unsigned(context, data);
 }
 
 void stlplus::restore_unsigned(restore_context& context, unsigned& data)
 {
-  ::restore_unsigned(context, sizeof(unsigned),(unsigned char*)&data);
+  ::restore_unsigned(context, data);
 }
 
 void stlplus::dump_long(stlplus::dump_context& context, const long& data)
 {
-  ::dump_signed(context, sizeof(long), (unsigned char*)&data);
+  ::dump_signed<long,unsigned long>(context, data);
 }
 
 void stlplus::restore_long(restore_context& context, long& data)
 {
-  ::restore_signed(context, sizeof(long),(unsigned char*)&data);
+  ::restore_signed<long,unsigned long>(context, data);
 }
 
 void stlplus::dump_unsigned_long(stlplus::dump_context& context, const unsigned long& data)
 {
-  ::dump_unsigned(context, sizeof(unsigned long), (unsigned char*)&data);
+  ::dump_unsigned(context, data);
 }
 
 void stlplus::restore_unsigned_long(restore_context& context, unsigned long& data)
 {
-  ::restore_unsigned(context, sizeof(unsigned long),(unsigned char*)&data);
+  ::restore_unsigned(context, data);
 }
 
 void stlplus::dump_size_t(stlplus::dump_context& context, const size_t& data)
 {
-  ::dump_unsigned(context, sizeof(size_t), (unsigned char*)&data);
+  ::dump_unsigned(context, data);
 }
 
 void stlplus::restore_size_t(restore_context& context, size_t& data)
 {
-  ::restore_unsigned(context, sizeof(size_t),(unsigned char*)&data);
+  ::restore_unsigned(context, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// arrays of integers
+
+void stlplus::dump_short_array(stlplus::dump_context& context, const short* data, size_t size)
+{
+  ::dump_signed_array<short,unsigned short>(context, data, size);
+}
+
+void stlplus::restore_short_array(restore_context& context, short* data, size_t size)
+{
+  ::restore_signed_array<short,unsigned short>(context, data, size);
+}
+
+void stlplus::dump_unsigned_short_array(stlplus::dump_context& context, const unsigned short* data, size_t size)
+{
+  ::dump_unsigned_array(context, data, size);
+}
+
+void stlplus::restore_unsigned_short_array(restore_context& context, unsigned short* data, size_t size)
+{
+  ::restore_unsigned_array(context, data, size);
+}
+
+void stlplus::dump_int_array(stlplus::dump_context& context, const int* data, size_t size)
+{
+  ::dump_signed_array<int,unsigned int>(context, data, size);
+}
+
+void stlplus::restore_int_array(restore_context& context, int* data, size_t size)
+{
+  ::restore_signed_array<int,unsigned int>(context, data, size);
+}
+
+void stlplus::dump_unsigned_array(stlplus::dump_context& context, const unsigned* data, size_t size)
+{
+  ::dump_unsigned_array(context, data, size);
+}
+
+void stlplus::restore_unsigned_array(restore_context& context, unsigned* data, size_t size)
+{
+  ::restore_unsigned_array(context, data, size);
+}
+
+void stlplus::dump_long_array(stlplus::dump_context& context, const long* data, size_t size)
+{
+  ::dump_signed_array<long,unsigned long>(context, data, size);
+}
+
+void stlplus::restore_long_array(restore_context& context, long* data, size_t size)
+{
+  ::restore_signed_array<long,unsigned long>(context, data, size);
+}
+
+void stlplus::dump_unsigned_long_array(stlplus::dump_context& context, const unsigned long* data, size_t size)
+{
+  ::dump_unsigned_array(context, data, size);
+}
+
+void stlplus::restore_unsigned_long_array(restore_context& context, unsigned long* data, size_t size)
+{
+  ::restore_unsigned_array(context, data, size);
+}
+
+void stlplus::dump_size_t_array(stlplus::dump_context& context, const size_t* data, size_t size)
+{
+  ::dump_unsigned_array(context, data, size);
+}
+
+void stlplus::restore_size_t_array(restore_context& context, size_t* data, size_t size)
+{
+  ::restore_unsigned_array(context, data, size);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +67,47 @@ namespace stlplus
   void restore_size_t(restore_context&, size_t& data) ;
 
   ////////////////////////////////////////////////////////////////////////////////
+  // arrays of integers
+  // these give exactly the same format as dumping or restoring each element in turn
+  // with the functions above, but are faster because the bytes are written in blocks
+  // the number of elements is not dumped, so dump it first unless it is fixed
+
+  // exceptions: persistent_dump_failed
+  void dump_short_array(dump_context&, const short* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_short_array(restore_context&, short* data, size_t size) ;
+
+  // exceptions: persistent_dump_failed
+  void dump_unsigned_short_array(dump_context&, const unsigned short* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_unsigned_short_array(restore_context&, unsigned short* data, size_t size) ;
+
+  // exceptions: persistent_dump_failed
+  void dump_int_array(dump_context&, const int* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_int_array(restore_context&, int* data, size_t size) ;
+
+  // exceptions: persistent_dump_failed
+  void dump_unsigned_array(dump_context&, const unsigned* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_unsigned_array(restore_context&, unsigned* data, size_t size) ;
+
+  // exceptions: persistent_dump_failed
+  void dump_long_array(dump_context&, const long* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_long_array(restore_context&, long* data, size_t size) ;
+
+  // exceptions: persistent_dump_failed
+  void dump_unsigned_long_array(dump_context&, const unsigned long* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_unsigned_long_array(restore_context&, unsigned long* data, size_t size) ;
+
+  // exceptions: persistent_dump_failed
+  void dump_size_t_array(dump_context&, const size_t* data, size_t size) ;
+  // exceptions: persistent_restore_failed
+  void restore_size_t_array(restore_context&, size_t* data, size_t size) ;
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
 
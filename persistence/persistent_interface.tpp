@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
+#include "persistent_arena.hpp"
 
 namespace stlplus
 {
@@ -54,11 +55,11 @@ namespace stlplus
     try
     {
       // first delete any previous object pointed to since the restore creates the object of the right subclass
-      if (data)
-      {
+      // in arena mode the previous object belongs to the arena
+      restore_arena* arena = context.arena();
+      if (data && !arena)
         delete data;
-        data = 0;
-      }
+      data = 0;
       // get the magic key
       unsigned magic = 0;
       restore_unsigned(context,magic);
@@ -78,6 +79,8 @@ namespace stlplus
         // interface approach
         // first clone the sample object stored in the map - lookup_interface can throw persistent_illegal_type
         data = (T*)(context.lookup_interface(key)->clone());
+        // in arena mode the arena takes ownership of the clone
+        if (arena) arena->adopt(data);
         // add this pointer to the set of already seen objects
         // do this before restoring the object so that self-referential structures restore correctly
         context.pointer_add(magic,data);
@@ -27,6 +27,20 @@ namespace stlplus
   template<typename K, typename T, typename P, typename RK, typename RT>
   void restore_map(restore_context&, std::map<K,T,P>& data, RK key_restore_fn, RT val_restore_fn);
 
+  // incremental (delta) dumps
+  // dump only the differences between the base - typically the contents at the last dump - and the data
+  // on restore, the differences are applied to a map which must already contain the base, for example
+  // by restoring a full dump and then each delta dump in turn
+  // the value type must have an operator==
+
+  // exceptions: persistent_dump_failed
+  template<typename K, typename T, typename P, typename DK, typename DT>
+  void dump_map_delta(dump_context&, const std::map<K,T,P>& base, const std::map<K,T,P>& data, DK key_dump_fn, DT val_dump_fn);
+
+  // exceptions: persistent_restore_failed
+  template<typename K, typename T, typename P, typename RK, typename RT>
+  void restore_map_delta(restore_context&, std::map<K,T,P>& data, RK key_restore_fn, RT val_restore_fn);
+
 } // end namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
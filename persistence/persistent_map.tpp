@@ -7,6 +7,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
+#include <vector>
 
 namespace stlplus
 {
@@ -31,6 +32,75 @@ namespace stlplus
     size_t size = 0;
     restore_size_t(context,size);
     for (size_t j = 0; j < size; j++)
+    {
+      K key;
+      key_fn(context,key);
+      // the dump is in key order, so inserting at the end is O(1) rather than O(log(n))
+      // the value is then restored in place
+      typename std::map<K,T,P>::iterator v = data.insert(data.end(), std::pair<const K,T>(key,T()));
+      val_fn(context,v->second);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // format: erase_count {key}* update_count {key value}*
+  // updates cover both changed values and new keys
+
+  template<typename K, typename T, typename P, typename DK, typename DT>
+  void dump_map_delta(dump_context& context, const std::map<K,T,P>& base, const std::map<K,T,P>& data, DK key_fn, DT val_fn)
+  {
+    typedef typename std::map<K,T,P>::const_iterator const_iterator;
+    // both maps are sorted, so walk them together to find the differences
+    std::vector<const_iterator> erased;
+    std::vector<const_iterator> updated;
+    P less = data.key_comp();
+    const_iterator b = base.begin();
+    const_iterator d = data.begin();
+    while (b != base.end() || d != data.end())
+    {
+      if (d == data.end() || (b != base.end() && less(b->first, d->first)))
+      {
+        erased.push_back(b);
+        b++;
+      }
+      else if (b == base.end() || less(d->first, b->first))
+      {
+        updated.push_back(d);
+        d++;
+      }
+      else
+      {
+        if (!(b->second == d->second))
+          updated.push_back(d);
+        b++;
+        d++;
+      }
+    }
+    dump_size_t(context,erased.size());
+    for (size_t i = 0; i < erased.size(); i++)
+      key_fn(context,erased[i]->first);
+    dump_size_t(context,updated.size());
+    for (size_t i = 0; i < updated.size(); i++)
+    {
+      key_fn(context,updated[i]->first);
+      val_fn(context,updated[i]->second);
+    }
+  }
+
+  template<typename K, typename T, typename P, typename RK, typename RT>
+  void restore_map_delta(restore_context& context, std::map<K,T,P>& data, RK key_fn, RT val_fn)
+  {
+    size_t erased = 0;
+    restore_size_t(context,erased);
+    for (size_t j = 0; j < erased; j++)
+    {
+      K key;
+      key_fn(context,key);
+      data.erase(key);
+    }
+    size_t updated = 0;
+    restore_size_t(context,updated);
+    for (size_t j = 0; j < updated; j++)
     {
       K key;
       key_fn(context,key);
@@ -34,7 +34,9 @@ namespace stlplus
     {
       K key;
       key_fn(context,key);
-      typename std::multimap<K,T,P>::iterator v = data.insert(std::pair<K,T>(key,T()));
+      // the dump is in key order, so inserting at the end is O(1) rather than O(log(n))
+      // this also keeps equal keys in their original order
+      typename std::multimap<K,T,P>::iterator v = data.insert(data.end(), std::pair<const K,T>(key,T()));
       val_fn(context,v->second);
     }
   }
@@ -27,13 +27,12 @@ namespace stlplus
     data.clear();
     size_t size = 0;
     restore_size_t(context,size);
-    typename std::multiset<K,P>::iterator i = data.begin();
     for (size_t j = 0; j < size; j++)
     {
       K key;
       restore_fn(context,key);
-      // inserting using an iterator is O(n) rather than O(n*log(n))
-      i = data.insert(i, key);
+      // the dump is in key order, so inserting at the end is O(1) rather than O(log(n))
+      data.insert(data.end(), key);
     }
   }
 
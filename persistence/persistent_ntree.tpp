@@ -9,6 +9,7 @@
 #include "persistent_bool.hpp"
 #include "persistent_int.hpp"
 #include "persistent_xref.hpp"
+#include <vector>
 
 namespace stlplus
 {
@@ -54,29 +55,26 @@ namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
 
+  // restore one node, reserving space for its children and returning how many there are
   template<typename T, typename R>
-  void restore_ntree_r(restore_context& context,
-                       ntree<T>& tree,
-                       const typename ntree<T>::iterator& node,
-                       R restore_fn)
+  unsigned restore_ntree_node(restore_context& context,
+                              ntree<T>& tree,
+                              ntree_node<T>* node,
+                              R restore_fn)
   {
     // restore the node magic key, check whether it has been used before and add it to the set of known addresses
     unsigned node_magic = 0;
     restore_unsigned(context,node_magic);
     std::pair<bool,void*> node_mapping = context.pointer_map(node_magic);
     if (node_mapping.first) throw persistent_restore_failed("ntree: restored this tree node already");
-    context.pointer_add(node_magic,node.node());
+    context.pointer_add(node_magic,node);
     // now restore the node contents
-    restore_fn(context,*node);
+    restore_fn(context,node->m_data);
     // restore the number of children
     unsigned children = 0;
     restore_unsigned(context,children);
-    // recurse on each child
-    for (unsigned i = 0; i < children; i++)
-    {
-      typename ntree<T>::iterator child = tree.insert(node,i,T());
-      restore_ntree_r<T,R>(context,tree,child,restore_fn);
-    }
+    tree._node_reserve(node,children);
+    return children;
   }
 
   template<typename T, typename R>
@@ -95,8 +93,26 @@ namespace stlplus
     restore_bool(context, empty);
     if (!empty)
     {
-      typename ntree<T>::iterator node = tree.insert(T());
-      restore_ntree_r<T,R>(context,tree,node,restore_fn);
+      // the tree is built in bulk in the prefix order of the dump
+      // using an explicit stack of the nodes whose children are still to be restored
+      // so that the depth of the tree is not limited by the depth of recursion
+      typedef std::pair<ntree_node<T>*,unsigned> pending;
+      std::vector<pending> stack;
+      ntree_node<T>* root = tree._node_append(0);
+      unsigned children = restore_ntree_node<T,R>(context,tree,root,restore_fn);
+      if (children > 0) stack.push_back(pending(root,children));
+      while (!stack.empty())
+      {
+        if (stack.back().second == 0)
+        {
+          stack.pop_back();
+          continue;
+        }
+        stack.back().second--;
+        ntree_node<T>* child = tree._node_append(stack.back().first);
+        children = restore_ntree_node<T,R>(context,tree,child,restore_fn);
+        if (children > 0) stack.push_back(pending(child,children));
+      }
     }
   }
 
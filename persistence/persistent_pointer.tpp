@@ -9,6 +9,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistent_int.hpp"
+#include "persistent_arena.hpp"
 
 namespace stlplus
 {
@@ -33,11 +34,10 @@ namespace stlplus
   template<typename T, typename R>
   void restore_pointer(restore_context& context, T*& data, R restore_fn)
   {
-    if (data)
-    {
+    // in arena mode the previous object belongs to the arena
+    if (data && !context.arena())
       delete data;
-      data = 0;
-    }
+    data = 0;
     // get the magic key
     unsigned magic = 0;
     restore_unsigned(context,magic);
@@ -52,7 +52,8 @@ namespace stlplus
     else
     {
       // this pointer has never been seen before and is non-null
-      data = new T();
+      restore_arena* arena = context.arena();
+      data = arena ? arena->create<T>() : new T();
       // add this pointer to the set of already seen objects
       // do this before restoring the object so that self-referential structures restore correctly
       context.pointer_add(magic,data);
@@ -0,0 +1,19 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_record.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stlplus::skip_record(stlplus::restore_context& context)
+{
+  context.begin_record();
+  context.end_record();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,55 @@
+#ifndef STLPLUS_PERSISTENT_RECORD
+#define STLPLUS_PERSISTENT_RECORD
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Framed records. A record is the dump of any object preceded by its size in
+//   bytes, so that a restore can skip over it without decoding it. This is
+//   opt-in - a record must be restored with restore_record or skipped with
+//   skip_record, and the normal dump functions do not use records.
+
+//   Records allow a file format to evolve. A restore function can stop
+//   reading a record early, for example because it is older than the dump and
+//   doesn't know about fields added later - the rest of the record is skipped.
+//   A newer restore function can use end_of_record on the context to test
+//   whether an older dump stopped before a field that it knows about.
+
+//   Skipping records also speeds up partial loads of large files. However,
+//   pointers in a skipped record are not restored, so later pointers to the
+//   same objects cannot be restored either - only skip records that are not
+//   pointed into from outside.
+
+//   The dump of a record is held in memory until it is complete so that its
+//   size can be written first.
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_contexts.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  // exceptions: persistent_dump_failed
+  template<typename T, typename D>
+  void dump_record(dump_context&, const T& data, D dump_fn);
+
+  // any part of the record not read by the restore function is skipped
+  // exceptions: persistent_restore_failed
+  template<typename T, typename R>
+  void restore_record(restore_context&, T& data, R restore_fn);
+
+  // skip a record without restoring it
+  // exceptions: persistent_restore_failed
+  void skip_record(restore_context&);
+
+} // end namespace stlplus
+
+  ////////////////////////////////////////////////////////////////////////////////
+#include "persistent_record.tpp"
+#endif
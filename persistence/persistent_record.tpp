@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, typename D>
+  void dump_record(dump_context& context, const T& data, D dump_fn)
+  {
+    context.begin_record();
+    dump_fn(context,data);
+    context.end_record();
+  }
+
+  template<typename T, typename R>
+  void restore_record(restore_context& context, T& data, R restore_fn)
+  {
+    context.begin_record();
+    restore_fn(context,data);
+    context.end_record();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
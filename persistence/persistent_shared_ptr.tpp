@@ -23,6 +23,17 @@
 #include "persistent_callback.hpp"
 #include "persistent_interface.hpp"
 
+////////////////////////////////////////////////////////////////////////////////
+// the deleter for shared pointers to objects owned by a restore_arena
+
+namespace stlplus
+{
+  template<typename T>
+  void shared_ptr_no_delete(T*)
+  {
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 template<typename  T, typename DE>
@@ -85,7 +96,11 @@ void stlplus::restore_shared_ptr(stlplus::restore_context& context, std::shared_
       // now restore the object
       T* value = 0;
       stlplus::restore_pointer(context, value, restore_element);
-      data.reset(value);
+      // in arena mode the arena owns the object, so the shared pointer must not delete it
+      if (context.arena())
+        data.reset(value, stlplus::shared_ptr_no_delete<T>);
+      else
+        data.reset(value);
     }
     else
     {
@@ -160,7 +175,11 @@ void stlplus::restore_shared_ptr_callback(stlplus::restore_context& context, std
       // now restore the object
       T* value = 0;
       stlplus::restore_callback(context,value);
-      data.reset(value);
+      // in arena mode the arena owns the object, so the shared pointer must not delete it
+      if (context.arena())
+        data.reset(value, stlplus::shared_ptr_no_delete<T>);
+      else
+        data.reset(value);
     }
     else
     {
@@ -232,7 +251,11 @@ void stlplus::restore_shared_ptr_interface(stlplus::restore_context& context, st
       // now restore the object
       T* value = 0;
       stlplus::restore_interface(context,value);
-      data.reset(value);
+      // in arena mode the arena owns the object, so the shared pointer must not delete it
+      if (context.arena())
+        data.reset(value, stlplus::shared_ptr_no_delete<T>);
+      else
+        data.reset(value);
     }
     else
     {
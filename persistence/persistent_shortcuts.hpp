@@ -18,9 +18,20 @@
 //   polymorphic types used in the data structure, then the callback can be set
 //   to null (i.e. 0).
 
+//   The compressed variants pass the dump through the block compressor in
+//   persistent_compression.hpp. A compressed dump can only be restored by the
+//   matching compressed restore function.
+
+//   The checked variants add a checksum of the whole dump, see
+//   persistent_checksum.hpp. A corrupt dump makes the restore throw
+//   persistent_restore_failed. A checked dump can only be restored by the
+//   matching checked restore function.
+
 ////////////////////////////////////////////////////////////////////////////////
 #include "persistence_fixes.hpp"
 #include "persistent_contexts.hpp"
+#include "persistent_compression.hpp"
+#include "persistent_checksum.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -39,8 +50,19 @@ namespace stlplus
   template<typename T, class R>
   void restore_from_device(std::istream& source, T& result, R restore_fn, restore_context::installer installer);
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // exact size of the dump without writing it anywhere
+  // for example, use this to reserve space in a buffer that will be reused for many dumps
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  size_t dump_size(const T& source, D dump_fn, dump_context::installer installer);
+
   ////////////////////////////////////////////////////////////////////////////////
   // string IO device
+  // these read and write the string directly rather than via a string stream
+  // the dump reuses the existing capacity of the result string
+  // if the dump fails the result is left empty
 
   // exceptions: persistent_dump_failed
   template<typename T, class D>
@@ -62,6 +84,75 @@ namespace stlplus
   void restore_from_file(const std::string& filename, T& result, R restore_fn, restore_context::installer installer);
 
   ////////////////////////////////////////////////////////////////////////////////
+  // compressed arbitrary IOStream device
+  // must be in binary mode
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  void dump_to_compressed_device(const T& source, std::ostream& result, D dump_fn, dump_context::installer installer);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, class R>
+  void restore_from_compressed_device(std::istream& source, T& result, R restore_fn, restore_context::installer installer);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // compressed string IO device
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  void dump_to_compressed_string(const T& source, std::string& result, D dump_fn, dump_context::installer installer);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, class R>
+  void restore_from_compressed_string(const std::string& source, T& result, R restore_fn, restore_context::installer installer);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // compressed file IO device
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  void dump_to_compressed_file(const T& source, const std::string& filename, D dump_fn, dump_context::installer installer);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, class R>
+  void restore_from_compressed_file(const std::string& filename, T& result, R restore_fn, restore_context::installer installer);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // checked arbitrary IOStream device
+  // must be in binary mode
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  void dump_to_checked_device(const T& source, std::ostream& result, D dump_fn, dump_context::installer installer);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, class R>
+  void restore_from_checked_device(std::istream& source, T& result, R restore_fn, restore_context::installer installer);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // checked string IO device
+  // if the dump fails the result is left empty
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  void dump_to_checked_string(const T& source, std::string& result, D dump_fn, dump_context::installer installer);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, class R>
+  void restore_from_checked_string(const std::string& source, T& result, R restore_fn, restore_context::installer installer);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // checked file IO device
+
+  // exceptions: persistent_dump_failed
+  template<typename T, class D>
+  void dump_to_checked_file(const T& source, const std::string& filename, D dump_fn, dump_context::installer installer);
+
+  // exceptions: persistent_restore_failed
+  template<typename T, class R>
+  void restore_from_checked_file(const std::string& filename, T& result, R restore_fn, restore_context::installer installer);
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
 
@@ -34,21 +34,44 @@ namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
 
+  template<typename T, class D>
+  size_t dump_size(const T& source, D dump_fn,
+                   dump_context::installer installer)
+  {
+    dump_context context;
+    context.register_all(installer);
+    dump_fn(context, source);
+    return context.size();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
   template<typename T, class D>
   void dump_to_string(const T& source, std::string& result, D dump_fn,
                       dump_context::installer installer)
   {
-    std::ostringstream output(std::ios_base::out | std::ios_base::binary);
-    dump_to_device<T,D>(source, output, dump_fn, installer);
-    result = output.str();
+    // dump straight into the result so that its existing capacity is reused
+    result.erase();
+    try
+    {
+      dump_context context(result);
+      context.register_all(installer);
+      dump_fn(context, source);
+    }
+    catch(...)
+    {
+      result.erase();
+      throw;
+    }
   }
 
   template<typename T, class R>
   void restore_from_string(const std::string& source, T& result, R restore_fn,
                            restore_context::installer installer)
   {
-    std::istringstream input(source, std::ios_base::in | std::ios_base::binary);
-    restore_from_device<T,R>(input, result, restore_fn, installer);
+    restore_context context(source);
+    context.register_all(installer);
+    restore_fn(context, result);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -71,4 +94,127 @@ namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
 
+  template<typename T, class D>
+  void dump_to_compressed_device(const T& source, std::ostream& result, D dump_fn,
+                                 dump_context::installer installer)
+  {
+    compressed_ostream output(result);
+    dump_to_device<T,D>(source, output, dump_fn, installer);
+    output.finish();
+  }
+
+  template<typename T, class R>
+  void restore_from_compressed_device(std::istream& source, T& result, R restore_fn,
+                                      restore_context::installer installer)
+  {
+    compressed_istream input(source);
+    restore_from_device<T,R>(input, result, restore_fn, installer);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  void dump_to_compressed_string(const T& source, std::string& result, D dump_fn,
+                                 dump_context::installer installer)
+  {
+    std::ostringstream output(std::ios_base::out | std::ios_base::binary);
+    dump_to_compressed_device<T,D>(source, output, dump_fn, installer);
+    result = output.str();
+  }
+
+  template<typename T, class R>
+  void restore_from_compressed_string(const std::string& source, T& result, R restore_fn,
+                                      restore_context::installer installer)
+  {
+    std::istringstream input(source, std::ios_base::in | std::ios_base::binary);
+    restore_from_compressed_device<T,R>(input, result, restore_fn, installer);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  void dump_to_compressed_file(const T& source, const std::string& filename, D dump_fn,
+                               dump_context::installer installer)
+  {
+    std::ofstream output(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    dump_to_compressed_device<T,D>(source, output, dump_fn, installer);
+  }
+
+  template<typename T, class R>
+  void restore_from_compressed_file(const std::string& filename, T& result, R restore_fn,
+                                    restore_context::installer installer)
+  {
+    std::ifstream input(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    restore_from_compressed_device<T,R>(input, result, restore_fn, installer);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  void dump_to_checked_device(const T& source, std::ostream& result, D dump_fn,
+                              dump_context::installer installer)
+  {
+    dump_context context(result);
+    context.register_all(installer);
+    dump_checked(context, source, dump_fn);
+  }
+
+  template<typename T, class R>
+  void restore_from_checked_device(std::istream& source, T& result, R restore_fn,
+                                   restore_context::installer installer)
+  {
+    restore_context context(source);
+    context.register_all(installer);
+    restore_checked(context, result, restore_fn);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  void dump_to_checked_string(const T& source, std::string& result, D dump_fn,
+                              dump_context::installer installer)
+  {
+    result.erase();
+    try
+    {
+      dump_context context(result);
+      context.register_all(installer);
+      dump_checked(context, source, dump_fn);
+    }
+    catch(...)
+    {
+      result.erase();
+      throw;
+    }
+  }
+
+  template<typename T, class R>
+  void restore_from_checked_string(const std::string& source, T& result, R restore_fn,
+                                   restore_context::installer installer)
+  {
+    restore_context context(source);
+    context.register_all(installer);
+    restore_checked(context, result, restore_fn);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  void dump_to_checked_file(const T& source, const std::string& filename, D dump_fn,
+                            dump_context::installer installer)
+  {
+    std::ofstream output(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    dump_to_checked_device<T,D>(source, output, dump_fn, installer);
+  }
+
+  template<typename T, class R>
+  void restore_from_checked_file(const std::string& filename, T& result, R restore_fn,
+                                 restore_context::installer installer)
+  {
+    std::ifstream input(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    restore_from_checked_device<T,R>(input, result, restore_fn, installer);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
 } // end namespace stlplus
@@ -36,6 +36,8 @@ void stlplus::restore_simple_ptr(stlplus::restore_context& context, stlplus::sim
                                  RE restore_element)
 
 {
+  // these pointers always delete the object so it must not be allocated in an arena
+  stlplus::restore_arena_suspend heap(context);
   // get the old counter magic key
   unsigned magic = 0;
   stlplus::restore_unsigned(context,magic);
@@ -83,6 +85,7 @@ template<typename T>
 void stlplus::restore_simple_ptr_clone_callback(stlplus::restore_context& context, stlplus::simple_ptr_clone<T>& data)
 
 {
+  stlplus::restore_arena_suspend heap(context);
   unsigned magic = 0;
   stlplus::restore_unsigned(context,magic);
   std::pair<bool,void*> mapping = context.object_map(magic);
@@ -118,6 +121,7 @@ template<typename T>
 void stlplus::restore_simple_ptr_clone_interface(stlplus::restore_context& context, stlplus::simple_ptr_clone<T>& data)
 
 {
+  stlplus::restore_arena_suspend heap(context);
   unsigned magic = 0;
   stlplus::restore_unsigned(context,magic);
   std::pair<bool,void*> mapping = context.object_map(magic);
@@ -38,6 +38,8 @@ void stlplus::restore_smart_ptr(stlplus::restore_context& context, stlplus::smar
                                 RE restore_element)
 
 {
+  // these pointers always delete the object so it must not be allocated in an arena
+  stlplus::restore_arena_suspend heap(context);
   // get the old substructure magic key
   unsigned magic = 0;
   stlplus::restore_unsigned(context,magic);
@@ -90,6 +92,7 @@ template<typename T>
 void stlplus::restore_smart_ptr_clone_callback(stlplus::restore_context& context, stlplus::smart_ptr_clone<T>& data)
 
 {
+  stlplus::restore_arena_suspend heap(context);
   // get the old substructure magic key
   unsigned magic = 0;
   restore_unsigned(context,magic);
@@ -142,6 +145,7 @@ template<typename T>
 void stlplus::restore_smart_ptr_clone_interface(stlplus::restore_context& context, stlplus::smart_ptr_clone<T>& data)
 
 {
+  stlplus::restore_arena_suspend heap(context);
   // get the old substructure magic key
   unsigned magic = 0;
   stlplus::restore_unsigned(context,magic);
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_snapshot.hpp"
+#include <fstream>
+#include <stdio.h>
+#ifdef STLPLUS_HAS_CXX11
+#include <thread>
+#include <mutex>
+#endif
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  class dump_snapshot_body
+  {
+  public:
+    snapshot_job* m_job;
+    std::string m_filename;
+    dump_snapshot::completion m_done;
+    void* m_argument;
+    bool m_busy;
+    std::string m_error;
+#ifdef STLPLUS_HAS_CXX11
+    std::thread m_thread;
+    // protects m_busy and m_error while the thread is running
+    mutable std::mutex m_mutex;
+#endif
+
+    dump_snapshot_body(void) :
+      m_job(0), m_done(0), m_argument(0), m_busy(false)
+      {
+      }
+
+    ~dump_snapshot_body(void)
+      {
+        wait();
+      }
+
+    void wait(void)
+      {
+#ifdef STLPLUS_HAS_CXX11
+        if (m_thread.joinable())
+          m_thread.join();
+#endif
+      }
+
+    bool busy(void) const
+      {
+#ifdef STLPLUS_HAS_CXX11
+        std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+        return m_busy;
+      }
+
+    std::string error(void) const
+      {
+#ifdef STLPLUS_HAS_CXX11
+        std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+        return m_error;
+      }
+
+    // dump the job to a temporary file and then replace the target with it
+    void run(void)
+      {
+        std::string error;
+        std::string temporary = m_filename + ".tmp";
+        try
+        {
+          {
+            std::ofstream output(temporary.c_str(), std::ios_base::out | std::ios_base::binary);
+            if (!output)
+              throw persistent_dump_failed(std::string("cannot create file ") + temporary);
+            m_job->dump(output);
+            output.close();
+            if (!output)
+              throw persistent_dump_failed(std::string("output device error"));
+          }
+          // the persistence library doesn't depend on portability, so use the C run-time to replace the file
+          // Windows won't rename onto an existing file, so the old one has to be removed first
+#ifdef _WIN32
+          ::remove(m_filename.c_str());
+#endif
+          if (::rename(temporary.c_str(), m_filename.c_str()) != 0)
+            throw persistent_dump_failed(std::string("cannot replace file ") + m_filename);
+        }
+        catch(const std::exception& except)
+        {
+          error = except.what();
+        }
+        catch(...)
+        {
+          error = "unknown exception";
+        }
+        if (!error.empty())
+          ::remove(temporary.c_str());
+        delete m_job;
+        m_job = 0;
+        {
+#ifdef STLPLUS_HAS_CXX11
+          std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+          m_error = error;
+        }
+        if (m_done)
+          m_done(m_filename, error, m_argument);
+        {
+#ifdef STLPLUS_HAS_CXX11
+          std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+          m_busy = false;
+        }
+      }
+
+    void start(snapshot_job* job, const std::string& filename, dump_snapshot::completion done, void* argument)
+      {
+        m_job = job;
+        m_filename = filename;
+        m_done = done;
+        m_argument = argument;
+        m_busy = true;
+#ifdef STLPLUS_HAS_CXX11
+        try
+        {
+          m_thread = std::thread(&dump_snapshot_body::run, this);
+          return;
+        }
+        catch(const std::system_error&)
+        {
+          // no thread available, so do the dump now
+        }
+#endif
+        run();
+      }
+
+  private:
+    // disallow copying by making assignment and copy constructor private
+    dump_snapshot_body(const dump_snapshot_body&);
+    dump_snapshot_body& operator=(const dump_snapshot_body&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  dump_snapshot::dump_snapshot(void) : m_body(new dump_snapshot_body)
+  {
+  }
+
+  dump_snapshot::~dump_snapshot(void)
+  {
+    delete m_body;
+  }
+
+  bool dump_snapshot::busy(void) const
+  {
+    return m_body->busy();
+  }
+
+  bool dump_snapshot::wait(void)
+  {
+    m_body->wait();
+    return m_body->error().empty();
+  }
+
+  std::string dump_snapshot::error(void) const
+  {
+    return m_body->error();
+  }
+
+  void dump_snapshot::start_job(snapshot_job* job, const std::string& filename, completion done, void* argument)
+  {
+    m_body->start(job, filename, done, argument);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
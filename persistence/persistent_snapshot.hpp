@@ -0,0 +1,110 @@
+#ifndef STLPLUS_PERSISTENT_SNAPSHOT
+#define STLPLUS_PERSISTENT_SNAPSHOT
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Background snapshots. A snapshot dumps a data structure to a file on a
+//   background thread, so that a long-running program can checkpoint its state
+//   without stalling while the dump is encoded and written.
+
+//   The consistent view of the data is a copy made on the calling thread when
+//   the snapshot is started, so the data can be modified as soon as the start
+//   function returns. The copy is usually much faster than the dump, but it
+//   does need the memory for a second copy of the data structure. The data
+//   type must therefore be copyable, and any pointers in it will be dumped as
+//   they were at the time of the copy, so the objects they point to must not
+//   be changed or deleted until the snapshot is complete.
+
+//   The dump is written to a temporary file which then replaces the target
+//   file, so a failed snapshot leaves the previous snapshot intact.
+
+//   When the snapshot finishes, the completion callback is called on the
+//   background thread with the error message, which is empty if the snapshot
+//   succeeded. Only one snapshot runs at a time - starting another waits for
+//   the previous one to finish.
+
+//   Background threads require C++11. Without them, the snapshot is dumped
+//   before the start function returns.
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistence_fixes.hpp"
+#include "persistent_contexts.hpp"
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Internals - type-independent interface to the copy of the data
+
+  class snapshot_job
+  {
+  public:
+    virtual ~snapshot_job(void) {}
+    // exceptions: persistent_dump_failed
+    virtual void dump(std::ostream& device) const = 0;
+  };
+
+  class dump_snapshot_body;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  class dump_snapshot
+  {
+  public:
+    // called on the background thread when a snapshot finishes
+    // the error is empty if the snapshot succeeded
+    // the argument is the user data passed to start
+    typedef void (*completion)(const std::string& filename, const std::string& error, void* argument);
+
+    dump_snapshot(void);
+    // waits for any snapshot in progress to finish
+    ~dump_snapshot(void);
+
+    // start a snapshot of the data to the named file
+    // the data is copied before this returns so may then be modified
+    // exceptions: std::bad_alloc or any exception thrown by copying the data
+    template<typename T, class D>
+    void start(const T& data, const std::string& filename, D dump_fn, dump_context::installer installer,
+               completion done = 0, void* argument = 0);
+
+    // start a snapshot with a checksum, see persistent_checksum.hpp
+    // the file must be restored with restore_from_checked_file
+    // exceptions: std::bad_alloc or any exception thrown by copying the data
+    template<typename T, class D>
+    void start_checked(const T& data, const std::string& filename, D dump_fn, dump_context::installer installer,
+                       completion done = 0, void* argument = 0);
+
+    // test whether a snapshot is in progress
+    bool busy(void) const;
+
+    // wait for the snapshot in progress to finish
+    // returns true if the last snapshot succeeded
+    bool wait(void);
+
+    // the error message from the last snapshot, empty if it succeeded
+    std::string error(void) const;
+
+  private:
+    dump_snapshot_body* m_body;
+
+    void start_job(snapshot_job* job, const std::string& filename, completion done, void* argument);
+
+    // disallow copying by making assignment and copy constructor private
+    dump_snapshot(const dump_snapshot&);
+    dump_snapshot& operator=(const dump_snapshot&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
+
+  ////////////////////////////////////////////////////////////////////////////////
+#include "persistent_snapshot.tpp"
+#endif
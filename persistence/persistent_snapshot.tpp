@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "persistent_shortcuts.hpp"
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // the job holds a private copy of the data together with its dump function
+
+  template<typename T, class D>
+  class snapshot_job_of : public snapshot_job
+  {
+  public:
+    snapshot_job_of(const T& data, D dump_fn, dump_context::installer installer, bool checked) :
+      m_data(data), m_dump_fn(dump_fn), m_installer(installer), m_checked(checked)
+      {
+      }
+
+    void dump(std::ostream& device) const
+      {
+        if (m_checked)
+          dump_to_checked_device(m_data, device, m_dump_fn, m_installer);
+        else
+          dump_to_device(m_data, device, m_dump_fn, m_installer);
+      }
+
+  private:
+    T m_data;
+    D m_dump_fn;
+    dump_context::installer m_installer;
+    bool m_checked;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<typename T, class D>
+  void dump_snapshot::start(const T& data, const std::string& filename, D dump_fn, dump_context::installer installer,
+                            completion done, void* argument)
+  {
+    // finish the previous snapshot before taking another copy of the data
+    wait();
+    start_job(new snapshot_job_of<T,D>(data, dump_fn, installer, false), filename, done, argument);
+  }
+
+  template<typename T, class D>
+  void dump_snapshot::start_checked(const T& data, const std::string& filename, D dump_fn, dump_context::installer installer,
+                                    completion done, void* argument)
+  {
+    wait();
+    start_job(new snapshot_job_of<T,D>(data, dump_fn, installer, true), filename, done, argument);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -24,6 +24,7 @@
 
 // can be excluded to break the dependency on the portability library
 #ifndef NO_STLPLUS_INF
+#include "persistent_fixed_inf.hpp"
 #include "persistent_inf.hpp"
 #endif
 
@@ -890,13 +890,51 @@ namespace stlplus
     DIR* d = opendir(dir.c_str());
     if (d)
     {
+      // compile the wildcard once for all the entries and test it before the file status, which is slower
+      wildcard_pattern pattern(wild);
       for (dirent* entry = readdir(d); entry; entry = readdir(d))
       {
         std::string strentry = entry->d_name;
-        if (strentry.compare(".")!=0 && strentry.compare("..")!=0)
+        if (strentry.compare(".")!=0 && strentry.compare("..")!=0 && pattern.match(strentry))
+        {
+          std::string subpath = create_filespec(dir, strentry);
+          if ((subdirs && is_folder(subpath)) || (files && is_file(subpath)))
+            results.push_back(strentry);
+        }
+      }
+      closedir(d);
+    }
+#endif
+    return results;
+  }
+
+  std::vector<std::string> folder_wildcard (const std::string& directory, const wildcard_set& wilds, bool subdirs, bool files)
+  {
+    std::string dir = directory.empty() ? std::string(".") : directory;
+    std::vector<std::string> results;
+#ifdef MSWINDOWS
+    std::string wildcard = create_filespec(dir, "*");
+    intptr_t handle = -1;
+    _finddata_t fileinfo;
+    for (bool OK = (handle = _findfirst((char*)wildcard.c_str(), &fileinfo)) != -1; OK; OK = (_findnext(handle, &fileinfo)==0))
+    {
+      std::string strentry = fileinfo.name;
+      if (strentry.compare(".")!=0 && strentry.compare("..")!=0 && wilds.match(strentry))
+        if ((subdirs && (fileinfo.attrib & _A_SUBDIR)) || (files && !(fileinfo.attrib & _A_SUBDIR)))
+          results.push_back(strentry);
+    }
+    _findclose(handle);
+#else
+    DIR* d = opendir(dir.c_str());
+    if (d)
+    {
+      for (dirent* entry = readdir(d); entry; entry = readdir(d))
+      {
+        std::string strentry = entry->d_name;
+        if (strentry.compare(".")!=0 && strentry.compare("..")!=0 && wilds.match(strentry))
         {
           std::string subpath = create_filespec(dir, strentry);
-          if (((subdirs && is_folder(subpath)) || (files && is_file(subpath))) && (wildcard(wild, strentry)))
+          if ((subdirs && is_folder(subpath)) || (files && is_file(subpath)))
             results.push_back(strentry);
         }
       }
@@ -15,6 +15,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "portability_fixes.hpp"
+#include "wildcard.hpp"
 #include <string>
 #include <vector>
 #include <time.h>
@@ -128,6 +129,12 @@ namespace stlplus
                                            const std::string& wildcard,
                                            bool folders = true,
                                            bool files = true);
+  // the set of all folder contents matching any of a set of wildcard strings
+  // this is faster than calling folder_wildcard for each wildcard since the folder is only read once
+  std::vector<std::string> folder_wildcard(const std::string& folder,
+                                           const wildcard_set& wildcards,
+                                           bool folders = true,
+                                           bool files = true);
 
   ////////////////////////////////////////////////////////////////////////////////
   // path functions
@@ -0,0 +1,279 @@
+#ifndef STLPLUS_FIXED_INF
+#define STLPLUS_FIXED_INF
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   A fixed-width integer class. fixed_inf<Bits> is a signed integer of
+//   exactly Bits bits, held in 2's-complement in an array of limbs inside the
+//   object. It never allocates memory and the limb loops all have a fixed trip
+//   count, so for values of known size - hashes, 128-bit counters, IPv6
+//   addresses - it avoids the dynamic sizing of inf.
+
+//   Like the C integer types, and unlike inf, the arithmetic wraps round
+//   modulo 2^Bits rather than growing the value. The same applies to the
+//   conversions from other types, including inf and strings.
+
+//   The operators are the same as for inf and a fixed_inf converts to and from
+//   inf, so inf can be used for anything not provided here, such as the number
+//   theory functions.
+
+//   this class can throw the following exceptions:
+//     std::out_of_range
+//     std::overflow_error
+//     std::invalid_argument
+//     stlplus::divide_by_zero
+//   all of these are derivations of the baseclass:
+//     std::logic_error
+//   So you can catch all of them by catching the baseclass
+
+////////////////////////////////////////////////////////////////////////////////
+#include "portability_fixes.hpp"
+#include "portability_exceptions.hpp"
+#include "inf.hpp"
+#include <string>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+  template<unsigned Bits>
+  class fixed_inf
+  {
+  public:
+
+    //////////////////////////////////////////////////////////////////////////////
+    // constructors and assignments initialise the fixed_inf
+
+    // the void constructor initialises to zero, the others initialise to the
+    // value of the C integer type, inf or the text value contained in the string,
+    // wrapped round to fit in Bits bits
+
+    fixed_inf(void);
+    explicit fixed_inf(short);
+    explicit fixed_inf(unsigned short);
+    explicit fixed_inf(int);
+    explicit fixed_inf(unsigned);
+    explicit fixed_inf(long);
+    explicit fixed_inf(unsigned long);
+    explicit fixed_inf(const inf&);
+    // exceptions: std::invalid_argument
+    explicit fixed_inf(const std::string&) ;
+
+    // conversion from another width, which is sign-extended or truncated
+    template<unsigned B>
+    explicit fixed_inf(const fixed_inf<B>&);
+
+    // assignments with equivalent behaviour to the constructors
+
+    fixed_inf& operator = (short);
+    fixed_inf& operator = (unsigned short);
+    fixed_inf& operator = (int);
+    fixed_inf& operator = (unsigned);
+    fixed_inf& operator = (long);
+    fixed_inf& operator = (unsigned long);
+    fixed_inf& operator = (const inf&);
+    // exceptions: std::invalid_argument
+    fixed_inf& operator = (const std::string&) ;
+
+    void swap(fixed_inf&);
+
+    //////////////////////////////////////////////////////////////////////////////
+    // conversions back to the C types and to inf
+    // truncate: controls the behaviour when the value is too long for the result
+    //           true: truncate the value
+    //           false: throw an exception
+
+    // exceptions: std::overflow_error
+    short to_short(bool truncate = true) const ;
+    // exceptions: std::overflow_error
+    unsigned short to_unsigned_short(bool truncate = true) const ;
+
+    // exceptions: std::overflow_error
+    int to_int(bool truncate = true) const ;
+    // exceptions: std::overflow_error
+    unsigned to_unsigned(bool truncate = true) const ;
+
+    // exceptions: std::overflow_error
+    long to_long(bool truncate = true) const ;
+    // exceptions: std::overflow_error
+    unsigned long to_unsigned_long(bool truncate = true) const ;
+
+    // the same value as an inf, which never loses information
+    inf to_inf(void) const;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // bitwise manipulation
+
+    // the number of significant bits in the value
+    unsigned bits (void) const;
+    unsigned size (void) const;
+
+    // the number of bits that can be accessed by the bit() method, which is always Bits
+    unsigned indexable_bits(void) const;
+
+    // exceptions: std::out_of_range
+    bool bit (unsigned index) const ;
+    // exceptions: std::out_of_range
+    bool operator [] (unsigned index) const ;
+
+    // exceptions: std::out_of_range
+    void set (unsigned index) ;
+    // exceptions: std::out_of_range
+    void clear (unsigned index) ;
+    // exceptions: std::out_of_range
+    void preset (unsigned index, bool value) ;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // tests for common values or ranges
+
+    bool negative (void) const;
+    bool natural (void) const;
+    bool positive (void) const;
+    bool zero (void) const;
+    bool non_zero (void) const;
+
+    // tests used in if(i) and if(!i)
+    bool operator ! (void) const;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // comparisons
+
+    bool operator == (const fixed_inf&) const;
+    bool operator != (const fixed_inf&) const;
+    bool operator < (const fixed_inf&) const;
+    bool operator <= (const fixed_inf&) const;
+    bool operator > (const fixed_inf&) const;
+    bool operator >= (const fixed_inf&) const;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // bitwise logic operations
+
+    fixed_inf& invert (void);
+    fixed_inf operator ~ (void) const;
+
+    fixed_inf& operator &= (const fixed_inf&);
+    fixed_inf operator & (const fixed_inf&) const;
+
+    fixed_inf& operator |= (const fixed_inf&);
+    fixed_inf operator | (const fixed_inf&) const;
+
+    fixed_inf& operator ^= (const fixed_inf&);
+    fixed_inf operator ^ (const fixed_inf&) const;
+
+    // shifts of Bits or more give zero, or -1 for a right shift of a negative value
+    fixed_inf& operator <<= (unsigned shift);
+    fixed_inf operator << (unsigned shift) const;
+
+    fixed_inf& operator >>= (unsigned shift);
+    fixed_inf operator >> (unsigned shift) const;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // arithmetic operations
+    // all of these wrap round modulo 2^Bits, so for example the negation of the
+    // most negative value is itself
+
+    fixed_inf& negate (void);
+    fixed_inf operator - (void) const;
+
+    fixed_inf& abs(void);
+
+    fixed_inf& operator += (const fixed_inf&);
+    fixed_inf operator + (const fixed_inf&) const;
+
+    fixed_inf& operator -= (const fixed_inf&);
+    fixed_inf operator - (const fixed_inf&) const;
+
+    fixed_inf& operator *= (const fixed_inf&);
+    fixed_inf operator * (const fixed_inf&) const;
+
+    // exceptions: divide_by_zero
+    fixed_inf& operator /= (const fixed_inf&) ;
+    // exceptions: divide_by_zero
+    fixed_inf operator / (const fixed_inf&) const ;
+
+    // exceptions: divide_by_zero
+    fixed_inf& operator %= (const fixed_inf&) ;
+    // exceptions: divide_by_zero
+    fixed_inf operator % (const fixed_inf&) const ;
+
+    // combined division operator - returns the result pair(quotient,remainder) in one go
+    // exceptions: divide_by_zero
+    std::pair<fixed_inf,fixed_inf> divide(const fixed_inf&) const ;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // pre- and post- increment and decrement
+
+    fixed_inf& operator ++ (void);
+    fixed_inf operator ++ (int);
+    fixed_inf& operator -- (void);
+    fixed_inf operator -- (int);
+
+    //////////////////////////////////////////////////////////////////////////////
+    // string representation and I/O
+    // these are the same as for inf
+
+    // conversion to a string representation
+    // radix must be 10, 2, 8 or 16
+    // exceptions: std::invalid_argument
+    std::string to_string(unsigned radix = 10) const;
+
+    // conversion from a string
+    // radix == 0 - radix is deduced from the input - assumed 10 unless number is prefixed by 0b, 0 or 0x
+    // however, you can specify the radix to be 10, 2, 8 or 16 to force that interpretation
+    // exceptions: std::invalid_argument
+    fixed_inf& from_string(const std::string&, unsigned radix = 0);
+
+    //////////////////////////////////////////////////////////////////////////////
+    // internal representation
+    // the value is held in 2's-complement as an array of limbs, lsL first, with
+    // the top limb sign-extended from bit Bits-1
+    typedef inf::limb limb;
+
+  private:
+    // top_bits is the number of bits of the value held in the top limb, from 1 to limb_bits
+    enum {limb_bits = 8 * sizeof(limb),
+          limb_count = (Bits + limb_bits - 1) / limb_bits,
+          top_bits = Bits - limb_bits * (limb_count - 1)};
+    // a fixed_inf must have at least one bit
+    typedef char bits_must_be_positive[Bits > 0 ? 1 : -1];
+
+    template<unsigned B> friend class fixed_inf;
+
+    limb m_limbs[limb_count];
+
+    limb sign_extension(void) const;
+    bool single_limb(void) const;
+    void assign_limb(limb value, bool negative);
+    void normalise(void);
+    static limb multiply_limbs(limb left, limb right, limb& high);
+
+  public:
+    // the value as a string of bytes, lsB first, used by the persistence routines
+    std::string get_bytes(void) const;
+    void set_bytes(const std::string&);
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  template<unsigned Bits>
+  fixed_inf<Bits> abs(const fixed_inf<Bits>&);
+
+  template<unsigned Bits>
+  std::ostream& operator << (std::ostream&, const fixed_inf<Bits>&);
+  template<unsigned Bits>
+  std::istream& operator >> (std::istream&, fixed_inf<Bits>&);
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
+
+#include "fixed_inf.tpp"
+#endif
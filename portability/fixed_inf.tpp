@@ -0,0 +1,855 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   The limb loops all run over the fixed number of limbs, so the compiler can
+//   unroll them completely for the small sizes. The operations that are not
+//   worth specialising - division of values wider than a limb and the string
+//   and C-type conversions - go through inf, which holds values of up to 128
+//   bits without allocating.
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // internals
+
+  template<unsigned Bits>
+  typename fixed_inf<Bits>::limb fixed_inf<Bits>::sign_extension(void) const
+  {
+    return (m_limbs[limb_count-1] >> (limb_bits - 1)) ? ~limb(0) : limb(0);
+  }
+
+  // test whether the value fits in the first limb, the rest being its sign extension
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::single_limb(void) const
+  {
+    limb extend = (m_limbs[0] >> (limb_bits - 1)) ? ~limb(0) : limb(0);
+    for (unsigned i = 1; i < limb_count; i++)
+      if (m_limbs[i] != extend)
+        return false;
+    return true;
+  }
+
+  // set to a single-limb value, which is treated as signed if negative is true
+  template<unsigned Bits>
+  void fixed_inf<Bits>::assign_limb(limb value, bool negative)
+  {
+    m_limbs[0] = value;
+    for (unsigned i = 1; i < limb_count; i++)
+      m_limbs[i] = negative ? ~limb(0) : limb(0);
+    normalise();
+  }
+
+  // wrap the value round to Bits bits by sign-extending the top limb from bit Bits-1
+  template<unsigned Bits>
+  void fixed_inf<Bits>::normalise(void)
+  {
+    if (top_bits < limb_bits)
+    {
+      limb mask = ~limb(0) << (top_bits % limb_bits);
+      if ((m_limbs[limb_count-1] >> (top_bits - 1)) & 1)
+        m_limbs[limb_count-1] |= mask;
+      else
+        m_limbs[limb_count-1] &= ~mask;
+    }
+  }
+
+  // the double-length product of two limbs - returns the high limb and sets low to the low limb
+  template<unsigned Bits>
+  typename fixed_inf<Bits>::limb fixed_inf<Bits>::multiply_limbs(limb left, limb right, limb& low)
+  {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 double_limb;
+    double_limb product = (double_limb)left * right;
+    low = (limb)product;
+    return (limb)(product >> limb_bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    limb high = 0;
+    low = _umul128(left, right, &high);
+    return high;
+#else
+    // multiply the half-limbs and add up the partial products
+    const limb half_mask = 0xffffffff;
+    limb ll = (left & half_mask) * (right & half_mask);
+    limb lh = (left & half_mask) * (right >> 32);
+    limb hl = (left >> 32) * (right & half_mask);
+    limb hh = (left >> 32) * (right >> 32);
+    limb middle = (ll >> 32) + (lh & half_mask) + (hl & half_mask);
+    low = (middle << 32) | (ll & half_mask);
+    return hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // constructors and assignments
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(void)
+  {
+    assign_limb(0, false);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(short r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(unsigned short r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(int r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(unsigned r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(long r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(unsigned long r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(const inf& r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>::fixed_inf(const std::string& r)
+  {
+    operator=(r);
+  }
+
+  template<unsigned Bits>
+  template<unsigned B>
+  fixed_inf<Bits>::fixed_inf(const fixed_inf<B>& r)
+  {
+    limb extend = r.sign_extension();
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] = i < (unsigned)fixed_inf<B>::limb_count ? r.m_limbs[i] : extend;
+    normalise();
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (short r)
+  {
+    assign_limb((limb)(long)r, r < 0);
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (unsigned short r)
+  {
+    assign_limb((limb)r, false);
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (int r)
+  {
+    assign_limb((limb)(long)r, r < 0);
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (unsigned r)
+  {
+    assign_limb((limb)r, false);
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (long r)
+  {
+    assign_limb((limb)r, r < 0);
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (unsigned long r)
+  {
+    assign_limb((limb)r, false);
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (const inf& r)
+  {
+    set_bytes(r.get_bytes());
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator = (const std::string& r)
+  {
+    return from_string(r);
+  }
+
+  template<unsigned Bits>
+  void fixed_inf<Bits>::swap(fixed_inf<Bits>& r)
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+    {
+      limb saved = m_limbs[i];
+      m_limbs[i] = r.m_limbs[i];
+      r.m_limbs[i] = saved;
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // conversions back to the C types and to inf
+
+  template<unsigned Bits>
+  short fixed_inf<Bits>::to_short(bool truncate) const
+  {
+    return to_inf().to_short(truncate);
+  }
+
+  template<unsigned Bits>
+  unsigned short fixed_inf<Bits>::to_unsigned_short(bool truncate) const
+  {
+    return to_inf().to_unsigned_short(truncate);
+  }
+
+  template<unsigned Bits>
+  int fixed_inf<Bits>::to_int(bool truncate) const
+  {
+    return to_inf().to_int(truncate);
+  }
+
+  template<unsigned Bits>
+  unsigned fixed_inf<Bits>::to_unsigned(bool truncate) const
+  {
+    return to_inf().to_unsigned(truncate);
+  }
+
+  template<unsigned Bits>
+  long fixed_inf<Bits>::to_long(bool truncate) const
+  {
+    return to_inf().to_long(truncate);
+  }
+
+  template<unsigned Bits>
+  unsigned long fixed_inf<Bits>::to_unsigned_long(bool truncate) const
+  {
+    return to_inf().to_unsigned_long(truncate);
+  }
+
+  template<unsigned Bits>
+  inf fixed_inf<Bits>::to_inf(void) const
+  {
+    inf result;
+    result.set_bytes(get_bytes());
+    result.reduce();
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // bitwise manipulation
+
+  template<unsigned Bits>
+  unsigned fixed_inf<Bits>::bits (void) const
+  {
+    // the number of bits up to the most significant one that differs from the sign, plus the sign bit
+    limb extend = sign_extension();
+    for (unsigned i = limb_count; i--; )
+    {
+      limb difference = m_limbs[i] ^ extend;
+      if (difference)
+      {
+        unsigned result = i * limb_bits + 1;
+        for ( ; difference; difference >>= 1)
+          result++;
+        return result;
+      }
+    }
+    return 1;
+  }
+
+  template<unsigned Bits>
+  unsigned fixed_inf<Bits>::size (void) const
+  {
+    return bits();
+  }
+
+  template<unsigned Bits>
+  unsigned fixed_inf<Bits>::indexable_bits (void) const
+  {
+    return Bits;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::bit (unsigned index) const
+  {
+    if (index >= Bits)
+      throw std::out_of_range(std::string("stlplus::fixed_inf::bit"));
+    return ((m_limbs[index / limb_bits] >> (index % limb_bits)) & 1) != 0;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator [] (unsigned index) const
+  {
+    return bit(index);
+  }
+
+  template<unsigned Bits>
+  void fixed_inf<Bits>::set (unsigned index)
+  {
+    if (index >= Bits)
+      throw std::out_of_range(std::string("stlplus::fixed_inf::set"));
+    m_limbs[index / limb_bits] |= limb(1) << (index % limb_bits);
+    // changing the sign bit changes the sign extension too
+    normalise();
+  }
+
+  template<unsigned Bits>
+  void fixed_inf<Bits>::clear (unsigned index)
+  {
+    if (index >= Bits)
+      throw std::out_of_range(std::string("stlplus::fixed_inf::clear"));
+    m_limbs[index / limb_bits] &= ~(limb(1) << (index % limb_bits));
+    normalise();
+  }
+
+  template<unsigned Bits>
+  void fixed_inf<Bits>::preset (unsigned index, bool value)
+  {
+    if (value)
+      set(index);
+    else
+      clear(index);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // tests for common values or ranges
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::negative (void) const
+  {
+    return (m_limbs[limb_count-1] >> (limb_bits - 1)) != 0;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::natural (void) const
+  {
+    return !negative();
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::positive (void) const
+  {
+    return natural() && !zero();
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::zero (void) const
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+      if (m_limbs[i] != 0)
+        return false;
+    return true;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::non_zero (void) const
+  {
+    return !zero();
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator ! (void) const
+  {
+    return zero();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // comparisons
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator == (const fixed_inf<Bits>& r) const
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+      if (m_limbs[i] != r.m_limbs[i])
+        return false;
+    return true;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator != (const fixed_inf<Bits>& r) const
+  {
+    return !operator==(r);
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator < (const fixed_inf<Bits>& r) const
+  {
+    // the top limb is compared as signed by flipping the sign bits, the rest as unsigned
+    limb sign = limb(1) << (limb_bits - 1);
+    if (m_limbs[limb_count-1] != r.m_limbs[limb_count-1])
+      return (m_limbs[limb_count-1] ^ sign) < (r.m_limbs[limb_count-1] ^ sign);
+    for (unsigned i = limb_count-1; i--; )
+      if (m_limbs[i] != r.m_limbs[i])
+        return m_limbs[i] < r.m_limbs[i];
+    return false;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator <= (const fixed_inf<Bits>& r) const
+  {
+    return !(r < *this);
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator > (const fixed_inf<Bits>& r) const
+  {
+    return r < *this;
+  }
+
+  template<unsigned Bits>
+  bool fixed_inf<Bits>::operator >= (const fixed_inf<Bits>& r) const
+  {
+    return !(*this < r);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // bitwise logic operations
+  // the sign extension of the top limb is preserved by all of these, so no normalisation is needed
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::invert (void)
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] = ~m_limbs[i];
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator ~ (void) const
+  {
+    fixed_inf<Bits> result(*this);
+    result.invert();
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator &= (const fixed_inf<Bits>& r)
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] &= r.m_limbs[i];
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator & (const fixed_inf<Bits>& r) const
+  {
+    fixed_inf<Bits> result(*this);
+    result &= r;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator |= (const fixed_inf<Bits>& r)
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] |= r.m_limbs[i];
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator | (const fixed_inf<Bits>& r) const
+  {
+    fixed_inf<Bits> result(*this);
+    result |= r;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator ^= (const fixed_inf<Bits>& r)
+  {
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] ^= r.m_limbs[i];
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator ^ (const fixed_inf<Bits>& r) const
+  {
+    fixed_inf<Bits> result(*this);
+    result ^= r;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator <<= (unsigned shift)
+  {
+    if (shift >= Bits)
+      return operator=(0);
+    unsigned limb_shift = shift / limb_bits;
+    unsigned bit_shift = shift % limb_bits;
+    // work down from the top so that each limb is read before it is overwritten
+    for (unsigned i = limb_count; i--; )
+    {
+      limb value = i >= limb_shift ? m_limbs[i - limb_shift] << bit_shift : 0;
+      if (bit_shift != 0 && i > limb_shift)
+        value |= m_limbs[i - limb_shift - 1] >> (limb_bits - bit_shift);
+      m_limbs[i] = value;
+    }
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator << (unsigned shift) const
+  {
+    fixed_inf<Bits> result(*this);
+    result <<= shift;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator >>= (unsigned shift)
+  {
+    limb extend = sign_extension();
+    if (shift >= Bits)
+    {
+      for (unsigned i = 0; i < limb_count; i++)
+        m_limbs[i] = extend;
+      return *this;
+    }
+    unsigned limb_shift = shift / limb_bits;
+    unsigned bit_shift = shift % limb_bits;
+    // work up from the bottom, filling from above with the sign
+    for (unsigned i = 0; i < limb_count; i++)
+    {
+      limb low = i + limb_shift < limb_count ? m_limbs[i + limb_shift] : extend;
+      if (bit_shift != 0)
+      {
+        limb high = i + limb_shift + 1 < limb_count ? m_limbs[i + limb_shift + 1] : extend;
+        low = (low >> bit_shift) | (high << (limb_bits - bit_shift));
+      }
+      m_limbs[i] = low;
+    }
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator >> (unsigned shift) const
+  {
+    fixed_inf<Bits> result(*this);
+    result >>= shift;
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // arithmetic
+  // a 2's-complement value is congruent to its unsigned interpretation modulo the
+  // width, so the arithmetic is done on the limbs as unsigned and then wrapped to Bits
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::negate (void)
+  {
+    limb carry = 1;
+    for (unsigned i = 0; i < limb_count; i++)
+    {
+      m_limbs[i] = ~m_limbs[i] + carry;
+      carry = carry & (m_limbs[i] == 0);
+    }
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator - (void) const
+  {
+    fixed_inf<Bits> result(*this);
+    result.negate();
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::abs(void)
+  {
+    if (negative())
+      negate();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> abs(const fixed_inf<Bits>& i)
+  {
+    fixed_inf<Bits> result(i);
+    result.abs();
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator += (const fixed_inf<Bits>& r)
+  {
+    limb carry = 0;
+    for (unsigned i = 0; i < limb_count; i++)
+    {
+      limb sum = m_limbs[i] + carry;
+      carry = sum < carry;
+      sum += r.m_limbs[i];
+      carry += sum < r.m_limbs[i];
+      m_limbs[i] = sum;
+    }
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator + (const fixed_inf<Bits>& r) const
+  {
+    fixed_inf<Bits> result(*this);
+    result += r;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator -= (const fixed_inf<Bits>& r)
+  {
+    limb borrow = 0;
+    for (unsigned i = 0; i < limb_count; i++)
+    {
+      limb left = m_limbs[i];
+      limb difference = left - r.m_limbs[i];
+      limb next_borrow = left < r.m_limbs[i];
+      next_borrow += difference < borrow;
+      m_limbs[i] = difference - borrow;
+      borrow = next_borrow;
+    }
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator - (const fixed_inf<Bits>& r) const
+  {
+    fixed_inf<Bits> result(*this);
+    result -= r;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator *= (const fixed_inf<Bits>& r)
+  {
+    // schoolbook multiplication keeping only the low limb_count limbs of the product
+    limb product[limb_count];
+    for (unsigned i = 0; i < limb_count; i++)
+      product[i] = 0;
+    for (unsigned i = 0; i < limb_count; i++)
+    {
+      limb carry = 0;
+      for (unsigned j = 0; i + j < limb_count; j++)
+      {
+        limb low = 0;
+        limb high = multiply_limbs(m_limbs[i], r.m_limbs[j], low);
+        low += carry;
+        high += low < carry;
+        product[i+j] += low;
+        high += product[i+j] < low;
+        carry = high;
+      }
+    }
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] = product[i];
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator * (const fixed_inf<Bits>& r) const
+  {
+    fixed_inf<Bits> result(*this);
+    result *= r;
+    return result;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator /= (const fixed_inf<Bits>& r)
+  {
+    std::pair<fixed_inf<Bits>,fixed_inf<Bits> > result = divide(r);
+    *this = result.first;
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator / (const fixed_inf<Bits>& r) const
+  {
+    return divide(r).first;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator %= (const fixed_inf<Bits>& r)
+  {
+    std::pair<fixed_inf<Bits>,fixed_inf<Bits> > result = divide(r);
+    *this = result.second;
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator % (const fixed_inf<Bits>& r) const
+  {
+    return divide(r).second;
+  }
+
+  template<unsigned Bits>
+  std::pair<fixed_inf<Bits>,fixed_inf<Bits> > fixed_inf<Bits>::divide(const fixed_inf<Bits>& r) const
+  {
+    if (r.zero())
+      throw divide_by_zero("stlplus::fixed_inf::divide");
+    if (!single_limb() || !r.single_limb())
+    {
+      // the general case uses the long division of inf
+      std::pair<inf,inf> result = to_inf().divide(r.to_inf());
+      return std::make_pair(fixed_inf<Bits>(result.first), fixed_inf<Bits>(result.second));
+    }
+    // divide the magnitudes, which still fit in a limb when unsigned, then apply the signs
+    // x/(-y) == (-x)/y == -(x/y) and x%(-y) == x%y and (-x)%y == -(x%y)
+    limb numerator = m_limbs[0];
+    limb denominator = r.m_limbs[0];
+    bool numerator_negative = (numerator >> (limb_bits - 1)) != 0;
+    bool denominator_negative = (denominator >> (limb_bits - 1)) != 0;
+    if (numerator_negative) numerator = 0 - numerator;
+    if (denominator_negative) denominator = 0 - denominator;
+    std::pair<fixed_inf<Bits>,fixed_inf<Bits> > result;
+    result.first.assign_limb(numerator / denominator, false);
+    result.second.assign_limb(numerator % denominator, false);
+    if (numerator_negative != denominator_negative)
+      result.first.negate();
+    if (numerator_negative)
+      result.second.negate();
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // pre- and post- increment and decrement
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator ++ (void)
+  {
+    limb carry = 1;
+    for (unsigned i = 0; i < limb_count && carry; i++)
+      carry = (++m_limbs[i] == 0);
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator ++ (int)
+  {
+    fixed_inf<Bits> old(*this);
+    operator ++ ();
+    return old;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::operator -- (void)
+  {
+    limb borrow = 1;
+    for (unsigned i = 0; i < limb_count && borrow; i++)
+      borrow = (m_limbs[i]-- == 0);
+    normalise();
+    return *this;
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> fixed_inf<Bits>::operator -- (int)
+  {
+    fixed_inf<Bits> old(*this);
+    operator -- ();
+    return old;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // string representation and I/O
+
+  template<unsigned Bits>
+  std::string fixed_inf<Bits>::to_string(unsigned radix) const
+  {
+    return to_inf().to_string(radix);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits>& fixed_inf<Bits>::from_string(const std::string& value, unsigned radix)
+  {
+    inf result;
+    result.from_string(value, radix);
+    return operator=(result);
+  }
+
+  template<unsigned Bits>
+  std::ostream& operator << (std::ostream& str, const fixed_inf<Bits>& i)
+  {
+    return str << i.to_inf();
+  }
+
+  template<unsigned Bits>
+  std::istream& operator >> (std::istream& str, fixed_inf<Bits>& i)
+  {
+    inf value;
+    if (str >> value)
+      i = value;
+    return str;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // the value as bytes, in the same format as inf except that the length is always the same
+
+  template<unsigned Bits>
+  std::string fixed_inf<Bits>::get_bytes(void) const
+  {
+    std::string result;
+    unsigned bytes = (Bits + 7) / 8;
+    result.reserve(bytes);
+    for (unsigned i = 0; i < bytes; i++)
+      result += std::string::value_type((m_limbs[i / sizeof(limb)] >> (8 * (i % sizeof(limb)))) & 0xff);
+    return result;
+  }
+
+  template<unsigned Bits>
+  void fixed_inf<Bits>::set_bytes(const std::string& data)
+  {
+    // the bytes are sign-extended from the last one, then wrapped round to fit
+    bool negative = !data.empty() && (data[data.size()-1] & 0x80) != 0;
+    for (unsigned i = 0; i < limb_count; i++)
+      m_limbs[i] = negative ? ~limb(0) : limb(0);
+    for (size_t i = 0; i < data.size() && i < limb_count * sizeof(limb); i++)
+    {
+      unsigned shift = 8 * (unsigned)(i % sizeof(limb));
+      m_limbs[i / sizeof(limb)] &= ~(limb(0xff) << shift);
+      m_limbs[i / sizeof(limb)] |= limb((unsigned char)data[i]) << shift;
+    }
+    normalise();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
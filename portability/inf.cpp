@@ -5,30 +5,41 @@
 //              (c) Andy Rushton           2004 onwards
 //   License:   BSD License, see ../docs/license.html
 
-//   The integer is represented as a sequence of bytes. They are stored such that
-//   element 0 is the lsB, which makes sense when seen as an integer offset but
-//   is counter-intuitive when you think that a string is usually read from left
-//   to right, 0 to size-1, in which case the lsB is on the *left*.
+//   The integer is represented as a sequence of 64-bit machine words, called
+//   limbs. They are stored such that element 0 is the least-significant limb,
+//   and the value is in 2's-complement form, so the msb of the last limb is the
+//   sign bit. Working a whole machine word at a time means that an addition of
+//   two n-bit values is n/64 word additions rather than n/8 byte additions, and
+//   multiplication and division use the double-length product and quotient
+//   that the processor provides.
+
+//   The user-visible size of the value is still measured in bytes, because
+//   that is what the bit interface (resize, indexable_bits, set, clear) and the
+//   persistent representation (get_bytes, set_bytes) have always used. This size
+//   is held in m_bytes and the limbs are kept sign-extended above it, so the
+//   arithmetic never has to look at m_bytes.
+
+//   Most operations produce a reduced result - that is, the minimum number of
+//   bytes needed to hold the value with its sign. The exceptions are the bit
+//   manipulation methods, which leave the size as it is, just as they did when
+//   the value was held as a string of bytes.
+
+//   Most values are small, so values of up to two limbs are held inside the inf
+//   object (see inf::limb_vector) and never allocate memory, and the operators
+//   handle single-limb arguments with native arithmetic.
 
 //   This solution is compatible with 32-bit and 64-bit machines with either
-//   little-endian or big-endian representations of integers.
-
-//   Problem: I'm using std::string, which is an array of char. However, char is
-//   not well-defined - it could be signed or unsigned.
-
-//   In fact, there's no requirement for a char to even be one byte - it can be
-//   any size of one byte or more. However, it's just impossible to make any
-//   progress with that naffness (thanks to the C non-standardisation committee)
-//   and the practice is that char on every platform/compiler I've ever come
-//   across is that char = byte.
-
-//   The algorithms here use unsigned char to represent bit-patterns so I have to
-//   be careful to type-cast from char to unsigned char a lot. I use a typedef to
-//   make life easier.
+//   little-endian or big-endian representations of integers, since the bytes are
+//   always extracted from the limbs by shifting.
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "inf.hpp"
 #include <ctype.h>
+#include <algorithm>
+#include <utility>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace stlplus
@@ -39,91 +50,1613 @@ namespace stlplus
 
   typedef unsigned char byte;
 
-  ////////////////////////////////////////////////////////////////////////////////
-  // local functions
+  ////////////////////////////////////////////////////////////////////////////////
+  // the limb and its properties
+
+  typedef inf::limb limb;
+  typedef inf::limb_vector limb_vector;
+
+  static const unsigned limb_bits = 64;
+  static const unsigned limb_bytes = 8;
+  static const limb limb_max = ~limb(0);
+
+  // use the compiler's double-length integer type where there is one
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 double_limb;
+#define STLPLUS_INF_DOUBLE_LIMB 1
+#endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // the array of limbs
+  // m_data points to m_inline while the capacity is the inline size, otherwise to an array on the heap
+
+  inf::limb_vector::limb_vector(void) :
+    m_data(m_inline), m_size(0), m_capacity(inline_size)
+  {
+  }
+
+  inf::limb_vector::limb_vector(size_t size, limb value) :
+    m_data(m_inline), m_size(0), m_capacity(inline_size)
+  {
+    assign(size, value);
+  }
+
+  inf::limb_vector::limb_vector(const limb* first, const limb* last) :
+    m_data(m_inline), m_size(0), m_capacity(inline_size)
+  {
+    assign(first, last);
+  }
+
+  inf::limb_vector::limb_vector(const limb_vector& r) :
+    m_data(m_inline), m_size(0), m_capacity(inline_size)
+  {
+    assign(r.begin(), r.end());
+  }
+
+  inf::limb_vector& inf::limb_vector::operator = (const limb_vector& r)
+  {
+    if (&r != this)
+      assign(r.begin(), r.end());
+    return *this;
+  }
+
+#ifdef STLPLUS_HAS_CXX11
+
+  inf::limb_vector::limb_vector(limb_vector&& r) STLPLUS_NOEXCEPT :
+    m_data(m_inline), m_size(0), m_capacity(inline_size)
+  {
+    take(r);
+  }
+
+  inf::limb_vector& inf::limb_vector::operator = (limb_vector&& r) STLPLUS_NOEXCEPT
+  {
+    if (&r != this)
+    {
+      clear();
+      take(r);
+    }
+    return *this;
+  }
+
+#endif
+
+  inf::limb_vector::~limb_vector(void)
+  {
+    if (m_data != m_inline)
+      delete[] m_data;
+  }
+
+  size_t inf::limb_vector::size(void) const
+  {
+    return m_size;
+  }
+
+  bool inf::limb_vector::empty(void) const
+  {
+    return m_size == 0;
+  }
+
+  limb& inf::limb_vector::operator [] (size_t index)
+  {
+    return m_data[index];
+  }
+
+  const limb& inf::limb_vector::operator [] (size_t index) const
+  {
+    return m_data[index];
+  }
+
+  limb& inf::limb_vector::back(void)
+  {
+    return m_data[m_size-1];
+  }
+
+  const limb& inf::limb_vector::back(void) const
+  {
+    return m_data[m_size-1];
+  }
+
+  inf::limb_vector::iterator inf::limb_vector::begin(void)
+  {
+    return m_data;
+  }
+
+  inf::limb_vector::const_iterator inf::limb_vector::begin(void) const
+  {
+    return m_data;
+  }
+
+  inf::limb_vector::iterator inf::limb_vector::end(void)
+  {
+    return m_data + m_size;
+  }
+
+  inf::limb_vector::const_iterator inf::limb_vector::end(void) const
+  {
+    return m_data + m_size;
+  }
+
+  // make room for at least capacity limbs, keeping the contents
+  // the capacity at least doubles so that repeated growth is amortised constant time
+  void inf::limb_vector::reserve(size_t capacity)
+  {
+    if (capacity <= m_capacity)
+      return;
+    capacity = maximum(capacity, 2 * (size_t)m_capacity);
+    limb* data = new limb[capacity];
+    std::copy(m_data, m_data + m_size, data);
+    if (m_data != m_inline)
+      delete[] m_data;
+    m_data = data;
+    m_capacity = (unsigned)capacity;
+  }
+
+  // take over the contents of r, stealing its array if it is on the heap, leaving r empty
+  void inf::limb_vector::take(limb_vector& r)
+  {
+    if (r.m_data == r.m_inline)
+    {
+      assign(r.begin(), r.end());
+    }
+    else
+    {
+      if (m_data != m_inline)
+        delete[] m_data;
+      m_data = r.m_data;
+      m_size = r.m_size;
+      m_capacity = r.m_capacity;
+      r.m_data = r.m_inline;
+      r.m_capacity = inline_size;
+    }
+    r.m_size = 0;
+  }
+
+  void inf::limb_vector::resize(size_t size, limb value)
+  {
+    reserve(size);
+    if (size > m_size)
+      std::fill(m_data + m_size, m_data + size, value);
+    m_size = (unsigned)size;
+  }
+
+  void inf::limb_vector::assign(size_t size, limb value)
+  {
+    m_size = 0;
+    resize(size, value);
+  }
+
+  void inf::limb_vector::assign(const limb* first, const limb* last)
+  {
+    size_t size = last - first;
+    if (size > m_capacity)
+    {
+      // the range may be part of this vector, so copy it before releasing the old array
+      limb* data = new limb[size];
+      std::copy(first, last, data);
+      if (m_data != m_inline)
+        delete[] m_data;
+      m_data = data;
+      m_capacity = (unsigned)size;
+    }
+    else
+    {
+      // a forward copy is safe even if the range is a later part of this vector
+      std::copy(first, last, m_data);
+    }
+    m_size = (unsigned)size;
+  }
+
+  void inf::limb_vector::push_back(limb value)
+  {
+    if (m_size == m_capacity)
+      reserve(m_size + 1);
+    m_data[m_size++] = value;
+  }
+
+  void inf::limb_vector::pop_back(void)
+  {
+    m_size--;
+  }
+
+  void inf::limb_vector::insert(iterator position, size_t count, limb value)
+  {
+    size_t offset = position - m_data;
+    reserve(m_size + count);
+    std::copy_backward(m_data + offset, m_data + m_size, m_data + m_size + count);
+    std::fill(m_data + offset, m_data + offset + count, value);
+    m_size += (unsigned)count;
+  }
+
+  void inf::limb_vector::insert(iterator position, const limb* first, const limb* last)
+  {
+    size_t offset = position - m_data;
+    size_t count = last - first;
+    reserve(m_size + count);
+    std::copy_backward(m_data + offset, m_data + m_size, m_data + m_size + count);
+    std::copy(first, last, m_data + offset);
+    m_size += (unsigned)count;
+  }
+
+  void inf::limb_vector::erase(iterator first, iterator last)
+  {
+    std::copy(last, end(), first);
+    m_size -= (unsigned)(last - first);
+  }
+
+  void inf::limb_vector::clear(void)
+  {
+    m_size = 0;
+  }
+
+  void inf::limb_vector::swap(limb_vector& r)
+  {
+    if (&r == this)
+      return;
+    if (m_data != m_inline && r.m_data != r.m_inline)
+    {
+      std::swap(m_data, r.m_data);
+      std::swap(m_size, r.m_size);
+      std::swap(m_capacity, r.m_capacity);
+    }
+    else if (m_data == m_inline && r.m_data == r.m_inline)
+    {
+      std::swap_ranges(m_inline, m_inline + inline_size, r.m_inline);
+      std::swap(m_size, r.m_size);
+    }
+    else
+    {
+      limb_vector temporary;
+      temporary.take(r);
+      r.take(*this);
+      take(temporary);
+    }
+  }
+
+  bool inf::limb_vector::operator == (const limb_vector& r) const
+  {
+    return m_size == r.m_size && std::equal(begin(), end(), r.begin());
+  }
+
+  bool inf::limb_vector::operator != (const limb_vector& r) const
+  {
+    return !operator==(r);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // single-limb operations
+  // these use the processor's double-length multiply and divide where the compiler gives access to them
+
+  // the number of leading zero bits in a non-zero limb
+  static inline unsigned leading_zeros(limb value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return limb_bits - 1 - (unsigned)index;
+#else
+    unsigned result = 0;
+    for ( ; !(value & (limb(1) << (limb_bits - 1))); value <<= 1)
+      result++;
+    return result;
+#endif
+  }
+
+  // the double-length product of two limbs - returns the high limb and sets low to the low limb
+  static inline limb multiply_limbs(limb left, limb right, limb& low)
+  {
+#if defined(STLPLUS_INF_DOUBLE_LIMB)
+    double_limb product = (double_limb)left * right;
+    low = (limb)product;
+    return (limb)(product >> limb_bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    limb high = 0;
+    low = _umul128(left, right, &high);
+    return high;
+#else
+    // multiply the half-limbs and add up the partial products
+    const limb half_mask = 0xffffffff;
+    limb ll = (left & half_mask) * (right & half_mask);
+    limb lh = (left & half_mask) * (right >> 32);
+    limb hl = (left >> 32) * (right & half_mask);
+    limb hh = (left >> 32) * (right >> 32);
+    limb middle = (ll >> 32) + (lh & half_mask) + (hl & half_mask);
+    low = (middle << 32) | (ll & half_mask);
+    return hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+  }
+
+  // divide the double-length value high:low by divisor, which requires high < divisor so that the quotient fits a limb
+  // returns the quotient and sets remainder
+  static inline limb divide_limbs(limb high, limb low, limb divisor, limb& remainder)
+  {
+#if defined(STLPLUS_INF_DOUBLE_LIMB)
+    double_limb numerator = ((double_limb)high << limb_bits) | low;
+    limb quotient = (limb)(numerator / divisor);
+    remainder = low - quotient * divisor;
+    return quotient;
+#elif defined(_MSC_VER) && defined(_M_X64) && (_MSC_VER >= 1920)
+    return _udiv128(high, low, divisor, &remainder);
+#else
+    // Knuth's long division using half-limb digits, after normalising the divisor so its msb is set
+    unsigned shift = leading_zeros(divisor);
+    if (shift)
+    {
+      divisor <<= shift;
+      high = (high << shift) | (low >> (limb_bits - shift));
+      low <<= shift;
+    }
+    const limb half_mask = 0xffffffff;
+    limb divisor_high = divisor >> 32;
+    limb divisor_low = divisor & half_mask;
+    // first half-limb digit of the quotient, the estimate is at most two too large
+    limb quotient_high = high / divisor_high;
+    limb partial = high - quotient_high * divisor_high;
+    limb product = quotient_high * divisor_low;
+    partial = (partial << 32) | (low >> 32);
+    if (partial < product)
+    {
+      quotient_high--;
+      partial += divisor;
+      if (partial >= divisor && partial < product)
+      {
+        quotient_high--;
+        partial += divisor;
+      }
+    }
+    partial -= product;
+    // second half-limb digit
+    limb quotient_low = partial / divisor_high;
+    limb rest = partial - quotient_low * divisor_high;
+    product = quotient_low * divisor_low;
+    rest = (rest << 32) | (low & half_mask);
+    if (rest < product)
+    {
+      quotient_low--;
+      rest += divisor;
+      if (rest >= divisor && rest < product)
+      {
+        quotient_low--;
+        rest += divisor;
+      }
+    }
+    rest -= product;
+    remainder = rest >> shift;
+    return (quotient_high << 32) | quotient_low;
+#endif
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // operations on arrays of limbs holding unsigned magnitudes
+
+  // result = left + right over size limbs, returns the carry out
+  // result can be the same array as either argument
+  static limb add_limbs(limb* result, const limb* left, const limb* right, size_t size)
+  {
+    limb carry = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb sum = left[i] + carry;
+      carry = sum < carry;
+      limb right_limb = right[i];
+      sum += right_limb;
+      carry += sum < right_limb;
+      result[i] = sum;
+    }
+    return carry;
+  }
+
+  // result = left - right over size limbs, returns the borrow out
+  // result can be the same array as either argument
+  static limb subtract_limbs(limb* result, const limb* left, const limb* right, size_t size)
+  {
+    limb borrow = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb left_limb = left[i];
+      limb right_limb = right[i];
+      limb difference = left_limb - right_limb;
+      limb next_borrow = left_limb < right_limb;
+      next_borrow |= difference < borrow;
+      result[i] = difference - borrow;
+      borrow = next_borrow;
+    }
+    return borrow;
+  }
+
+  // compare two magnitudes of the same size, returns -1, 0 or 1
+  static int compare_limbs(const limb* left, const limb* right, size_t size)
+  {
+    for (size_t i = size; i--; )
+      if (left[i] != right[i])
+        return left[i] < right[i] ? -1 : 1;
+    return 0;
+  }
+
+  // result = |left - right|, where right_size <= left_size and result has left_size limbs
+  // returns true if right is the larger, i.e. left - right is negative
+  static bool difference_limbs(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size)
+  {
+    bool left_larger = false;
+    for (size_t i = right_size; !left_larger && i < left_size; i++)
+      left_larger = left[i] != 0;
+    if (left_larger || compare_limbs(left, right, right_size) >= 0)
+    {
+      limb borrow = subtract_limbs(result, left, right, right_size);
+      for (size_t i = right_size; i < left_size; i++)
+      {
+        result[i] = left[i] - borrow;
+        borrow = borrow & (left[i] == 0);
+      }
+      return false;
+    }
+    // right is larger, so the high limbs of left must be zero
+    subtract_limbs(result, right, left, right_size);
+    std::fill(result + right_size, result + left_size, limb(0));
+    return true;
+  }
+
+  // result += value, with value added at the offset and the carry propagated to the end of result
+  // the sum must fit in result, so any high-order zeros of value can be beyond the end
+  static void add_into(limb* result, size_t result_size, size_t offset, const limb* value, size_t value_size)
+  {
+    while (value_size > 0 && value[value_size-1] == 0)
+      value_size--;
+    limb carry = add_limbs(result + offset, result + offset, value, value_size);
+    for (size_t i = offset + value_size; carry && i < result_size; i++)
+      carry = ++result[i] == 0;
+  }
+
+  // result -= value, with the borrow propagated to the end of result, which must be the larger
+  static void subtract_from(limb* result, size_t result_size, const limb* value, size_t value_size)
+  {
+    while (value_size > 0 && value[value_size-1] == 0)
+      value_size--;
+    limb borrow = subtract_limbs(result, result, value, value_size);
+    for (size_t i = value_size; borrow && i < result_size; i++)
+      borrow = result[i]-- == 0;
+  }
+
+  // result += left * right, where left has size limbs and right is a single limb, returns the carry out
+  static limb multiply_add_limb(limb* result, const limb* left, size_t size, limb right)
+  {
+    limb carry = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb low = 0;
+      limb high = multiply_limbs(left[i], right, low);
+      low += carry;
+      high += low < carry;
+      limb sum = result[i] + low;
+      high += sum < low;
+      result[i] = sum;
+      carry = high;
+    }
+    return carry;
+  }
+
+  // result = left * right, where left has size limbs and right is a single limb, returns the carry out
+  // result can be the same array as left
+  static limb multiply_limb(limb* result, const limb* left, size_t size, limb right)
+  {
+    limb carry = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb low = 0;
+      limb high = multiply_limbs(left[i], right, low);
+      low += carry;
+      high += low < carry;
+      result[i] = low;
+      carry = high;
+    }
+    return carry;
+  }
+
+  // result -= left * right, where left has size limbs and right is a single limb, returns the borrow out
+  static limb multiply_subtract_limb(limb* result, const limb* left, size_t size, limb right)
+  {
+    limb borrow = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb low = 0;
+      limb high = multiply_limbs(left[i], right, low);
+      low += borrow;
+      high += low < borrow;
+      limb difference = result[i] - low;
+      high += difference > result[i];
+      result[i] = difference;
+      borrow = high;
+    }
+    return borrow;
+  }
+
+  // result = value << shift for 0 <= shift < limb_bits, returns the bits shifted out of the top
+  // result can be the same array as value
+  static limb shift_left_limbs(limb* result, const limb* value, size_t size, unsigned shift)
+  {
+    if (shift == 0)
+    {
+      std::copy(value, value + size, result);
+      return 0;
+    }
+    limb carry = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb next_carry = value[i] >> (limb_bits - shift);
+      result[i] = (value[i] << shift) | carry;
+      carry = next_carry;
+    }
+    return carry;
+  }
+
+  // result = value >> shift for 0 <= shift < limb_bits, with zeros shifted in at the top
+  // result can be the same array as value
+  static void shift_right_limbs(limb* result, const limb* value, size_t size, unsigned shift)
+  {
+    if (shift == 0)
+    {
+      std::copy(value, value + size, result);
+      return;
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+      limb high = i + 1 < size ? value[i+1] << (limb_bits - shift) : limb(0);
+      result[i] = (value[i] >> shift) | high;
+    }
+  }
+
+  // quotient = numerator / divisor for a single-limb divisor, returns the remainder
+  // quotient can be the same array as numerator
+  static limb divide_limb(limb* quotient, const limb* numerator, size_t size, limb divisor)
+  {
+    limb remainder = 0;
+    for (size_t i = size; i--; )
+      quotient[i] = divide_limbs(remainder, numerator[i], divisor, remainder);
+    return remainder;
+  }
+
+  // remove high-order zero limbs, leaving at least one limb
+  static void trim_magnitude(limb_vector& value)
+  {
+    while (value.size() > 1 && value.back() == 0)
+      value.pop_back();
+  }
+
+  // long division of magnitudes, one limb of the quotient at a time - this is Knuth's Algorithm D
+  // the magnitudes must be trimmed, the divisor must be non-zero and the results must be different vectors from the arguments
+  static void divide_magnitudes(const limb_vector& numerator, const limb_vector& divisor, limb_vector& quotient, limb_vector& remainder)
+  {
+    size_t numerator_size = numerator.size();
+    size_t divisor_size = divisor.size();
+    if (numerator_size < divisor_size ||
+        (numerator_size == divisor_size && compare_limbs(&numerator[0], &divisor[0], divisor_size) < 0))
+    {
+      remainder = numerator;
+      quotient.assign(1, 0);
+      return;
+    }
+    // a single-limb divisor is a simple division by the processor's double-length divide
+    if (divisor_size == 1)
+    {
+      quotient.resize(numerator_size);
+      remainder.assign(1, divide_limb(&quotient[0], &numerator[0], numerator_size, divisor[0]));
+      trim_magnitude(quotient);
+      return;
+    }
+    // normalise so that the divisor's msb is set, which makes the estimate of each quotient limb at most two too large
+    // the numerator gets an extra limb for the bits shifted out of the top
+    unsigned shift = leading_zeros(divisor.back());
+    limb_vector normal_divisor(divisor_size);
+    shift_left_limbs(&normal_divisor[0], &divisor[0], divisor_size, shift);
+    limb_vector& partial = remainder;
+    partial.resize(numerator_size + 1);
+    partial[numerator_size] = shift_left_limbs(&partial[0], &numerator[0], numerator_size, shift);
+    limb divisor_high = normal_divisor[divisor_size-1];
+    limb divisor_next = normal_divisor[divisor_size-2];
+    quotient.resize(numerator_size - divisor_size + 1);
+    for (size_t j = quotient.size(); j--; )
+    {
+      // estimate the quotient limb by dividing the top two limbs of the partial remainder by the top limb of the divisor
+      limb* window = &partial[j];
+      limb top = window[divisor_size];
+      limb estimate = limb_max;
+      limb rest = 0;
+      bool rest_overflow = false;
+      if (top < divisor_high)
+        estimate = divide_limbs(top, window[divisor_size-1], divisor_high, rest);
+      else
+      {
+        // the estimate would not fit a limb, so start from the largest limb
+        rest = window[divisor_size-1] + divisor_high;
+        rest_overflow = rest < divisor_high;
+      }
+      // use the next limb of each to correct the estimate, which leaves it at most one too large
+      while (!rest_overflow)
+      {
+        limb low = 0;
+        limb high = multiply_limbs(estimate, divisor_next, low);
+        if (high < rest || (high == rest && low <= window[divisor_size-2]))
+          break;
+        estimate--;
+        rest += divisor_high;
+        rest_overflow = rest < divisor_high;
+      }
+      // subtract the estimate times the divisor and add the divisor back in the rare case that it was still one too large
+      limb borrow = multiply_subtract_limb(window, &normal_divisor[0], divisor_size, estimate);
+      window[divisor_size] = top - borrow;
+      if (top < borrow)
+      {
+        estimate--;
+        window[divisor_size] += add_limbs(window, window, &normal_divisor[0], divisor_size);
+      }
+      quotient[j] = estimate;
+    }
+    // what is left in the low limbs of the partial remainder is the remainder, still normalised
+    partial.resize(divisor_size);
+    shift_right_limbs(&partial[0], &partial[0], divisor_size, shift);
+    trim_magnitude(quotient);
+    trim_magnitude(remainder);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // operations on vectors of limbs holding 2's-complement values
+
+  // the limb that extends the value - all ones for a negative value or all zeros for a natural value
+  static inline limb sign_extension(const limb_vector& value)
+  {
+    return (value.back() >> (limb_bits - 1)) ? limb_max : limb(0);
+  }
+
+  // a single bit of the value - index must be within the limbs
+  static inline bool limb_bit(const limb_vector& value, size_t index)
+  {
+    return ((value[index / limb_bits] >> (index % limb_bits)) & 1) != 0;
+  }
+
+  // a single byte of the value - index must be within the limbs
+  static inline byte limb_byte(const limb_vector& value, size_t index)
+  {
+    return byte(value[index / limb_bytes] >> (8 * (index % limb_bytes)));
+  }
+
+  // the limb-sized group of bits starting at position, sign-extended beyond the end of the value
+  static limb extract_limb(const limb_vector& value, size_t position, limb extend)
+  {
+    size_t index = position / limb_bits;
+    unsigned offset = (unsigned)(position % limb_bits);
+    limb low = index < value.size() ? value[index] : extend;
+    if (offset == 0)
+      return low;
+    limb high = index + 1 < value.size() ? value[index + 1] : extend;
+    return (low >> offset) | (high << (limb_bits - offset));
+  }
+
+  // sign-extend the top limb from the sign bit at bits-1
+  static void extend_sign(limb_vector& value, size_t bits)
+  {
+    unsigned used = (unsigned)(bits % limb_bits);
+    if (used == 0)
+      return;
+    limb& top = value.back();
+    limb mask = limb_max << used;
+    if (top & (limb(1) << (used - 1)))
+      top |= mask;
+    else
+      top &= ~mask;
+  }
+
+  // The number of significant bits in the value - this is the number of bits
+  // up to and including the highest bit that differs from the sign, plus the sign bit
+  static unsigned significant_bits(const limb_vector& value)
+  {
+    limb extend = sign_extension(value);
+    for (size_t i = value.size(); i--; )
+      if (value[i] != extend)
+        return (unsigned)(i * limb_bits) + (limb_bits - leading_zeros(value[i] ^ extend)) + 1;
+    return 1;
+  }
+
+  // reduce the value to the minimum number of bytes that preserves the value, and the limbs to match
+  static void reduce_limbs(limb_vector& value, unsigned& bytes)
+  {
+    bytes = (significant_bits(value) + 7) / 8;
+    value.resize((bytes + limb_bytes - 1) / limb_bytes);
+  }
+
+  // in-place 2's-complement negation over the limbs
+  // the most negative value overflows to itself, so the caller must provide an extra limb if that matters
+  static void negate_limbs(limb* value, size_t size)
+  {
+    limb carry = 1;
+    for (size_t i = 0; i < size; i++)
+    {
+      value[i] = ~value[i] + carry;
+      carry = carry & (value[i] == 0);
+    }
+  }
+
+  // convert a 2's-complement value into an unsigned magnitude, returns true if the value was negative
+  static bool to_magnitude(const limb_vector& value, limb_vector& magnitude)
+  {
+    magnitude = value;
+    bool negative = sign_extension(value) != 0;
+    // the magnitude of the most negative value of n limbs still fits in n limbs when unsigned
+    if (negative)
+      negate_limbs(&magnitude[0], magnitude.size());
+    trim_magnitude(magnitude);
+    return negative;
+  }
+
+  // convert an unsigned magnitude back to a 2's-complement value, negating it if required
+  static void from_magnitude(limb_vector& value, bool negative)
+  {
+    value.push_back(0);
+    if (negative)
+      negate_limbs(&value[0], value.size());
+  }
+
+  // two's-complement addition or subtraction of right into left
+  // right can be the same vector as left
+  static void add_values(limb_vector& left, const limb_vector& right, bool subtract)
+  {
+    // subtraction is addition of the inverse plus one
+    limb invert = subtract ? limb_max : limb(0);
+    limb left_extend = sign_extension(left);
+    limb right_extend = sign_extension(right) ^ invert;
+    limb carry = subtract ? 1 : 0;
+    size_t size = maximum(left.size(), right.size());
+    left.resize(size, left_extend);
+    for (size_t i = 0; i < size; i++)
+    {
+      limb right_limb = i < right.size() ? right[i] ^ invert : right_extend;
+      limb sum = left[i] + carry;
+      carry = sum < carry;
+      sum += right_limb;
+      carry += sum < right_limb;
+      left[i] = sum;
+    }
+    // the result can be one limb longer than the longer argument
+    // that limb is the sum of the sign extensions and is only needed if it is not the sign extension of the result
+    limb top = left_extend + right_extend + carry;
+    if (top != sign_extension(left))
+      left.push_back(top);
+  }
+
+  // comparison of two 2's-complement values of any size, returns -1, 0 or 1
+  static int compare_values(const limb_vector& left, const limb_vector& right)
+  {
+    limb left_extend = sign_extension(left);
+    limb right_extend = sign_extension(right);
+    // when the signs are different, the left is less if it is the negative one
+    if (left_extend != right_extend)
+      return left_extend ? -1 : 1;
+    // the arguments are the same sign so the ordering is a simple unsigned limb-by-limb comparison from the msL down
+    for (size_t i = maximum(left.size(), right.size()); i--; )
+    {
+      limb left_limb = i < left.size() ? left[i] : left_extend;
+      limb right_limb = i < right.size() ? right[i] : right_extend;
+      if (left_limb != right_limb)
+        return left_limb < right_limb ? -1 : 1;
+    }
+    return 0;
+  }
+
+  // the bitwise logic operations, extended to the length of the largest argument
+  enum logic_operation {logic_and, logic_or, logic_xor};
+
+  static void logic_values(limb_vector& left, const limb_vector& right, logic_operation operation)
+  {
+    limb left_extend = sign_extension(left);
+    limb right_extend = sign_extension(right);
+    size_t size = maximum(left.size(), right.size());
+    left.resize(size, left_extend);
+    for (size_t i = 0; i < size; i++)
+    {
+      limb right_limb = i < right.size() ? right[i] : right_extend;
+      switch(operation)
+      {
+      case logic_and:
+        left[i] &= right_limb;
+        break;
+      case logic_or:
+        left[i] |= right_limb;
+        break;
+      case logic_xor:
+        left[i] ^= right_limb;
+        break;
+      }
+    }
+  }
+
+  // Values that fit in one limb are by far the most common, so the operators handle them with native
+  // arithmetic, which needs none of the sign extension and carry handling of the general case
+  static inline bool single_limbs(const limb_vector& left, const limb_vector& right)
+  {
+    return left.size() == 1 && right.size() == 1;
+  }
+
+  // flipping the sign bit turns the signed ordering of limbs into the unsigned ordering
+  static inline limb signed_order(limb value)
+  {
+    return value ^ (limb(1) << (limb_bits - 1));
+  }
+
+  // the limb above a single-limb result that overflowed, which is the opposite sign to the overflowed limb
+  static inline limb overflow_extension(limb value)
+  {
+    return (value >> (limb_bits - 1)) ? limb(0) : limb_max;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // multiplication of magnitudes
+  // The schoolbook method is O(n^2) but has the lowest overhead so is used for small values.
+  // Above a threshold, Karatsuba's method splits the values in two and needs three half-size
+  // products instead of four, which is O(n^1.58). Above a higher threshold, Toom-3 splits the
+  // values in three and needs five third-size products instead of nine, which is O(n^1.46).
+  // Squaring has its own versions of each since it needs only about half the work.
+  // The thresholds are in limbs and were tuned with tests/inf_benchmark
+
+  static const size_t karatsuba_threshold = 28;
+  static const size_t toom3_threshold = 300;
+  static const size_t square_karatsuba_threshold = 48;
+  static const size_t square_toom3_threshold = 300;
+
+  static void multiply_magnitudes(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size);
+  static void square_magnitude(limb* result, const limb* value, size_t size);
+
+  // result = left * right by the schoolbook method
+  // result must have left_size + right_size limbs and must not overlap either argument
+  static void multiply_basecase(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size)
+  {
+    std::fill(result, result + left_size, limb(0));
+    for (size_t j = 0; j < right_size; j++)
+      result[j + left_size] = multiply_add_limb(result + j, left, left_size, right[j]);
+  }
+
+  // result = value * value by the schoolbook method
+  // each cross product value[i]*value[j] appears twice in the square, so is calculated once then doubled
+  static void square_basecase(limb* result, const limb* value, size_t size)
+  {
+    std::fill(result, result + 2 * size, limb(0));
+    // the cross products - row i is value[i] * value[i+1..size-1], added in at position 2i+1
+    for (size_t i = 0; i + 1 < size; i++)
+      result[i + size] = multiply_add_limb(result + 2 * i + 1, value + i + 1, size - i - 1, value[i]);
+    // double them - the cross products add up to less than half the square so this cannot overflow
+    limb carry = 0;
+    for (size_t i = 0; i < 2 * size; i++)
+    {
+      limb next_carry = result[i] >> (limb_bits - 1);
+      result[i] = (result[i] << 1) | carry;
+      carry = next_carry;
+    }
+    // add the squares of each limb on the diagonal
+    carry = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      limb low = 0;
+      limb high = multiply_limbs(value[i], value[i], low);
+      limb sum = result[2*i] + carry;
+      carry = sum < carry;
+      sum += low;
+      carry += sum < low;
+      result[2*i] = sum;
+      sum = result[2*i+1] + carry;
+      carry = sum < carry;
+      sum += high;
+      carry += sum < high;
+      result[2*i+1] = sum;
+    }
+  }
+
+  // the product of a long value by a shorter one, done as a series of products of the shorter one
+  // by chunks of the long one, which keeps the faster methods working on balanced sizes
+  static void multiply_unbalanced(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size)
+  {
+    std::fill(result, result + left_size + right_size, limb(0));
+    limb_vector product(2 * right_size);
+    for (size_t offset = 0; offset < left_size; offset += right_size)
+    {
+      size_t chunk = minimum(right_size, left_size - offset);
+      multiply_magnitudes(&product[0], left + offset, chunk, right, right_size);
+      add_into(result, left_size + right_size, offset, &product[0], chunk + right_size);
+    }
+  }
+
+  // Karatsuba multiplication, which handles squaring when left and right are the same
+  // left = left1*B^h + left0 and right = right1*B^h + right0 where B is the limb base, then
+  // left*right = z2*B^2h + (z0 + z2 - (left0-left1)*(right0-right1))*B^h + z0
+  // where z0 = left0*right0 and z2 = left1*right1
+  static void multiply_karatsuba(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size)
+  {
+    bool square = left == right && left_size == right_size;
+    size_t half = (left_size + 1) / 2;
+    // if right has no upper half it is too short for this method
+    if (right_size <= half)
+    {
+      multiply_unbalanced(result, left, left_size, right, right_size);
+      return;
+    }
+    size_t left_high = left_size - half;
+    size_t right_high = right_size - half;
+    // the differences of the halves and their product
+    limb_vector left_difference(half);
+    bool left_negative = difference_limbs(&left_difference[0], left, half, left + half, left_high);
+    limb_vector right_difference;
+    bool right_negative = left_negative;
+    if (!square)
+    {
+      right_difference.resize(half);
+      right_negative = difference_limbs(&right_difference[0], right, half, right + half, right_high);
+    }
+    limb_vector middle(2 * half);
+    if (square)
+      square_magnitude(&middle[0], &left_difference[0], half);
+    else
+      multiply_magnitudes(&middle[0], &left_difference[0], half, &right_difference[0], half);
+    // z0 and z2 go straight into the low and high parts of the result
+    if (square)
+    {
+      square_magnitude(result, left, half);
+      square_magnitude(result + 2 * half, left + half, left_high);
+    }
+    else
+    {
+      multiply_magnitudes(result, left, half, right, half);
+      multiply_magnitudes(result + 2 * half, left + half, left_high, right + half, right_high);
+    }
+    // the middle term is z0 + z2 -/+ the product of the differences, which cannot be negative
+    limb_vector sum(2 * half + 1, limb(0));
+    std::copy(result, result + 2 * half, sum.begin());
+    add_into(&sum[0], sum.size(), 0, result + 2 * half, left_high + right_high);
+    if (left_negative == right_negative)
+      subtract_from(&sum[0], sum.size(), &middle[0], middle.size());
+    else
+      add_into(&sum[0], sum.size(), 0, &middle[0], middle.size());
+    add_into(result, left_size + right_size, half, &sum[0], sum.size());
+  }
+
+  // Toom-3 works on signed intermediate values, so these helpers work on 2's-complement vectors
+
+  // a natural value made from a range of the limbs of a magnitude
+  static limb_vector toom3_piece(const limb* value, size_t size, size_t offset, size_t length)
+  {
+    limb_vector result;
+    if (offset < size)
+      result.assign(value + offset, value + minimum(size, offset + length));
+    result.push_back(0);
+    return result;
+  }
+
+  // the signed product of two signed values
+  static limb_vector toom3_multiply(const limb_vector& left, const limb_vector& right, bool square)
+  {
+    limb_vector left_magnitude;
+    limb_vector right_magnitude;
+    limb_vector result;
+    bool negative = to_magnitude(left, left_magnitude);
+    if (square)
+    {
+      negative = false;
+      result.resize(2 * left_magnitude.size());
+      square_magnitude(&result[0], &left_magnitude[0], left_magnitude.size());
+    }
+    else
+    {
+      negative ^= to_magnitude(right, right_magnitude);
+      result.resize(left_magnitude.size() + right_magnitude.size());
+      multiply_magnitudes(&result[0], &left_magnitude[0], left_magnitude.size(), &right_magnitude[0], right_magnitude.size());
+    }
+    from_magnitude(result, negative);
+    return result;
+  }
+
+  // evaluate the polynomial value0 + value1*x + value2*x^2 at 1, -1 and -2
+  static void toom3_evaluate(const limb_vector& value0, const limb_vector& value1, const limb_vector& value2,
+                             limb_vector& at_1, limb_vector& at_minus_1, limb_vector& at_minus_2)
+  {
+    limb_vector even = value0;
+    add_values(even, value2, false);
+    at_1 = even;
+    add_values(at_1, value1, false);
+    at_minus_1 = even;
+    add_values(at_minus_1, value1, true);
+    // p(-2) = (p(-1) + value2)*2 - value0
+    at_minus_2 = at_minus_1;
+    add_values(at_minus_2, value2, false);
+    add_values(at_minus_2, at_minus_2, false);
+    add_values(at_minus_2, value0, true);
+  }
+
+  // exact division of a signed value by 2, i.e. an arithmetic shift right by one bit
+  static void toom3_halve(limb_vector& value)
+  {
+    limb extend = sign_extension(value);
+    for (size_t i = 0; i < value.size(); i++)
+      value[i] = extract_limb(value, i * limb_bits + 1, extend);
+  }
+
+  // exact division of a signed value by 3
+  static void toom3_third(limb_vector& value)
+  {
+    limb_vector magnitude;
+    bool negative = to_magnitude(value, magnitude);
+    divide_limb(&magnitude[0], &magnitude[0], magnitude.size(), 3);
+    from_magnitude(magnitude, negative);
+    value.swap(magnitude);
+  }
+
+  // Toom-3 multiplication, which handles squaring when left and right are the same
+  // The values are split into three pieces and treated as polynomials in B^k. The product
+  // polynomial is found from its values at 0, 1, -1, -2 and infinity using the interpolation
+  // sequence from Marco Bodrato's paper "Towards Optimal Toom-Cook Multiplication".
+  static void multiply_toom3(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size)
+  {
+    bool square = left == right && left_size == right_size;
+    size_t k = (left_size + 2) / 3;
+    limb_vector left0 = toom3_piece(left, left_size, 0, k);
+    limb_vector left1 = toom3_piece(left, left_size, k, k);
+    limb_vector left2 = toom3_piece(left, left_size, 2 * k, k);
+    limb_vector left_1, left_minus_1, left_minus_2;
+    toom3_evaluate(left0, left1, left2, left_1, left_minus_1, left_minus_2);
+    limb_vector right0, right1, right2, right_1, right_minus_1, right_minus_2;
+    if (!square)
+    {
+      right0 = toom3_piece(right, right_size, 0, k);
+      right1 = toom3_piece(right, right_size, k, k);
+      right2 = toom3_piece(right, right_size, 2 * k, k);
+      toom3_evaluate(right0, right1, right2, right_1, right_minus_1, right_minus_2);
+    }
+    // the five pointwise products
+    limb_vector r0 = toom3_multiply(left0, right0, square);
+    limb_vector r1 = toom3_multiply(left_1, right_1, square);
+    limb_vector r_minus_1 = toom3_multiply(left_minus_1, right_minus_1, square);
+    limb_vector r_minus_2 = toom3_multiply(left_minus_2, right_minus_2, square);
+    limb_vector r_infinity = toom3_multiply(left2, right2, square);
+    // interpolation
+    // r3 = (r(-2) - r(1))/3
+    limb_vector r3 = r_minus_2;
+    add_values(r3, r1, true);
+    toom3_third(r3);
+    // r1 = (r(1) - r(-1))/2
+    add_values(r1, r_minus_1, true);
+    toom3_halve(r1);
+    // r2 = r(-1) - r(0)
+    limb_vector r2 = r_minus_1;
+    add_values(r2, r0, true);
+    // r3 = (r2 - r3)/2 + 2*r(inf)
+    limb_vector difference = r2;
+    add_values(difference, r3, true);
+    toom3_halve(difference);
+    add_values(difference, r_infinity, false);
+    add_values(difference, r_infinity, false);
+    r3.swap(difference);
+    // r2 = r2 + r1 - r(inf)
+    add_values(r2, r1, false);
+    add_values(r2, r_infinity, true);
+    // r1 = r1 - r3
+    add_values(r1, r3, true);
+    // recombine - all the coefficients of the product are natural
+    size_t size = left_size + right_size;
+    std::fill(result, result + size, limb(0));
+    add_into(result, size, 0, &r0[0], r0.size());
+    add_into(result, size, k, &r1[0], r1.size());
+    add_into(result, size, 2 * k, &r2[0], r2.size());
+    add_into(result, size, 3 * k, &r3[0], r3.size());
+    add_into(result, size, 4 * k, &r_infinity[0], r_infinity.size());
+  }
+
+  // result = left * right, choosing the best method for the sizes
+  // result must have left_size + right_size limbs and must not overlap either argument
+  static void multiply_magnitudes(limb* result, const limb* left, size_t left_size, const limb* right, size_t right_size)
+  {
+    if (left_size < right_size)
+    {
+      std::swap(left, right);
+      std::swap(left_size, right_size);
+    }
+    if (right_size < karatsuba_threshold)
+      multiply_basecase(result, left, left_size, right, right_size);
+    else if (left_size >= 2 * right_size)
+      multiply_unbalanced(result, left, left_size, right, right_size);
+    else if (right_size < toom3_threshold || 4 * right_size < 3 * left_size)
+      multiply_karatsuba(result, left, left_size, right, right_size);
+    else
+      multiply_toom3(result, left, left_size, right, right_size);
+  }
+
+  // result = value * value, choosing the best method for the size
+  // result must have 2 * size limbs and must not overlap value
+  static void square_magnitude(limb* result, const limb* value, size_t size)
+  {
+    if (size < square_karatsuba_threshold)
+      square_basecase(result, value, size);
+    else if (size < square_toom3_threshold)
+      multiply_karatsuba(result, value, size, value, size);
+    else
+      multiply_toom3(result, value, size, value, size);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // multiplication of 2's-complement values
+  // These are the cores of the multiplication operator and the fused multiply-add, which work directly in
+  // the destination so that accumulating a sum of products does not need a temporary for each product
+
+  // the signed double-length product of two single-limb values
+  // the unsigned product is made signed by subtracting each argument from the high limb when the
+  // other one is negative, since a negative limb x is x-2^64 when treated as unsigned
+  static void multiply_single(limb left, limb right, limb_vector& result)
+  {
+    limb low = 0;
+    limb high = multiply_limbs(left, right, low);
+    if (left >> (limb_bits - 1))
+      high -= right;
+    if (right >> (limb_bits - 1))
+      high -= left;
+    result.resize(2);
+    result[0] = low;
+    result[1] = high;
+  }
+
+  // the magnitude of a multiplication argument, returns true if the value was negative
+  // a natural value is used where it is, only a negative one is converted into the workspace
+  static bool magnitude_argument(const limb_vector& value, limb_vector& workspace, const limb*& data, size_t& size)
+  {
+    if (sign_extension(value))
+    {
+      to_magnitude(value, workspace);
+      data = &workspace[0];
+      size = workspace.size();
+      return true;
+    }
+    data = &value[0];
+    size = value.size();
+    while (size > 1 && data[size-1] == 0)
+      size--;
+    return false;
+  }
+
+  // result = left * right, where result must not be the same vector as either argument
+  // multiplying a value by itself uses the faster squaring
+  static void multiply_values(limb_vector& result, const limb_vector& left, const limb_vector& right)
+  {
+    limb_vector left_workspace;
+    limb_vector right_workspace;
+    const limb* left_data = 0;
+    const limb* right_data = 0;
+    size_t left_size = 0;
+    size_t right_size = 0;
+    bool negative = magnitude_argument(left, left_workspace, left_data, left_size);
+    negative ^= magnitude_argument(right, right_workspace, right_data, right_size);
+    result.resize(left_size + right_size);
+    if (left_size == right_size && std::equal(left_data, left_data + left_size, right_data))
+      square_magnitude(&result[0], left_data, left_size);
+    else
+      multiply_magnitudes(&result[0], left_data, left_size, right_data, right_size);
+    from_magnitude(result, negative);
+  }
+
+  // value += left * right, or value -= left * right if subtract is set
+  // value must not be the same vector as either argument
+  // This works on the magnitude of value in place: if the product has the same sign it is added into the
+  // magnitude, otherwise it is subtracted and if it was the larger the difference wraps round and is negated
+  static void multiply_accumulate(limb_vector& value, const limb_vector& left, const limb_vector& right, bool subtract)
+  {
+    limb_vector left_workspace;
+    limb_vector right_workspace;
+    const limb* left_data = 0;
+    const limb* right_data = 0;
+    size_t left_size = 0;
+    size_t right_size = 0;
+    bool product_negative = magnitude_argument(left, left_workspace, left_data, left_size);
+    product_negative ^= magnitude_argument(right, right_workspace, right_data, right_size);
+    product_negative ^= subtract;
+    bool negative = sign_extension(value) != 0;
+    if (negative)
+    {
+      value.push_back(limb_max);
+      negate_limbs(&value[0], value.size());
+    }
+    // room for the product and a carry, so that the top limb of a natural magnitude is always zero
+    size_t size = maximum(value.size(), left_size + right_size) + 1;
+    value.resize(size, 0);
+    // the schoolbook method works a row at a time without a temporary, above that the product is formed first
+    bool schoolbook = minimum(left_size, right_size) < karatsuba_threshold;
+    limb_vector product;
+    if (!schoolbook)
+    {
+      product.resize(left_size + right_size);
+      multiply_magnitudes(&product[0], left_data, left_size, right_data, right_size);
+    }
+    if (product_negative == negative)
+    {
+      if (!schoolbook)
+        add_into(&value[0], size, 0, &product[0], product.size());
+      else
+        for (size_t i = 0; i < right_size; i++)
+        {
+          limb carry = multiply_add_limb(&value[i], left_data, left_size, right_data[i]);
+          add_into(&value[0], size, i + left_size, &carry, 1);
+        }
+    }
+    else
+    {
+      if (!schoolbook)
+        subtract_from(&value[0], size, &product[0], product.size());
+      else
+        for (size_t i = 0; i < right_size; i++)
+        {
+          limb borrow = multiply_subtract_limb(&value[i], left_data, left_size, right_data[i]);
+          subtract_from(&value[i + left_size], size - i - left_size, &borrow, 1);
+        }
+      if (value.back() != 0)
+      {
+        negate_limbs(&value[0], size);
+        negative = !negative;
+      }
+    }
+    from_magnitude(value, negative);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // division by a reciprocal
+  // When many values are divided by the same large divisor, it is faster to calculate the reciprocal of
+  // the divisor once and then multiply by it, since the multiplication is sub-quadratic and Algorithm D
+  // is not. The divisor must be normalised - that is, the msb of its top limb must be set - and the
+  // reciprocal of a divisor d of n limbs is beta^(2n)/d rounded down, where beta = 2^64.
+
+  static const size_t reciprocal_threshold = 40;
+
+  // compare two trimmed magnitudes of any size, returns -1, 0 or 1
+  static int compare_magnitudes(const limb_vector& left, const limb_vector& right)
+  {
+    if (left.size() != right.size())
+      return left.size() < right.size() ? -1 : 1;
+    return compare_limbs(&left[0], &right[0], left.size());
+  }
+
+  // left -= right for trimmed magnitudes, where left must be the larger
+  static void subtract_magnitude(limb_vector& left, const limb_vector& right)
+  {
+    subtract_from(&left[0], left.size(), &right[0], right.size());
+    trim_magnitude(left);
+  }
+
+  // add one to a magnitude
+  static void increment_magnitude(limb_vector& value)
+  {
+    limb one = 1;
+    value.push_back(0);
+    add_into(&value[0], value.size(), 0, &one, 1);
+    trim_magnitude(value);
+  }
+
+  static void reciprocal_magnitude(const limb_vector& divisor, limb_vector& reciprocal)
+  {
+    size_t size = divisor.size();
+    if (size < reciprocal_threshold)
+    {
+      limb_vector power(2 * size + 1, 0);
+      power[2 * size] = 1;
+      limb_vector remainder;
+      divide_magnitudes(power, divisor, reciprocal, remainder);
+      return;
+    }
+    // the reciprocal of the top half of the divisor is correct to about half the precision, then one
+    // step of Newton's iteration x += x*(beta^(2n) - divisor*x)/beta^(2n) doubles that
+    size_t half = (size + 1) / 2;
+    size_t low = size - half;
+    limb_vector top(divisor.end() - half, divisor.end());
+    limb_vector estimate;
+    reciprocal_magnitude(top, estimate);
+    // with x = estimate*beta^low, the step simplifies to
+    // reciprocal = estimate*beta^low + estimate*(beta^(size+half) - divisor*estimate)/beta^(2*half)
+    limb_vector product(size + half + 1, 0);
+    multiply_magnitudes(&product[0], &divisor[0], size, &estimate[0], estimate.size());
+    limb_vector power(size + half + 1, 0);
+    power[size + half] = 1;
+    limb_vector error(size + half + 1);
+    bool negative = difference_limbs(&error[0], &power[0], power.size(), &product[0], product.size());
+    trim_magnitude(error);
+    limb_vector correction(estimate.size() + error.size());
+    multiply_magnitudes(&correction[0], &estimate[0], estimate.size(), &error[0], error.size());
+    correction.erase(correction.begin(), correction.begin() + minimum(2 * half, correction.size() - 1));
+    reciprocal.assign(low, 0);
+    reciprocal.insert(reciprocal.end(), estimate.begin(), estimate.end());
+    reciprocal.push_back(0);
+    if (negative)
+      subtract_from(&reciprocal[0], reciprocal.size(), &correction[0], correction.size());
+    else
+      add_into(&reciprocal[0], reciprocal.size(), 0, &correction[0], correction.size());
+    trim_magnitude(reciprocal);
+    // this can still be out by a few, so correct it until 0 <= beta^(2n) - divisor*reciprocal < divisor
+    product.assign(size + reciprocal.size(), 0);
+    multiply_magnitudes(&product[0], &divisor[0], size, &reciprocal[0], reciprocal.size());
+    product.resize(maximum(product.size(), 2 * size + 1), 0);
+    power.assign(product.size(), 0);
+    power[2 * size] = 1;
+    limb_vector remainder(product.size());
+    negative = difference_limbs(&remainder[0], &power[0], power.size(), &product[0], product.size());
+    trim_magnitude(remainder);
+    limb one = 1;
+    while (negative)
+    {
+      subtract_from(&reciprocal[0], reciprocal.size(), &one, 1);
+      if (compare_magnitudes(remainder, divisor) > 0)
+        subtract_magnitude(remainder, divisor);
+      else
+      {
+        limb_vector difference(divisor);
+        subtract_magnitude(difference, remainder);
+        remainder.swap(difference);
+        negative = false;
+      }
+    }
+    while (compare_magnitudes(remainder, divisor) >= 0)
+    {
+      increment_magnitude(reciprocal);
+      subtract_magnitude(remainder, divisor);
+    }
+    trim_magnitude(reciprocal);
+  }
+
+  // quotient and remainder of the numerator by a divisor of n limbs, given its reciprocal
+  // the numerator must be less than divisor*beta^n, so the quotient has at most n limbs
+  static void divide_by_reciprocal(const limb_vector& numerator, const limb_vector& divisor, const limb_vector& reciprocal,
+                                   limb_vector& quotient, limb_vector& remainder)
+  {
+    // the estimate (numerator/beta^n)*reciprocal/beta^n is never too large and is at most a few too small
+    size_t size = divisor.size();
+    quotient.assign(1, 0);
+    if (numerator.size() > size)
+    {
+      size_t high = numerator.size() - size;
+      quotient.resize(high + reciprocal.size());
+      multiply_magnitudes(&quotient[0], &numerator[size], high, &reciprocal[0], reciprocal.size());
+      quotient.erase(quotient.begin(), quotient.begin() + minimum(size, quotient.size() - 1));
+      trim_magnitude(quotient);
+    }
+    // remainder = numerator - quotient*divisor, then correct
+    limb_vector product(quotient.size() + size);
+    multiply_magnitudes(&product[0], &quotient[0], quotient.size(), &divisor[0], size);
+    trim_magnitude(product);
+    remainder = numerator;
+    subtract_magnitude(remainder, product);
+    while (compare_magnitudes(remainder, divisor) >= 0)
+    {
+      increment_magnitude(quotient);
+      subtract_magnitude(remainder, divisor);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // modular exponentiation of magnitudes
+  // The exponentiation is written once as a template and is given one of two ways of reducing a
+  // product modulo the modulus. Both hold the values in their own working form, and convert()
+  // and revert() move a value into and out of that form.
+
+  // Montgomery reduction for an odd modulus n of s limbs
+  // A value x is held as x*R mod n where R = 2^(64s), always in s limbs. The product of two such values
+  // is reduced by dividing by R rather than by n, which can be done one limb at a time by adding
+  // multiples of n that clear the low limb, so there is no trial division at all.
+
+  class montgomery_reduction
+  {
+  public:
+    montgomery_reduction(const limb_vector& modulus) :
+      m_modulus(modulus), m_size(modulus.size()), m_inverse(0), m_product(2 * modulus.size())
+    {
+      // -1/n mod 2^64 by Newton's iteration - n*n == 1 mod 8 for odd n so n is correct to 3 bits
+      // and each iteration doubles the number of correct bits
+      limb inverse = modulus[0];
+      for (unsigned i = 0; i < 5; i++)
+        inverse *= 2 - modulus[0] * inverse;
+      m_inverse = limb(0) - inverse;
+    }
+
+    // result = value*R mod n, for value < n
+    void convert(limb_vector& result, const limb_vector& value)
+    {
+      limb_vector shifted(m_size, 0);
+      shifted.insert(shifted.end(), value.begin(), value.end());
+      trim_magnitude(shifted);
+      limb_vector quotient;
+      divide_magnitudes(shifted, m_modulus, quotient, result);
+      result.resize(m_size, 0);
+    }
+
+    // result = value/R mod n, the inverse of convert
+    void revert(limb_vector& result, const limb_vector& value)
+    {
+      std::copy(value.begin(), value.end(), m_product.begin());
+      std::fill(m_product.begin() + m_size, m_product.end(), limb(0));
+      reduce(result);
+      trim_magnitude(result);
+    }
+
+    // result = left*right/R mod n - result can be the same vector as either argument
+    void multiply(limb_vector& result, const limb_vector& left, const limb_vector& right)
+    {
+      multiply_magnitudes(&m_product[0], &left[0], m_size, &right[0], m_size);
+      reduce(result);
+    }
+
+    // result = value*value/R mod n - result can be the same vector as value
+    void square(limb_vector& result, const limb_vector& value)
+    {
+      square_magnitude(&m_product[0], &value[0], m_size);
+      reduce(result);
+    }
+
+  private:
+    const limb_vector& m_modulus;
+    size_t m_size;
+    limb m_inverse;
+    limb_vector m_product;
+
+    // result = m_product/R mod n, for m_product < n*R
+    void reduce(limb_vector& result)
+    {
+      // add the multiple of n that clears each low limb in turn, which adds less than n*R in total
+      // the carry out of each step is kept in the limb it cleared and they are all added in at the end
+      for (size_t i = 0; i < m_size; i++)
+        m_product[i] = multiply_add_limb(&m_product[i], &m_modulus[0], m_size, m_product[i] * m_inverse);
+      limb* high = &m_product[m_size];
+      limb carry = add_limbs(high, high, &m_product[0], m_size);
+      // the high half is now less than 2n, so at most one subtraction brings it into range
+      if (carry || compare_limbs(high, &m_modulus[0], m_size) >= 0)
+        subtract_limbs(high, high, &m_modulus[0], m_size);
+      result.assign(high, high + m_size);
+    }
+  };
+
+  // reduction by division for an even modulus, where Montgomery reduction does not work
+  // values are held as trimmed magnitudes less than the modulus
+
+  class division_reduction
+  {
+  public:
+    division_reduction(const limb_vector& modulus) : m_modulus(modulus) {}
+
+    void convert(limb_vector& result, const limb_vector& value)
+    {
+      limb_vector quotient;
+      divide_magnitudes(value, m_modulus, quotient, result);
+    }
+
+    void revert(limb_vector& result, const limb_vector& value)
+    {
+      result = value;
+    }
+
+    void multiply(limb_vector& result, const limb_vector& left, const limb_vector& right)
+    {
+      m_product.resize(left.size() + right.size());
+      multiply_magnitudes(&m_product[0], &left[0], left.size(), &right[0], right.size());
+      trim_magnitude(m_product);
+      divide_magnitudes(m_product, m_modulus, m_quotient, result);
+    }
+
+    void square(limb_vector& result, const limb_vector& value)
+    {
+      m_product.resize(2 * value.size());
+      square_magnitude(&m_product[0], &value[0], value.size());
+      trim_magnitude(m_product);
+      divide_magnitudes(m_product, m_modulus, m_quotient, result);
+    }
+
+  private:
+    const limb_vector& m_modulus;
+    limb_vector m_product;
+    limb_vector m_quotient;
+  };
 
-  // removes leading bytes that don't contribute to the value to create the minimum string representation
-  static void reduce_string(std::string& data)
-  {
-    while(data.size() > 1 &&
-          ((byte(data[data.size()-1]) == byte(0) && byte(data[data.size()-2]) < byte(128)) ||
-           (byte(data[data.size()-1]) == byte(255) && byte(data[data.size()-2]) >= byte(128))))
+  // result = base^exponent mod n, where base < n and the reduction has been given n
+  // This uses sliding windows of exponent bits: every odd power of the base that fits in a window is
+  // calculated in advance, then each window of the exponent costs one multiplication instead of
+  // one per set bit, with a squaring per bit as usual.
+  template<typename R>
+  static void power_magnitude(R& reduction, const limb_vector& base, const limb_vector& exponent, limb_vector& result)
+  {
+    // the exponent is trimmed so only zero has a zero top limb
+    size_t bits = 0;
+    if (exponent.back() != 0)
+      bits = exponent.size() * limb_bits - leading_zeros(exponent.back());
+    // the window size that minimises the total number of multiplications for this size of exponent
+    unsigned window = bits > 1024 ? 6 : bits > 256 ? 5 : bits > 64 ? 4 : bits > 16 ? 3 : bits > 4 ? 2 : 1;
+    // powers[i] is base^(2i+1)
+    std::vector<limb_vector> powers(size_t(1) << (window - 1));
+    reduction.convert(powers[0], base);
+    if (powers.size() > 1)
+    {
+      limb_vector base_squared;
+      reduction.square(base_squared, powers[0]);
+      for (size_t i = 1; i < powers.size(); i++)
+        reduction.multiply(powers[i], powers[i-1], base_squared);
+    }
+    // work from the msb of the exponent down, starting from one
+    limb_vector one(1, 1);
+    limb_vector power;
+    reduction.convert(power, one);
+    bool started = false;
+    for (size_t i = bits; i > 0; )
     {
-      data.erase(data.end()-1);
+      if (!limb_bit(exponent, i-1))
+      {
+        reduction.square(power, power);
+        i--;
+        continue;
+      }
+      // the window runs from bit i-1 down to the lowest set bit within the window size
+      size_t low = i > window ? i - window : 0;
+      while (!limb_bit(exponent, low))
+        low++;
+      size_t index = 0;
+      for (size_t j = i; j-- > low; )
+        index = (index << 1) | (limb_bit(exponent, j) ? 1 : 0);
+      // the first window just sets the value, saving the squarings of one
+      if (!started)
+        power = powers[index >> 1];
+      else
+      {
+        for (size_t j = low; j < i; j++)
+          reduction.square(power, power);
+        reduction.multiply(power, power, powers[index >> 1]);
+      }
+      started = true;
+      i = low;
     }
+    reduction.revert(result, power);
   }
 
+  ////////////////////////////////////////////////////////////////////////////////
   // generic implementations of type conversions from integer type to internal representation
   // data: integer value for conversion
   // result: internal representation
+  // bytes: size of the internal representation
+
+  // all the C integer types fit in a single limb
 
   template <typename T>
-  static void convert_from_signed(const T& data, std::string& result)
+  static void convert_from_signed(const T& data, limb_vector& result, unsigned& bytes)
   {
-    result.erase();
-    bool lsb_first = little_endian();
-    byte* address = (byte*)&data;
-    for (size_t i = 0; i < sizeof(T); i++)
-    {
-      size_t offset = (lsb_first ? i : (sizeof(T) - i - 1));
-      result.append(1,address[offset]);
-    }
-    reduce_string(result);
+    // converting to the unsigned limb sign-extends the value
+    result.assign(1, limb(data));
+    reduce_limbs(result, bytes);
   }
 
   template <typename T>
-  static void convert_from_unsigned(const T& data, std::string& result)
+  static void convert_from_unsigned(const T& data, limb_vector& result, unsigned& bytes)
   {
-    result.erase();
-    bool lsb_first = little_endian();
-    byte* address = (byte*)&data;
-    for (size_t i = 0; i < sizeof(T); i++)
-    {
-      size_t offset = (lsb_first ? i : (sizeof(T) - i - 1));
-      result.append(1,address[offset]);
-    }
+    result.assign(1, limb(data));
     // inf is signed - so there is a possible extra sign bit to add
-    result.append(1,std::string::value_type(0));
-    reduce_string(result);
+    result.push_back(0);
+    reduce_limbs(result, bytes);
   }
 
   // generic implementations of type conversions from internal representation to an integer type
-  // data : string representation of integer
+  // data : internal representation
+  // bytes: size of the internal representation
   // result: integer result of conversion
   // return: flag indicating success - false = overflow
 
   template <class T>
-  bool convert_to_signed(const std::string& data, T& result)
+  bool convert_to_signed(const limb_vector& data, unsigned bytes, T& result)
   {
-    bool lsb_first = little_endian();
-    byte* address = (byte*)&result;
-    for (size_t i = 0; i < sizeof(T); i++)
-    {
-      size_t offset = lsb_first ? i : (sizeof(T) - i - 1);
-      if (i < data.size())
-        address[offset] = byte(data[i]);
-      else if (data.empty() || (byte(data[data.size()-1]) < byte(128)))
-        address[offset] = byte(0);
-      else
-        address[offset] = byte(255);
-    }
-    return data.size() <= sizeof(T);
+    // the limb is already sign-extended to its full width, so this simply truncates it
+    result = T(data[0]);
+    return bytes <= sizeof(T);
   }
 
   template <class T>
-  bool convert_to_unsigned(const std::string& data, T& result)
+  bool convert_to_unsigned(const limb_vector& data, unsigned bytes, T& result)
   {
-    bool lsb_first = little_endian();
-    byte* address = (byte*)&result;
-    for (size_t i = 0; i < sizeof(T); i++)
-    {
-      size_t offset = lsb_first ? i : (sizeof(T) - i - 1);
-      if (i < data.size())
-        address[offset] = byte(data[i]);
-      else
-        address[offset] = byte(0);
-    }
-    return data.size() <= sizeof(T);
+    // the bytes beyond the size of the value are treated as zeros, not as sign bits
+    limb value = data[0];
+    if (bytes < limb_bytes)
+      value &= ~(limb_max << (8 * bytes));
+    result = T(value);
+    return bytes <= sizeof(T);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -150,12 +1683,171 @@ namespace stlplus
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
   };
 
-  static void convert_to_string(const stlplus::inf& data, std::string& result, unsigned radix = 10)
+  ////////////////////////////////////////////////////////////////////////////////
+  // decimal conversion of magnitudes
+  // The digits are converted 19 at a time, since 10^19 is the largest power of ten that fits in a
+  // limb, so each pass over the value is a division or multiplication by 10^19 rather than by 10.
+  // Large values are split in two by dividing by a power 10^(19*2^k), or joined by multiplying by
+  // one, and the halves converted separately. This replaces the long run of passes over the whole
+  // value with a few large divisions or multiplications, which are the fast ones.
+  // The thresholds were tuned with tests/inf_benchmark
+
+  static const limb decimal_chunk = limb(1000000000) * limb(1000000000) * limb(10);
+  static const unsigned decimal_chunk_digits = 19;
+  static const size_t decimal_to_string_threshold = 16;
+  static const size_t decimal_from_string_threshold = 600;
+  static const size_t reciprocal_division_threshold = 500;
+
+  // add the next power 10^(19*2^k) to the table, where each one is the square of the one before
+  static void next_decimal_power(std::vector<limb_vector>& powers)
+  {
+    if (powers.empty())
+    {
+      powers.push_back(limb_vector(1, decimal_chunk));
+      return;
+    }
+    limb_vector square(2 * powers.back().size());
+    square_magnitude(&square[0], &powers.back()[0], powers.back().size());
+    trim_magnitude(square);
+    powers.push_back(square);
+  }
+
+  // a power of 10^19 used to split a value in two
+  // Algorithm D costs the product of the sizes of the quotient and the power, so it is used for small
+  // powers and short quotients. Otherwise the power is normalised and its reciprocal calculated, the first
+  // time it is needed, and the reciprocal is kept for the other values split by the same power.
+  class decimal_divisor
+  {
+  public:
+    explicit decimal_divisor(const limb_vector& power) : m_power(power), m_shift(0) {}
+
+    // the value must be less than the square of the power
+    void divide(const limb_vector& value, limb_vector& quotient, limb_vector& remainder)
+    {
+      size_t size = m_power.size();
+      if (size < reciprocal_division_threshold || value.size() < size + size / 2)
+      {
+        divide_magnitudes(value, m_power, quotient, remainder);
+        return;
+      }
+      if (m_reciprocal.empty())
+      {
+        m_shift = leading_zeros(m_power.back());
+        m_normalised.resize(size);
+        shift_left_limbs(&m_normalised[0], &m_power[0], size, m_shift);
+        reciprocal_magnitude(m_normalised, m_reciprocal);
+      }
+      // dividing the value shifted by the same amount as the power gives the same quotient and a shifted remainder
+      limb_vector shifted(value.size() + 1);
+      shifted.back() = shift_left_limbs(&shifted[0], &value[0], value.size(), m_shift);
+      trim_magnitude(shifted);
+      divide_by_reciprocal(shifted, m_normalised, m_reciprocal, quotient, remainder);
+      shift_right_limbs(&remainder[0], &remainder[0], remainder.size(), m_shift);
+      trim_magnitude(remainder);
+    }
+
+  private:
+    limb_vector m_power;
+    unsigned m_shift;
+    limb_vector m_normalised;
+    limb_vector m_reciprocal;
+  };
+
+  // append the decimal digits of the magnitude, which must be less than powers[level]^2
+  // if pad is set the digits are padded with leading zeros to the 2*19*2^level digits of that square
+  // the value is used as workspace
+  static void magnitude_to_decimal(limb_vector& value, std::vector<decimal_divisor>& powers, size_t level, bool pad, std::string& result)
+  {
+    if (level == 0 || value.size() < decimal_to_string_threshold)
+    {
+      // generate the digits lsd first by dividing by 10^19 then reverse them into place
+      size_t start = result.size();
+      while (value.size() > 1 || value[0] != 0)
+      {
+        limb chunk = divide_limb(&value[0], &value[0], value.size(), decimal_chunk);
+        trim_magnitude(value);
+        for (unsigned i = 0; i < decimal_chunk_digits; i++)
+        {
+          result += to_char[chunk % 10];
+          chunk /= 10;
+        }
+      }
+      if (pad)
+        result.resize(start + (decimal_chunk_digits << (level + 1)), '0');
+      else
+      {
+        while (result.size() > start && result[result.size()-1] == '0')
+          result.erase(result.size()-1);
+        if (result.size() == start)
+          result += '0';
+      }
+      std::reverse(result.begin() + start, result.end());
+      return;
+    }
+    limb_vector quotient;
+    limb_vector remainder;
+    powers[level].divide(value, quotient, remainder);
+    value.clear();
+    if (pad || quotient.size() > 1 || quotient[0] != 0)
+    {
+      magnitude_to_decimal(quotient, powers, level-1, pad, result);
+      pad = true;
+    }
+    magnitude_to_decimal(remainder, powers, level-1, pad, result);
+  }
+
+  // the magnitude of a string of decimal digits, which must all be valid
+  static void decimal_to_magnitude(const char* digits, size_t count, const std::vector<limb_vector>& powers, limb_vector& result)
+  {
+    if (count < decimal_from_string_threshold)
+    {
+      // multiply by 10^19 and add in the next 19 digits, starting with the odd digits at the msd end
+      result.assign(1, 0);
+      for (size_t i = 0; i < count; )
+      {
+        size_t end = i + (count - i - 1) % decimal_chunk_digits + 1;
+        limb chunk = 0;
+        limb scale = 1;
+        for ( ; i < end; i++)
+        {
+          chunk = chunk * 10 + (limb)(digits[i] - '0');
+          scale *= 10;
+        }
+        limb carry = multiply_limb(&result[0], &result[0], result.size(), scale);
+        for (size_t j = 0; chunk && j < result.size(); j++)
+        {
+          result[j] += chunk;
+          chunk = result[j] < chunk;
+        }
+        carry += chunk;
+        if (carry)
+          result.push_back(carry);
+      }
+      return;
+    }
+    // split off the largest number of low digits 19*2^k that leaves some high digits
+    size_t level = 0;
+    while ((decimal_chunk_digits << (level + 1)) < count)
+      level++;
+    size_t low_count = decimal_chunk_digits << level;
+    limb_vector high;
+    limb_vector low;
+    decimal_to_magnitude(digits, count - low_count, powers, high);
+    decimal_to_magnitude(digits + count - low_count, low_count, powers, low);
+    // result = high * 10^low_count + low
+    const limb_vector& power = powers[level];
+    result.resize(high.size() + power.size());
+    multiply_magnitudes(&result[0], &high[0], high.size(), &power[0], power.size());
+    result.push_back(0);
+    add_into(&result[0], result.size(), 0, &low[0], low.size());
+    trim_magnitude(result);
+  }
+
+  static void convert_to_string(const limb_vector& data, std::string& result, unsigned radix = 10)
   {
     // only support the C-style radixes plus 0b for binary
     if (radix != 2 && radix != 8 && radix != 10 && radix != 16)
       throw std::invalid_argument("invalid radix value");
-    inf local_i = data;
     // untangle all the options
     bool binary = radix == 2;
     bool octal = radix == 8;
@@ -167,8 +1859,8 @@ namespace stlplus
       // bit-pattern representation
       // this is the binary representation optionally shown in octal or hex
       // first generate the binary by masking the bits
-      for (unsigned j = local_i.bits(); j--; )
-        result += (local_i.bit(j) ? '1' : '0');
+      for (unsigned j = significant_bits(data); j--; )
+        result += (limb_bit(data, j) ? '1' : '0');
       // the result is now the full width of the type - e.g. int will give a 32-bit result
       // now interpret this as either binary, octal or hex and add the prefix
       if (binary)
@@ -348,32 +2040,31 @@ namespace stlplus
       // convert to sign-magnitude
       // the representation is:
       // [sign]magnitude
-      bool negative = local_i.negative();
-      local_i.abs();
-      // create a representation of the magnitude by successive division
-      inf inf_radix(radix);
-      do
-      {
-        std::pair<inf,inf> divided = local_i.divide(inf_radix);
-        unsigned remainder = divided.second.to_unsigned();
-        char digit = to_char[remainder];
-        result.insert((std::string::size_type)0, 1, digit);
-        local_i = divided.first;
-      }
-      while(!local_i.zero());
-      // add the prefixes
+      limb_vector magnitude;
+      bool negative = to_magnitude(data, magnitude);
       // add a sign only for negative values
       if (negative)
-        result.insert((std::string::size_type)0, 1, '-');
+        result += '-';
+      // a large value is split using powers of 10^19 - the last one must have a square larger than the value
+      std::vector<decimal_divisor> divisors;
+      if (magnitude.size() >= decimal_to_string_threshold)
+      {
+        std::vector<limb_vector> powers;
+        do
+          next_decimal_power(powers);
+        while (2 * powers.back().size() - 2 < magnitude.size());
+        for (size_t i = 0; i < powers.size(); i++)
+          divisors.push_back(decimal_divisor(powers[i]));
+      }
+      magnitude_to_decimal(magnitude, divisors, divisors.empty() ? 0 : divisors.size() - 1, false, result);
     }
   }
 
   ////////////////////////////////////////////////////////////////////////////////
   // Conversions FROM string
 
-  void convert_from_string(const std::string& str, inf& result, unsigned radix = 10)
+  static void convert_from_string(const std::string& str, limb_vector& result, unsigned& bytes, unsigned radix = 10)
   {
-    result = 0;
     // only support the C-style radixes plus 0b for binary
     // a radix of 0 means deduce the radix from the input - assume 10
     if (radix != 0 && radix != 2 && radix != 8 && radix != 10 && radix != 16)
@@ -526,9 +2217,17 @@ namespace stlplus
         }
       }
       // now convert the value
-      result.resize(static_cast<unsigned>(binary.size()));
-      for (unsigned j = 0; j < binary.size(); j++)
-        result.preset(static_cast<unsigned>(binary.size()) - j - 1, binary[j] == '1');
+      // the size is the bit pattern rounded up to whole bytes and the sign is the msb of the last byte
+      size_t size = maximum(binary.size(), (size_t)1);
+      bytes = (unsigned)((size + 7) / 8);
+      result.assign((bytes + limb_bytes - 1) / limb_bytes, 0);
+      for (size_t j = 0; j < binary.size(); j++)
+        if (binary[j] == '1')
+        {
+          size_t index = binary.size() - j - 1;
+          result[index / limb_bits] |= limb(1) << (index % limb_bits);
+        }
+      extend_sign(result, 8 * (size_t)bytes);
     }
     else
     {
@@ -548,76 +2247,82 @@ namespace stlplus
           break;
         }
       }
-      for (; i < str.size(); i++)
+      // check the digits, then convert them all in one go
+      for (unsigned j = i; j < str.size(); j++)
       {
-        result *= inf(radix);
-        unsigned char ascii = (unsigned char)str[i];
+        unsigned char ascii = (unsigned char)str[j];
         int ch = from_char[ascii] ;
-        if (ch == -1)
+        if (ch == -1 || ch >= (int)radix)
           throw std::invalid_argument("invalid decimal character in string " + str);
-        result += inf(ch);
       }
-      if (negative)
-        result.negate();
+      size_t count = str.size() - i;
+      // a long string is split using powers of 10^19, up to the largest with fewer digits than the string
+      std::vector<limb_vector> powers;
+      if (count >= decimal_from_string_threshold)
+        while ((decimal_chunk_digits << powers.size()) < count)
+          next_decimal_power(powers);
+      decimal_to_magnitude(str.data() + i, count, powers, result);
+      from_magnitude(result, negative);
+      reduce_limbs(result, bytes);
     }
   }
 
   ////////////////////////////////////////////////////////////////////////////////
   // constructors - mostly implemented in terms of the assignment operators
 
-  inf::inf(void)
+  inf::inf(void) : m_limbs(1, limb(0)), m_bytes(1)
   {
     // void constructor initialises to zero - represented as a single-byte value containing zero
-    m_data.append(1,std::string::value_type(0));
   }
 
-  inf::inf(short r)
+  inf::inf(short r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf(unsigned short r)
+  inf::inf(unsigned short r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf(int r)
+  inf::inf(int r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf(unsigned r)
+  inf::inf(unsigned r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf(long r)
+  inf::inf(long r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf(unsigned long r)
+  inf::inf(unsigned long r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf (const std::string& r)
+  inf::inf (const std::string& r) : m_bytes(1)
   {
     operator=(r);
   }
 
-  inf::inf(const inf& r)
+  inf::inf(const inf& r) : m_limbs(r.m_limbs), m_bytes(r.m_bytes)
   {
-#ifdef __BORLANDC__
-    // work round bug in Borland compiler - copy constructor fails if string
-    // contains null characters, so do my own copy
-    for (unsigned i = 0; i < r.m_data.size(); i++)
-      m_data += r.m_data[i];
-#else
-    m_data = r.m_data;
-#endif
   }
 
+#ifdef STLPLUS_HAS_CXX11
+
+  inf::inf(inf&& r) STLPLUS_NOEXCEPT : m_limbs(1, limb(0)), m_bytes(1)
+  {
+    swap(r);
+  }
+
+#endif
+
   ////////////////////////////////////////////////////////////////////////////////
 
   inf::~inf(void)
@@ -629,58 +2334,74 @@ namespace stlplus
 
   inf& inf::operator = (short r)
   {
-    convert_from_signed(r, m_data);
+    convert_from_signed(r, m_limbs, m_bytes);
     return *this;
   }
 
   inf& inf::operator = (unsigned short r)
   {
-    convert_from_unsigned(r, m_data);
+    convert_from_unsigned(r, m_limbs, m_bytes);
     return *this;
   }
 
   inf& inf::operator = (int r)
   {
-    convert_from_signed(r, m_data);
+    convert_from_signed(r, m_limbs, m_bytes);
     return *this;
   }
 
   inf& inf::operator = (unsigned r)
   {
-    convert_from_unsigned(r, m_data);
+    convert_from_unsigned(r, m_limbs, m_bytes);
     return *this;
   }
 
   inf& inf::operator = (long r)
   {
-    convert_from_signed(r, m_data);
+    convert_from_signed(r, m_limbs, m_bytes);
     return *this;
   }
 
   inf& inf::operator = (unsigned long r)
   {
-    convert_from_unsigned(r, m_data);
+    convert_from_unsigned(r, m_limbs, m_bytes);
     return *this;
   }
 
   inf& inf::operator = (const std::string& r)
   {
-    convert_from_string(r, *this);
-    return *this;
+    return from_string(r, 10);
   }
 
   inf& inf::operator = (const inf& r)
   {
-    m_data = r.m_data;
+    m_limbs = r.m_limbs;
+    m_bytes = r.m_bytes;
+    return *this;
+  }
+
+#ifdef STLPLUS_HAS_CXX11
+
+  inf& inf::operator = (inf&& r) STLPLUS_NOEXCEPT
+  {
+    swap(r);
     return *this;
   }
 
+#endif
+
+  void inf::swap(inf& r)
+  {
+    m_limbs.swap(r.m_limbs);
+    std::swap(m_bytes, r.m_bytes);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 
   short inf::to_short(bool truncate) const
   {
     short result = 0;
-    if (!convert_to_signed(m_data, result))
+    if (!convert_to_signed(m_limbs, m_bytes, result))
       if (!truncate)
         throw std::overflow_error("stlplus::inf::to_short");
     return result;
@@ -689,7 +2410,7 @@ namespace stlplus
   unsigned short inf::to_unsigned_short(bool truncate) const
   {
     unsigned short result = 0;
-    if (!convert_to_unsigned(m_data, result))
+    if (!convert_to_unsigned(m_limbs, m_bytes, result))
       if (!truncate)
         throw std::overflow_error("stlplus::inf::to_unsigned_short");
     return result;
@@ -698,7 +2419,7 @@ namespace stlplus
   int inf::to_int(bool truncate) const
   {
     int result = 0;
-    if (!convert_to_signed(m_data, result))
+    if (!convert_to_signed(m_limbs, m_bytes, result))
       if (!truncate)
         throw std::overflow_error("stlplus::inf::to_int");
     return result;
@@ -707,7 +2428,7 @@ namespace stlplus
   unsigned inf::to_unsigned(bool truncate) const
   {
     unsigned result = 0;
-    if (!convert_to_unsigned(m_data, result))
+    if (!convert_to_unsigned(m_limbs, m_bytes, result))
       if (!truncate)
         throw std::overflow_error("stlplus::inf::to_unsigned");
     return result;
@@ -716,7 +2437,7 @@ namespace stlplus
   long inf::to_long(bool truncate) const
   {
     long result = 0;
-    if (!convert_to_signed(m_data, result))
+    if (!convert_to_signed(m_limbs, m_bytes, result))
       if (!truncate)
         throw std::overflow_error("stlplus::inf::to_long");
     return result;
@@ -725,7 +2446,7 @@ namespace stlplus
   unsigned long inf::to_unsigned_long(bool truncate) const
   {
     unsigned long result = 0;
-    if (!convert_to_unsigned(m_data, result))
+    if (!convert_to_unsigned(m_limbs, m_bytes, result))
       if (!truncate)
         throw std::overflow_error("stlplus::inf::to_unsigned_long");
     return result;
@@ -738,16 +2459,19 @@ namespace stlplus
   {
     if (bits == 0) bits = 1;
     unsigned bytes = (bits+7)/8;
-    byte extend = negative() ? byte(255) : byte (0);
-    while(bytes > m_data.size())
-      m_data.append(1,extend);
+    if (bytes > m_bytes)
+    {
+      // the limbs are already sign-extended, so any new ones are just the extension
+      m_limbs.resize((bytes + limb_bytes - 1) / limb_bytes, sign_extension(m_limbs));
+      m_bytes = bytes;
+    }
   }
 
   // reduce the bit count to the minimum needed to preserve the value
 
   void inf::reduce(void)
   {
-    reduce_string(m_data);
+    reduce_limbs(m_limbs, m_bytes);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -758,11 +2482,7 @@ namespace stlplus
     // The number of significant bits in the integer value - this is the number
     // of indexable bits less any redundant sign bits at the msb
     // This does not assume that the inf has been reduced to its minimum form
-    unsigned result = indexable_bits();
-    bool sign = bit(result-1);
-    while (result > 1 && (sign == bit(result-2)))
-      result--;
-    return result;
+    return significant_bits(m_limbs);
   }
 
   unsigned inf::size(void) const
@@ -772,7 +2492,7 @@ namespace stlplus
 
   unsigned inf::indexable_bits (void) const
   {
-    return 8 * unsigned(m_data.size());
+    return 8 * m_bytes;
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -782,10 +2502,7 @@ namespace stlplus
   {
     if (index >= indexable_bits())
       throw std::out_of_range(std::string("stlplus::inf::bit"));
-    // first split the offset into byte offset and bit offset
-    unsigned byte_offset = index/8;
-    unsigned bit_offset = index%8;
-    return (byte(m_data[byte_offset]) & (byte(1) << bit_offset)) != 0;
+    return limb_bit(m_limbs, index);
   }
 
   bool inf::operator [] (unsigned index) const
@@ -797,20 +2514,20 @@ namespace stlplus
   {
     if (index >= indexable_bits())
       throw std::out_of_range(std::string("stlplus::inf::set"));
-    // first split the offset into byte offset and bit offset
-    unsigned byte_offset = index/8;
-    unsigned bit_offset = index%8;
-    m_data[byte_offset] |= (byte(1) << bit_offset);
+    m_limbs[index / limb_bits] |= limb(1) << (index % limb_bits);
+    // changing the sign bit changes the sign extension too
+    if (index == indexable_bits() - 1)
+      extend_sign(m_limbs, indexable_bits());
   }
 
   void inf::clear (unsigned index)
   {
     if (index >= indexable_bits())
       throw std::out_of_range(std::string("stlplus::inf::clear"));
-    // first split the offset into byte offset and bit offset
-    unsigned byte_offset = index/8;
-    unsigned bit_offset = index%8;
-    m_data[byte_offset] &= (~(byte(1) << bit_offset));
+    m_limbs[index / limb_bits] &= ~(limb(1) << (index % limb_bits));
+    // changing the sign bit changes the sign extension too
+    if (index == indexable_bits() - 1)
+      extend_sign(m_limbs, indexable_bits());
   }
 
   void inf::preset (unsigned index, bool value)
@@ -830,15 +2547,14 @@ namespace stlplus
     inf result;
     if (high >= low)
     {
-      // create a result the right size and filled with sign bits
-      std::string::size_type result_size = (high-low+1+7)/8;
-      result.m_data.erase();
-      byte extend = bit(high) ? byte(255) : byte (0);
-      while (result.m_data.size() < result_size)
-        result.m_data.append(1,extend);
-      // now set the relevant bits
-      for (unsigned i = low; i <= high; i++)
-        result.preset(i-low, bit(i));
+      // create a result the right size, copy the bits a limb at a time, then fill above them with the sign
+      unsigned width = high-low+1;
+      result.m_bytes = (width+7)/8;
+      result.m_limbs.resize((result.m_bytes + limb_bytes - 1) / limb_bytes);
+      limb extend = sign_extension(m_limbs);
+      for (size_t i = 0; i < result.m_limbs.size(); i++)
+        result.m_limbs[i] = extract_limb(m_limbs, low + i * limb_bits, extend);
+      extend_sign(result.m_limbs, width);
     }
     return result;
   }
@@ -848,7 +2564,7 @@ namespace stlplus
 
   bool inf::negative (void) const
   {
-    return bit(indexable_bits()-1);
+    return sign_extension(m_limbs) != 0;
   }
 
   bool inf::natural (void) const
@@ -863,8 +2579,8 @@ namespace stlplus
 
   bool inf::zero (void) const
   {
-    for (std::string::size_type i = 0; i < m_data.size(); i++)
-      if (m_data[i] != 0)
+    for (size_t i = 0; i < m_limbs.size(); i++)
+      if (m_limbs[i] != 0)
         return false;
     return true;
   }
@@ -886,18 +2602,9 @@ namespace stlplus
   {
     // Two infs are equal if they are numerically equal, even if they are
     // different sizes (i.e. they could be non-reduced values).
-    // This makes life a little more complicated than if I could assume that values were reduced.
-    byte l_extend = negative() ? byte(255) : byte (0);
-    byte r_extend = r.negative() ? byte(255) : byte (0);
-    std::string::size_type bytes = maximum(m_data.size(),r.m_data.size());
-    for (std::string::size_type i = bytes; i--; )
-    {
-      byte l_byte = (i < m_data.size() ? byte(m_data[i]) : l_extend);
-      byte r_byte = (i < r.m_data.size() ? byte(r.m_data[i]) : r_extend);
-      if (l_byte != r_byte)
-        return false;
-    }
-    return true;
+    if (single_limbs(m_limbs, r.m_limbs))
+      return m_limbs[0] == r.m_limbs[0];
+    return compare_values(m_limbs, r.m_limbs) == 0;
   }
 
   bool inf::operator != (const inf& r) const
@@ -909,8 +2616,8 @@ namespace stlplus
   {
     // This could be implemented in terms of subtraction. However, it can be
     // simplified since there is no need to calculate the accurate difference,
-    // just the direction of the difference. I compare from msB down and as
-    // soon as a byte difference is found, that defines the ordering. The
+    // just the direction of the difference. I compare from msL down and as
+    // soon as a limb difference is found, that defines the ordering. The
     // problem is that in 2's-complement, all negative values are greater than
     // all natural values if you just do a straight unsigned comparison. I
     // handle this by doing a preliminary test for different signs.
@@ -929,31 +2636,9 @@ namespace stlplus
     // However, the bit patterns for the negative values are *greater than*
     // the natural values. This is a side-effect of the naffness of
     // 2's-complement representation
-
-    // first handle the case of comparing two values with different signs
-    bool l_sign = negative();
-    bool r_sign = r.negative();
-    if (l_sign != r_sign)
-    {
-      // one argument must be negative and the other natural
-      // the left is less if it is the negative one
-      return l_sign;
-    }
-    // the arguments are the same sign
-    // so the ordering is a simple unsigned byte-by-byte comparison
-    // However, this is complicated by the possibility that the values could be different lengths
-    byte l_extend = l_sign ? byte(255) : byte (0);
-    byte r_extend = r_sign ? byte(255) : byte (0);
-    std::string::size_type bytes = maximum(m_data.size(),r.m_data.size());
-    for (std::string::size_type i = bytes; i--; )
-    {
-      byte l_byte = (i < m_data.size() ? byte(m_data[i]) : l_extend);
-      byte r_byte = (i < r.m_data.size() ? byte(r.m_data[i]) : r_extend);
-      if (l_byte != r_byte)
-        return l_byte < r_byte;
-    }
-    // if I get here, the two are equal, so that is not less-than
-    return false;
+    if (single_limbs(m_limbs, r.m_limbs))
+      return signed_order(m_limbs[0]) < signed_order(r.m_limbs[0]);
+    return compare_values(m_limbs, r.m_limbs) < 0;
   }
 
   bool inf::operator <= (const inf& r) const
@@ -976,8 +2661,9 @@ namespace stlplus
 
   inf& inf::invert (void)
   {
-    for (std::string::size_type i = 0; i < m_data.size(); i++)
-      m_data[i] = ~m_data[i];
+    // inverting the sign extension as well keeps it consistent
+    for (size_t i = 0; i < m_limbs.size(); i++)
+      m_limbs[i] = ~m_limbs[i];
     return *this;
   }
 
@@ -991,19 +2677,7 @@ namespace stlplus
   inf& inf::operator &= (const inf& r)
   {
     // bitwise AND is extended to the length of the largest argument
-    byte l_extend = negative() ? byte(255) : byte (0);
-    byte r_extend = r.negative() ? byte(255) : byte (0);
-    std::string::size_type bytes = maximum(m_data.size(),r.m_data.size());
-    for (std::string::size_type i = 0; i < bytes; i++)
-    {
-      byte l_byte = (i < m_data.size() ? byte(m_data[i]) : l_extend);
-      byte r_byte = (i < r.m_data.size() ? byte(r.m_data[i]) : r_extend);
-      byte result = l_byte & r_byte;
-      if (i < m_data.size())
-        m_data[i] = result;
-      else
-        m_data.append(1,result);
-    }
+    logic_values(m_limbs, r.m_limbs, logic_and);
     // now reduce the result
     reduce();
     return *this;
@@ -1019,19 +2693,7 @@ namespace stlplus
   inf& inf::operator |= (const inf& r)
   {
     // bitwise OR is extended to the length of the largest argument
-    byte l_extend = negative() ? byte(255) : byte (0);
-    byte r_extend = r.negative() ? byte(255) : byte (0);
-    std::string::size_type bytes = maximum(m_data.size(),r.m_data.size());
-    for (std::string::size_type i = 0; i < bytes; i++)
-    {
-      byte l_byte = (i < m_data.size() ? byte(m_data[i]) : l_extend);
-      byte r_byte = (i < r.m_data.size() ? byte(r.m_data[i]) : r_extend);
-      byte result = l_byte | r_byte;
-      if (i < m_data.size())
-        m_data[i] = result;
-      else
-        m_data.append(1,result);
-    }
+    logic_values(m_limbs, r.m_limbs, logic_or);
     // now reduce the result
     reduce();
     return *this;
@@ -1047,19 +2709,7 @@ namespace stlplus
   inf& inf::operator ^= (const inf& r)
   {
     // bitwise XOR is extended to the length of the largest argument
-    byte l_extend = negative() ? byte(255) : byte (0);
-    byte r_extend = r.negative() ? byte(255) : byte (0);
-    std::string::size_type bytes = maximum(m_data.size(),r.m_data.size());
-    for (std::string::size_type i = 0; i < bytes; i++)
-    {
-      byte l_byte = (i < m_data.size() ? byte(m_data[i]) : l_extend);
-      byte r_byte = (i < r.m_data.size() ? byte(r.m_data[i]) : r_extend);
-      byte result = l_byte ^ r_byte;
-      if (i < m_data.size())
-        m_data[i] = result;
-      else
-        m_data.append(1,result);
-    }
+    logic_values(m_limbs, r.m_limbs, logic_xor);
     // now reduce the result
     reduce();
     return *this;
@@ -1072,38 +2722,22 @@ namespace stlplus
     return result;
   }
 
-  ////////////////////////////////////////////////////////////////////////////////
-  // shift operators all preserve the value by increasing the word size
-
   inf& inf::operator <<= (unsigned shift)
   {
-    // left shift is a shift towards the msb, with 0s being shifted in at the lsb
-    // split this into a byte shift followed by a bit shift
-
-    // first expand the value to be big enough for the result
-    std::string::size_type new_size = (indexable_bits() + shift + 7) / 8;
-    byte extend = negative() ? byte(255) : byte (0);
-    while (m_data.size() < new_size)
-      m_data.append(1,extend);
-    // now do the byte shift
-    unsigned byte_shift = shift/8;
-    if (byte_shift > 0)
-    {
-      for (std::string::size_type b = new_size; b--; )
-        m_data[b] = (b >= byte_shift) ? m_data[b-byte_shift] : byte(0);
-    }
-    // and finally the bit shift
-    unsigned bit_shift = shift%8;
-    if (bit_shift > 0)
+    // move whole limbs first by inserting zero limbs at the lsL end, with an extra limb at the msL end for the bits shifted out
+    size_t limb_shift = shift / limb_bits;
+    unsigned bit_shift = shift % limb_bits;
+    m_limbs.push_back(sign_extension(m_limbs));
+    m_limbs.insert(m_limbs.begin(), limb_shift, limb(0));
+    // then shift the remaining bits working from the msL down
+    if (bit_shift != 0)
     {
-      for (std::string::size_type b = new_size; b--; )
+      for (size_t i = m_limbs.size(); i-- > limb_shift; )
       {
-        byte current = byte(m_data[b]);
-        byte previous = b > 0 ? m_data[b-1] : byte(0);
-        m_data[b] = (current << bit_shift) | (previous >> (8 - bit_shift));
+        limb carry = i > limb_shift ? m_limbs[i-1] >> (limb_bits - bit_shift) : limb(0);
+        m_limbs[i] = (m_limbs[i] << bit_shift) | carry;
       }
     }
-    // now reduce the result
     reduce();
     return *this;
   }
@@ -1117,31 +2751,19 @@ namespace stlplus
 
   inf& inf::operator >>= (unsigned shift)
   {
-    // right shift is a shift towards the lsb, with sign bits being shifted in at the msb
-    // split this into a byte shift followed by a bit shift
-
-    // a byte of sign bits
-    byte extend = negative() ? byte(255) : byte (0);
-    // do the byte shift
-    unsigned byte_shift = shift/8;
-    if (byte_shift > 0)
-    {
-      for (std::string::size_type b = 0; b < m_data.size(); b++)
-        m_data[b] = (b + byte_shift < m_data.size()) ? m_data[b+byte_shift] : extend;
-    }
-    // and finally the bit shift
-    unsigned bit_shift = shift%8;
-    if (bit_shift > 0)
+    // arithmetic shift right - the sign is shifted in at the msb
+    limb extend = sign_extension(m_limbs);
+    size_t limb_shift = shift / limb_bits;
+    if (limb_shift >= m_limbs.size())
+      m_limbs.assign(1, extend);
+    else
     {
-      for (std::string::size_type b = 0; b < m_data.size(); b++)
-      {
-        byte current = byte(m_data[b]);
-        byte next = ((b+1) < m_data.size()) ? m_data[b+1] : extend;
-        byte shifted = (current >> bit_shift) | (next << (8 - bit_shift));
-        m_data[b] = shifted;
-      }
+      // each limb of the result only depends on limbs at the same or higher positions, so this can be done in place
+      size_t size = m_limbs.size() - limb_shift;
+      for (size_t i = 0; i < size; i++)
+        m_limbs[i] = extract_limb(m_limbs, shift + i * limb_bits, extend);
+      m_limbs.resize(size);
     }
-    // now reduce the result
     reduce();
     return *this;
   }
@@ -1154,14 +2776,15 @@ namespace stlplus
   }
 
   ////////////////////////////////////////////////////////////////////////////////
-  // negation operators
+  // arithmetic operators
 
   inf& inf::negate (void)
   {
     // do 2's-complement negation
-    // equivalent to inversion plus one
-    invert();
-    operator += (inf(1));
+    // this needs an extra limb because the negation of the most negative value is positive
+    m_limbs.push_back(sign_extension(m_limbs));
+    negate_limbs(&m_limbs[0], m_limbs.size());
+    reduce();
     return *this;
   }
 
@@ -1185,36 +2808,23 @@ namespace stlplus
     return result;
   }
 
-  ////////////////////////////////////////////////////////////////////////////////
-  // addition operators
-
   inf& inf::operator += (const inf& r)
   {
-    // do 2's-complement addition
-    // Note that the addition can give a result that is larger than either argument
-    byte carry = 0;
-    std::string::size_type max_size = maximum(m_data.size(),r.m_data.size());
-    byte l_extend = negative() ? byte(255) : byte (0);
-    byte r_extend = r.negative() ? byte(255) : byte (0);
-    for (std::string::size_type i = 0; i < max_size; i++)
-    {
-      byte l_byte = (i < m_data.size() ? byte(m_data[i]) : l_extend);
-      byte r_byte = (i < r.m_data.size() ? byte(r.m_data[i]) : r_extend);
-      // calculate the addition in a type that is bigger than a byte in order to catch the carry-out
-      unsigned short result = ((unsigned short)(l_byte)) + ((unsigned short)(r_byte)) + carry;
-      // now truncate the result to get the lsB
-      if (i < m_data.size())
-        m_data[i] = byte(result);
-      else
-        m_data.append(1,byte(result));
-      // and capture the carry out by grabbing the second byte of the result
-      carry = byte(result >> 8);
-    }
-    // if the result overflowed or underflowed, add an extra byte to catch it
-    unsigned short result = ((unsigned short)(l_extend)) + ((unsigned short)(r_extend)) + carry;
-    if (byte(result) != (negative() ? byte(255) : byte(0)))
-      m_data.append(1,byte(result));
-    // now reduce the result
+    if (single_limbs(m_limbs, r.m_limbs))
+    {
+      // the sum overflows if both arguments have the same sign and the sum has the other sign
+      limb left = m_limbs[0];
+      limb right = r.m_limbs[0];
+      limb sum = left + right;
+      m_limbs[0] = sum;
+      if (((left ^ sum) & (right ^ sum)) >> (limb_bits - 1))
+        m_limbs.push_back(overflow_extension(sum));
+    }
+    else
+    {
+      // 2's complement addition, one limb at a time with carry
+      add_values(m_limbs, r.m_limbs, false);
+    }
     reduce();
     return *this;
   }
@@ -1226,14 +2836,24 @@ namespace stlplus
     return result;
   }
 
-  ////////////////////////////////////////////////////////////////////////////////
-  // subtraction operators
-
   inf& inf::operator -= (const inf& r)
   {
-    // subtraction is defined in terms of negation and addition
-    inf negated = -r;
-    operator += (negated);
+    if (single_limbs(m_limbs, r.m_limbs))
+    {
+      // the difference overflows if the arguments have different signs and the difference has the sign of the right
+      limb left = m_limbs[0];
+      limb right = r.m_limbs[0];
+      limb difference = left - right;
+      m_limbs[0] = difference;
+      if (((left ^ right) & (left ^ difference)) >> (limb_bits - 1))
+        m_limbs.push_back(overflow_extension(difference));
+    }
+    else
+    {
+      // subtraction is implemented as addition of the 2's complement of the right, done one limb at a time
+      add_values(m_limbs, r.m_limbs, true);
+    }
+    reduce();
     return *this;
   }
 
@@ -1244,39 +2864,141 @@ namespace stlplus
     return result;
   }
 
-  ////////////////////////////////////////////////////////////////////////////////
-  // multiplication operators
-
   inf& inf::operator *= (const inf& r)
   {
-    // 2's complement multiplication
-    // one day I'll do a more efficient version than this based on the underlying representation
-    inf left(*this);
-    inf right = r;
-    // make the right value natural but preserve its sign for later
-    bool right_negative = right.negative();
-    right.abs();
-    // implemented as a series of conditional additions
-    operator = (0);
-    //  left.resize(right.bits() + left.bits() - 1);
-    left <<= right.bits()-1;
-    for (unsigned i = right.bits(); i--; )
-    {
-      if (right[i])
-        operator += (left);
-      left >>= 1;
-    }
-    if (right_negative)
-      negate();
-    // now reduce the result
-    reduce();
-    return *this;
+    return mul_into(*this, *this, r);
   }
 
   inf inf::operator * (const inf& r) const
   {
-    inf result(*this);
-    result *= r;
+    // the product is built in the result, so there is no need to copy this first
+    inf result;
+    mul_into(result, *this, r);
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // arithmetic on temporaries
+  // the temporary argument becomes the result, which is then moved out
+
+#ifdef STLPLUS_HAS_CXX11
+
+  inf operator + (inf&& left, const inf& right)
+  {
+    left += right;
+    return std::move(left);
+  }
+
+  inf operator + (const inf& left, inf&& right)
+  {
+    right += left;
+    return std::move(right);
+  }
+
+  inf operator + (inf&& left, inf&& right)
+  {
+    left += right;
+    return std::move(left);
+  }
+
+  inf operator - (inf&& left, const inf& right)
+  {
+    left -= right;
+    return std::move(left);
+  }
+
+  inf operator - (const inf& left, inf&& right)
+  {
+    right.negate();
+    right += left;
+    return std::move(right);
+  }
+
+  inf operator - (inf&& left, inf&& right)
+  {
+    left -= right;
+    return std::move(left);
+  }
+
+  inf operator * (inf&& left, const inf& right)
+  {
+    left *= right;
+    return std::move(left);
+  }
+
+  inf operator * (const inf& left, inf&& right)
+  {
+    right *= left;
+    return std::move(right);
+  }
+
+  inf operator * (inf&& left, inf&& right)
+  {
+    left *= right;
+    return std::move(left);
+  }
+
+#endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // fused multiplication
+
+  inf& mul_into(inf& result, const inf& left, const inf& right)
+  {
+    if (single_limbs(left.m_limbs, right.m_limbs))
+    {
+      // read the arguments first, since result can be one of them
+      limb left_limb = left.m_limbs[0];
+      limb right_limb = right.m_limbs[0];
+      multiply_single(left_limb, right_limb, result.m_limbs);
+    }
+    else if (&result == &left || &result == &right)
+    {
+      // multiply the magnitudes then fix up the sign
+      // x*(-y) == (-x)*y == -(x*y) and (-x)*(-y) == x*y
+      limb_vector product;
+      multiply_values(product, left.m_limbs, right.m_limbs);
+      result.m_limbs.swap(product);
+    }
+    else
+    {
+      // build the product in the result so that its memory is reused
+      multiply_values(result.m_limbs, left.m_limbs, right.m_limbs);
+    }
+    result.reduce();
+    return result;
+  }
+
+  inf& add_mul(inf& result, const inf& left, const inf& right)
+  {
+    if (single_limbs(left.m_limbs, right.m_limbs))
+    {
+      // the product of single limbs fits in the inline storage, so needs no memory
+      limb_vector product;
+      multiply_single(left.m_limbs[0], right.m_limbs[0], product);
+      add_values(result.m_limbs, product, false);
+    }
+    else if (&result == &left || &result == &right)
+      result += left * right;
+    else
+      multiply_accumulate(result.m_limbs, left.m_limbs, right.m_limbs, false);
+    result.reduce();
+    return result;
+  }
+
+  inf& sub_mul(inf& result, const inf& left, const inf& right)
+  {
+    if (single_limbs(left.m_limbs, right.m_limbs))
+    {
+      limb_vector product;
+      multiply_single(left.m_limbs[0], right.m_limbs[0], product);
+      add_values(result.m_limbs, product, true);
+    }
+    else if (&result == &left || &result == &right)
+      result -= left * right;
+    else
+      multiply_accumulate(result.m_limbs, left.m_limbs, right.m_limbs, true);
+    result.reduce();
     return result;
   }
 
@@ -1287,75 +3009,204 @@ namespace stlplus
   {
     if (right.zero())
       throw divide_by_zero("stlplus::inf::divide");
-    inf numerator(*this);
-    inf denominator = right;
-    // make the numerator natural but preserve the sign for later
-    bool numerator_negative = numerator.negative();
-    numerator.abs();
-    // same with the denominator
-    bool denominator_negative = denominator.negative();
-    denominator.abs();
-    // the quotient and remainder will form the result
-    // start with the quotiont zero and the remainder equal to the whole of the
-    // numerator, then do trial subtraction from this
-    inf quotient;
-    inf remainder = numerator;
-    // there's nothing more to do if the numerator is smaller than the denominator
-    // but otherwise do the division
-    if (numerator.bits() >= denominator.bits())
-    {
-      // make the quotient big enough to take the result
-      quotient.resize(numerator.bits());
-      // start with the numerator shifted to the far left
-      unsigned shift = numerator.bits() - denominator.bits();
-      denominator <<= shift;
-      // do the division by repeated subtraction,
-      for (unsigned i = shift+1; i--; )
-      {
-        if (remainder >= denominator)
-        {
-          remainder -= denominator;
-          quotient.set(i);
-        }
-        denominator >>= 1;
-      }
+    // divide the magnitudes but preserve the signs for later
+    // the results are built in place to avoid copying them
+    std::pair<inf,inf> result;
+    inf& quotient = result.first;
+    inf& remainder = result.second;
+    bool numerator_negative = false;
+    bool denominator_negative = false;
+    if (single_limbs(m_limbs, right.m_limbs))
+    {
+      // the magnitude of the most negative limb still fits in a limb when unsigned
+      limb numerator = m_limbs[0];
+      limb denominator = right.m_limbs[0];
+      numerator_negative = (numerator >> (limb_bits - 1)) != 0;
+      denominator_negative = (denominator >> (limb_bits - 1)) != 0;
+      if (numerator_negative) numerator = 0 - numerator;
+      if (denominator_negative) denominator = 0 - denominator;
+      quotient.m_limbs[0] = numerator / denominator;
+      remainder.m_limbs[0] = numerator % denominator;
+    }
+    else
+    {
+      limb_vector numerator;
+      limb_vector denominator;
+      numerator_negative = to_magnitude(m_limbs, numerator);
+      denominator_negative = to_magnitude(right.m_limbs, denominator);
+      divide_magnitudes(numerator, denominator, quotient.m_limbs, remainder.m_limbs);
     }
     // now adjust the signs
     // x/(-y) == (-x)/y == -(x/y)
-    if (numerator_negative != denominator_negative)
-      quotient.negate();
+    from_magnitude(quotient.m_limbs, numerator_negative != denominator_negative);
     quotient.reduce();
     // x%(-y) == x%y and (-x)%y == -(x%y)
-    if (numerator_negative)
-      remainder.negate();
+    from_magnitude(remainder.m_limbs, numerator_negative);
     remainder.reduce();
-    return std::pair<inf,inf>(quotient,remainder);
+    return result;
   }
 
   inf& inf::operator /= (const inf& r)
   {
     std::pair<inf,inf> result = divide(r);
-    operator=(result.first);
+    swap(result.first);
     return *this;
   }
 
   inf inf::operator / (const inf& r) const
   {
-    std::pair<inf,inf> result = divide(r);
-    return result.first;
+    inf result(*this);
+    result /= r;
+    return result;
   }
 
   inf& inf::operator %= (const inf& r)
   {
     std::pair<inf,inf> result = divide(r);
-    operator=(result.second);
+    swap(result.second);
     return *this;
   }
 
   inf inf::operator % (const inf& r) const
   {
-    std::pair<inf,inf> result = divide(r);
-    return result.second;
+    inf result(*this);
+    result %= r;
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // number theory
+
+  inf pow(const inf& base, unsigned exponent)
+  {
+    // square and multiply, working up from the lsb of the exponent
+    inf result(1);
+    inf square(base);
+    for (;;)
+    {
+      if (exponent & 1)
+        result *= square;
+      exponent >>= 1;
+      if (exponent == 0)
+        break;
+      square *= square;
+    }
+    return result;
+  }
+
+  inf powmod(const inf& base, const inf& exponent, const inf& modulus)
+  {
+    if (modulus.zero())
+      throw divide_by_zero("stlplus::powmod");
+    if (exponent.negative())
+      throw std::invalid_argument("stlplus::powmod: negative exponent");
+    // bring the base into the range 0 to abs(modulus)-1
+    inf natural_modulus = abs(modulus);
+    inf natural_base = base % natural_modulus;
+    if (natural_base.negative())
+      natural_base += natural_modulus;
+    limb_vector base_magnitude;
+    limb_vector exponent_magnitude;
+    limb_vector modulus_magnitude;
+    to_magnitude(natural_base.m_limbs, base_magnitude);
+    to_magnitude(exponent.m_limbs, exponent_magnitude);
+    to_magnitude(natural_modulus.m_limbs, modulus_magnitude);
+    inf result;
+    if (modulus_magnitude[0] & 1)
+    {
+      montgomery_reduction reduction(modulus_magnitude);
+      power_magnitude(reduction, base_magnitude, exponent_magnitude, result.m_limbs);
+    }
+    else
+    {
+      division_reduction reduction(modulus_magnitude);
+      power_magnitude(reduction, base_magnitude, exponent_magnitude, result.m_limbs);
+    }
+    from_magnitude(result.m_limbs, false);
+    result.reduce();
+    return result;
+  }
+
+  inf gcd(const inf& left, const inf& right)
+  {
+    // Euclid's algorithm on the magnitudes, finishing in single limbs once the values are small enough
+    limb_vector larger;
+    limb_vector smaller;
+    limb_vector quotient;
+    limb_vector remainder;
+    to_magnitude(left.m_limbs, larger);
+    to_magnitude(right.m_limbs, smaller);
+    while (smaller.size() > 1)
+    {
+      divide_magnitudes(larger, smaller, quotient, remainder);
+      larger.swap(smaller);
+      smaller.swap(remainder);
+    }
+    if (smaller[0] != 0)
+    {
+      divide_magnitudes(larger, smaller, quotient, remainder);
+      limb a = smaller[0];
+      limb b = remainder[0];
+      while (b != 0)
+      {
+        limb next = a % b;
+        a = b;
+        b = next;
+      }
+      larger.assign(1, a);
+    }
+    inf result;
+    result.m_limbs.swap(larger);
+    from_magnitude(result.m_limbs, false);
+    result.reduce();
+    return result;
+  }
+
+  inf modinv(const inf& value, const inf& modulus)
+  {
+    if (modulus.zero())
+      throw divide_by_zero("stlplus::modinv");
+    // the extended Euclid's algorithm, keeping only the cofactor of the value
+    // the cofactors alternate in sign so only their magnitudes are kept, with a flag for the sign of the current one
+    inf natural_modulus = abs(modulus);
+    inf natural_value = value % natural_modulus;
+    if (natural_value.negative())
+      natural_value += natural_modulus;
+    limb_vector larger;
+    limb_vector smaller;
+    limb_vector quotient;
+    limb_vector remainder;
+    to_magnitude(natural_modulus.m_limbs, larger);
+    to_magnitude(natural_value.m_limbs, smaller);
+    limb_vector cofactor(1, 0);
+    limb_vector next_cofactor(1, 1);
+    limb_vector product;
+    bool cofactor_negative = true;
+    while (smaller.size() > 1 || smaller[0] != 0)
+    {
+      divide_magnitudes(larger, smaller, quotient, remainder);
+      larger.swap(smaller);
+      smaller.swap(remainder);
+      // the new cofactor is cofactor - quotient*next_cofactor, which in magnitudes is a sum
+      product.resize(quotient.size() + next_cofactor.size() + 1);
+      multiply_magnitudes(&product[0], &quotient[0], quotient.size(), &next_cofactor[0], next_cofactor.size());
+      product.back() = 0;
+      add_into(&product[0], product.size(), 0, &cofactor[0], cofactor.size());
+      trim_magnitude(product);
+      cofactor.swap(next_cofactor);
+      next_cofactor.swap(product);
+      cofactor_negative = !cofactor_negative;
+    }
+    // larger is now the gcd, which must be one for there to be an inverse
+    if (larger.size() != 1 || larger[0] != 1)
+      throw std::invalid_argument("stlplus::modinv: value has no inverse");
+    inf result;
+    result.m_limbs.swap(cofactor);
+    from_magnitude(result.m_limbs, false);
+    result.reduce();
+    if (cofactor_negative && result.non_zero())
+      result = natural_modulus - result;
+    return result;
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -1394,13 +3245,18 @@ namespace stlplus
 
   {
     std::string result;
-    convert_to_string(*this, result, radix);
+    convert_to_string(m_limbs, result, radix);
     return result;
   }
 
   inf& inf::from_string(const std::string& value, unsigned radix)
   {
-    convert_from_string(value, *this, radix);
+    // convert into a local value so that this is unchanged if the conversion fails
+    limb_vector limbs;
+    unsigned bytes = 1;
+    convert_from_string(value, limbs, bytes, radix);
+    m_limbs.swap(limbs);
+    m_bytes = bytes;
     return *this;
   }
 
@@ -1418,7 +3274,7 @@ namespace stlplus
       // generate the string representation then print it
       str << i.to_string(radix);
     }
-    catch(const std::invalid_argument)
+    catch(const std::invalid_argument&)
     {
       str.setstate(std::ios_base::badbit);
     }
@@ -1441,7 +3297,7 @@ namespace stlplus
       // and convert to inf
       i.from_string(image, radix);
     }
-    catch(const std::invalid_argument)
+    catch(const std::invalid_argument&)
     {
       str.setstate(std::ios_base::badbit);
     }
@@ -1456,9 +3312,9 @@ namespace stlplus
   {
     // create this dump in the human-readable form, i.e. msB to the left
     std::string result = "0x";
-    for (std::string::size_type i = m_data.size(); i--; )
+    for (unsigned i = m_bytes; i--; )
     {
-      byte current = m_data[i];
+      byte current = limb_byte(m_limbs, i);
       byte msB = (current & byte(0xf0)) >> 4;
       result += to_char[msB];
       byte lsB = (current & byte(0x0f));
@@ -1467,14 +3323,26 @@ namespace stlplus
     return result;
   }
 
-  const std::string& inf::get_bytes(void) const
+  ////////////////////////////////////////////////////////////////////////////////
+  // the byte representation, which is the persistent form
+
+  std::string inf::get_bytes(void) const
   {
-    return m_data;
+    std::string result;
+    result.reserve(m_bytes);
+    for (unsigned i = 0; i < m_bytes; i++)
+      result += std::string::value_type(limb_byte(m_limbs, i));
+    return result;
   }
 
   void inf::set_bytes(const std::string& data)
   {
-    m_data = data;
+    // an empty string is treated as a zero
+    m_bytes = maximum((unsigned)data.size(), 1u);
+    m_limbs.assign((m_bytes + limb_bytes - 1) / limb_bytes, limb(0));
+    for (size_t i = 0; i < data.size(); i++)
+      m_limbs[i / limb_bytes] |= limb(byte(data[i])) << (8 * (i % limb_bytes));
+    extend_sign(m_limbs, 8 * (size_t)m_bytes);
   }
 
 } // end namespace stlplus
@@ -29,6 +29,7 @@
 #include "portability_fixes.hpp"
 #include "portability_exceptions.hpp"
 #include <string>
+#include <vector>
 #include <iostream>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +59,10 @@ namespace stlplus
     // exceptions: std::invalid_argument
     explicit inf(const std::string&) ;
     inf(const inf&);
+#ifdef STLPLUS_HAS_CXX11
+    // the moved-from inf is left as zero
+    inf(inf&&) STLPLUS_NOEXCEPT;
+#endif
 
     ~inf(void);
 
@@ -72,6 +77,12 @@ namespace stlplus
     // exceptions: std::invalid_argument
     inf& operator = (const std::string&) ;
     inf& operator = (const inf&);
+#ifdef STLPLUS_HAS_CXX11
+    inf& operator = (inf&&) STLPLUS_NOEXCEPT;
+#endif
+
+    // exchange values without copying
+    void swap(inf&);
 
     //////////////////////////////////////////////////////////////////////////////
     // conversions back to the C types
@@ -198,6 +209,38 @@ namespace stlplus
     // exceptions: divide_by_zero
     std::pair<inf,inf> divide(const inf&) const ;
 
+    //////////////////////////////////////////////////////////////////////////////
+    // fused arithmetic
+    // these work directly in the result, so they do not create a temporary for the product
+    // the result can be the same inf as either argument
+
+    // result = left * right, reusing the memory of the result
+    friend inf& mul_into(inf& result, const inf& left, const inf& right);
+
+    // result += left * right
+    friend inf& add_mul(inf& result, const inf& left, const inf& right);
+
+    // result -= left * right
+    friend inf& sub_mul(inf& result, const inf& left, const inf& right);
+
+    //////////////////////////////////////////////////////////////////////////////
+    // number theory
+    // the modular functions use the magnitude of the modulus and always give a natural result less than it
+
+    // raise to a power
+    friend inf pow(const inf& base, unsigned exponent);
+
+    // modular exponentiation - (base to the power exponent) % modulus
+    // exceptions: divide_by_zero, std::invalid_argument (if the exponent is negative)
+    friend inf powmod(const inf& base, const inf& exponent, const inf& modulus) ;
+
+    // greatest common divisor, which is always natural
+    friend inf gcd(const inf&, const inf&);
+
+    // modular inverse - the value x such that (value * x) % modulus == 1
+    // exceptions: divide_by_zero, std::invalid_argument (if there is no inverse)
+    friend inf modinv(const inf& value, const inf& modulus) ;
+
     //////////////////////////////////////////////////////////////////////////////
     // pre- and post- increment and decrement
 
@@ -223,10 +266,74 @@ namespace stlplus
     inf& from_string(const std::string&, unsigned radix = 0);
 
     //////////////////////////////////////////////////////////////////////////////
+    // internal representation
+    // the value is held in 2's-complement as an array of machine words (limbs), lsL first
+    typedef unsigned long long limb;
+
+    // the array of limbs - this is like a std::vector<limb> except that values of up
+    // to two limbs (128 bits) are held inside the object, so only larger values
+    // allocate memory on the heap
+    class limb_vector
+    {
+    public:
+      typedef limb* iterator;
+      typedef const limb* const_iterator;
+
+      limb_vector(void);
+      explicit limb_vector(size_t size, limb value = 0);
+      limb_vector(const limb* first, const limb* last);
+      limb_vector(const limb_vector&);
+      limb_vector& operator = (const limb_vector&);
+#ifdef STLPLUS_HAS_CXX11
+      limb_vector(limb_vector&&) STLPLUS_NOEXCEPT;
+      limb_vector& operator = (limb_vector&&) STLPLUS_NOEXCEPT;
+#endif
+      ~limb_vector(void);
+
+      size_t size(void) const;
+      bool empty(void) const;
+      limb& operator [] (size_t index);
+      const limb& operator [] (size_t index) const;
+      limb& back(void);
+      const limb& back(void) const;
+      iterator begin(void);
+      const_iterator begin(void) const;
+      iterator end(void);
+      const_iterator end(void) const;
+
+      void resize(size_t size, limb value = 0);
+      void assign(size_t size, limb value);
+      void assign(const limb* first, const limb* last);
+      void push_back(limb value);
+      void pop_back(void);
+      // the inserted range must not be part of this vector
+      void insert(iterator position, size_t count, limb value);
+      void insert(iterator position, const limb* first, const limb* last);
+      void erase(iterator first, iterator last);
+      void clear(void);
+      void swap(limb_vector&);
+
+      bool operator == (const limb_vector&) const;
+      bool operator != (const limb_vector&) const;
+
+    private:
+      enum {inline_size = 2};
+      limb* m_data;
+      unsigned m_size;
+      unsigned m_capacity;
+      limb m_inline[inline_size];
+
+      void reserve(size_t capacity);
+      void take(limb_vector&);
+    };
+
   private:
-    std::string m_data;
+    limb_vector m_limbs;
+    unsigned m_bytes;
+
   public:
-    const std::string& get_bytes(void) const;
+    // the value as a string of bytes, lsB first, used by the persistence routines
+    std::string get_bytes(void) const;
     void set_bytes(const std::string&);
   };
 
@@ -234,6 +341,30 @@ namespace stlplus
   // redefine friends for gcc v4.1
 
   inf abs(const inf&);
+  inf& mul_into(inf& result, const inf& left, const inf& right);
+  inf& add_mul(inf& result, const inf& left, const inf& right);
+  inf& sub_mul(inf& result, const inf& left, const inf& right);
+  inf pow(const inf& base, unsigned exponent);
+  inf powmod(const inf& base, const inf& exponent, const inf& modulus);
+  inf gcd(const inf&, const inf&);
+  inf modinv(const inf& value, const inf& modulus);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // arithmetic on temporaries
+  // when an argument is a temporary, such as the result of another operator, its memory is reused
+  // for the result, so a chain of operations like a*b + c*d - e only creates temporaries for the products
+
+#ifdef STLPLUS_HAS_CXX11
+  inf operator + (inf&& left, const inf& right);
+  inf operator + (const inf& left, inf&& right);
+  inf operator + (inf&& left, inf&& right);
+  inf operator - (inf&& left, const inf& right);
+  inf operator - (const inf& left, inf&& right);
+  inf operator - (inf&& left, inf&& right);
+  inf operator * (inf&& left, const inf& right);
+  inf operator * (const inf& left, inf&& right);
+  inf operator * (inf&& left, inf&& right);
+#endif
 
   ////////////////////////////////////////////////////////////////////////////////
 
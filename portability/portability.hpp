@@ -16,6 +16,7 @@
 #include "dprintf.hpp"
 #include "dynaload.hpp"
 #include "file_system.hpp"
+#include "fixed_inf.hpp"
 #include "inf.hpp"
 #include "subprocesses.hpp"
 #include "tcp_sockets.hpp"
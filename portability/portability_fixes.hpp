@@ -65,6 +65,42 @@ unsigned sleep(unsigned seconds);
 #include <unistd.h>
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+// Rules for testing whether this compiler has C++11 features (especially move semantics)
+// These are the same rules as in the other libraries' fixes headers
+////////////////////////////////////////////////////////////////////////////////
+
+// gcc
+// C++11 mode is switched on from the command line using the -std=c++11 flag and that sets the following macro
+#if defined(__GNUC__) && (__cplusplus > 201100)
+#define STLPLUS_HAS_CXX11 1
+#endif
+
+// Visual Studio
+// Microsoft only incorporated the extensions in their C++11 form from Visual Studio 2010 (v16.00)
+#if defined(_MSC_VER) && (_MSC_VER >= 1600)
+#define STLPLUS_HAS_CXX11 1
+#endif
+
+// Borland
+// Add support as soon as it becomes available which I think is Dinkumware v505
+#if defined(__BORLANDC__) && (__BORLANDC__ >= 0x631)
+#include <yvals.h>
+#if defined(_CPPLIB_VER) && (_CPPLIB_VER >= 505)
+#define STLPLUS_HAS_CXX11 1
+#endif
+#endif
+
+// move constructors must be declared noexcept for the STL containers to use them
+// but Visual Studio only supports the keyword from Visual Studio 2015 (v19.00)
+#ifdef STLPLUS_HAS_CXX11
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+#define STLPLUS_NOEXCEPT throw()
+#else
+#define STLPLUS_NOEXCEPT noexcept
+#endif
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // Function for establishing endian-ness
 ////////////////////////////////////////////////////////////////////////////////
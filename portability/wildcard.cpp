@@ -12,20 +12,23 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "wildcard.hpp"
+#include <algorithm>
 
 namespace stlplus
 {
 
-  // function for testing whether a character matches a set
+  ////////////////////////////////////////////////////////////////////////////////
+  // compilation of sets
+
   // I can't remember the exact rules and I have no definitive references but:
   // a set contains characters, escaped characters (I think) and ranges in the form a-z
   // The character '-' can only appear at the start of the set where it is not interpreted as a range
   // This is a horrible mess - blame the Unix folks for making a hash of wildcards
   // first expand any ranges and remove escape characters to make life more palatable
+  // returns false if the set is malformed, in which case it matches nothing
 
-  static bool match_set (const std::string& set, char match)
+  static bool expand_set (const std::string& set, std::string& simple_set)
   {
-    std::string simple_set;
     for (std::string::const_iterator i = set.begin(); i != set.end(); ++i)
     {
       switch(*i)
@@ -42,12 +45,15 @@ namespace stlplus
         }
         else
         {
-          // found a set. The first character is already in the result, so first remove it (the set might be empty)
-          simple_set.erase(simple_set.end()-1);
+          // found a range. The first character is already in the result, so first remove it (the range might be empty)
+          // it may already have been removed as the end of an empty range, e.g. z-a-c
+          if (!simple_set.empty())
+            simple_set.erase(simple_set.end()-1);
+          char first = *(i-1);
           char last = *++i;
-          for (char ch = *(i-2); ch <= last; ch++)
+          for (int ch = first; ch <= last; ch++)
           {
-            simple_set += ch;
+            simple_set += (char)ch;
           }
         }
         break;
@@ -61,104 +67,495 @@ namespace stlplus
         break;
       }
     }
-    std::string::size_type result = simple_set.find(match);
-    return result != std::string::npos;
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // compiled wildcard expression
+
+  // Each element of the expression - a character, ?, * or a set - becomes a state which
+  // matches one character. A * matches any character and can then loop to match any
+  // number more. The states active after each character are held as one bit per state,
+  // so a character is matched against every state at once: each active state moves on
+  // to the next if that state can match the character, and an active * state also stays
+  // where it is. The states that match a character are looked up via its class, where
+  // characters that are treated the same way by every state share a class.
+
+  wildcard_pattern::wildcard_pattern(void) :
+    m_valid(true), m_loops(false), m_states(0), m_words(0)
+  {
+    compile(std::string());
+  }
+
+  wildcard_pattern::wildcard_pattern(const std::string& wild) :
+    m_valid(true), m_loops(false), m_states(0), m_words(0)
+  {
+    compile(wild);
   }
 
-  // the recursive bit - basically whenever a * is found you recursively call this for each candidate substring match
-  // until either it succeeds or you run out of string to match
-  // for each * in the wildcard another level of recursion is created
+  // parse the element of the expression starting at position i and move past it
+  // ? and * match any character, otherwise if set is given it is filled in with the characters matched
+  // returns false if the expression is malformed
 
-  static bool match_remainder (const std::string& wild, std::string::const_iterator wildi, const std::string& match, std::string::const_iterator matchi)
+  static bool parse_element(const std::string& wild, std::string::size_type& i, bool& any, bool& loop, std::string* set)
   {
-    //cerr << "match_remainder called at " << *matchi << " with wildcard " << *wildi << endl;
-    while (wildi != wild.end() && matchi != match.end())
+    any = false;
+    loop = false;
+    switch(wild[i])
     {
-      //cerr << "trying to match " << *matchi << " with wildcard " << *wildi << endl;
-      switch(*wildi)
+    case '*':
+      loop = true;
+      any = true;
+      ++i;
+      return true;
+    case '?':
+      any = true;
+      ++i;
+      return true;
+    case '[':
+    {
+      // scan for the end of the set using a similar method for avoiding escaped characters
+      for (std::string::size_type end = i + 1; end < wild.size(); ++end)
       {
-      case '*':
+        switch(wild[end])
+        {
+        case ']':
+        {
+          // found the set, now expand its contents excluding the brackets - a malformed set matches nothing
+          if (set && !expand_set(wild.substr(i + 1, end - i - 1), *set))
+            set->erase();
+          i = end + 1;
+          return true;
+        }
+        case '\\':
+          if (end == wild.size()-1)
+            return false;
+          ++end;
+          break;
+        default:
+          break;
+        }
+      }
+      return false;
+    }
+    case '\\':
+      if (i == wild.size()-1)
+        return false;
+      if (set) *set += wild[i+1];
+      i += 2;
+      return true;
+    default:
+      if (set) *set += wild[i];
+      ++i;
+      return true;
+    }
+  }
+
+  void wildcard_pattern::compile(const std::string& wild)
+  {
+    m_expression = wild;
+    m_valid = true;
+    m_loops = false;
+    m_states = 0;
+    m_words = 0;
+    m_masks.clear();
+    m_loop.clear();
+    for (unsigned ch = 0; ch < 256; ch++)
+      m_classes[ch] = 0;
+    // first count the states so that the size of a mask is known
+    bool any = false;
+    bool loop = false;
+    for (std::string::size_type i = 0; i < wild.size(); m_states++)
+    {
+      if (!parse_element(wild, i, any, loop, 0))
       {
-        ++wildi;
-        ++matchi;
-        for (std::string::const_iterator i = matchi; i != match.end(); ++i)
+        m_valid = false;
+        m_states = 0;
+        return;
+      }
+    }
+    // now give each character that appears in the expression its own class with a mask of the states that
+    // match it - class 0 is all the other characters, which are only matched by ? and *
+    const unsigned word_bits = 8 * sizeof(word);
+    m_words = (m_states + word_bits - 1) / word_bits;
+    m_masks.reserve(m_words * (wild.size() < 256 ? wild.size() + 1 : 257));
+    m_masks.assign(m_words, 0);
+    m_loop.assign(m_words, 0);
+    std::string set;
+    std::string::size_type i = 0;
+    for (unsigned state = 0; state < m_states; state++)
+    {
+      word bit = (word)1 << (state % word_bits);
+      unsigned w = state / word_bits;
+      set.erase();
+      parse_element(wild, i, any, loop, &set);
+      if (any)
+        m_masks[w] |= bit;
+      if (loop)
+      {
+        m_loop[w] |= bit;
+        m_loops = true;
+      }
+      for (std::string::size_type c = 0; c < set.size(); c++)
+      {
+        unsigned short& char_class = m_classes[(unsigned char)set[c]];
+        if (char_class == 0)
         {
-          // deal with * at the end of the wildcard - there is no remainder then
-          if (wildi == wild.end())
-          {
-            if (i == match.end()-1)
-              return true;
-          }
-          else if (match_remainder(wild, wildi, match, i))
-          {
-            return true;
-          }
+          char_class = (unsigned short)(m_masks.size() / m_words);
+          m_masks.resize(m_masks.size() + m_words, 0);
         }
+        m_masks[char_class * m_words + w] |= bit;
+      }
+    }
+    // finally the states that match any character are added to every other class
+    for (std::vector<word>::size_type m = m_words; m < m_masks.size(); m++)
+      m_masks[m] |= m_masks[m % m_words];
+  }
+
+  const std::string& wildcard_pattern::expression(void) const
+  {
+    return m_expression;
+  }
+
+  bool wildcard_pattern::valid(void) const
+  {
+    return m_valid;
+  }
+
+  bool wildcard_pattern::match(const std::string& match) const
+  {
+    return this->match(match.data(), match.data() + match.size());
+  }
+
+  bool wildcard_pattern::match(const char* begin, const char* end) const
+  {
+    if (!m_valid)
+      return false;
+    // every state consumes at least one character, and without a * exactly one
+    std::size_t length = end - begin;
+    if (length < m_states || (!m_loops && length != m_states))
+      return false;
+    if (m_states == 0)
+      return true;
+    const unsigned word_bits = 8 * sizeof(word);
+    const unsigned last = m_words - 1;
+    const word final_bit = (word)1 << ((m_states - 1) % word_bits);
+    if (m_words == 1)
+    {
+      // the common case of up to 64 states is done in a single word
+      const word* masks = &m_masks[0];
+      const word loop = m_loop[0];
+      const bool final_loop = (loop & final_bit) != 0;
+      word states = masks[m_classes[(unsigned char)*begin]] & 1;
+      for (const char* i = begin + 1; i != end; ++i)
+      {
+        // once a final * has been reached it matches all the rest of the string
+        if (!states || (final_loop && (states & final_bit)))
+          break;
+        states = ((states << 1) & masks[m_classes[(unsigned char)*i]]) | (states & loop);
+      }
+      return (states & final_bit) != 0;
+    }
+    // longer expressions need a multi-word shift with carries between the words
+    std::vector<word> states(m_words, 0);
+    states[0] = m_masks[m_classes[(unsigned char)*begin] * m_words] & 1;
+    for (const char* i = begin + 1; i != end; ++i)
+    {
+      const word* masks = &m_masks[m_classes[(unsigned char)*i] * m_words];
+      word carry = 0;
+      bool any = false;
+      for (unsigned w = 0; w < m_words; w++)
+      {
+        word next_carry = states[w] >> (word_bits - 1);
+        states[w] = (((states[w] << 1) | carry) & masks[w]) | (states[w] & m_loop[w]);
+        carry = next_carry;
+        if (states[w]) any = true;
+      }
+      if (!any)
         return false;
+    }
+    return (states[last] & final_bit) != 0;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // compiled set of wildcard expressions
+
+  // The expressions are compiled in the same way as a single expression, except that the
+  // states of all of them are numbered consecutively to form one large automaton. The
+  // first state of each expression is only made active at the start of the string, so an
+  // expression never runs on into the next one. Before the automaton is run, the
+  // expressions which might match are found by looking up the first and last few
+  // characters of the string in an index of their literal prefixes and suffixes. These are
+  // checked against the length of the string and their full prefix and suffix and only
+  // the expressions that pass are started. The automaton is then only run over the
+  // words that hold their states.
+
+  // the number of characters of a literal prefix or suffix used to index an expression
+  static const std::string::size_type index_key = 4;
+
+  wildcard_set::wildcard_set(void)
+  {
+    clear();
+  }
+
+  wildcard_set::wildcard_set(const std::vector<std::string>& wilds)
+  {
+    clear();
+    for (std::vector<std::string>::size_type i = 0; i < wilds.size(); i++)
+      add(wilds[i]);
+  }
+
+  unsigned wildcard_set::add(const std::string& wild)
+  {
+    unsigned index = (unsigned)m_members.size();
+    m_members.push_back(member());
+    member& added = m_members.back();
+    added.m_expression = wild;
+    added.m_valid = true;
+    added.m_loops = false;
+    added.m_first = m_states;
+    added.m_states = 0;
+    // first count the states - a malformed expression has none and is never started
+    bool any = false;
+    bool loop = false;
+    for (std::string::size_type i = 0; i < wild.size(); added.m_states++)
+    {
+      if (!parse_element(wild, i, any, loop, 0))
+      {
+        added.m_valid = false;
+        added.m_states = 0;
+        return index;
+      }
+    }
+    // make room for the new states - the words per class are doubled so that adding many expressions
+    // one at a time doesn't have to copy the masks every time
+    const unsigned word_bits = 8 * sizeof(word);
+    unsigned words = (m_states + added.m_states + word_bits - 1) / word_bits;
+    if (words > m_words)
+    {
+      unsigned new_words = words > 2 * m_words ? words : 2 * m_words;
+      std::vector<word> masks(m_class_count * new_words, 0);
+      for (unsigned c = 0; c < m_class_count; c++)
+        for (unsigned w = 0; w < m_words; w++)
+          masks[c * new_words + w] = m_masks[c * m_words + w];
+      m_masks.swap(masks);
+      m_loop.resize(new_words, 0);
+      m_starts.resize(new_words, 0);
+      m_words = new_words;
+    }
+    // now add the states to the masks of the classes, as in wildcard_pattern::compile
+    // at the same time collect the runs of single characters at the start and end of the expression
+    bool literal_prefix = true;
+    std::string set;
+    std::string::size_type i = 0;
+    for (unsigned state = added.m_first; state < added.m_first + added.m_states; state++)
+    {
+      word bit = (word)1 << (state % word_bits);
+      unsigned w = state / word_bits;
+      set.erase();
+      parse_element(wild, i, any, loop, &set);
+      if (state == added.m_first)
+        m_starts[w] |= bit;
+      if (loop)
+      {
+        m_loop[w] |= bit;
+        added.m_loops = true;
       }
-      case '[':
+      if (any)
       {
-        // scan for the end of the set using a similar method for avoiding escaped characters
-        bool found = false;
-        std::string::const_iterator end = wildi + 1;
-        for (; !found && end != wild.end(); ++end)
+        // ? and * match every character, so the state is added to every class, including class 0
+        for (unsigned c = 0; c < m_class_count; c++)
+          m_masks[c * m_words + w] |= bit;
+      }
+      for (std::string::size_type c = 0; c < set.size(); c++)
+      {
+        unsigned short& char_class = m_classes[(unsigned char)set[c]];
+        if (char_class == 0)
         {
-          switch(*end)
-          {
-          case ']':
-          {
-            // found the set, now match with its contents excluding the brackets
-            if (!match_set(wild.substr(wildi - wild.begin() + 1, end - wildi - 1), *matchi))
-              return false;
-            found = true;
-            break;
-          }
-          case '\\':
-            if (end == wild.end()-1)
-              return false;
-            ++end;
-            break;
-          default:
-            break;
-          }
+          // a new class starts with the states that match any character, which are those of class 0
+          char_class = (unsigned short)m_class_count++;
+          m_masks.resize(m_class_count * m_words, 0);
+          for (unsigned m = 0; m < m_words; m++)
+            m_masks[char_class * m_words + m] = m_masks[m];
         }
-        if (!found)
-          return false;
-        ++matchi;
-        wildi = end;
-        break;
+        m_masks[char_class * m_words + w] |= bit;
       }
-      case '?':
-        ++wildi;
-        ++matchi;
-        break;
-      case '\\':
-        if (wildi == wild.end()-1)
-          return false;
-        ++wildi;
-        if (*wildi != *matchi)
-          return false;
-        ++wildi;
-        ++matchi;
-        break;
-      default:
-        if (*wildi != *matchi)
-          return false;
-        ++wildi;
-        ++matchi;
-        break;
+      if (!any && set.size() == 1)
+      {
+        if (literal_prefix)
+          added.m_prefix += set[0];
+        added.m_suffix += set[0];
+      }
+      else
+      {
+        literal_prefix = false;
+        added.m_suffix.erase();
+      }
+    }
+    m_states += added.m_states;
+    if (!added.m_suffix.empty())
+      m_suffixes[added.m_suffix.substr(added.m_suffix.size() - std::min(added.m_suffix.size(), index_key))].push_back(index);
+    else if (!added.m_prefix.empty())
+      m_prefixes[added.m_prefix.substr(0, index_key)].push_back(index);
+    else
+      m_unindexed.push_back(index);
+    return index;
+  }
+
+  void wildcard_set::clear(void)
+  {
+    m_members.clear();
+    m_states = 0;
+    m_words = 0;
+    m_class_count = 1;
+    for (unsigned ch = 0; ch < 256; ch++)
+      m_classes[ch] = 0;
+    m_masks.clear();
+    m_loop.clear();
+    m_starts.clear();
+    m_suffixes.clear();
+    m_prefixes.clear();
+    m_unindexed.clear();
+  }
+
+  unsigned wildcard_set::size(void) const
+  {
+    return (unsigned)m_members.size();
+  }
+
+  const std::string& wildcard_set::expression(unsigned index) const
+  {
+    return m_members[index].m_expression;
+  }
+
+  bool wildcard_set::valid(unsigned index) const
+  {
+    return m_members[index].m_valid;
+  }
+
+  bool wildcard_set::match(const std::string& match) const
+  {
+    return match_members(match.data(), match.data() + match.size(), 0);
+  }
+
+  bool wildcard_set::match(const char* begin, const char* end) const
+  {
+    return match_members(begin, end, 0);
+  }
+
+  bool wildcard_set::match(const std::string& match, std::vector<unsigned>& matches) const
+  {
+    return match_members(match.data(), match.data() + match.size(), &matches);
+  }
+
+  bool wildcard_set::match(const char* begin, const char* end, std::vector<unsigned>& matches) const
+  {
+    return match_members(begin, end, &matches);
+  }
+
+  // add the expressions under a key that the string starts or ends with
+  static void lookup(const std::map<std::string,std::vector<unsigned> >& index, const std::string& key, std::vector<unsigned>& candidates)
+  {
+    std::map<std::string,std::vector<unsigned> >::const_iterator found = index.find(key);
+    if (found != index.end())
+      candidates.insert(candidates.end(), found->second.begin(), found->second.end());
+  }
+
+  bool wildcard_set::match_members(const char* begin, const char* end, std::vector<unsigned>* matches) const
+  {
+    if (matches)
+      matches->clear();
+    const unsigned word_bits = 8 * sizeof(word);
+    std::size_t length = end - begin;
+    // find the expressions which might match from the indexes, then put them in order of their states
+    std::vector<unsigned> candidates(m_unindexed);
+    for (std::string::size_type key = 1; key <= index_key && key <= length; key++)
+    {
+      if (!m_suffixes.empty())
+        lookup(m_suffixes, std::string(end - key, end), candidates);
+      if (!m_prefixes.empty())
+        lookup(m_prefixes, std::string(begin, begin + key), candidates);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    // start the expressions that pass the checks on length, prefix and suffix and list the words that hold their states
+    // an empty expression has no states and only matches the empty string, which no other expression can match
+    bool result = false;
+    std::vector<unsigned> started;
+    std::vector<unsigned> words;
+    std::vector<word> states(m_words, 0);
+    for (std::vector<unsigned>::size_type c = 0; c < candidates.size(); c++)
+    {
+      const member& candidate = m_members[candidates[c]];
+      if (candidate.m_states == 0)
+      {
+        if (length == 0)
+        {
+          result = true;
+          if (!matches) return true;
+          matches->push_back(candidates[c]);
+        }
+        continue;
+      }
+      if (length < candidate.m_states || (!candidate.m_loops && length != candidate.m_states))
+        continue;
+      if (candidate.m_prefix.compare(0, std::string::npos, begin, candidate.m_prefix.size()) != 0)
+        continue;
+      if (candidate.m_suffix.compare(0, std::string::npos, end - candidate.m_suffix.size(), candidate.m_suffix.size()) != 0)
+        continue;
+      started.push_back(candidates[c]);
+      states[candidate.m_first / word_bits] |= (word)1 << (candidate.m_first % word_bits);
+      for (unsigned w = candidate.m_first / word_bits; w <= (candidate.m_first + candidate.m_states - 1) / word_bits; w++)
+        if (words.empty() || words.back() < w)
+          words.push_back(w);
+    }
+    if (started.empty())
+      return result;
+    // run the automaton over the words holding the started expressions - the states in all the other words are inactive
+    const word* masks = &m_masks[m_classes[(unsigned char)*begin] * m_words];
+    for (std::vector<unsigned>::size_type w = 0; w < words.size(); w++)
+      states[words[w]] &= masks[words[w]];
+    for (const char* i = begin + 1; i != end; ++i)
+    {
+      masks = &m_masks[m_classes[(unsigned char)*i] * m_words];
+      word carry = 0;
+      bool any = false;
+      for (std::vector<unsigned>::size_type w = 0; w < words.size(); w++)
+      {
+        // a carry can only come from the word before if that is also in use
+        unsigned s = words[w];
+        if (w > 0 && words[w-1] + 1 != s)
+          carry = 0;
+        word next_carry = states[s] >> (word_bits - 1);
+        states[s] = ((((states[s] << 1) | carry) & ~m_starts[s]) & masks[s]) | (states[s] & m_loop[s]);
+        carry = next_carry;
+        if (states[s]) any = true;
+      }
+      if (!any)
+        return result;
+    }
+    // the expressions that match are the ones whose final state is active at the end of the string
+    for (std::vector<unsigned>::size_type s = 0; s < started.size(); s++)
+    {
+      const member& candidate = m_members[started[s]];
+      unsigned final_state = candidate.m_first + candidate.m_states - 1;
+      if (states[final_state / word_bits] & ((word)1 << (final_state % word_bits)))
+      {
+        result = true;
+        if (!matches) return true;
+        matches->push_back(started[s]);
       }
     }
-    bool result = wildi == wild.end() && matchi == match.end();
     return result;
   }
 
-  // like all recursions the exported function has a simpler interface than the
-  // recursive function and is just a 'seed' to the recursion itself
+  ////////////////////////////////////////////////////////////////////////////////
+  // one-off matching just compiles the expression
 
   bool wildcard(const std::string& wild, const std::string& match)
   {
-    return match_remainder(wild, wild.begin(), match, match.begin());
+    return wildcard_pattern(wild).match(match);
   }
 
+  ////////////////////////////////////////////////////////////////////////////////
+
 } // end namespace stlplus
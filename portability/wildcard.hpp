@@ -9,27 +9,154 @@
 
 //   This is a portable interface to wildcard matching.
 
-//   The problem:
-//     *  matches any number of characters - this is achieved by matching 1 and seeing if the remainder matches
-//        if not, try 2 characters and see if the remainder matches etc.
-//        this must be recursive, not iterative, so that multiple *s can appear in the same wildcard expression
-//     ?  matches exactly one character so doesn't need the what-if approach
+//   The wildcard expression can contain:
+//     *  matches 1 or more characters
+//     ?  matches exactly one character
 //     \  escapes special characters such as *, ? and [
-//     [] matches exactly one character in the set - the difficulty is the set can contain ranges, e.g [a-zA-Z0-9]
-//        a set cannot be empty and the ] character can be included by making it the first character
+//     [] matches exactly one character in the set - the set can contain ranges, e.g [a-zA-Z0-9]
+//        the ] character can be included by escaping it
+
+//   The original implementation matched * by matching 1 character and then recursively trying
+//   every split point for the remainder, which is exponential for expressions like *a*a*a*b
+//   Now the expression is compiled once into a small automaton which is run over the string
+//   in a single pass - each element of the expression is a state, all the states are tracked
+//   together as the bits of a word and each character moves them all on with a few bit operations
+//   So the time to match is proportional to the length of the string whatever the expression
+
+//   A wildcard_set combines many expressions into one automaton so that a string is tested
+//   against all of them in a single pass, after first ruling out the expressions which can't
+//   match because of the string's length or their literal prefix or suffix - the expressions are
+//   indexed by a few characters of their prefix or suffix so that only the ones which might
+//   match are checked, so a set can contain thousands of expressions
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "portability_fixes.hpp"
 #include <string>
+#include <vector>
+#include <map>
 
 namespace stlplus
 {
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // a wildcard expression compiled for fast repeated matching
+
+  class wildcard_pattern
+  {
+  public:
+
+    // an empty expression, which matches only the empty string
+    wildcard_pattern(void);
+
+    // compile the wildcard expression
+    explicit wildcard_pattern(const std::string& wild);
+
+    // replace the expression with a new one
+    void compile(const std::string& wild);
+
+    // the expression that was compiled
+    const std::string& expression(void) const;
+
+    // a malformed expression, e.g. with an unterminated set or a trailing escape, never matches anything
+    bool valid(void) const;
+
+    // test a string against the expression
+    bool match(const std::string& match) const;
+    bool match(const char* begin, const char* end) const;
+
+  private:
+    typedef unsigned long long word;
+
+    std::string m_expression;
+    bool m_valid;
+    bool m_loops;                  // whether there are any * elements
+    unsigned m_states;             // the number of elements, each of which matches at least one character
+    unsigned m_words;              // the number of words needed to hold a bit per state
+    unsigned short m_classes[256]; // the class of each character - characters not in the expression are class 0
+    std::vector<word> m_masks;     // for each class, the states that can match it - m_words per class
+    std::vector<word> m_loop;      // the states that can match more than one character i.e. the * elements
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // a set of wildcard expressions compiled together so that a string can be tested against all of them at once
+
+  class wildcard_set
+  {
+  public:
+
+    // an empty set, which matches nothing
+    wildcard_set(void);
+
+    // compile a set of wildcard expressions
+    explicit wildcard_set(const std::vector<std::string>& wilds);
+
+    // add another expression, returning its index in the set
+    unsigned add(const std::string& wild);
+
+    // remove all the expressions
+    void clear(void);
+
+    // the number of expressions and the expression with each index
+    unsigned size(void) const;
+    const std::string& expression(unsigned index) const;
+
+    // a malformed expression never matches anything, as with wildcard_pattern
+    bool valid(unsigned index) const;
+
+    // test a string against all of the expressions, returning true if any of them match
+    bool match(const std::string& match) const;
+    bool match(const char* begin, const char* end) const;
+
+    // as above but also report the indexes of all the expressions that matched, in increasing order
+    bool match(const std::string& match, std::vector<unsigned>& matches) const;
+    bool match(const char* begin, const char* end, std::vector<unsigned>& matches) const;
+
+  private:
+    typedef unsigned long long word;
+
+    // each expression is a run of consecutive states in the combined automaton
+    // strings which can't match it are rejected before the automaton is run using its length and literal prefix and suffix
+    struct member
+    {
+      std::string m_expression;
+      bool m_valid;
+      bool m_loops;           // whether there are any * elements
+      unsigned m_first;       // the first state
+      unsigned m_states;      // the number of states, each of which matches at least one character
+      std::string m_prefix;   // the literal characters that must start the string
+      std::string m_suffix;   // the literal characters that must end the string
+    };
+
+    std::vector<member> m_members;
+    unsigned m_states;             // the total number of states of all the expressions
+    unsigned m_words;              // the number of words allocated per class, which may be more than needed
+    unsigned m_class_count;        // the number of classes in use
+    unsigned short m_classes[256]; // the class of each character - characters not in any expression are class 0
+    std::vector<word> m_masks;     // for each class, the states that can match it - m_words per class
+    std::vector<word> m_loop;      // the states that can match more than one character i.e. the * elements
+    std::vector<word> m_starts;    // the first state of each expression, which can't be reached from the state before it
+
+    // the expressions indexed by the end of their literal suffix, or failing that the start of their literal prefix
+    // so that only the expressions which might match a string need to be checked - the rest are unindexed
+    typedef std::map<std::string,std::vector<unsigned> > index;
+    index m_suffixes;
+    index m_prefixes;
+    std::vector<unsigned> m_unindexed;
+
+    bool match_members(const char* begin, const char* end, std::vector<unsigned>* matches) const;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // one-off matching
+
   // wild = the wildcard expression
   // match = the string to test against that expression
   // e.g. wildcard("[a-f]*", "fred") returns true
+  // when matching many strings against the same expression, compile it once with wildcard_pattern
   bool wildcard(const std::string& wild, const std::string& match);
 
+  ////////////////////////////////////////////////////////////////////////////////
+
 }
 
 #endif
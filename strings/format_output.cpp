@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "format_output.hpp"
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // appending to a string
+
+  void format_text(std::string& result, const std::string& text)
+  {
+    result += text;
+  }
+
+  void format_text(std::string& result, const char* text)
+  {
+    result += text;
+  }
+
+  void format_text(std::string& result, char ch)
+  {
+    result += ch;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // printing to a device
+
+  void format_text(std::ostream& device, const std::string& text)
+  {
+    device << text;
+  }
+
+  void format_text(std::ostream& device, const char* text)
+  {
+    device << text;
+  }
+
+  void format_text(std::ostream& device, char ch)
+  {
+    device.put(ch);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
@@ -0,0 +1,60 @@
+#ifndef STLPLUS_FORMAT_OUTPUT
+#define STLPLUS_FORMAT_OUTPUT
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Output primitives shared by the string formatting and print functions
+
+//   The formatting of each container is written once, as a format_<type>
+//   template that writes to an output which is either a std::string being
+//   appended to or a std::ostream being printed to. The <type>_to_string,
+//   append_<type> and print_<type> functions are all thin wrappers around it.
+
+////////////////////////////////////////////////////////////////////////////////
+#include "strings_fixes.hpp"
+#include <string>
+#include <iostream>
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // write fixed text such as a separator to either kind of output
+
+  void format_text(std::string& result, const std::string& text);
+  void format_text(std::string& result, const char* text);
+  void format_text(std::string& result, char ch);
+
+  void format_text(std::ostream& device, const std::string& text);
+  void format_text(std::ostream& device, const char* text);
+  void format_text(std::ostream& device, char ch);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // adapts a to_string function of the form:
+  //   std::string to_string_fn(const T&)
+  // to the append form used by the formatting templates:
+  //   void append_fn(std::string& result, const T&)
+  // so that the <type>_to_string functions can share the same formatting code
+
+  template<typename S>
+  class to_string_appender
+  {
+  public:
+    to_string_appender(S to_string_fn) : m_to_string_fn(to_string_fn) {}
+
+    template<typename T>
+    void operator()(std::string& result, const T& value) {result += m_to_string_fn(value);}
+
+  private:
+    S m_to_string_fn;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+} // end namespace stlplus
+
+#endif
@@ -59,6 +59,20 @@ enum alignment_t
   align_centre
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Parse status:
+//   The non-throwing conversions from text return one of these to say how the parse went
+//     - ok - a number was read
+//     - invalid - the text does not start with a number in the expected format
+//     - overflow - the text is a number but it is out of range for the type
+
+enum parse_status_t
+{
+  parse_ok,
+  parse_invalid,
+  parse_overflow
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 }
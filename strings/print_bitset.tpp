@@ -14,7 +14,7 @@ namespace stlplus
   template<size_t N>
   void print_bitset(std::ostream& device, const std::bitset<N>& data)
   {
-    device << bitset_to_string(data);
+    format_bitset(device, data);
   }
 
 } // end namespace stlplus
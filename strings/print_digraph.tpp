@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_digraph.hpp"
 #include "print_sequence.hpp"
 
 namespace stlplus
@@ -19,12 +20,7 @@ namespace stlplus
                      AS arc_print_fn,
                      const std::string& separator)
   {
-    device << "nodes:";
-    device << separator;
-    print_sequence(device, values.begin(), values.end(), node_print_fn, separator);
-    device << "arcs:";
-    device << separator;
-    print_sequence(device, values.arc_begin(), values.arc_end(), arc_print_fn, separator);
+    format_digraph(device, values, node_print_fn, arc_print_fn, separator);
   }
 
 } // end namespace stlplus
@@ -0,0 +1,39 @@
+#ifndef STLPLUS_PRINT_FIXED_INF
+#define STLPLUS_PRINT_FIXED_INF
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   Print functions for the fixed-width integer type fixed_inf
+
+//   The conversion supports all the formatting modes defined on format_types
+
+////////////////////////////////////////////////////////////////////////////////
+#include "strings_fixes.hpp"
+#include "fixed_inf.hpp"
+#include "format_types.hpp"
+#include <stdexcept>
+#include <iostream>
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // exceptions: std::invalid_argument
+  template<unsigned Bits>
+  void print_fixed_inf(std::ostream& device,
+                       const fixed_inf<Bits>&,
+                       unsigned radix = 10,
+                       radix_display_t display = radix_c_style_or_hash,
+                       unsigned width = 0);
+
+////////////////////////////////////////////////////////////////////////////////
+} // end namespace stlplus
+
+#include "print_fixed_inf.tpp"
+#endif
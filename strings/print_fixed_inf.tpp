@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "string_fixed_inf.hpp"
+
+namespace stlplus
+{
+
+  template<unsigned Bits>
+  void print_fixed_inf(std::ostream& device,
+                       const fixed_inf<Bits>& data,
+                       unsigned radix,
+                       radix_display_t display,
+                       unsigned width)
+  {
+    device << fixed_inf_to_string(data, radix, display, width);
+  }
+
+} // end namespace stlplus
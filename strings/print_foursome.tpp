@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_foursome.hpp"
 
 namespace stlplus
 {
@@ -19,13 +20,7 @@ namespace stlplus
                       S4 print_fn4,
                       const std::string& separator)
   {
-    print_fn1(device, values.first);
-    device << separator;
-    print_fn2(device, values.second);
-    device << separator;
-    print_fn3(device, values.third);
-    device << separator;
-    print_fn4(device, values.fourth);
+    format_foursome(device, values, print_fn1, print_fn2, print_fn3, print_fn4, separator);
   }
 
 
@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_matrix.hpp"
 
 namespace stlplus
 {
@@ -18,15 +19,7 @@ namespace stlplus
                     const std::string& column_separator,
                     const std::string& row_separator)
   {
-    for (unsigned r = 0; r < values.rows(); r++)
-    {
-      if (r != 0) device << row_separator;
-      for (unsigned c = 0; c < values.columns(); c++)
-      {
-        if (c != 0) device << column_separator;
-        print_fn(device, values(r,c));
-      }
-    }
+    format_matrix(device, values, print_fn, column_separator, row_separator);
   }
 
 } // end namespace stlplus
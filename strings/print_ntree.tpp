@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_ntree.hpp"
 
 namespace stlplus
 {
@@ -17,13 +18,7 @@ namespace stlplus
                    const std::string& separator,
                    const std::string& indent_string)
   {
-    for (typename ntree<T>::const_prefix_iterator i = values.prefix_begin(); i != values.prefix_end(); i++)
-    {
-      if (i != values.prefix_begin()) device << separator;
-      for (unsigned indent = values.depth(i.simplify()); --indent; )
-        device << indent_string;
-      print_fn(device, *i);
-    }
+    format_ntree(device, values, print_fn, separator, indent_string);
   }
 
 } // end namespace stlplus
@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_pair.hpp"
 
 namespace stlplus
 {
@@ -17,9 +18,7 @@ namespace stlplus
                   S2 print_fn2,
                   const std::string& separator)
   {
-    print_fn1(device, values.first);
-    device << separator;
-    print_fn2(device, values.second);
+    format_pair(device, values, print_fn1, print_fn2, separator);
   }
 
 } // end namespace stlplus
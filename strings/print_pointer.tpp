@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_pointer.hpp"
 #include <string>
 
 namespace stlplus
@@ -19,16 +20,7 @@ namespace stlplus
                      const std::string& prefix,
                      const std::string& suffix)
   {
-    if (value)
-    {
-      device << prefix;
-      print_fn(device, *value);
-      device << suffix;
-    }
-    else
-    {
-      device << null_string;
-    }
+    format_pointer(device, value, print_fn, null_string, prefix, suffix);
   }
 
 } // end namespace stlplus
@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_sequence.hpp"
 #include "print_pair.hpp"
 
 namespace stlplus
@@ -20,11 +21,7 @@ namespace stlplus
                       S print_fn,
                       const std::string& separator)
   {
-    for (I i = begin; i != end; i++)
-    {
-      if (i != begin) device << separator;
-      print_fn(device, *i);
-    }
+    format_sequence(device, begin, end, print_fn, separator);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -38,11 +35,7 @@ namespace stlplus
                            const std::string& pair_separator,
                            const std::string& separator)
   {
-    for (I i = begin; i != end; i++)
-    {
-      if (i != begin) device << separator;
-      print_pair(device, *i, print_fn1, print_fn2, pair_separator);
-    }
+    format_pair_sequence(device, begin, end, print_fn1, print_fn2, pair_separator, separator);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_shared_ptr.hpp"
 
 namespace stlplus
 {
@@ -19,16 +20,7 @@ namespace stlplus
                         const std::string& prefix,
                         const std::string& suffix)
   {
-    if (value.use_count() == 0)
-      device << empty_string;
-    else if (value.get() == 0)
-      device << null_string;
-    else
-    {
-      device << prefix;
-      print_fn(device, *value);
-      device << suffix;
-    }
+    format_shared_ptr(device, value, print_fn, empty_string, null_string, prefix, suffix);
   }
 
 } // end namespace stlplus
@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_pointer.hpp"
 
 namespace stlplus
 {
@@ -18,16 +19,7 @@ namespace stlplus
                        const std::string& prefix,
                        const std::string& suffix)
   {
-    if (value)
-    {
-      device << prefix;
-      print_fn(device, *value);
-      device << suffix;
-    }
-    else
-    {
-      device << null_string;
-    }
+    format_pointer(device, value.pointer(), print_fn, null_string, prefix, suffix);
   }
 
   template<typename T, typename S>
@@ -38,16 +30,7 @@ namespace stlplus
                              const std::string& prefix,
                              const std::string& suffix)
   {
-    if (value)
-    {
-      device << prefix;
-      print_fn(device, *value);
-      device << suffix;
-    }
-    else
-    {
-      device << null_string;
-    }
+    format_pointer(device, value.pointer(), print_fn, null_string, prefix, suffix);
   }
 
   template<typename T, typename S>
@@ -58,16 +41,7 @@ namespace stlplus
                               const std::string& prefix,
                               const std::string& suffix)
   {
-    if (value)
-    {
-      device << prefix;
-      print_fn(device, *value);
-      device << suffix;
-    }
-    else
-    {
-      device << null_string;
-    }
+    format_pointer(device, value.pointer(), print_fn, null_string, prefix, suffix);
   }
 
 } // end namespace stlplus
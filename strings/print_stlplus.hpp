@@ -21,6 +21,7 @@
 #include "print_triple.hpp"
 #endif
 
+#include "print_fixed_inf.hpp"
 #include "print_inf.hpp"
 
 #endif
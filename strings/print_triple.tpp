@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_triple.hpp"
 
 namespace stlplus
 {
@@ -18,12 +19,7 @@ namespace stlplus
                     S3 print_fn3,
                     const std::string& separator)
   {
-
-    print_fn1(device, values.first);
-    device << separator;
-    print_fn2(device, values.second);
-    device << separator;
-    print_fn3(device, values.third);
+    format_triple(device, values, print_fn1, print_fn2, print_fn3, separator);
   }
 
 } // end namespace stlplus
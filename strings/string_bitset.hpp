@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include <bitset>
 #include <string>
 
@@ -20,6 +21,12 @@ namespace stlplus
   template<size_t N>
   std::string bitset_to_string(const std::bitset<N>& data);
 
+  template<size_t N>
+  void append_bitset(std::string& result, const std::bitset<N>& data);
+
+  template<typename O, size_t N>
+  void format_bitset(O& output, const std::bitset<N>& data);
+
 } // end namespace stlplus
 
 #include "string_bitset.tpp"
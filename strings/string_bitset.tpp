@@ -10,12 +10,25 @@
 namespace stlplus
 {
 
+  template<typename O, size_t N>
+  void format_bitset(O& output, const std::bitset<N>& data)
+  {
+    for (size_t i = data.size(); i--; )
+      format_text(output, data.test(i) ? '1' : '0');
+  }
+
+  template<size_t N>
+  void append_bitset(std::string& result, const std::bitset<N>& data)
+  {
+    result.reserve(result.size() + data.size());
+    format_bitset(result, data);
+  }
+
   template<size_t N>
   std::string bitset_to_string(const std::bitset<N>& data)
   {
     std::string result;
-    for (size_t i = data.size(); i--; )
-      result += data.test(i) ? '1' : '0';
+    append_bitset(result, data);
     return result;
   }
 
@@ -21,6 +21,11 @@ namespace stlplus
     return unsigned_short_to_string((unsigned short)i, radix, display, width);
   }
 
+  void append_bool(std::string& result, bool i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    append_unsigned_short(result, (unsigned short)i, radix, display, width);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 
   bool string_to_bool(const std::string& str, unsigned radix)
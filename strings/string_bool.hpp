@@ -26,6 +26,13 @@ namespace stlplus
                              radix_display_t display = radix_c_style_or_hash,
                              unsigned width = 0);
 
+  // append form, e.g. for use in append_vector for vector<bool>
+  // exceptions: std::invalid_argument
+  void append_bool(std::string& result, bool i,
+                   unsigned radix = 10,
+                   radix_display_t display = radix_c_style_or_hash,
+                   unsigned width = 0);
+
   ////////////////////////////////////////////////////////////////////////////////
 
   // exceptions: std::invalid_argument
@@ -16,4 +16,9 @@ namespace stlplus
     return std::string(value);
   }
 
+  void append_cstring(std::string& result, const char* value)
+  {
+    result += value;
+  }
+
 } // end namespace stlplus
@@ -21,6 +21,9 @@ namespace stlplus
 
   std::string cstring_to_string(const char* value);
 
+  // append form, e.g. for use in append_vector for vector<const char*>
+  void append_cstring(std::string& result, const char* value);
+
 }
 
 #endif
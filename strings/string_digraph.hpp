@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include "digraph.hpp"
 #include <string>
 
@@ -25,6 +26,20 @@ namespace stlplus
                                 AS arc_to_string_fn,
                                 const std::string& separator = ",");
 
+  template<typename NT, typename AT, typename NA, typename AA>
+  void append_digraph(std::string& result,
+                      const digraph<NT,AT>& values,
+                      NA node_append_fn,
+                      AA arc_append_fn,
+                      const std::string& separator = ",");
+
+  template<typename O, typename NT, typename AT, typename NF, typename AF>
+  void format_digraph(O& output,
+                      const digraph<NT,AT>& values,
+                      NF node_format_fn,
+                      AF arc_format_fn,
+                      const std::string& separator);
+
 } // end namespace stlplus
 
 #include "string_digraph.tpp"
@@ -13,6 +13,31 @@ namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
 
+  template<typename O, typename NT, typename AT, typename NF, typename AF>
+  void format_digraph(O& output,
+                      const digraph<NT,AT>& values,
+                      NF node_format_fn,
+                      AF arc_format_fn,
+                      const std::string& separator)
+  {
+    format_text(output, "nodes:");
+    format_text(output, separator);
+    format_sequence(output, values.begin(), values.end(), node_format_fn, separator);
+    format_text(output, "arcs:");
+    format_text(output, separator);
+    format_sequence(output, values.arc_begin(), values.arc_end(), arc_format_fn, separator);
+  }
+
+  template<typename NT, typename AT, typename NA, typename AA>
+  void append_digraph(std::string& result,
+                      const digraph<NT,AT>& values,
+                      NA node_append_fn,
+                      AA arc_append_fn,
+                      const std::string& separator)
+  {
+    format_digraph(result, values, node_append_fn, arc_append_fn, separator);
+  }
+
   template<typename NT, typename AT, typename NS, typename AS>
   std::string digraph_to_string(const digraph<NT,AT>& values,
                                 NS node_to_string_fn,
@@ -20,12 +45,7 @@ namespace stlplus
                                 const std::string& separator)
   {
     std::string result;
-    result += "nodes:";
-    result += separator;
-    result += sequence_to_string(values.begin(), values.end(), node_to_string_fn, separator);
-    result += "arcs:";
-    result += separator;
-    result += sequence_to_string(values.arc_begin(), values.arc_end(), arc_to_string_fn, separator);
+    format_digraph(result, values, to_string_appender<NS>(node_to_string_fn), to_string_appender<AS>(arc_to_string_fn), separator);
     return result;
   }
 
@@ -0,0 +1,54 @@
+#ifndef STLPLUS_STRING_FIXED_INF
+#define STLPLUS_STRING_FIXED_INF
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+//   String conversion functions for the fixed-width integer type fixed_inf
+
+//   The conversions are the same as for inf - see string_inf.hpp
+
+////////////////////////////////////////////////////////////////////////////////
+#include "strings_fixes.hpp"
+#include "fixed_inf.hpp"
+#include "format_types.hpp"
+#include <string>
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stlplus
+{
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // conversion TO string
+  // exceptions: std::invalid_argument
+  template<unsigned Bits>
+  std::string fixed_inf_to_string(const fixed_inf<Bits>&,
+                                  unsigned radix = 10,
+                                  radix_display_t display = radix_c_style_or_hash,
+                                  unsigned width = 0);
+
+  // append form, e.g. for use in append_vector for vector<fixed_inf<Bits> >
+  // exceptions: std::invalid_argument
+  template<unsigned Bits>
+  void append_fixed_inf(std::string& result, const fixed_inf<Bits>&,
+                        unsigned radix = 10,
+                        radix_display_t display = radix_c_style_or_hash,
+                        unsigned width = 0);
+
+  // conversion FROM string
+  // the width cannot be deduced so must be given, e.g. string_to_fixed_inf<128>(str)
+  // a value too large for the width is wrapped round
+  // exceptions: std::invalid_argument
+  template<unsigned Bits>
+  fixed_inf<Bits> string_to_fixed_inf(const std::string&,
+                                      unsigned radix = 0);
+
+////////////////////////////////////////////////////////////////////////////////
+} // end namespace stlplus
+
+#include "string_fixed_inf.tpp"
+#endif
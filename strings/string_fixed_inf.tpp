@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////
+
+//   Author:    Andy Rushton
+//   Copyright: (c) Southampton University 1999-2004
+//              (c) Andy Rushton           2004 onwards
+//   License:   BSD License, see ../docs/license.html
+
+////////////////////////////////////////////////////////////////////////////////
+#include "string_inf.hpp"
+
+namespace stlplus
+{
+
+  template<unsigned Bits>
+  std::string fixed_inf_to_string(const fixed_inf<Bits>& data,
+                                  unsigned radix,
+                                  radix_display_t display,
+                                  unsigned width)
+  {
+    return inf_to_string(data.to_inf(), radix, display, width);
+  }
+
+  template<unsigned Bits>
+  void append_fixed_inf(std::string& result,
+                        const fixed_inf<Bits>& data,
+                        unsigned radix,
+                        radix_display_t display,
+                        unsigned width)
+  {
+    append_inf(result, data.to_inf(), radix, display, width);
+  }
+
+  template<unsigned Bits>
+  fixed_inf<Bits> string_to_fixed_inf(const std::string& str,
+                                      unsigned radix)
+  {
+    return fixed_inf<Bits>(string_to_inf(str, radix));
+  }
+
+} // end namespace stlplus
@@ -15,6 +15,10 @@
 #include <iomanip>
 #include <stdexcept>
 #include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <cfloat>
 
 namespace stlplus
 {
@@ -52,6 +56,16 @@ namespace stlplus
     return std::string(stream.str());
   }
 
+  void append_float(std::string& result, float f, real_display_t display, unsigned width, unsigned precision)
+  {
+    result += double_to_string((double)f, display, width, precision);
+  }
+
+  void append_double(std::string& result, double f, real_display_t display, unsigned width, unsigned precision)
+  {
+    result += double_to_string(f, display, width, precision);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 
   float string_to_float(const std::string& value)
@@ -66,5 +80,62 @@ namespace stlplus
   }
 
   ////////////////////////////////////////////////////////////////////////////////
+  // conversions from characters without exceptions
+
+  // the characters that can be part of a decimal floating-point number
+  static bool real_char(char ch)
+  {
+    return (ch >= '0' && ch <= '9') || ch == '.' || ch == '-' || ch == '+' || ch == 'e' || ch == 'E';
+  }
+
+  parse_status_t chars_to_float(const char* begin, const char* end, float& value, const char** stop)
+  {
+    double result = 0.0;
+    parse_status_t status = chars_to_double(begin, end, result, stop);
+    if (status == parse_ok && (result > FLT_MAX || result < -FLT_MAX))
+      status = parse_overflow;
+    if (status == parse_ok)
+      value = (float)result;
+    return status;
+  }
+
+  parse_status_t chars_to_double(const char* begin, const char* end, double& value, const char** stop)
+  {
+    if (stop)
+      *stop = begin;
+    // strtod needs a null-terminated string, so copy the longest run of characters that could be part
+    // of the number - this also stops strtod from skipping white space or reading inf or nan
+    const char* last = begin;
+    while (last != end && real_char(*last))
+      last++;
+    size_t size = (size_t)(last - begin);
+    char buffer[64];
+    std::string copy;
+    const char* text = buffer;
+    if (size < sizeof(buffer))
+    {
+      std::memcpy(buffer, begin, size);
+      buffer[size] = '\0';
+    }
+    else
+    {
+      copy.assign(begin, last);
+      text = copy.c_str();
+    }
+    errno = 0;
+    char* text_end = 0;
+    double result = std::strtod(text, &text_end);
+    const char* i = begin + (text_end - text);
+    if (i == begin || (!stop && i != end))
+      return parse_invalid;
+    if (stop)
+      *stop = i;
+    if (errno == ERANGE && (result == HUGE_VAL || result == -HUGE_VAL))
+      return parse_overflow;
+    value = result;
+    return parse_ok;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 }
@@ -39,6 +39,21 @@ namespace stlplus
                                unsigned width = 0,
                                unsigned precision = 6);
 
+  // append forms, e.g. for use in append_vector for vector<double>
+  // the image is formatted by iostream as above, so these are for convenience rather than speed
+
+  // exceptions: std::invalid_argument
+  void append_float(std::string& result, float f,
+                    real_display_t display = display_mixed,
+                    unsigned width = 0,
+                    unsigned precision = 6);
+
+  // exceptions: std::invalid_argument
+  void append_double(std::string& result, double f,
+                     real_display_t display = display_mixed,
+                     unsigned width = 0,
+                     unsigned precision = 6);
+
   ////////////////////////////////////////////////////////////////////////////////
   // Convert a string to a floating-point type
 
@@ -49,6 +64,17 @@ namespace stlplus
   double string_to_double(const std::string& value);
 
   ////////////////////////////////////////////////////////////////////////////////
+  // Convert characters to a floating-point type without exceptions
+  // These read a decimal number from the character range [begin,end) and return the
+  // parse status in the same way as the integer conversions in string_int.hpp:
+  // If stop is non-null, it is set to point to the first character not used
+  // If stop is null, the whole range must be the number, otherwise the result is parse_invalid
+
+  parse_status_t chars_to_float(const char* begin, const char* end, float& value, const char** stop = 0);
+
+  parse_status_t chars_to_double(const char* begin, const char* end, double& value, const char** stop = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
 
@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include "foursome.hpp"
 #include <string>
 
@@ -27,6 +28,24 @@ namespace stlplus
                                  S4 to_string_fn4,
                                  const std::string& separator = ":");
 
+  template<typename T1, typename T2, typename T3, typename T4, typename A1, typename A2, typename A3, typename A4>
+  void append_foursome(std::string& result,
+                       const foursome<T1,T2,T3,T4>& values,
+                       A1 append_fn1,
+                       A2 append_fn2,
+                       A3 append_fn3,
+                       A4 append_fn4,
+                       const std::string& separator = ":");
+
+  template<typename O, typename T1, typename T2, typename T3, typename T4, typename F1, typename F2, typename F3, typename F4>
+  void format_foursome(O& output,
+                       const foursome<T1,T2,T3,T4>& values,
+                       F1 format_fn1,
+                       F2 format_fn2,
+                       F3 format_fn3,
+                       F4 format_fn4,
+                       const std::string& separator);
+
 } // end namespace stlplus
 
 #include "string_foursome.tpp"
@@ -10,6 +10,36 @@
 namespace stlplus
 {
 
+  template<typename O, typename T1, typename T2, typename T3, typename T4, typename F1, typename F2, typename F3, typename F4>
+  void format_foursome(O& output,
+                       const foursome<T1,T2,T3,T4>& values,
+                       F1 format_fn1,
+                       F2 format_fn2,
+                       F3 format_fn3,
+                       F4 format_fn4,
+                       const std::string& separator)
+  {
+    format_fn1(output, values.first);
+    format_text(output, separator);
+    format_fn2(output, values.second);
+    format_text(output, separator);
+    format_fn3(output, values.third);
+    format_text(output, separator);
+    format_fn4(output, values.fourth);
+  }
+
+  template<typename T1, typename T2, typename T3, typename T4, typename A1, typename A2, typename A3, typename A4>
+  void append_foursome(std::string& result,
+                       const foursome<T1,T2,T3,T4>& values,
+                       A1 append_fn1,
+                       A2 append_fn2,
+                       A3 append_fn3,
+                       A4 append_fn4,
+                       const std::string& separator)
+  {
+    format_foursome(result, values, append_fn1, append_fn2, append_fn3, append_fn4, separator);
+  }
+
   template<typename T1, typename T2, typename T3, typename T4, typename S1, typename S2, typename S3, typename S4>
   std::string foursome_to_string(const foursome<T1,T2,T3,T4>& values,
                                  S1 to_string_fn1,
@@ -18,15 +48,14 @@ namespace stlplus
                                  S4 to_string_fn4,
                                  const std::string& separator)
   {
-    return
-      to_string_fn1(values.first) +
-      separator +
-      to_string_fn2(values.second) +
-      separator +
-      to_string_fn3(values.third) +
-      separator +
-      to_string_fn4(values.fourth);
+    std::string result;
+    format_foursome(result, values,
+                    to_string_appender<S1>(to_string_fn1),
+                    to_string_appender<S2>(to_string_fn2),
+                    to_string_appender<S3>(to_string_fn3),
+                    to_string_appender<S4>(to_string_fn4),
+                    separator);
+    return result;
   }
 
-
 } // end namespace stlplus
@@ -26,6 +26,14 @@ namespace stlplus
                              const std::string& pair_separator = ":",
                              const std::string& separator = ",");
 
+  template<typename K, typename T, typename H, typename E, typename KA, typename TA>
+  void append_hash(std::string& result,
+                   const hash<K,T,H,E>& values,
+                   KA key_append_fn,
+                   TA value_append_fn,
+                   const std::string& pair_separator = ":",
+                   const std::string& separator = ",");
+
 } // end namespace stlplus
 
 #include "string_hash.tpp"
@@ -23,4 +23,17 @@ namespace stlplus
                                    pair_separator, separator);
   }
 
+  template<typename K, typename T, typename H, typename E, typename KA, typename TA>
+  void append_hash(std::string& result,
+                   const hash<K,T,H,E>& values,
+                   KA key_append_fn,
+                   TA value_append_fn,
+                   const std::string& pair_separator,
+                   const std::string& separator)
+  {
+    append_pair_sequence(result, values.begin(), values.end(),
+                         key_append_fn, value_append_fn,
+                         pair_separator, separator);
+  }
+
 } // end namespace stlplus
@@ -15,6 +15,8 @@
 #include "string_inf.hpp"
 #include "string_basic.hpp"
 #include <ctype.h>
+#include <vector>
+#include <algorithm>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -44,6 +46,104 @@ namespace stlplus
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
   };
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // conversion of natural values to and from sign-magnitude digits
+  // The digits are converted several at a time, using the largest power of the radix that fits in 32
+  // bits, so each pass over the value is a single division or multiplication by that chunk. Large
+  // values are split in two by dividing by a power chunk^(2^k), or joined by multiplying by one, and
+  // the halves converted separately, which replaces the long run of passes over the whole value
+  // with a few large divisions or multiplications.
+
+  static const unsigned digits_split_bits = 2048;
+  static const unsigned string_split_digits = 600;
+
+  // the largest power of the radix that fits in 32 bits and the number of digits it represents
+  static unsigned long chunk_power(unsigned radix, unsigned& digits)
+  {
+    unsigned long power = radix;
+    digits = 1;
+    while (power <= 0xffffffffUL / radix)
+    {
+      power *= radix;
+      digits++;
+    }
+    return power;
+  }
+
+  // append the digits of the natural value, which must be less than powers[level]^2
+  // if pad is set the digits are padded with leading zeros to the 2*2^level chunks of that square
+  static void natural_to_digits(const inf& value, unsigned radix, const std::vector<inf>& powers, unsigned chunk_digits,
+                                size_t level, bool pad, std::string& result)
+  {
+    if (level == 0 || value.bits() < digits_split_bits)
+    {
+      // generate the digits lsd first a chunk at a time then reverse them into place
+      std::string::size_type start = result.size();
+      inf local_i = value;
+      while (!local_i.zero())
+      {
+        std::pair<inf,inf> divided = local_i.divide(powers[0]);
+        unsigned long chunk = divided.second.to_unsigned_long();
+        for (unsigned i = 0; i < chunk_digits; i++)
+        {
+          result += to_char[chunk % radix];
+          chunk /= radix;
+        }
+        local_i = divided.first;
+      }
+      if (pad)
+        result.resize(start + (chunk_digits << (level + 1)), '0');
+      else
+      {
+        while (result.size() > start && result[result.size()-1] == '0')
+          result.erase(result.size()-1);
+      }
+      std::reverse(result.begin() + start, result.end());
+      return;
+    }
+    std::pair<inf,inf> divided = value.divide(powers[level]);
+    if (pad || !divided.first.zero())
+    {
+      natural_to_digits(divided.first, radix, powers, chunk_digits, level-1, pad, result);
+      pad = true;
+    }
+    natural_to_digits(divided.second, radix, powers, chunk_digits, level-1, pad, result);
+  }
+
+  // the value of count digits starting at begin, which must all be valid digits in the radix
+  static inf digits_to_natural(const std::string& str, std::string::size_type begin, std::string::size_type count,
+                               unsigned radix, const std::vector<inf>& powers, unsigned chunk_digits)
+  {
+    inf result;
+    if (count < string_split_digits)
+    {
+      // multiply by the chunk and add in the next chunk of digits, starting with the odd digits at the msd end
+      for (std::string::size_type i = 0; i < count; )
+      {
+        std::string::size_type end = i + (count - i - 1) % chunk_digits + 1;
+        unsigned long chunk = 0;
+        unsigned long scale = 1;
+        for ( ; i < end; i++)
+        {
+          chunk = chunk * radix + (unsigned long)from_char[(unsigned char)str[begin + i]];
+          scale *= radix;
+        }
+        result *= inf(scale);
+        result += inf(chunk);
+      }
+      return result;
+    }
+    // split off the largest number of low digits chunk_digits*2^k that leaves some high digits
+    size_t level = 0;
+    while ((chunk_digits << (level + 1)) < count)
+      level++;
+    std::string::size_type low_count = chunk_digits << level;
+    result = digits_to_natural(str, begin, count - low_count, radix, powers, chunk_digits);
+    result *= powers[level];
+    result += digits_to_natural(str, begin + count - low_count, low_count, radix, powers, chunk_digits);
+    return result;
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 
   std::string inf_to_string(const stlplus::inf& data, unsigned radix, radix_display_t display, unsigned width)
@@ -88,9 +188,6 @@ namespace stlplus
     default:
       throw std::invalid_argument("invalid radix display value");
     }
-    // create constants of the same type as the template parameter to avoid type mismatches
-    const inf t_zero(0);
-    const inf t_radix(radix);
     // the C representations for binary, octal and hex use 2's-complement representation
     // all other represenations use sign-magnitude
     if (hex || octal || binary)
@@ -290,16 +387,25 @@ namespace stlplus
       // [radix#][sign]magnitude
       bool negative = local_i.negative();
       local_i.abs();
-      // create a representation of the magnitude by successive division
-      do
+      if (radix == 10)
       {
-        std::pair<inf,inf> divided = local_i.divide(t_radix);
-        unsigned remainder = divided.second.to_unsigned();
-        char digit = to_char[remainder];
-        result.insert((std::string::size_type)0, 1, digit);
-        local_i = divided.first;
+        // decimal is converted by inf itself, which has a faster way of splitting large values
+        result = local_i.to_string(10);
       }
-      while(!local_i.zero() || result.size() < width);
+      else
+      {
+        // create a representation of the magnitude by successive division, splitting a large value
+        // using powers of the chunk - the last one must have a square larger than the value
+        unsigned chunk_digits = 0;
+        std::vector<inf> powers(1, inf(chunk_power(radix, chunk_digits)));
+        if (local_i.bits() >= digits_split_bits)
+          while (2 * (powers.back().bits() - 2) < local_i.bits() - 1)
+            powers.push_back(powers.back() * powers.back());
+        natural_to_digits(local_i, radix, powers, chunk_digits, powers.size() - 1, false, result);
+      }
+      // pad with leading zeros to the width, with at least one digit
+      if (result.size() < width || result.empty())
+        result.insert((std::string::size_type)0, maximum((std::string::size_type)width, (std::string::size_type)1) - result.size(), '0');
       // add the prefixes
       // add a sign only for negative values
       if (negative)
@@ -311,6 +417,11 @@ namespace stlplus
     return result;
   }
 
+  void append_inf(std::string& result, const stlplus::inf& data, unsigned radix, radix_display_t display, unsigned width)
+  {
+    result += inf_to_string(data, radix, display, width);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   // Conversions FROM string
 
@@ -514,13 +625,27 @@ namespace stlplus
           break;
         }
       }
-      for (; i < str.size(); i++)
+      // check the digits, then convert them all in one go
+      for (unsigned j = i; j < str.size(); j++)
       {
-        result *= inf(radix);
-        int ch = from_char[(unsigned char)str[i]] ;
-        if (ch == -1)
+        int ch = from_char[(unsigned char)str[j]] ;
+        if (ch == -1 || ch >= (int)radix)
           throw std::invalid_argument("invalid character in string " + str + " for radix " + unsigned_to_string(radix));
-        result += inf(ch);
+      }
+      std::string::size_type count = str.size() - i;
+      if (radix == 10)
+      {
+        // decimal is converted by inf itself
+        result.from_string(str.substr(i), 10);
+      }
+      else
+      {
+        unsigned chunk_digits = 0;
+        std::vector<inf> powers(1, inf(chunk_power(radix, chunk_digits)));
+        if (count >= string_split_digits)
+          while ((chunk_digits << powers.size()) < count)
+            powers.push_back(powers.back() * powers.back());
+        result = digits_to_natural(str, i, count, radix, powers, chunk_digits);
       }
       if (negative)
         result.negate();
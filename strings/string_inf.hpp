@@ -30,6 +30,13 @@ namespace stlplus
                             radix_display_t display = radix_c_style_or_hash,
                             unsigned width = 0);
 
+  // append form, e.g. for use in append_vector for vector<inf>
+  // exceptions: std::invalid_argument
+  void append_inf(std::string& result, const inf&,
+                  unsigned radix = 10,
+                  radix_display_t display = radix_c_style_or_hash,
+                  unsigned width = 0);
+
   // conversion FROM string
   // exceptions: std::invalid_argument
   inf string_to_inf(const std::string&,
@@ -9,6 +9,7 @@
 #include "string_int.hpp"
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 namespace stlplus
 {
@@ -41,290 +42,103 @@ namespace stlplus
   // Conversions to string
   // Local generic routines
 
-  // signed version of the generic image generation function for all integer types
-  template<typename T>
-  static std::string simage (T i, unsigned radix, radix_display_t display, unsigned width)
+  // the digit pairs 00 to 99, for generating decimal two digits at a time
+  static const char decimal_pairs [] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+  // all integer types are converted via the widest type
+  // a value is passed as its bit pattern in the low bits of the widest unsigned type, sign-extended if signed
+  typedef unsigned long long widest_unsigned;
+  static const unsigned widest_bits = 8 * sizeof(widest_unsigned);
+
+  // the bits of the value from the bit position upwards
+  static inline widest_unsigned pattern_bits(widest_unsigned value, size_t position)
   {
-    if (radix < 2 || radix > 36)
-      throw std::invalid_argument("invalid radix value " + unsigned_to_string(radix));
-    // untangle all the options
-    bool hashed = false;
-    bool binary = false;
-    bool octal = false;
-    bool hex = false;
-    switch(display)
-    {
-    case radix_none:
-      break;
-    case radix_hash_style:
-      hashed = radix != 10;
-      break;
-    case radix_hash_style_all:
-      hashed = true;
-      break;
-    case radix_c_style:
-      if (radix == 16)
-        hex = true;
-      else if (radix == 8)
-        octal = true;
-      else if (radix == 2)
-        binary = true;
-      break;
-    case radix_c_style_or_hash:
-      if (radix == 16)
-        hex = true;
-      else if (radix == 8)
-        octal = true;
-      else if (radix == 2)
-        binary = true;
-      else if (radix != 10)
-        hashed = true;
-      break;
-    default:
-      throw std::invalid_argument("invalid radix display value");
-    }
-    // create constants of the same type as the template parameter to avoid type mismatches
-    const T t_zero(0);
-    const T t_radix(radix);
-    // the C representations for binary, octal and hex use 2's-complement representation
-    // all other represenations use sign-magnitude
-    std::string result;
-    if (hex || octal || binary)
+    return position < widest_bits ? value >> position : 0;
+  }
+
+  // the number of bits in the bit-pattern representation
+  // a negative value is shown as the bit pattern of its type with a zero bit added above it
+  // a natural value uses the fewest bits, which for signed types includes a sign bit
+  static inline unsigned pattern_size(widest_unsigned value, bool is_signed, bool negative, unsigned type_bits)
+  {
+    if (negative)
+      return type_bits + 1;
+    unsigned result = is_signed ? 1 : 0;
+    for ( ; value; value >>= 1)
+      result++;
+    return result < (is_signed ? 2u : 1u) ? (is_signed ? 2u : 1u) : result;
+  }
+
+  // the magnitude digits of a value in any radix, generated backwards from the end of the buffer
+  // returns the start of the digits
+  static char* magnitude_digits(char* end, widest_unsigned magnitude, unsigned radix)
+  {
+    char* digits = end;
+    if (radix == 10)
     {
-      // bit-pattern representation
-      // this is the binary representation optionally shown in octal or hex
-      // first generate the binary by masking the bits
-      // ensure that it has at least one bit!
-      for (T mask(1); ; mask <<= 1)
+      // two digits at a time from the table, the divisions by constants compile to multiplications
+      while (magnitude >= 100)
       {
-        result.insert((std::string::size_type)0, 1, i & mask ? '1' : '0');
-        if (mask == t_zero) break;
+        unsigned pair = (unsigned)(magnitude % 100) * 2;
+        magnitude /= 100;
+        *--digits = decimal_pairs[pair+1];
+        *--digits = decimal_pairs[pair];
       }
-      // the result is now the full width of the type - e.g. int will give a 32-bit result
-      // now interpret this as either binary, octal or hex and add the prefix
-      if (binary)
+      if (magnitude >= 10)
       {
-        // the result is already binary - but the width may be wrong
-        // if this is still smaller than the width field, sign extend
-        // otherwise trim down to either the width or the smallest string that preserves the value
-        while (result.size() < width)
-          result.insert((std::string::size_type)0, 1, result[0]);
-        while (result.size() > width)
-        {
-          // do not trim to less than 2 bits (sign plus 1-bit magnitude)
-          if (result.size() <= 2) break;
-          // only trim if it doesn't change the sign and therefore the value
-          if (result[0] != result[1]) break;
-          result.erase(0,1);
-        }
-        // add the prefix
-        result.insert((std::string::size_type)0, "0b");
-      }
-      else if (octal)
-      {
-        // the result is currently binary - but before converting get the width right
-        // the width is expressed in octal digits so make the binary 3 times this
-        // if this is still smaller than the width field, sign extend
-        // otherwise trim down to either the width or the smallest string that preserves the value
-        // also ensure that the binary is a multiple of 3 bits to make the conversion to octal easier
-        while (result.size() < 3*width)
-          result.insert((std::string::size_type)0, 1, result[0]);
-        while (result.size() > 3*width)
-        {
-          // do not trim to less than 2 bits (sign plus 1-bit magnitude)
-          if (result.size() <= 2) break;
-          // only trim if it doesn't change the sign and therefore the value
-          if (result[0] != result[1]) break;
-          result.erase(0,1);
-        }
-        while (result.size() % 3 != 0)
-          result.insert((std::string::size_type)0, 1, result[0]);
-        // now convert to octal
-        std::string octal_result;
-        for (unsigned i = 0; i < result.size()/3; i++)
-        {
-          // yuck - ugly or what?
-          if (result[i*3] == '0')
-          {
-            if (result[i*3+1] == '0')
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '0';
-              else
-                octal_result += '1';
-            }
-            else
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '2';
-              else
-                octal_result += '3';
-            }
-          }
-          else
-          {
-            if (result[i*3+1] == '0')
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '4';
-              else
-                octal_result += '5';
-            }
-            else
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '6';
-              else
-                octal_result += '7';
-            }
-          }
-        }
-        result = octal_result;
-        // add the prefix
-        result.insert((std::string::size_type)0, "0");
+        unsigned pair = (unsigned)magnitude * 2;
+        *--digits = decimal_pairs[pair+1];
+        *--digits = decimal_pairs[pair];
       }
       else
+        *--digits = to_char[magnitude];
+    }
+    else if ((radix & (radix - 1)) == 0)
+    {
+      // a power-of-two radix takes the digits straight from the bits
+      unsigned shift = 0;
+      for (unsigned r = radix; r > 1; r >>= 1)
+        shift++;
+      widest_unsigned mask = radix - 1;
+      do
       {
-        // hex - similar to octal
-        while (result.size() < 4*width)
-          result.insert((std::string::size_type)0, 1, result[0]);
-        while (result.size() > 4*width)
-        {
-          // do not trim to less than 2 bits (sign plus 1-bit magnitude)
-          if (result.size() <= 2) break;
-          // only trim if it doesn't change the sign and therefore the value
-          if (result[0] != result[1]) break;
-          result.erase(0,1);
-        }
-        while (result.size() % 4 != 0)
-          result.insert((std::string::size_type)0, 1, result[0]);
-        // now convert to hex
-        std::string hex_result;
-        for (unsigned i = 0; i < result.size()/4; i++)
-        {
-          // yuck - ugly or what?
-          if (result[i*4] == '0')
-          {
-            if (result[i*4+1] == '0')
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '0';
-                else
-                  hex_result += '1';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '2';
-                else
-                  hex_result += '3';
-              }
-            }
-            else
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '4';
-                else
-                  hex_result += '5';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '6';
-                else
-                  hex_result += '7';
-              }
-            }
-          }
-          else
-          {
-            if (result[i*4+1] == '0')
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '8';
-                else
-                  hex_result += '9';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += 'a';
-                else
-                  hex_result += 'b';
-              }
-            }
-            else
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += 'c';
-                else
-                  hex_result += 'd';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += 'e';
-                else
-                  hex_result += 'f';
-              }
-            }
-          }
-        }
-        result = hex_result;
-        // add the prefix
-        result.insert((std::string::size_type)0, "0x");
+        *--digits = to_char[magnitude & mask];
+        magnitude >>= shift;
       }
+      while (magnitude != 0);
     }
     else
     {
-      // convert to sign-magnitude
-      // the representation is:
-      // [radix#][sign]magnitude
-      bool negative = i < t_zero;
-      // DJDM ensure that the initial value is positive, so that we don't have to use abs()
-      // the reason I need to do this is that abs doesn't exist for 64-bit numbers (it's called something different)
-      // and I've recently added support for long long (which is minimally 64 bit)
-      if (negative)
-        i = t_zero - i;
-      // create a representation of the magnitude by successive division
       do
       {
-//        T ch = abs(i % t_radix);
-        T ch = i % t_radix;
-        i /= t_radix;
-        result.insert((std::string::size_type)0, 1, to_char[ch]);
+        *--digits = to_char[magnitude % radix];
+        magnitude /= radix;
       }
-      while(i != t_zero || result.size() < width);
-      // add the prefixes
-      // add a sign only for negative values
-      if (negative)
-        result.insert((std::string::size_type)0, 1, '-');
-      // then prefix everything with the radix if the hashed representation was requested
-      if (hashed)
-        result.insert((std::string::size_type)0, unsigned_to_string(radix) + "#");
+      while (magnitude != 0);
     }
-    return result;
+    return digits;
   }
 
-  // unsigned version
-  template<typename T>
-  static std::string uimage (T i, unsigned radix, radix_display_t display, unsigned width)
+  // the generic image generation function for all integer types
+  // writes into [first,last) and returns the end, or null if it does not fit
+  static char* integer_chars (char* first, char* last, widest_unsigned value, bool is_signed, unsigned type_bits,
+                              unsigned radix, radix_display_t display, unsigned width)
   {
     if (radix < 2 || radix > 36)
       throw std::invalid_argument("invalid radix value " + unsigned_to_string(radix));
     // untangle all the options
     bool hashed = false;
-    bool binary = false;
-    bool octal = false;
-    bool hex = false;
+    unsigned pattern_shift = 0;
     switch(display)
     {
     case radix_none:
@@ -336,243 +150,100 @@ namespace stlplus
       hashed = true;
       break;
     case radix_c_style:
-      if (radix == 16)
-        hex = true;
-      else if (radix == 8)
-        octal = true;
-      else if (radix == 2)
-        binary = true;
-      break;
     case radix_c_style_or_hash:
       if (radix == 16)
-        hex = true;
+        pattern_shift = 4;
       else if (radix == 8)
-        octal = true;
+        pattern_shift = 3;
       else if (radix == 2)
-        binary = true;
-      else if (radix != 10)
+        pattern_shift = 1;
+      else if (radix != 10 && display == radix_c_style_or_hash)
         hashed = true;
       break;
     default:
       throw std::invalid_argument("invalid radix display value");
     }
-    // create constants of the same type as the template parameter to avoid type mismatches
-    const T t_zero(0);
-    const T t_radix(radix);
+    bool negative = is_signed && (value >> (widest_bits - 1)) != 0;
     // the C representations for binary, octal and hex use 2's-complement representation
     // all other represenations use sign-magnitude
-    std::string result;
-    if (hex || octal || binary)
+    if (pattern_shift != 0)
     {
       // bit-pattern representation
-      // this is the binary representation optionally shown in octal or hex
-      // first generate the binary by masking the bits
-      // ensure at least one bit
-      for (T mask(1); ; mask <<= 1)
-      {
-        result.insert((std::string::size_type)0, 1, i & mask ? '1' : '0');
-        if (mask == t_zero) break;
-      }
-      // the result is now the full width of the type - e.g. int will give a 32-bit result
-      // now interpret this as either binary, octal or hex and add the prefix
-      if (binary)
-      {
-        // the result is already binary - but the width may be wrong
-        // if this is still smaller than the width field, zero extend
-        // otherwise trim down to either the width or the smallest string that preserves the value
-        while (result.size() < width)
-          result.insert((std::string::size_type)0, 1, '0');
-        while (result.size() > width)
-        {
-          // do not trim to less than 1 bit (1-bit magnitude)
-          if (result.size() <= 1) break;
-          // only trim if it doesn't change the sign and therefore the value
-          if (result[0] != '0') break;
-          result.erase(0,1);
-        }
-        // add the prefix
-        result.insert((std::string::size_type)0, "0b");
-      }
-      else if (octal)
-      {
-        // the result is currently binary - but before converting get the width right
-        // the width is expressed in octal digits so make the binary 3 times this
-        // if this is still smaller than the width field, sign extend
-        // otherwise trim down to either the width or the smallest string that preserves the value
-        // also ensure that the binary is a multiple of 3 bits to make the conversion to octal easier
-        while (result.size() < 3*width)
-          result.insert((std::string::size_type)0, 1, '0');
-        while (result.size() > 3*width)
-        {
-          // do not trim to less than 1 bit (1-bit magnitude)
-          if (result.size() <= 1) break;
-          // only trim if it doesn't change the sign and therefore the value
-          if (result[0] != '0') break;
-          result.erase(0,1);
-        }
-        while (result.size() % 3 != 0)
-          result.insert((std::string::size_type)0, 1, '0');
-        // now convert to octal
-        std::string octal_result;
-        for (unsigned i = 0; i < result.size()/3; i++)
-        {
-          // yuck - ugly or what?
-          if (result[i*3] == '0')
-          {
-            if (result[i*3+1] == '0')
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '0';
-              else
-                octal_result += '1';
-            }
-            else
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '2';
-              else
-                octal_result += '3';
-            }
-          }
-          else
-          {
-            if (result[i*3+1] == '0')
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '4';
-              else
-                octal_result += '5';
-            }
-            else
-            {
-              if (result[i*3+2] == '0')
-                octal_result += '6';
-              else
-                octal_result += '7';
-            }
-          }
-        }
-        result = octal_result;
-        // add the prefix if the leading digit is not already 0
-        if (result.empty() || result[0] != '0') result.insert((std::string::size_type)0, "0");
-      }
-      else
-      {
-        // similar to octal
-        while (result.size() < 4*width)
-          result.insert((std::string::size_type)0, 1, '0');
-        while (result.size() > 4*width)
-        {
-          // do not trim to less than 1 bit (1-bit magnitude)
-          if (result.size() <= 1) break;
-          // only trim if it doesn't change the sign and therefore the value
-          if (result[0] != '0') break;
-          result.erase(0,1);
-        }
-        while (result.size() % 4 != 0)
-          result.insert((std::string::size_type)0, 1, '0');
-        // now convert to hex
-        std::string hex_result;
-        for (unsigned i = 0; i < result.size()/4; i++)
-        {
-          // yuck - ugly or what?
-          if (result[i*4] == '0')
-          {
-            if (result[i*4+1] == '0')
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '0';
-                else
-                  hex_result += '1';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '2';
-                else
-                  hex_result += '3';
-              }
-            }
-            else
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '4';
-                else
-                  hex_result += '5';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '6';
-                else
-                  hex_result += '7';
-              }
-            }
-          }
-          else
-          {
-            if (result[i*4+1] == '0')
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += '8';
-                else
-                  hex_result += '9';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += 'a';
-                else
-                  hex_result += 'b';
-              }
-            }
-            else
-            {
-              if (result[i*4+2] == '0')
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += 'c';
-                else
-                  hex_result += 'd';
-              }
-              else
-              {
-                if (result[i*4+3] == '0')
-                  hex_result += 'e';
-                else
-                  hex_result += 'f';
-              }
-            }
-          }
-        }
-        result = hex_result;
-        // add the prefix
-        result.insert((std::string::size_type)0, "0x");
-      }
+      // the pattern is the smallest that preserves the value, extended to the width in digits
+      // then zero-extended to whole digits
+      if (type_bits < widest_bits)
+        value &= (widest_unsigned(1) << type_bits) - 1;
+      size_t bits = pattern_size(value, is_signed, negative, type_bits);
+      if (bits < (size_t)width * pattern_shift)
+        bits = (size_t)width * pattern_shift;
+      size_t digits = (bits + pattern_shift - 1) / pattern_shift;
+      widest_unsigned mask = (widest_unsigned(1) << pattern_shift) - 1;
+      // the prefix is 0b, 0 or 0x, except that an unsigned octal value starting with 0 has no prefix
+      const char* prefix = pattern_shift == 1 ? "0b" : pattern_shift == 4 ? "0x" : "0";
+      if (pattern_shift == 3 && !is_signed && (pattern_bits(value, (digits - 1) * 3) & mask) == 0)
+        prefix = "";
+      size_t prefix_size = 0;
+      while (prefix[prefix_size]) prefix_size++;
+      if ((size_t)(last - first) < prefix_size + digits)
+        return 0;
+      for (size_t i = 0; i < prefix_size; i++)
+        *first++ = prefix[i];
+      for (size_t i = digits; i--; )
+        *first++ = to_char[pattern_bits(value, i * pattern_shift) & mask];
+      return first;
     }
-    else
+    // convert to sign-magnitude
+    // the representation is:
+    // [radix#][sign]magnitude
+    // the magnitude of the most negative value still fits when unsigned
+    char buffer[widest_bits];
+    char* end = buffer + widest_bits;
+    char* digits = magnitude_digits(end, negative ? widest_unsigned(0) - value : value, radix);
+    size_t digit_count = (size_t)(end - digits);
+    size_t padding = width > digit_count ? width - digit_count : 0;
+    size_t size = (hashed ? (radix >= 10 ? 3 : 2) : 0) + (negative ? 1 : 0) + padding + digit_count;
+    if ((size_t)(last - first) < size)
+      return 0;
+    // prefix everything with the radix if the hashed representation was requested
+    if (hashed)
     {
-      // convert to sign-magnitude
-      // the representation is:
-      // [radix#]magnitude
-      // create a representation of the magnitude by successive division
-      do
-      {
-        T ch = i % t_radix;
-        i /= t_radix;
-        result.insert((std::string::size_type)0, 1, to_char[(int)ch]);
-      }
-      while(i != t_zero || result.size() < width);
-      // prefix everything with the radix if the hashed representation was requested
-      if (hashed)
-        result.insert((std::string::size_type)0, unsigned_to_string(radix) + "#");
+      if (radix >= 10)
+        *first++ = to_char[radix / 10];
+      *first++ = to_char[radix % 10];
+      *first++ = '#';
+    }
+    // add a sign only for negative values
+    if (negative)
+      *first++ = '-';
+    for (size_t i = 0; i < padding; i++)
+      *first++ = '0';
+    for ( ; digits != end; digits++)
+      *first++ = *digits;
+    return first;
+  }
+
+  // the appending version uses a buffer on the stack unless the width makes the image too long for it
+  static void integer_append (std::string& result, widest_unsigned value, bool is_signed, unsigned type_bits,
+                              unsigned radix, radix_display_t display, unsigned width)
+  {
+    char buffer[max_integer_chars];
+    char* end = integer_chars(buffer, buffer + max_integer_chars, value, is_signed, type_bits, radix, display, width);
+    if (end)
+    {
+      result.append(buffer, end);
+      return;
     }
+    size_t start = result.size();
+    result.resize(start + max_integer_chars + (size_t)width, ' ');
+    end = integer_chars(&result[start], &result[0] + result.size(), value, is_signed, type_bits, radix, display, width);
+    result.erase(end - &result[0]);
+  }
+
+  static std::string integer_image (widest_unsigned value, bool is_signed, unsigned type_bits,
+                                    unsigned radix, radix_display_t display, unsigned width)
+  {
+    std::string result;
+    integer_append(result, value, is_signed, type_bits, radix, display, width);
     return result;
   }
 
@@ -581,47 +252,143 @@ namespace stlplus
 
   std::string short_to_string(short i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return simage(i, radix, display, width);
+    return integer_image((widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
   }
 
   std::string unsigned_short_to_string(unsigned short i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return uimage(i, radix, display, width);
+    return integer_image((widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
   }
 
   std::string int_to_string(int i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return simage(i, radix, display, width);
+    return integer_image((widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
   }
 
   std::string unsigned_to_string(unsigned i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return uimage(i, radix, display, width);
+    return integer_image((widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
   }
 
   std::string long_to_string(long i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return simage(i, radix, display, width);
+    return integer_image((widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
   }
 
   std::string unsigned_long_to_string(unsigned long i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return uimage(i, radix, display, width);
+    return integer_image((widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
   }
 
   std::string longlong_to_string(long long i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return simage(i, radix, display, width);
+    return integer_image((widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
   }
 
   std::string unsigned_longlong_to_string(unsigned long long i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return uimage(i, radix, display, width);
+    return integer_image((widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
   }
 
   std::string address_to_string(const void* i, unsigned radix, radix_display_t display, unsigned width)
   {
-    return simage((std::ptrdiff_t)i, radix, display, width);
+    return integer_image((widest_unsigned)(long long)(std::ptrdiff_t)i, true, 8 * sizeof(std::ptrdiff_t), radix, display, width);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // exported conversions into a buffer
+
+  char* short_to_chars(char* first, char* last, short i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* unsigned_short_to_chars(char* first, char* last, unsigned short i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* int_to_chars(char* first, char* last, int i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* unsigned_to_chars(char* first, char* last, unsigned i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* long_to_chars(char* first, char* last, long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* unsigned_long_to_chars(char* first, char* last, unsigned long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* longlong_to_chars(char* first, char* last, long long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* unsigned_longlong_to_chars(char* first, char* last, unsigned long long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  char* address_to_chars(char* first, char* last, const void* i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    return integer_chars(first, last, (widest_unsigned)(long long)(std::ptrdiff_t)i, true, 8 * sizeof(std::ptrdiff_t), radix, display, width);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // exported conversions appending to a string
+
+  void append_short(std::string& result, short i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_unsigned_short(std::string& result, unsigned short i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_int(std::string& result, int i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_unsigned(std::string& result, unsigned i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_long(std::string& result, long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_unsigned_long(std::string& result, unsigned long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_longlong(std::string& result, long long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)(long long)i, true, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_unsigned_longlong(std::string& result, unsigned long long i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)i, false, 8 * sizeof(i), radix, display, width);
+  }
+
+  void append_address(std::string& result, const void* i, unsigned radix, radix_display_t display, unsigned width)
+  {
+    integer_append(result, (widest_unsigned)(long long)(std::ptrdiff_t)i, true, 8 * sizeof(std::ptrdiff_t), radix, display, width);
   }
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -1117,5 +884,344 @@ namespace stlplus
   }
 
   ////////////////////////////////////////////////////////////////////////////////
+  // Conversions from characters without exceptions
+  // Local generic routines
+
+  // the value of a character as a digit, which is 36 or more if it is not a digit in any radix
+  static inline unsigned digit_value(char ch)
+  {
+    return (unsigned)from_char[(unsigned char)ch];
+  }
+
+  // SWAR (SIMD within a register) conversion of eight characters at a time
+  static const widest_unsigned swar_ones = 0x0101010101010101ULL;
+  static const widest_unsigned swar_highs = 0x8080808080808080ULL;
+
+  // the characters are loaded with the first in the low byte whatever the byte order of the machine
+  static inline widest_unsigned load_chars(const char* chars, unsigned count)
+  {
+    widest_unsigned result = 0;
+    memcpy(&result, chars, count);
+    // the test of the byte order is a constant, so this is removed on a little-endian machine
+    const widest_unsigned one = 1;
+    if (*(const unsigned char*)&one == 0)
+    {
+      widest_unsigned reversed = 0;
+      for (unsigned i = 0; i < sizeof(result); i++, result >>= 8)
+        reversed = (reversed << 8) | (result & 0xff);
+      result = reversed;
+    }
+    return result;
+  }
+
+  // four decimal digits are converted as the last four of eight with leading zeros
+  static inline widest_unsigned load_four(const char* chars)
+  {
+    return (load_chars(chars, 4) << 32) | ((swar_ones * '0') >> 32);
+  }
+
+  // the value of eight decimal digits, or false if they are not all digits
+  static inline bool eight_decimal(widest_unsigned chars, widest_unsigned& value)
+  {
+    // every byte must be 0x30 to 0x39 - the upper nibble must be 3 with or without 6 added
+    if ((chars & (swar_ones * 0xf0)) != swar_ones * 0x30 ||
+        ((chars + swar_ones * 6) & (swar_ones * 0xf0)) != swar_ones * 0x30)
+      return false;
+    // combine neighbouring digits, then pairs, then fours - each step halves the number of lanes
+    widest_unsigned lanes = chars & (swar_ones * 0x0f);
+    lanes = (lanes * 10 + (lanes >> 8)) & 0x00ff00ff00ff00ffULL;
+    lanes = (lanes * 100 + (lanes >> 16)) & 0x0000ffff0000ffffULL;
+    value = (lanes * 10000 + (lanes >> 32)) & 0xffffffffULL;
+    return true;
+  }
+
+  // the value of eight hex digits in either case, or false if they are not all hex digits
+  static inline bool eight_hex(widest_unsigned chars, widest_unsigned& value)
+  {
+    // with only 7-bit characters the additions below cannot carry from one byte to the next
+    // each addition sets the top bit of the bytes at or above a character
+    if ((chars & swar_highs) != 0)
+      return false;
+    widest_unsigned digits = (chars + swar_ones * (0x80 - '0')) & ~(chars + swar_ones * (0x80 - '9' - 1)) & swar_highs;
+    widest_unsigned lower = chars | (swar_ones * 0x20);
+    widest_unsigned letters = (lower + swar_ones * (0x80 - 'a')) & ~(lower + swar_ones * (0x80 - 'f' - 1)) & swar_highs;
+    if ((digits | letters) != swar_highs)
+      return false;
+    // the low nibble is the digit value, except that letters need 9 adding
+    widest_unsigned lanes = (chars & (swar_ones * 0x0f)) + (letters >> 7) * 9;
+    lanes = ((lanes << 4) | (lanes >> 8)) & 0x00ff00ff00ff00ffULL;
+    lanes = ((lanes << 8) | (lanes >> 16)) & 0x0000ffff0000ffffULL;
+    value = ((lanes << 16) | (lanes >> 32)) & 0xffffffffULL;
+    return true;
+  }
+
+  // add a chunk of digits to a magnitude, where scale is the radix to the power of the number of digits
+  // a magnitude below 2^32 cannot overflow with a scale of up to 2^32, so only larger ones need the division
+  static inline void add_chunk(widest_unsigned& magnitude, widest_unsigned chunk, widest_unsigned scale, bool& overflow)
+  {
+    if ((magnitude >> 32) != 0 && magnitude > (~widest_unsigned(0) - chunk) / scale)
+      overflow = true;
+    else
+      magnitude = magnitude * scale + chunk;
+  }
+
+  // shift a chunk of bits into a bit pattern - the bits shifted out of the top must all be copies of the sign
+  static inline void shift_chunk(widest_unsigned& pattern, widest_unsigned chunk, unsigned bits, bool negative, bool& overflow)
+  {
+    if ((pattern >> (widest_bits - bits)) != (negative ? ~widest_unsigned(0) >> (widest_bits - bits) : 0))
+      overflow = true;
+    pattern = (pattern << bits) | chunk;
+  }
+
+  // accumulate the digits of a sign-magnitude number and return the first character that is not a digit
+  // all the digits are consumed even if the magnitude overflows
+  static const char* magnitude_value(const char* i, const char* end, unsigned radix, widest_unsigned& magnitude, bool& overflow)
+  {
+    // decimal is done eight digits at a time then four, and hex eight at a time
+    widest_unsigned chunk = 0;
+    if (radix == 10)
+    {
+      for ( ; end - i >= 8 && eight_decimal(load_chars(i, 8), chunk); i += 8)
+        add_chunk(magnitude, chunk, 100000000, overflow);
+      if (end - i >= 4 && eight_decimal(load_four(i), chunk))
+      {
+        add_chunk(magnitude, chunk, 10000, overflow);
+        i += 4;
+      }
+    }
+    else if (radix == 16)
+    {
+      for ( ; end - i >= 8 && eight_hex(load_chars(i, 8), chunk); i += 8)
+        add_chunk(magnitude, chunk, widest_unsigned(1) << 32, overflow);
+    }
+    for ( ; i != end; i++)
+    {
+      unsigned digit = digit_value(*i);
+      if (digit >= radix)
+        break;
+      // a magnitude below 2^58 cannot overflow in radix 36 or less, so only larger ones need the division
+      if ((magnitude >> (widest_bits - 6)) != 0 && magnitude > (~widest_unsigned(0) - digit) / radix)
+        overflow = true;
+      else
+        magnitude = magnitude * radix + digit;
+    }
+    return i;
+  }
+
+  // accumulate the digits of a C-style bit pattern and return the first character that is not a digit
+  // a negative pattern is sign-extended from its first digit
+  static const char* pattern_value(const char* i, const char* end, unsigned shift, bool negative, widest_unsigned& pattern, bool& overflow)
+  {
+    pattern = negative ? ~widest_unsigned(0) : 0;
+    widest_unsigned chunk = 0;
+    if (shift == 4)
+    {
+      for ( ; end - i >= 8 && eight_hex(load_chars(i, 8), chunk); i += 8)
+        shift_chunk(pattern, chunk, 32, negative, overflow);
+    }
+    unsigned radix = 1u << shift;
+    for ( ; i != end; i++)
+    {
+      unsigned digit = digit_value(*i);
+      if (digit >= radix)
+        break;
+      shift_chunk(pattern, digit, shift, negative, overflow);
+    }
+    return i;
+  }
+
+  // the generic parser for all integer types
+  // the result is the value in the widest type, sign-extended for a signed type
+  // this reads the same formats as svalue and uvalue
+  static parse_status_t integer_value(const char* begin, const char* end, widest_unsigned& value,
+                                      bool is_signed, unsigned type_bits, unsigned radix, const char** stop)
+  {
+    if (stop)
+      *stop = begin;
+    if (radix != 0 && (radix < 2 || radix > 36))
+      return parse_invalid;
+    const char* i = begin;
+    // the radix passed as a parameter is just the default - it can be overridden by either the C
+    // prefix or the hash prefix, so with a radix of 16 or more 0b is still the binary prefix
+    unsigned pattern_shift = 0;
+    if (i != end && *i == '0')
+    {
+      if (end - i > 1 && (i[1] == 'x' || i[1] == 'X'))
+      {
+        radix = 16;
+        pattern_shift = 4;
+        i += 2;
+      }
+      else if (end - i > 1 && (i[1] == 'b' || i[1] == 'B'))
+      {
+        radix = 2;
+        pattern_shift = 1;
+        i += 2;
+      }
+      else if (radix == 0)
+      {
+        radix = 8;
+        pattern_shift = 3;
+        i += 1;
+      }
+    }
+    else
+    {
+      // look for the sequence {digits}# - a valid radix has one or two digits, so the # is the second or third character
+      const char* hash = (end - i > 1 && i[1] == '#') ? i+1 : (end - i > 2 && i[2] == '#') ? i+2 : 0;
+      if (hash && digit_value(i[0]) < 10 && (hash == i+1 || digit_value(i[1]) < 10))
+      {
+        unsigned hash_radix = hash == i+1 ? digit_value(i[0]) : digit_value(i[0]) * 10 + digit_value(i[1]);
+        if (hash_radix < 2 || hash_radix > 36)
+          return parse_invalid;
+        radix = hash_radix;
+        i = hash+1;
+      }
+    }
+    if (radix == 0)
+      radix = 10;
+    bool overflow = false;
+    widest_unsigned result = 0;
+    const char* digits = i;
+    if (pattern_shift != 0)
+    {
+      // the C style formats are bit patterns - a signed pattern is negative if its first bit is set
+      bool negative = is_signed && i != end && digit_value(*i) < radix && (digit_value(*i) >> (pattern_shift - 1)) != 0;
+      // a C prefix with no digits, including a lone 0 which is the octal prefix, is zero
+      i = pattern_value(i, end, pattern_shift, negative, result, overflow);
+      if (type_bits < widest_bits)
+      {
+        if (negative)
+        {
+          // the bits above the sign bit of the type must all be ones
+          if ((result >> (type_bits - 1)) != (~widest_unsigned(0) >> (type_bits - 1)))
+            overflow = true;
+        }
+        else
+        {
+          // a natural value may use all the bits of the type, so that the
+          // 2's-complement images of negative values read back correctly
+          if ((result >> type_bits) != 0)
+            overflow = true;
+          else if (is_signed && ((result >> (type_bits - 1)) & 1))
+            result |= ~widest_unsigned(0) << type_bits;
+        }
+      }
+    }
+    else
+    {
+      // sign-magnitude
+      bool negative = false;
+      if (i != end && (*i == '-' || *i == '+'))
+      {
+        negative = *i == '-';
+        digits = ++i;
+      }
+      i = magnitude_value(i, end, radix, result, overflow);
+      if (i == digits || (negative && !is_signed))
+        return parse_invalid;
+      widest_unsigned limit = type_bits < widest_bits ? (widest_unsigned(1) << type_bits) - 1 : ~widest_unsigned(0);
+      if (is_signed)
+        limit = (limit >> 1) + (negative ? 1 : 0);
+      if (result > limit)
+        overflow = true;
+      if (negative)
+        result = widest_unsigned(0) - result;
+    }
+    if (!stop && i != end)
+      return parse_invalid;
+    if (stop)
+      *stop = i;
+    if (overflow)
+      return parse_overflow;
+    value = result;
+    return parse_ok;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // exported functions
+
+  parse_status_t chars_to_short(const char* begin, const char* end, short& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, true, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (short)(long long)result;
+    return status;
+  }
+
+  parse_status_t chars_to_unsigned_short(const char* begin, const char* end, unsigned short& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, false, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (unsigned short)result;
+    return status;
+  }
+
+  parse_status_t chars_to_int(const char* begin, const char* end, int& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, true, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (int)(long long)result;
+    return status;
+  }
+
+  parse_status_t chars_to_unsigned(const char* begin, const char* end, unsigned& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, false, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (unsigned)result;
+    return status;
+  }
+
+  parse_status_t chars_to_long(const char* begin, const char* end, long& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, true, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (long)(long long)result;
+    return status;
+  }
+
+  parse_status_t chars_to_unsigned_long(const char* begin, const char* end, unsigned long& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, false, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (unsigned long)result;
+    return status;
+  }
+
+  parse_status_t chars_to_longlong(const char* begin, const char* end, long long& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, true, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (long long)result;
+    return status;
+  }
+
+  parse_status_t chars_to_unsigned_longlong(const char* begin, const char* end, unsigned long long& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, false, 8 * sizeof(value), radix, stop);
+    if (status == parse_ok)
+      value = (unsigned long long)result;
+    return status;
+  }
+
+  parse_status_t chars_to_address(const char* begin, const char* end, void*& value, unsigned radix, const char** stop)
+  {
+    widest_unsigned result = 0;
+    parse_status_t status = integer_value(begin, end, result, true, 8 * sizeof(std::ptrdiff_t), radix, stop);
+    if (status == parse_ok)
+      value = (void*)(std::ptrdiff_t)(long long)result;
+    return status;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
@@ -91,6 +91,132 @@ namespace stlplus
                                 radix_display_t display = radix_c_style_or_hash,
                                 unsigned width = 0);
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // Conversions of Integer types into a character buffer
+  ////////////////////////////////////////////////////////////////////////////////
+  // These give the same result as the conversions to string above, but write it into
+  // the caller's buffer [first,last) in the style of std::to_chars, so they never allocate
+  // The result is the end of the characters written - no null terminator is added
+  // If the result does not fit, the result is null and the buffer contents are unspecified
+
+  // a buffer of this size plus the width is always big enough
+  const unsigned max_integer_chars = 72;
+
+  // exceptions: std::invalid_argument
+  char* short_to_chars(char* first, char* last, short i,
+                       unsigned radix = 10,
+                       radix_display_t display = radix_c_style_or_hash,
+                       unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* unsigned_short_to_chars(char* first, char* last, unsigned short i,
+                                unsigned radix = 10,
+                                radix_display_t display = radix_c_style_or_hash,
+                                unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* int_to_chars(char* first, char* last, int i,
+                     unsigned radix = 10,
+                     radix_display_t display = radix_c_style_or_hash,
+                     unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* unsigned_to_chars(char* first, char* last, unsigned i,
+                          unsigned radix = 10,
+                          radix_display_t display = radix_c_style_or_hash,
+                          unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* long_to_chars(char* first, char* last, long i,
+                      unsigned radix = 10,
+                      radix_display_t display = radix_c_style_or_hash,
+                      unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* unsigned_long_to_chars(char* first, char* last, unsigned long i,
+                               unsigned radix = 10,
+                               radix_display_t display = radix_c_style_or_hash,
+                               unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* longlong_to_chars(char* first, char* last, long long i,
+                          unsigned radix = 10,
+                          radix_display_t display = radix_c_style_or_hash,
+                          unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* unsigned_longlong_to_chars(char* first, char* last, unsigned long long i,
+                                   unsigned radix = 10,
+                                   radix_display_t display = radix_c_style_or_hash,
+                                   unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  char* address_to_chars(char* first, char* last, const void*,
+                         unsigned radix = 16,
+                         radix_display_t display = radix_c_style_or_hash,
+                         unsigned width = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Append integer types to a string
+  ////////////////////////////////////////////////////////////////////////////////
+  // These give the same result as the conversions to string above, but append it to the
+  // caller's string, so that the element formatting functions used by append_vector etc.
+  // can build a whole container image without a temporary string per element
+
+  // exceptions: std::invalid_argument
+  void append_short(std::string& result, short i,
+                    unsigned radix = 10,
+                    radix_display_t display = radix_c_style_or_hash,
+                    unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_unsigned_short(std::string& result, unsigned short i,
+                             unsigned radix = 10,
+                             radix_display_t display = radix_c_style_or_hash,
+                             unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_int(std::string& result, int i,
+                  unsigned radix = 10,
+                  radix_display_t display = radix_c_style_or_hash,
+                  unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_unsigned(std::string& result, unsigned i,
+                       unsigned radix = 10,
+                       radix_display_t display = radix_c_style_or_hash,
+                       unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_long(std::string& result, long i,
+                   unsigned radix = 10,
+                   radix_display_t display = radix_c_style_or_hash,
+                   unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_unsigned_long(std::string& result, unsigned long i,
+                            unsigned radix = 10,
+                            radix_display_t display = radix_c_style_or_hash,
+                            unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_longlong(std::string& result, long long i,
+                       unsigned radix = 10,
+                       radix_display_t display = radix_c_style_or_hash,
+                       unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_unsigned_longlong(std::string& result, unsigned long long i,
+                                unsigned radix = 10,
+                                radix_display_t display = radix_c_style_or_hash,
+                                unsigned width = 0);
+
+  // exceptions: std::invalid_argument
+  void append_address(std::string& result, const void*,
+                      unsigned radix = 16,
+                      radix_display_t display = radix_c_style_or_hash,
+                      unsigned width = 0);
+
   ////////////////////////////////////////////////////////////////////////////////
   // Convert a string to an integer type
   ////////////////////////////////////////////////////////////////////////////////
@@ -136,6 +262,50 @@ namespace stlplus
                           unsigned radix = 0);
 
   ////////////////////////////////////////////////////////////////////////////////
+  // Convert characters to an integer type without exceptions
+  ////////////////////////////////////////////////////////////////////////////////
+  // These read the same formats as the conversions from string above, but from the
+  // character range [begin,end) in the style of std::from_chars, so that a field can be
+  // parsed in place - e.g. from a line of a CSV file - without copying it to a string
+  // They never throw - the result is the parse status defined in format_types.hpp:
+  //   parse_ok       - value is set to the number
+  //   parse_invalid  - there is no number at the start of the range, or the radix is
+  //                    not valid - value is unchanged
+  //   parse_overflow - the number does not fit in the type - value is unchanged
+  // Parsing stops at the first character that cannot be part of the number
+  // If stop is non-null, it is set to point to that character, or to begin if the result is parse_invalid
+  // If stop is null, the whole range must be the number, otherwise the result is parse_invalid
+  // Unlike the string conversions, a C-style bit pattern with more significant bits than the type is
+  // reported as an overflow rather than being truncated
+
+  parse_status_t chars_to_short(const char* begin, const char* end, short& value,
+                                unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_unsigned_short(const char* begin, const char* end, unsigned short& value,
+                                         unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_int(const char* begin, const char* end, int& value,
+                              unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_unsigned(const char* begin, const char* end, unsigned& value,
+                                   unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_long(const char* begin, const char* end, long& value,
+                               unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_unsigned_long(const char* begin, const char* end, unsigned long& value,
+                                        unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_longlong(const char* begin, const char* end, long long& value,
+                                   unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_unsigned_longlong(const char* begin, const char* end, unsigned long long& value,
+                                            unsigned radix = 0, const char** stop = 0);
+
+  parse_status_t chars_to_address(const char* begin, const char* end, void*& value,
+                                  unsigned radix = 0, const char** stop = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
 
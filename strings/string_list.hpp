@@ -22,6 +22,12 @@ namespace stlplus
                              S to_string_fn,
                              const std::string& separator = ",");
 
+  template<typename T, typename A>
+  void append_list(std::string& result,
+                   const std::list<T>& values,
+                   A append_fn,
+                   const std::string& separator = ",");
+
 } // end namespace stlplus
 
 #include "string_list.tpp"
@@ -21,4 +21,13 @@ namespace stlplus
     return sequence_to_string(values.begin(), values.end(), to_string_fn, separator);
   }
 
+  template<typename T, typename A>
+  void append_list(std::string& result,
+                   const std::list<T>& values,
+                   A append_fn,
+                   const std::string& separator)
+  {
+    append_sequence(result, values.begin(), values.end(), append_fn, separator);
+  }
+
 } // end namespace stlplus
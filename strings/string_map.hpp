@@ -24,6 +24,14 @@ namespace stlplus
                             const std::string& pair_separator = ":",
                             const std::string& separator = ",");
 
+  template<typename K, typename T, typename C, typename AK, typename AT>
+  void append_map(std::string& result,
+                  const std::map<K,T,C>& values,
+                  AK key_append_fn,
+                  AT value_append_fn,
+                  const std::string& pair_separator = ":",
+                  const std::string& separator = ",");
+
   template<typename K, typename T, typename C, typename SK, typename ST>
   std::string multimap_to_string(const std::multimap<K,T,C>& values,
                                  SK key_to_string_fn,
@@ -31,6 +39,14 @@ namespace stlplus
                                  const std::string& pair_separator = ":",
                                  const std::string& separator = ",");
 
+  template<typename K, typename T, typename C, typename AK, typename AT>
+  void append_multimap(std::string& result,
+                       const std::multimap<K,T,C>& values,
+                       AK key_append_fn,
+                       AT value_append_fn,
+                       const std::string& pair_separator = ":",
+                       const std::string& separator = ",");
+
 } // end namespace stlplus
 
 #include "string_map.tpp"
@@ -26,6 +26,19 @@ namespace stlplus
                                    pair_separator, separator);
   }
 
+  template<typename K, typename T, typename C, typename AK, typename AT>
+  void append_map(std::string& result,
+                  const std::map<K,T,C>& values,
+                  AK key_append_fn,
+                  AT value_append_fn,
+                  const std::string& pair_separator,
+                  const std::string& separator)
+  {
+    append_pair_sequence(result, values.begin(), values.end(),
+                         key_append_fn, value_append_fn,
+                         pair_separator, separator);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   // multimap
 
@@ -41,5 +54,18 @@ namespace stlplus
                                    pair_separator, separator);
   }
 
+  template<typename K, typename T, typename C, typename AK, typename AT>
+  void append_multimap(std::string& result,
+                       const std::multimap<K,T,C>& values,
+                       AK key_append_fn,
+                       AT value_append_fn,
+                       const std::string& pair_separator,
+                       const std::string& separator)
+  {
+    append_pair_sequence(result, values.begin(), values.end(),
+                         key_append_fn, value_append_fn,
+                         pair_separator, separator);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 } // end namespace stlplus
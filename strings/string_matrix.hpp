@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include "matrix.hpp"
 #include <string>
 
@@ -25,6 +26,20 @@ namespace stlplus
                                const std::string& column_separator = "|",
                                const std::string& row_separator = ",");
 
+  template<typename T, typename A>
+  void append_matrix(std::string& result,
+                     const matrix<T>& values,
+                     A append_fn,
+                     const std::string& column_separator = "|",
+                     const std::string& row_separator = ",");
+
+  template<typename O, typename T, typename F>
+  void format_matrix(O& output,
+                     const matrix<T>& values,
+                     F format_fn,
+                     const std::string& column_separator,
+                     const std::string& row_separator);
+
 } // end namespace stlplus
 
 #include "string_matrix.tpp"
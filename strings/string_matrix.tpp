@@ -12,22 +12,42 @@ namespace stlplus
 
   ////////////////////////////////////////////////////////////////////////////////
 
-  template<typename T, typename S>
-  std::string matrix_to_string(const matrix<T>& values,
-                               S to_string_fn,
-                               const std::string& column_separator,
-                               const std::string& row_separator)
+  template<typename O, typename T, typename F>
+  void format_matrix(O& output,
+                     const matrix<T>& values,
+                     F format_fn,
+                     const std::string& column_separator,
+                     const std::string& row_separator)
   {
-    std::string result;
     for (unsigned r = 0; r < values.rows(); r++)
     {
-      if (r != 0) result += row_separator;
+      if (r != 0) format_text(output, row_separator);
       for (unsigned c = 0; c < values.columns(); c++)
       {
-        if (c != 0) result += column_separator;
-        result += to_string_fn(values(r,c));
+        if (c != 0) format_text(output, column_separator);
+        format_fn(output, values(r,c));
       }
     }
+  }
+
+  template<typename T, typename A>
+  void append_matrix(std::string& result,
+                     const matrix<T>& values,
+                     A append_fn,
+                     const std::string& column_separator,
+                     const std::string& row_separator)
+  {
+    format_matrix(result, values, append_fn, column_separator, row_separator);
+  }
+
+  template<typename T, typename S>
+  std::string matrix_to_string(const matrix<T>& values,
+                               S to_string_fn,
+                               const std::string& column_separator,
+                               const std::string& row_separator)
+  {
+    std::string result;
+    format_matrix(result, values, to_string_appender<S>(to_string_fn), column_separator, row_separator);
     return result;
   }
 
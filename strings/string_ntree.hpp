@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include "ntree.hpp"
 #include <string>
 
@@ -25,6 +26,20 @@ namespace stlplus
                               const std::string& separator = "|",
                               const std::string& indent_string = "  ");
 
+  template<typename T, typename A>
+  void append_ntree(std::string& result,
+                    const ntree<T>& values,
+                    A append_fn,
+                    const std::string& separator = "|",
+                    const std::string& indent_string = "  ");
+
+  template<typename O, typename T, typename F>
+  void format_ntree(O& output,
+                    const ntree<T>& values,
+                    F format_fn,
+                    const std::string& separator,
+                    const std::string& indent_string);
+
 } // end namespace stlplus
 
 #include "string_ntree.tpp"
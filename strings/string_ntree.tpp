@@ -10,6 +10,32 @@
 namespace stlplus
 {
 
+  template<typename O, typename T, typename F>
+  void format_ntree(O& output,
+                    const ntree<T>& values,
+                    F format_fn,
+                    const std::string& separator,
+                    const std::string& indent_string)
+  {
+    for (typename ntree<T>::const_prefix_iterator i = values.prefix_begin(); i != values.prefix_end(); i++)
+    {
+      if (i != values.prefix_begin()) format_text(output, separator);
+      for (unsigned indent = values.depth(i.simplify()); --indent; )
+        format_text(output, indent_string);
+      format_fn(output, *i);
+    }
+  }
+
+  template<typename T, typename A>
+  void append_ntree(std::string& result,
+                    const ntree<T>& values,
+                    A append_fn,
+                    const std::string& separator,
+                    const std::string& indent_string)
+  {
+    format_ntree(result, values, append_fn, separator, indent_string);
+  }
+
   template<typename T, typename S>
   std::string ntree_to_string(const ntree<T>& values,
                               S to_string_fn,
@@ -17,13 +43,7 @@ namespace stlplus
                               const std::string& indent_string)
   {
     std::string result;
-    for (typename ntree<T>::const_prefix_iterator i = values.prefix_begin(); i != values.prefix_end(); i++)
-    {
-      if (i != values.prefix_begin()) result += separator;
-      for (unsigned indent = values.depth(i.simplify()); --indent; )
-        result += indent_string;
-      result += to_string_fn(*i);
-    }
+    format_ntree(result, values, to_string_appender<S>(to_string_fn), separator, indent_string);
     return result;
   }
 
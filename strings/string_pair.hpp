@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include <map>
 #include <string>
 
@@ -23,6 +24,20 @@ namespace stlplus
                              S2 to_string_fn2,
                              const std::string& separator = ":");
 
+  template<typename V1, typename V2, typename A1, typename A2>
+  void append_pair(std::string& result,
+                   const std::pair<V1,V2>& values,
+                   A1 append_fn1,
+                   A2 append_fn2,
+                   const std::string& separator = ":");
+
+  template<typename O, typename V1, typename V2, typename F1, typename F2>
+  void format_pair(O& output,
+                   const std::pair<V1,V2>& values,
+                   F1 format_fn1,
+                   F2 format_fn2,
+                   const std::string& separator);
+
 } // end namespace stlplus
 
 #include "string_pair.tpp"
@@ -10,13 +10,37 @@
 namespace stlplus
 {
 
+  template<typename O, typename V1, typename V2, typename F1, typename F2>
+  void format_pair(O& output,
+                   const std::pair<V1,V2>& values,
+                   F1 format_fn1,
+                   F2 format_fn2,
+                   const std::string& separator)
+  {
+    format_fn1(output, values.first);
+    format_text(output, separator);
+    format_fn2(output, values.second);
+  }
+
+  template<typename V1, typename V2, typename A1, typename A2>
+  void append_pair(std::string& result,
+                   const std::pair<V1,V2>& values,
+                   A1 append_fn1,
+                   A2 append_fn2,
+                   const std::string& separator)
+  {
+    format_pair(result, values, append_fn1, append_fn2, separator);
+  }
+
   template<typename V1, typename V2, typename S1, typename S2>
   std::string pair_to_string(const std::pair<V1,V2>& values,
                              S1 to_string_fn1,
                              S2 to_string_fn2,
                              const std::string& separator)
   {
-    return to_string_fn1(values.first) + separator + to_string_fn2(values.second);
+    std::string result;
+    format_pair(result, values, to_string_appender<S1>(to_string_fn1), to_string_appender<S2>(to_string_fn2), separator);
+    return result;
   }
 
 } // end namespace stlplus
@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include <string>
 
 namespace stlplus
@@ -23,6 +24,22 @@ namespace stlplus
                                 const std::string& prefix = "(",
                                 const std::string& suffix = ")");
 
+  template <typename T, typename A>
+  void append_pointer(std::string& result,
+                      const T* value,
+                      A append_fn,
+                      const std::string& null_string = "<null>",
+                      const std::string& prefix = "(",
+                      const std::string& suffix = ")");
+
+  template <typename O, typename T, typename F>
+  void format_pointer(O& output,
+                      const T* value,
+                      F format_fn,
+                      const std::string& null_string,
+                      const std::string& prefix,
+                      const std::string& suffix);
+
 
 }
 
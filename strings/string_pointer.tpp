@@ -11,6 +11,37 @@
 namespace stlplus
 {
 
+  template <typename O, typename T, typename F>
+  void format_pointer(O& output,
+                      const T* value,
+                      F format_fn,
+                      const std::string& null_string,
+                      const std::string& prefix,
+                      const std::string& suffix)
+  {
+    if (value)
+    {
+      format_text(output, prefix);
+      format_fn(output, *value);
+      format_text(output, suffix);
+    }
+    else
+    {
+      format_text(output, null_string);
+    }
+  }
+
+  template <typename T, typename A>
+  void append_pointer(std::string& result,
+                      const T* value,
+                      A append_fn,
+                      const std::string& null_string,
+                      const std::string& prefix,
+                      const std::string& suffix)
+  {
+    format_pointer(result, value, append_fn, null_string, prefix, suffix);
+  }
+
   template <typename T, typename S>
   std::string pointer_to_string(const T* value,
                                 S to_string_fn,
@@ -18,7 +49,9 @@ namespace stlplus
                                 const std::string& prefix,
                                 const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    std::string result;
+    format_pointer(result, value, to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
   }
 
 } // end namespace stlplus
@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include <string>
 
 namespace stlplus
@@ -25,6 +26,21 @@ namespace stlplus
                                  S to_string,
                                  const std::string& separator);
 
+  // append form - append_fn(result, value) appends each element to the string
+  template <typename I, typename A>
+  void append_sequence(std::string& result,
+                       I begin,
+                       I end,
+                       A append_fn,
+                       const std::string& separator);
+
+  // formatting core - output is a std::string or std::ostream and format_fn(output, value) writes each element
+  template <typename O, typename I, typename F>
+  void format_sequence(O& output,
+                       I begin,
+                       I end,
+                       F format_fn,
+                       const std::string& separator);
 
   ////////////////////////////////////////////////////////////////////////////////
   // any forward iterator sequence of pairs
@@ -37,6 +53,24 @@ namespace stlplus
                                       const std::string& pair_separator,
                                       const std::string& separator);
 
+  template <typename I, typename A1, typename A2>
+  void append_pair_sequence(std::string& result,
+                            I begin,
+                            I end,
+                            A1 append_fn1,
+                            A2 append_fn2,
+                            const std::string& pair_separator,
+                            const std::string& separator);
+
+  template <typename O, typename I, typename F1, typename F2>
+  void format_pair_sequence(O& output,
+                            I begin,
+                            I end,
+                            F1 format_fn1,
+                            F2 format_fn2,
+                            const std::string& pair_separator,
+                            const std::string& separator);
+
   ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
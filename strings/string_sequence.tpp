@@ -14,6 +14,30 @@ namespace stlplus
   ////////////////////////////////////////////////////////////////////////////////
   // any forward iterator sequence
 
+  template <typename O, typename I, typename F>
+  void format_sequence(O& output,
+                       I begin,
+                       I end,
+                       F format_fn,
+                       const std::string& separator)
+  {
+    for (I i = begin; i != end; i++)
+    {
+      if (i != begin) format_text(output, separator);
+      format_fn(output, *i);
+    }
+  }
+
+  template <typename I, typename A>
+  void append_sequence(std::string& result,
+                       I begin,
+                       I end,
+                       A append_fn,
+                       const std::string& separator)
+  {
+    format_sequence(result, begin, end, append_fn, separator);
+  }
+
   template <typename I, typename S>
   std::string sequence_to_string(I begin,
                                  I end,
@@ -21,17 +45,41 @@ namespace stlplus
                                  const std::string& separator)
   {
     std::string result;
-    for (I i = begin; i != end; i++)
-    {
-      if (i != begin) result += separator;
-      result += to_string(*i);
-    }
+    format_sequence(result, begin, end, to_string_appender<S>(to_string), separator);
     return result;
   }
 
   ////////////////////////////////////////////////////////////////////////////////
   // any sequence where the value is a pair
 
+  template <typename O, typename I, typename F1, typename F2>
+  void format_pair_sequence(O& output,
+                            I begin,
+                            I end,
+                            F1 format_fn1,
+                            F2 format_fn2,
+                            const std::string& pair_separator,
+                            const std::string& separator)
+  {
+    for (I i = begin; i != end; i++)
+    {
+      if (i != begin) format_text(output, separator);
+      format_pair(output, *i, format_fn1, format_fn2, pair_separator);
+    }
+  }
+
+  template <typename I, typename A1, typename A2>
+  void append_pair_sequence(std::string& result,
+                            I begin,
+                            I end,
+                            A1 append_fn1,
+                            A2 append_fn2,
+                            const std::string& pair_separator,
+                            const std::string& separator)
+  {
+    format_pair_sequence(result, begin, end, append_fn1, append_fn2, pair_separator, separator);
+  }
+
   template <typename I, typename S1, typename S2>
   std::string pair_sequence_to_string(I begin,
                                       I end,
@@ -41,11 +89,9 @@ namespace stlplus
                                       const std::string& separator)
   {
     std::string result;
-    for (I i = begin; i != end; i++)
-    {
-      if (i != begin) result += separator;
-      result += pair_to_string(*i, to_string_fn1, to_string_fn2, pair_separator);
-    }
+    format_pair_sequence(result, begin, end,
+                         to_string_appender<S1>(to_string_fn1), to_string_appender<S2>(to_string_fn2),
+                         pair_separator, separator);
     return result;
   }
 
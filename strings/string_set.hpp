@@ -22,11 +22,23 @@ namespace stlplus
                             S to_string_fn,
                             const std::string& separator = ",");
 
+  template<typename K, typename C, typename A>
+  void append_set(std::string& result,
+                  const std::set<K,C>& values,
+                  A append_fn,
+                  const std::string& separator = ",");
+
   template<typename K, typename C, typename S>
   std::string multiset_to_string(const std::multiset<K,C>& values,
                                  S to_string_fn,
                                  const std::string& separator = ",");
 
+  template<typename K, typename C, typename A>
+  void append_multiset(std::string& result,
+                       const std::multiset<K,C>& values,
+                       A append_fn,
+                       const std::string& separator = ",");
+
 } // end namespace stlplus
 
 #include "string_set.tpp"
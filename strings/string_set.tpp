@@ -24,6 +24,15 @@ namespace stlplus
     return sequence_to_string(values.begin(), values.end(), to_string_fn, separator);
   }
 
+  template<typename K, typename C, typename A>
+  void append_set(std::string& result,
+                  const std::set<K,C>& values,
+                  A append_fn,
+                  const std::string& separator)
+  {
+    append_sequence(result, values.begin(), values.end(), append_fn, separator);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   // multiset
 
@@ -35,5 +44,14 @@ namespace stlplus
     return sequence_to_string(values.begin(), values.end(), to_string_fn, separator);
   }
 
+  template<typename K, typename C, typename A>
+  void append_multiset(std::string& result,
+                       const std::multiset<K,C>& values,
+                       A append_fn,
+                       const std::string& separator)
+  {
+    append_sequence(result, values.begin(), values.end(), append_fn, separator);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 } // end namespace stlplus
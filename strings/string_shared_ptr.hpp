@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include <memory>
 #include <string>
 
@@ -28,6 +29,24 @@ namespace stlplus
                                   const std::string& prefix = "(",
                                   const std::string& suffix = ")");
 
+  template<typename T, typename A>
+  void append_shared_ptr(std::string& result,
+                         const std::shared_ptr<T>& value,
+                         A append_fn,
+                         const std::string& empty_string = "<empty>",
+                         const std::string& null_string = "<null>",
+                         const std::string& prefix = "(",
+                         const std::string& suffix = ")");
+
+  template<typename O, typename T, typename F>
+  void format_shared_ptr(O& output,
+                         const std::shared_ptr<T>& value,
+                         F format_fn,
+                         const std::string& empty_string,
+                         const std::string& null_string,
+                         const std::string& prefix,
+                         const std::string& suffix);
+
 } // end namespace stlplus
 
 #include "string_shared_ptr.tpp"
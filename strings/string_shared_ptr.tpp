@@ -6,10 +6,38 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_pointer.hpp"
 
 namespace stlplus
 {
 
+  template<typename O, typename T, typename F>
+  void format_shared_ptr(O& output,
+                         const std::shared_ptr<T>& value,
+                         F format_fn,
+                         const std::string& empty_string,
+                         const std::string& null_string,
+                         const std::string& prefix,
+                         const std::string& suffix)
+  {
+    if (value.use_count() == 0)
+      format_text(output, empty_string);
+    else
+      format_pointer(output, value.get(), format_fn, null_string, prefix, suffix);
+  }
+
+  template<typename T, typename A>
+  void append_shared_ptr(std::string& result,
+                         const std::shared_ptr<T>& value,
+                         A append_fn,
+                         const std::string& empty_string,
+                         const std::string& null_string,
+                         const std::string& prefix,
+                         const std::string& suffix)
+  {
+    format_shared_ptr(result, value, append_fn, empty_string, null_string, prefix, suffix);
+  }
+
   template<typename T, typename S>
   std::string shared_ptr_to_string(const std::shared_ptr<T>& value,
                                    S to_string_fn,
@@ -18,11 +46,9 @@ namespace stlplus
                                    const std::string& prefix,
                                    const std::string& suffix)
   {
-    if (value.use_count() == 0)
-      return empty_string;
-    if (value.get() == 0)
-      return null_string;
-    return prefix + to_string_fn(*value) + suffix;
+    std::string result;
+    format_shared_ptr(result, value, to_string_appender<S>(to_string_fn), empty_string, null_string, prefix, suffix);
+    return result;
   }
 
 } // end namespace stlplus
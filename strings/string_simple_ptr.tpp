@@ -6,38 +6,78 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_pointer.hpp"
 
 namespace stlplus
 {
 
   template<typename T, typename S>
   std::string simple_ptr_to_string(const simple_ptr<T>& value,
-                                  S to_string_fn,
-                                  const std::string& null_string,
-                                  const std::string& prefix,
-                                  const std::string& suffix)
+                                   S to_string_fn,
+                                   const std::string& null_string,
+                                   const std::string& prefix,
+                                   const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    std::string result;
+    format_pointer(result, value.pointer(), to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
   }
 
-  template<typename T, typename S>
-  std::string simple_ptr_clone_to_string(const simple_ptr_clone<T>& value,
-                                        S to_string_fn,
-                                        const std::string& null_string,
-                                        const std::string& prefix,
-                                        const std::string& suffix)
+  template<typename T, typename A>
+  void append_simple_ptr(std::string& result,
+                         const simple_ptr<T>& value,
+                         A append_fn,
+                         const std::string& null_string,
+                         const std::string& prefix,
+                         const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    format_pointer(result, value.pointer(), append_fn, null_string, prefix, suffix);
   }
 
   template<typename T, typename S>
-  std::string simple_ptr_nocopy_to_string(const simple_ptr_nocopy<T>& value,
+  std::string simple_ptr_clone_to_string(const simple_ptr_clone<T>& value,
                                          S to_string_fn,
                                          const std::string& null_string,
                                          const std::string& prefix,
                                          const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    std::string result;
+    format_pointer(result, value.pointer(), to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
+  }
+
+  template<typename T, typename A>
+  void append_simple_ptr_clone(std::string& result,
+                               const simple_ptr_clone<T>& value,
+                               A append_fn,
+                               const std::string& null_string,
+                               const std::string& prefix,
+                               const std::string& suffix)
+  {
+    format_pointer(result, value.pointer(), append_fn, null_string, prefix, suffix);
+  }
+
+  template<typename T, typename S>
+  std::string simple_ptr_nocopy_to_string(const simple_ptr_nocopy<T>& value,
+                                          S to_string_fn,
+                                          const std::string& null_string,
+                                          const std::string& prefix,
+                                          const std::string& suffix)
+  {
+    std::string result;
+    format_pointer(result, value.pointer(), to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
+  }
+
+  template<typename T, typename A>
+  void append_simple_ptr_nocopy(std::string& result,
+                                const simple_ptr_nocopy<T>& value,
+                                A append_fn,
+                                const std::string& null_string,
+                                const std::string& prefix,
+                                const std::string& suffix)
+  {
+    format_pointer(result, value.pointer(), append_fn, null_string, prefix, suffix);
   }
 
 } // end namespace stlplus
@@ -26,6 +26,14 @@ namespace stlplus
                                   const std::string& prefix = "(",
                                   const std::string& suffix = ")");
 
+  template<typename T, typename A>
+  void append_smart_ptr(std::string& result,
+                        const smart_ptr<T>& value,
+                        A append_fn,
+                        const std::string& null_string = "<null>",
+                        const std::string& prefix = "(",
+                        const std::string& suffix = ")");
+
   template<typename T, typename S>
   std::string smart_ptr_clone_to_string(const smart_ptr_clone<T>& value,
                                         S to_string_fn,
@@ -33,6 +41,14 @@ namespace stlplus
                                         const std::string& prefix = "(",
                                         const std::string& suffix = ")");
 
+  template<typename T, typename A>
+  void append_smart_ptr_clone(std::string& result,
+                              const smart_ptr_clone<T>& value,
+                              A append_fn,
+                              const std::string& null_string = "<null>",
+                              const std::string& prefix = "(",
+                              const std::string& suffix = ")");
+
   template<typename T, typename S>
   std::string smart_ptr__nocopy_to_string(const smart_ptr_nocopy<T>& value,
                                           S to_string_fn,
@@ -40,6 +56,14 @@ namespace stlplus
                                           const std::string& prefix = "(",
                                           const std::string& suffix = ")");
 
+  template<typename T, typename A>
+  void append_smart_ptr_nocopy(std::string& result,
+                               const smart_ptr_nocopy<T>& value,
+                               A append_fn,
+                               const std::string& null_string = "<null>",
+                               const std::string& prefix = "(",
+                               const std::string& suffix = ")");
+
 
 } // end namespace stlplus
 
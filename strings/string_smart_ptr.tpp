@@ -6,6 +6,7 @@
 //   License:   BSD License, see ../docs/license.html
 
 ////////////////////////////////////////////////////////////////////////////////
+#include "string_pointer.hpp"
 
 namespace stlplus
 {
@@ -17,7 +18,20 @@ namespace stlplus
                                   const std::string& prefix,
                                   const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    std::string result;
+    format_pointer(result, value.pointer(), to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
+  }
+
+  template<typename T, typename A>
+  void append_smart_ptr(std::string& result,
+                        const smart_ptr<T>& value,
+                        A append_fn,
+                        const std::string& null_string,
+                        const std::string& prefix,
+                        const std::string& suffix)
+  {
+    format_pointer(result, value.pointer(), append_fn, null_string, prefix, suffix);
   }
 
   template<typename T, typename S>
@@ -27,7 +41,20 @@ namespace stlplus
                                         const std::string& prefix,
                                         const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    std::string result;
+    format_pointer(result, value.pointer(), to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
+  }
+
+  template<typename T, typename A>
+  void append_smart_ptr_clone(std::string& result,
+                              const smart_ptr_clone<T>& value,
+                              A append_fn,
+                              const std::string& null_string,
+                              const std::string& prefix,
+                              const std::string& suffix)
+  {
+    format_pointer(result, value.pointer(), append_fn, null_string, prefix, suffix);
   }
 
   template<typename T, typename S>
@@ -37,7 +64,20 @@ namespace stlplus
                                          const std::string& prefix,
                                          const std::string& suffix)
   {
-    return value ? (prefix + to_string_fn(*value) + suffix) : null_string;
+    std::string result;
+    format_pointer(result, value.pointer(), to_string_appender<S>(to_string_fn), null_string, prefix, suffix);
+    return result;
+  }
+
+  template<typename T, typename A>
+  void append_smart_ptr_nocopy(std::string& result,
+                               const smart_ptr_nocopy<T>& value,
+                               A append_fn,
+                               const std::string& null_string,
+                               const std::string& prefix,
+                               const std::string& suffix)
+  {
+    format_pointer(result, value.pointer(), append_fn, null_string, prefix, suffix);
   }
 
 } // end namespace stlplus
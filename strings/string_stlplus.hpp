@@ -24,6 +24,7 @@
 
 // can be excluded to break the dependency on the portability library
 #ifndef NO_STLPLUS_INF
+#include "string_fixed_inf.hpp"
 #include "string_inf.hpp"
 #endif
 
@@ -19,4 +19,9 @@ namespace stlplus
     return value;
   }
 
+  void append_string(std::string& result, const std::string& value)
+  {
+    result += value;
+  }
+
 } // end namespace stlplus
@@ -21,6 +21,9 @@ namespace stlplus
 
   std::string string_to_string(const std::string& value);
 
+  // append form, e.g. for use in append_vector for vector<string>
+  void append_string(std::string& result, const std::string& value);
+
 }
 
 #endif
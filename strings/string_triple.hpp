@@ -11,6 +11,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "strings_fixes.hpp"
+#include "format_output.hpp"
 #include "triple.hpp"
 #include <string>
 
@@ -26,6 +27,22 @@ namespace stlplus
                                S3 to_string_fn3,
                                const std::string& separator = ":");
 
+  template<typename T1, typename T2, typename T3, typename A1, typename A2, typename A3>
+  void append_triple(std::string& result,
+                     const triple<T1,T2,T3>& values,
+                     A1 append_fn1,
+                     A2 append_fn2,
+                     A3 append_fn3,
+                     const std::string& separator = ":");
+
+  template<typename O, typename T1, typename T2, typename T3, typename F1, typename F2, typename F3>
+  void format_triple(O& output,
+                     const triple<T1,T2,T3>& values,
+                     F1 format_fn1,
+                     F2 format_fn2,
+                     F3 format_fn3,
+                     const std::string& separator);
+
 } // end namespace stlplus
 
 #include "string_triple.tpp"
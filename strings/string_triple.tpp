@@ -10,6 +10,32 @@
 namespace stlplus
 {
 
+  template<typename O, typename T1, typename T2, typename T3, typename F1, typename F2, typename F3>
+  void format_triple(O& output,
+                     const triple<T1,T2,T3>& values,
+                     F1 format_fn1,
+                     F2 format_fn2,
+                     F3 format_fn3,
+                     const std::string& separator)
+  {
+    format_fn1(output, values.first);
+    format_text(output, separator);
+    format_fn2(output, values.second);
+    format_text(output, separator);
+    format_fn3(output, values.third);
+  }
+
+  template<typename T1, typename T2, typename T3, typename A1, typename A2, typename A3>
+  void append_triple(std::string& result,
+                     const triple<T1,T2,T3>& values,
+                     A1 append_fn1,
+                     A2 append_fn2,
+                     A3 append_fn3,
+                     const std::string& separator)
+  {
+    format_triple(result, values, append_fn1, append_fn2, append_fn3, separator);
+  }
+
   template<typename T1, typename T2, typename T3, typename S1, typename S2, typename S3>
   std::string triple_to_string(const triple<T1,T2,T3>& values,
                                S1 to_string_fn1,
@@ -17,12 +43,13 @@ namespace stlplus
                                S3 to_string_fn3,
                                const std::string& separator)
   {
-    return
-      to_string_fn1(values.first) +
-      separator +
-      to_string_fn2(values.second) +
-      separator +
-      to_string_fn3(values.third);
+    std::string result;
+    format_triple(result, values,
+                  to_string_appender<S1>(to_string_fn1),
+                  to_string_appender<S2>(to_string_fn2),
+                  to_string_appender<S3>(to_string_fn3),
+                  separator);
+    return result;
   }
 
 } // end namespace stlplus
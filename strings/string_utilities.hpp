@@ -74,6 +74,7 @@ namespace stlplus
   // there are also character sets [a-z] [qwertyuiop] etc. which match 1 character
   // TODO: character sets like [:alpha:]
   // TODO eventually: regular expression matching and substitution (3rd party library?)
+  // this is the same as stlplus::wildcard - to match many strings against one expression, compile it once with wildcard_pattern
 
   bool match_wildcard(const std::string& wild,
                       const std::string& match);
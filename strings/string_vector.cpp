@@ -17,11 +17,17 @@ namespace stlplus
   std::string bool_vector_to_string(const std::vector<bool>& values)
   {
     std::string result;
-    for (size_t i = 0; i < values.size(); i++)
-      result.append(1, values[i] ? '1' : '0');
+    append_bool_vector(result, values);
     return result;
   }
 
+  void append_bool_vector(std::string& result, const std::vector<bool>& values)
+  {
+    result.reserve(result.size() + values.size());
+    for (size_t i = 0; i < values.size(); i++)
+      result += values[i] ? '1' : '0';
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
@@ -25,9 +25,17 @@ namespace stlplus
                                S to_string_fn,
                                const std::string& separator = ",");
 
+  template<typename T, typename A>
+  void append_vector(std::string& result,
+                     const std::vector<T>& values,
+                     A append_fn,
+                     const std::string& separator = ",");
+
   // specialisation for vector<bool> which has a different implementation
   std::string bool_vector_to_string(const std::vector<bool>& values);
 
+  void append_bool_vector(std::string& result, const std::vector<bool>& values);
+
   ////////////////////////////////////////////////////////////////////////////////
 
 } // end namespace stlplus
@@ -0,0 +1,188 @@
+#include <string>
+#include <vector>
+#include <map>
+#include "persistent_contexts.hpp"
+#include "persistent_archive.hpp"
+#include "persistent_map.hpp"
+#include "persistent_vector.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "strings.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define SECTIONS 8
+#define NUMBER 50
+#define THREADS 4
+#define DATA "archive_test.tmp"
+#define MASTER "archive_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<int,std::string> int_string_map;
+typedef std::vector<int> int_vector;
+
+void dump_int_string_map(stlplus::dump_context& context, const int_string_map& data)
+{
+  stlplus::dump_map(context, data, stlplus::dump_int, stlplus::dump_string);
+}
+
+void restore_int_string_map(stlplus::restore_context& context, int_string_map& data)
+{
+  stlplus::restore_map(context, data, stlplus::restore_int, stlplus::restore_string);
+}
+
+void dump_int_vector(stlplus::dump_context& context, const int_vector& data)
+{
+  stlplus::dump_vector(context, data, stlplus::dump_int);
+}
+
+void restore_int_vector(stlplus::restore_context& context, int_vector& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_int);
+}
+
+// the sample state is a set of independent maps plus a vector
+class state
+{
+public:
+  std::vector<int_string_map> m_maps;
+  int_vector m_vector;
+
+  state(void) : m_maps(SECTIONS) {}
+
+  void add_sections(stlplus::dump_archive& archive) const
+    {
+      for (unsigned i = 0; i < m_maps.size(); i++)
+        archive.add(m_maps[i], dump_int_string_map, 0);
+      archive.add(m_vector, dump_int_vector, 0);
+    }
+
+  void add_sections(stlplus::restore_archive& archive)
+    {
+      for (unsigned i = 0; i < m_maps.size(); i++)
+        archive.add(m_maps[i], restore_int_string_map, 0);
+      archive.add(m_vector, restore_int_vector, 0);
+    }
+};
+
+bool compare(const state& left, const state& right)
+{
+  bool result = true;
+  for (unsigned i = 0; i < left.m_maps.size(); i++)
+  {
+    if (left.m_maps[i] != right.m_maps[i])
+    {
+      std::cerr << "map section " << i << " is different" << std::endl;
+      result = false;
+    }
+  }
+  if (left.m_vector != right.m_vector)
+  {
+    std::cerr << "vector section is different" << std::endl;
+    result = false;
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing " << SECTIONS << " sections of " << NUMBER << " mappings" << std::endl;
+
+  try
+  {
+    // build the sample data structure
+    std::cerr << "creating" << std::endl;
+    state data;
+    for (unsigned s = 0; s < SECTIONS; s++)
+      for (unsigned i = 0; i < NUMBER; i++)
+        data.m_maps[s][i] = stlplus::dformat("section %u value %u", s, i);
+    for (unsigned i = 0; i < NUMBER; i++)
+      data.m_vector.push_back((int)(i * i) - NUMBER);
+
+    // dump to the file using several threads
+    std::cerr << "dumping" << std::endl;
+    {
+      stlplus::dump_archive archive;
+      data.add_sections(archive);
+      archive.dump_to_file(DATA, THREADS);
+    }
+
+    // now restore the same file and compare
+    std::cerr << "restoring" << std::endl;
+    {
+      state restored;
+      stlplus::restore_archive archive;
+      restored.add_sections(archive);
+      archive.restore_from_file(DATA, THREADS);
+      result &= compare(data, restored);
+    }
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      state master;
+      stlplus::restore_archive archive;
+      master.add_sections(archive);
+      archive.restore_from_file(MASTER, THREADS);
+      result &= compare(data, master);
+    }
+
+    // restoring a subset of the sections is allowed
+    std::cerr << "restoring first section only" << std::endl;
+    {
+      int_string_map first;
+      stlplus::restore_archive archive;
+      archive.add(first, restore_int_string_map, 0);
+      archive.restore_from_file(DATA);
+      if (first != data.m_maps[0])
+      {
+        std::cerr << "error: first section is different" << std::endl;
+        result = false;
+      }
+    }
+
+    // restoring more sections than were dumped is an error
+    std::cerr << "restoring too many sections" << std::endl;
+    try
+    {
+      state restored;
+      int_vector extra;
+      stlplus::restore_archive archive;
+      restored.add_sections(archive);
+      archive.add(extra, restore_int_vector, 0);
+      archive.restore_from_file(DATA);
+      std::cerr << "error: restored more sections than dumped" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
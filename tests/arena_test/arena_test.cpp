@@ -0,0 +1,388 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include "smart_ptr.hpp"
+#include "persistent_contexts.hpp"
+#include "persistent_arena.hpp"
+#include "persistent_pointer.hpp"
+#include "persistent_callback.hpp"
+#include "persistent_smart_ptr.hpp"
+#include "persistent_vector.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "persistent_shortcuts.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 1000
+#define DATA "arena_test.tmp"
+#define MASTER "arena_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+// a graph of nodes linked by plain pointers - a ring with an extra link from every node
+// the nodes don't own each other, so the graph is deleted through the vector of all nodes
+
+static int live_nodes = 0;
+
+class node
+{
+public:
+  int m_value;
+  std::string m_name;
+  node* m_next;
+  node* m_other;
+
+  node(int value = 0) : m_value(value), m_name(stlplus::dformat("node %d", value)), m_next(0), m_other(0) {live_nodes++;}
+  ~node(void) {live_nodes--;}
+};
+
+void dump_node(stlplus::dump_context& context, const node& data);
+void restore_node(stlplus::restore_context& context, node& data);
+
+void dump_node_ptr(stlplus::dump_context& context, node* const& data)
+{
+  stlplus::dump_pointer(context, data, dump_node);
+}
+
+void restore_node_ptr(stlplus::restore_context& context, node*& data)
+{
+  stlplus::restore_pointer(context, data, restore_node);
+}
+
+void dump_node(stlplus::dump_context& context, const node& data)
+{
+  stlplus::dump_int(context, data.m_value);
+  stlplus::dump_string(context, data.m_name);
+  dump_node_ptr(context, data.m_next);
+  dump_node_ptr(context, data.m_other);
+}
+
+void restore_node(stlplus::restore_context& context, node& data)
+{
+  stlplus::restore_int(context, data.m_value);
+  stlplus::restore_string(context, data.m_name);
+  restore_node_ptr(context, data.m_next);
+  restore_node_ptr(context, data.m_other);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// polymorphic objects using callbacks
+
+static int live_shapes = 0;
+
+class shape
+{
+public:
+  int m_size;
+
+  shape(int size = 0) : m_size(size) {live_shapes++;}
+  shape(const shape& right) : m_size(right.m_size) {live_shapes++;}
+  virtual ~shape(void) {live_shapes--;}
+  virtual shape* clone(void) const {return new shape(*this);}
+  virtual std::string image(void) const {return stlplus::dformat("shape %d", m_size);}
+};
+
+class square : public shape
+{
+public:
+  std::string m_colour;
+
+  square(int size = 0) : shape(size), m_colour(size % 2 ? "red" : "blue") {}
+  virtual shape* clone(void) const {return new square(*this);}
+  virtual std::string image(void) const {return stlplus::dformat("%s square %d", m_colour.c_str(), m_size);}
+};
+
+void dump_shape(stlplus::dump_context& context, const void* data)
+{
+  stlplus::dump_int(context, ((const shape*)data)->m_size);
+}
+
+void* create_shape(void)
+{
+  return new shape;
+}
+
+void restore_shape(stlplus::restore_context& context, void* data)
+{
+  stlplus::restore_int(context, ((shape*)data)->m_size);
+}
+
+void dump_square(stlplus::dump_context& context, const void* data)
+{
+  dump_shape(context, data);
+  stlplus::dump_string(context, ((const square*)data)->m_colour);
+}
+
+void* create_square(void)
+{
+  return new square;
+}
+
+void restore_square(stlplus::restore_context& context, void* data)
+{
+  restore_shape(context, data);
+  stlplus::restore_string(context, ((square*)data)->m_colour);
+}
+
+void install_shape_dump(stlplus::dump_context& context)
+{
+  context.register_callback(typeid(shape), dump_shape);
+  context.register_callback(typeid(square), dump_square);
+}
+
+// shapes are created in the arena, squares are created with new and handed over to the arena
+void install_shape_restore(stlplus::restore_context& context)
+{
+  context.register_callback(create_shape, restore_shape, stlplus::create_in_arena<shape>);
+  context.register_callback(create_square, restore_square);
+}
+
+void dump_shape_ptr(stlplus::dump_context& context, shape* const& data)
+{
+  stlplus::dump_callback(context, data);
+}
+
+void restore_shape_ptr(stlplus::restore_context& context, shape*& data)
+{
+  stlplus::restore_callback(context, data);
+}
+
+typedef stlplus::smart_ptr_clone<shape> shape_smart_ptr;
+
+void dump_shape_smart_ptr(stlplus::dump_context& context, const shape_smart_ptr& data)
+{
+  stlplus::dump_smart_ptr_clone_callback(context, data);
+}
+
+void restore_shape_smart_ptr(stlplus::restore_context& context, shape_smart_ptr& data)
+{
+  stlplus::restore_smart_ptr_clone_callback(context, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// a pair of pointers to the same int with the given magic number, as a dump would write them if it numbered pointers
+// from that magic number - used to check that restoring a corrupt dump neither crashes nor allocates a huge table
+
+typedef std::pair<int*,int*> int_pointer_pair;
+
+void dump_magic_pointers(stlplus::dump_context& context, const unsigned& magic)
+{
+  stlplus::dump_unsigned(context, magic);
+  stlplus::dump_int(context, 42);
+  stlplus::dump_unsigned(context, magic);
+}
+
+void restore_int_pointer_pair(stlplus::restore_context& context, int_pointer_pair& data)
+{
+  stlplus::restore_pointer(context, data.first, stlplus::restore_int);
+  stlplus::restore_pointer(context, data.second, stlplus::restore_int);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// the whole data structure
+
+class model
+{
+public:
+  std::vector<node*> m_nodes;
+  std::vector<shape*> m_shapes;
+  std::vector<shape_smart_ptr> m_owned;
+
+  // delete the objects in a model that was not restored into an arena
+  void clear(void)
+    {
+      for (unsigned i = 0; i < m_nodes.size(); i++)
+        delete m_nodes[i];
+      m_nodes.clear();
+      for (unsigned i = 0; i < m_shapes.size(); i++)
+        delete m_shapes[i];
+      m_shapes.clear();
+      m_owned.clear();
+    }
+};
+
+void dump_model(stlplus::dump_context& context, const model& data)
+{
+  stlplus::dump_vector(context, data.m_nodes, dump_node_ptr);
+  stlplus::dump_vector(context, data.m_shapes, dump_shape_ptr);
+  stlplus::dump_vector(context, data.m_owned, dump_shape_smart_ptr);
+}
+
+void restore_model(stlplus::restore_context& context, model& data)
+{
+  stlplus::restore_vector(context, data.m_nodes, restore_node_ptr);
+  stlplus::restore_vector(context, data.m_shapes, restore_shape_ptr);
+  stlplus::restore_vector(context, data.m_owned, restore_shape_smart_ptr);
+}
+
+// restore into an arena - the equivalent of restore_from_file
+void restore_model_in_arena(const std::string& filename, model& data, stlplus::restore_arena& arena)
+{
+  std::ifstream input(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+  stlplus::restore_context context(input);
+  context.register_all(install_shape_restore);
+  context.set_arena(&arena);
+  restore_model(context, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string image(const model& data)
+{
+  std::string result;
+  for (unsigned i = 0; i < data.m_nodes.size(); i++)
+  {
+    const node* n = data.m_nodes[i];
+    result += stlplus::dformat("%d %s %d %d;", n->m_value, n->m_name.c_str(), n->m_next->m_value, n->m_other->m_value);
+    // the pointers must point into the graph, not at copies
+    if (n->m_next != data.m_nodes[(i+1) % data.m_nodes.size()])
+      result += "bad link;";
+  }
+  for (unsigned i = 0; i < data.m_shapes.size(); i++)
+    result += data.m_shapes[i]->image() + ";";
+  for (unsigned i = 0; i < data.m_owned.size(); i++)
+    result += data.m_owned[i]->image() + ";";
+  return result;
+}
+
+bool compare(const model& left, const model& right)
+{
+  if (image(left) != image(right))
+  {
+    std::cerr << "models are different" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing arena restore of " << NUMBER << " nodes" << std::endl;
+
+  try
+  {
+    // build the sample data structure
+    std::cerr << "creating" << std::endl;
+    model data;
+    for (int i = 0; i < NUMBER; i++)
+      data.m_nodes.push_back(new node(i));
+    for (int i = 0; i < NUMBER; i++)
+    {
+      data.m_nodes[i]->m_next = data.m_nodes[(i+1) % NUMBER];
+      data.m_nodes[i]->m_other = data.m_nodes[(i*7+3) % NUMBER];
+    }
+    for (int i = 0; i < NUMBER/10; i++)
+    {
+      data.m_shapes.push_back(i % 2 ? new shape(i) : new square(i));
+      data.m_owned.push_back(shape_smart_ptr(i % 2 ? new shape(i) : new square(i)));
+    }
+    int nodes_before = live_nodes;
+    int shapes_before = live_shapes;
+
+    // now dump to the file
+    std::cerr << "dumping" << std::endl;
+    stlplus::dump_to_file(data,DATA,dump_model,install_shape_dump);
+
+    // restore without an arena and compare
+    std::cerr << "restoring" << std::endl;
+    model restored;
+    stlplus::restore_from_file(DATA,restored,restore_model,install_shape_restore);
+    result &= compare(data,restored);
+    restored.clear();
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      model master;
+      stlplus::restore_from_file(MASTER,master,restore_model,install_shape_restore);
+      result &= compare(data,master);
+      master.clear();
+    }
+
+    // now restore into an arena
+    std::cerr << "restoring into an arena" << std::endl;
+    {
+      stlplus::restore_arena arena;
+      {
+        model in_arena;
+        restore_model_in_arena(DATA, in_arena, arena);
+        result &= compare(data,in_arena);
+        // the arena owns the nodes and the raw shape pointers, but not the shapes in smart pointers
+        if (arena.objects() != (size_t)(NUMBER + NUMBER/10))
+        {
+          std::cerr << "error: arena owns " << arena.objects() << " objects" << std::endl;
+          result = false;
+        }
+        // restoring again into the same data structure doesn't delete the old objects
+        restore_model_in_arena(DATA, in_arena, arena);
+        result &= compare(data,in_arena);
+        // the smart pointers delete their own objects when the model is destroyed here
+      }
+      if (live_nodes != nodes_before + 2*NUMBER || live_shapes != shapes_before + 2*(NUMBER/10))
+      {
+        std::cerr << "error: wrong number of live objects before release" << std::endl;
+        result = false;
+      }
+      std::cerr << "arena holds " << arena.objects() << " objects in " << arena.bytes() << " bytes" << std::endl;
+      arena.release();
+      if (live_nodes != nodes_before || live_shapes != shapes_before || arena.objects() != 0 || arena.bytes() != 0)
+      {
+        std::cerr << "error: release did not destroy all the objects" << std::endl;
+        result = false;
+      }
+      // the arena can be reused after a release, and the destructor releases it again
+      model reused;
+      restore_model_in_arena(DATA, reused, arena);
+      result &= compare(data,reused);
+    }
+    if (live_nodes != nodes_before || live_shapes != shapes_before)
+    {
+      std::cerr << "error: arena destructor did not destroy all the objects" << std::endl;
+      result = false;
+    }
+
+    // magic numbers far beyond any that have been seen, including the largest possible, still restore correctly
+    std::cerr << "restoring corrupt pointer magic numbers" << std::endl;
+    const unsigned magics [] = {0xFFFFFFFF, 0x7FFFFFFF, 5000};
+    for (unsigned i = 0; i < sizeof(magics)/sizeof(magics[0]); i++)
+    {
+      std::string image;
+      stlplus::dump_to_string(magics[i], image, dump_magic_pointers, 0);
+      int_pointer_pair pointers(0,0);
+      stlplus::restore_from_string(image, pointers, restore_int_pointer_pair, 0);
+      if (!pointers.first || pointers.first != pointers.second || *pointers.first != 42)
+      {
+        std::cerr << "error: pointers with magic number " << magics[i] << " restored wrongly" << std::endl;
+        result = false;
+      }
+      delete pointers.first;
+    }
+
+    data.clear();
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+#include <string>
+#include <map>
+#include <sstream>
+#include "persistent_contexts.hpp"
+#include "persistent_checksum.hpp"
+#include "persistent_record.hpp"
+#include "persistent_map.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "persistent_shortcuts.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 100
+#define DATA "checksum_test.tmp"
+#define MASTER "checksum_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<int,std::string> int_string_map;
+
+void dump_int_string_map(stlplus::dump_context& context, const int_string_map& data)
+{
+  stlplus::dump_map(context, data, stlplus::dump_int, stlplus::dump_string);
+}
+
+void restore_int_string_map(stlplus::restore_context& context, int_string_map& data)
+{
+  stlplus::restore_map(context, data, stlplus::restore_int, stlplus::restore_string);
+}
+
+// a checked section containing a record, for testing that skipped data is still checksummed
+void dump_checked_record(stlplus::dump_context& context, const int_string_map& data)
+{
+  stlplus::dump_checked(context, data, dump_int_string_map);
+  context.begin_checksum();
+  stlplus::dump_record(context, data, dump_int_string_map);
+  stlplus::dump_int(context, 42);
+  context.end_checksum();
+}
+
+void skip_checked_record(stlplus::restore_context& context, int_string_map& data)
+{
+  stlplus::restore_checked(context, data, restore_int_string_map);
+  context.begin_checksum();
+  stlplus::skip_record(context);
+  int last = 0;
+  stlplus::restore_int(context, last);
+  context.end_checksum();
+  if (last != 42)
+    throw stlplus::persistent_restore_failed("wrong value after skipped record");
+}
+
+bool compare(const int_string_map& left, const int_string_map& right)
+{
+  if (left != right)
+  {
+    std::cerr << "error: maps are different" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// test the checksum of a string against its known value
+bool check_crc(const std::string& data, unsigned expected)
+{
+  unsigned crc = stlplus::crc32c(0, (const unsigned char*)data.data(), data.size());
+  if (crc != expected)
+  {
+    std::cerr << "error: checksum " << stlplus::dformat("%08x", crc) << " should be " << stlplus::dformat("%08x", expected) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing checksums of " << NUMBER << " mappings" << std::endl;
+
+  try
+  {
+    // the standard test vectors for CRC32C
+    std::cerr << "checksums" << std::endl;
+    result &= check_crc("", 0);
+    result &= check_crc("123456789", 0xE3069283);
+    result &= check_crc(std::string(32, '\0'), 0x8A9136AA);
+    result &= check_crc(std::string(32, '\xff'), 0x62A8AB43);
+    // a checksum calculated in pieces is the same as in one go, wherever the data is split
+    std::string sample;
+    for (unsigned i = 0; i < 1000; i++)
+      sample += (char)(i * 7);
+    unsigned whole = stlplus::crc32c(0, (const unsigned char*)sample.data(), sample.size());
+    for (unsigned split = 0; split <= sample.size(); split += 37)
+    {
+      unsigned crc = stlplus::crc32c(0, (const unsigned char*)sample.data(), split);
+      crc = stlplus::crc32c(crc, (const unsigned char*)sample.data() + split, sample.size() - split);
+      if (crc != whole)
+      {
+        std::cerr << "error: checksum split at " << split << " is different" << std::endl;
+        result = false;
+      }
+    }
+
+    // build the sample data structure
+    std::cerr << "creating" << std::endl;
+    int_string_map data;
+    for (unsigned i = 0; i < NUMBER; i++)
+      data[i] = stlplus::dformat("%d",i);
+
+    // now dump to the file
+    std::cerr << "dumping" << std::endl;
+    stlplus::dump_to_checked_file(data,DATA,dump_int_string_map,0);
+
+    // now restore the same file and compare
+    std::cerr << "restoring" << std::endl;
+    int_string_map restored;
+    stlplus::restore_from_checked_file(DATA,restored,restore_int_string_map,0);
+    result &= compare(data,restored);
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      int_string_map master;
+      stlplus::restore_from_checked_file(MASTER,master,restore_int_string_map,0);
+      result &= compare(data,master);
+    }
+
+    // the checked dump is the plain dump followed by the 4-byte checksum
+    std::cerr << "dumping to string" << std::endl;
+    std::string plain;
+    stlplus::dump_to_string(data,plain,dump_int_string_map,0);
+    std::string image;
+    stlplus::dump_to_checked_string(data,image,dump_int_string_map,0);
+    if (image.size() != plain.size() + 4 || image.compare(0, plain.size(), plain) != 0 ||
+        image.size() != stlplus::file_size(DATA))
+    {
+      std::cerr << "error: checked dump is not the plain dump with a checksum" << std::endl;
+      result = false;
+    }
+    int_string_map from_string;
+    stlplus::restore_from_checked_string(image,from_string,restore_int_string_map,0);
+    result &= compare(data,from_string);
+
+    // every single-bit error is detected, either by the checksum or by the restore failing first
+    std::cerr << "corrupting" << std::endl;
+    unsigned undetected = 0;
+    unsigned by_checksum = 0;
+    for (size_t i = 1; i < image.size(); i++)
+    {
+      for (unsigned bit = 0; bit < 8; bit++)
+      {
+        std::string corrupt = image;
+        corrupt[i] = (char)(corrupt[i] ^ (1 << bit));
+        try
+        {
+          int_string_map bad;
+          stlplus::restore_from_checked_string(corrupt,bad,restore_int_string_map,0);
+          undetected++;
+        }
+        catch(const stlplus::persistent_restore_failed& except)
+        {
+          if (std::string(except.what()).find("checksum") != std::string::npos)
+            by_checksum++;
+        }
+      }
+    }
+    std::cerr << by_checksum << " errors detected by the checksum" << std::endl;
+    if (undetected > 0 || by_checksum == 0)
+    {
+      std::cerr << "error: " << undetected << " corrupt dumps were not detected" << std::endl;
+      result = false;
+    }
+
+    // skipped records are checksummed too, from both a string and a device
+    std::cerr << "skipping records" << std::endl;
+    std::string records;
+    stlplus::dump_to_string(data,records,dump_checked_record,0);
+    int_string_map skipped;
+    stlplus::restore_from_string(records,skipped,skip_checked_record,0);
+    result &= compare(data,skipped);
+    std::istringstream records_device(records, std::ios_base::in | std::ios_base::binary);
+    stlplus::restore_from_device(records_device,skipped,skip_checked_record,0);
+    result &= compare(data,skipped);
+    // corrupt the last string in the skipped record, which is just before the final int and checksum
+    std::string corrupt = records;
+    corrupt[corrupt.size() - 7] ^= 1;
+    try
+    {
+      stlplus::restore_from_string(corrupt,skipped,skip_checked_record,0);
+      std::cerr << "error: corrupt skipped record was not detected" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+
+    // a checksum cannot start inside a record
+    std::cerr << "checksum inside record" << std::endl;
+    try
+    {
+      std::string output;
+      stlplus::dump_context context(output);
+      context.begin_record();
+      context.begin_checksum();
+      std::cerr << "error: checksum started inside a record" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_dump_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#include <string>
+#include <map>
+#include "persistent_contexts.hpp"
+#include "persistent_compression.hpp"
+#include "persistent_map.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "persistent_shortcuts.hpp"
+#include "strings.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 1000
+#define DATA "compression_test.tmp"
+#define MASTER "compression_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<int,std::string> int_string_map;
+
+void dump_int_string_map(stlplus::dump_context& context, const int_string_map& data)
+{
+  stlplus::dump_map(context, data, stlplus::dump_int, stlplus::dump_string);
+}
+
+void restore_int_string_map(stlplus::restore_context& context, int_string_map& data)
+{
+  stlplus::restore_map(context, data, stlplus::restore_int, stlplus::restore_string);
+}
+
+bool compare(const int_string_map& left, const int_string_map& right)
+{
+  bool result = true;
+  if (left.size() != right.size())
+  {
+    std::cerr << "different size - left = " << left.size() << " right = " << right.size() << std::endl;
+    result = false;
+  }
+  int_string_map::const_iterator j, k;
+  for (j = left.begin(), k = right.begin(); j != left.end() && k != right.end(); j++, k++)
+  {
+    if (*j != *k)
+    {
+      std::cerr << "left = \"" << j->first << "\" is different from right = \"" << k->first << "\"" << std::endl;
+      result = false;
+    }
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing " << NUMBER << " mappings" << std::endl;
+
+  try
+  {
+    // build a sample data structure dominated by repetitive strings, which is typical of real dumps
+    std::cerr << "creating" << std::endl;
+    int_string_map data;
+    static const char* states[] = {"active", "suspended", "pending", "closed"};
+    for (unsigned i = 0; i < NUMBER; i++)
+      data[i*7] = stlplus::dformat("record %u: state=%s owner=user%u group=staff path=/home/user%u/data/file%u.txt",
+                                   i, states[i % 4], i % 50, i % 50, i);
+
+    // dump to the file and restore
+    std::cerr << "dumping" << std::endl;
+    stlplus::dump_to_compressed_file(data, DATA, dump_int_string_map, 0);
+    std::cerr << "restoring" << std::endl;
+    int_string_map restored;
+    stlplus::restore_from_compressed_file(DATA, restored, restore_int_string_map, 0);
+    result &= compare(data, restored);
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      int_string_map master;
+      stlplus::restore_from_compressed_file(MASTER, master, restore_int_string_map, 0);
+      result &= compare(data, master);
+    }
+
+    // an empty structure must also round-trip
+    std::cerr << "empty" << std::endl;
+    int_string_map empty;
+    std::string empty_dump;
+    stlplus::dump_to_compressed_string(empty, empty_dump, dump_int_string_map, 0);
+    stlplus::restore_from_compressed_string(empty_dump, restored, restore_int_string_map, 0);
+    result &= compare(empty, restored);
+
+    // a truncated compressed dump must be detected
+    std::cerr << "truncated" << std::endl;
+    std::string compressed;
+    stlplus::dump_to_compressed_string(data, compressed, dump_int_string_map, 0);
+    try
+    {
+      stlplus::restore_from_compressed_string(compressed.substr(0, compressed.size()/2), restored, restore_int_string_map, 0);
+      std::cerr << "error: truncated dump restored without error" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+
+    // an uncompressed dump must be rejected by the compressed restore
+    std::string uncompressed;
+    stlplus::dump_to_string(data, uncompressed, dump_int_string_map, 0);
+    try
+    {
+      stlplus::restore_from_compressed_string(uncompressed, restored, restore_int_string_map, 0);
+      std::cerr << "error: uncompressed dump restored without error" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+
+    // the whole compressed string must round-trip and be smaller than the uncompressed dump
+    stlplus::restore_from_compressed_string(compressed, restored, restore_int_string_map, 0);
+    result &= compare(data, restored);
+    std::cerr << "uncompressed size " << uncompressed.size() << " bytes, compressed size " << compressed.size() << " bytes, ratio "
+              << stlplus::dformat("%.2f", (double)uncompressed.size() / (double)compressed.size()) << std::endl;
+    if (compressed.size() >= uncompressed.size())
+    {
+      std::cerr << "error: compression made no saving" << std::endl;
+      result = false;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
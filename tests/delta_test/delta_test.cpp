@@ -0,0 +1,286 @@
+#include <string>
+#include <map>
+#include "hash.hpp"
+#include "digraph.hpp"
+#include "persistent_contexts.hpp"
+#include "persistent_map.hpp"
+#include "persistent_hash.hpp"
+#include "persistent_digraph.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "persistent_shortcuts.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 1000
+#define DATA "delta_test.tmp"
+#define MASTER "delta_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+
+class hash_int
+{
+public:
+  unsigned operator () (int value)
+    {return (unsigned)value;}
+};
+
+typedef std::map<int,std::string> int_string_map;
+typedef stlplus::hash<int,std::string,hash_int> int_string_hash;
+typedef stlplus::digraph<std::string,int> string_int_graph;
+
+// the sample state is one of each type with a delta-capable dump
+class state
+{
+public:
+  int_string_map m_map;
+  int_string_hash m_hash;
+  string_int_graph m_graph;
+};
+
+void dump_state(stlplus::dump_context& context, const state& data)
+{
+  stlplus::dump_map(context, data.m_map, stlplus::dump_int, stlplus::dump_string);
+  stlplus::dump_hash(context, data.m_hash, stlplus::dump_int, stlplus::dump_string);
+  stlplus::dump_digraph(context, data.m_graph, stlplus::dump_string, stlplus::dump_int);
+}
+
+void restore_state(stlplus::restore_context& context, state& data)
+{
+  stlplus::restore_map(context, data.m_map, stlplus::restore_int, stlplus::restore_string);
+  stlplus::restore_hash(context, data.m_hash, stlplus::restore_int, stlplus::restore_string);
+  stlplus::restore_digraph(context, data.m_graph, stlplus::restore_string, stlplus::restore_int);
+}
+
+void dump_state_delta(stlplus::dump_context& context, const state& base, const state& data)
+{
+  stlplus::dump_map_delta(context, base.m_map, data.m_map, stlplus::dump_int, stlplus::dump_string);
+  stlplus::dump_hash_delta(context, base.m_hash, data.m_hash, stlplus::dump_int, stlplus::dump_string);
+  stlplus::dump_digraph_delta(context, base.m_graph, data.m_graph, stlplus::dump_string, stlplus::dump_int);
+}
+
+void restore_state_delta(stlplus::restore_context& context, state& data)
+{
+  stlplus::restore_map_delta(context, data.m_map, stlplus::restore_int, stlplus::restore_string);
+  stlplus::restore_hash_delta(context, data.m_hash, stlplus::restore_int, stlplus::restore_string);
+  stlplus::restore_digraph_delta(context, data.m_graph, stlplus::restore_string, stlplus::restore_int);
+}
+
+// a checkpoint is a full dump of the base followed by the delta to the current state
+class checkpoint
+{
+public:
+  state m_base;
+  state m_data;
+};
+
+void dump_checkpoint(stlplus::dump_context& context, const checkpoint& data)
+{
+  dump_state(context, data.m_base);
+  dump_state_delta(context, data.m_base, data.m_data);
+}
+
+void restore_checkpoint(stlplus::restore_context& context, state& data)
+{
+  restore_state(context, data);
+  restore_state_delta(context, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// represent a graph as a string so that graphs can be compared by node and arc position
+std::string graph_image(const string_int_graph& graph)
+{
+  std::map<const void*,unsigned> index;
+  std::string result;
+  unsigned n = 0;
+  for (string_int_graph::const_iterator i = graph.begin(); i != graph.end(); i++)
+  {
+    index[i.node()] = n++;
+    result += *i + ";";
+  }
+  for (string_int_graph::const_arc_iterator a = graph.arc_begin(); a != graph.arc_end(); a++)
+    result += stlplus::dformat("%u->%u:%d;",
+                               index[graph.arc_from(a).node()],
+                               index[graph.arc_to(a).node()],
+                               *a);
+  return result;
+}
+
+bool compare(const state& left, const state& right)
+{
+  bool result = true;
+  if (left.m_map != right.m_map)
+  {
+    std::cerr << "maps are different" << std::endl;
+    result = false;
+  }
+  if (left.m_hash.size() != right.m_hash.size())
+  {
+    std::cerr << "hashes are different sizes" << std::endl;
+    result = false;
+  }
+  for (int_string_hash::const_iterator i = left.m_hash.begin(); i != left.m_hash.end(); i++)
+  {
+    const std::string* value = right.m_hash.at_pointer(i->first);
+    if (!value || *value != i->second)
+    {
+      std::cerr << "hashes are different at key " << i->first << std::endl;
+      result = false;
+    }
+  }
+  if (graph_image(left.m_graph) != graph_image(right.m_graph))
+  {
+    std::cerr << "graphs are different" << std::endl;
+    result = false;
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void create(state& data)
+{
+  std::vector<string_int_graph::iterator> nodes;
+  for (int i = 0; i < NUMBER; i++)
+  {
+    data.m_map[i] = stlplus::dformat("%d",i);
+    data.m_hash[i] = stlplus::dformat("%d",i);
+    nodes.push_back(data.m_graph.insert(stlplus::dformat("node %d",i)));
+  }
+  for (int i = 1; i < NUMBER; i++)
+    data.m_graph.arc_insert(nodes[i-1], nodes[i], i);
+}
+
+// make a small change to every structure - erase, modify and add elements
+void modify(state& data)
+{
+  for (int i = 0; i < NUMBER; i += 100)
+  {
+    data.m_map.erase(i);
+    data.m_map[i+1] = "changed";
+    data.m_map[NUMBER+i] = "added";
+    data.m_hash.erase(i);
+    data.m_hash[i+1] = "changed";
+    data.m_hash[NUMBER+i] = "added";
+  }
+  // modify the first node and move the first arc
+  string_int_graph::iterator first = data.m_graph.begin();
+  *first = "changed";
+  string_int_graph::iterator fifth = first;
+  for (unsigned i = 0; i < 5; i++) fifth++;
+  string_int_graph::arc_iterator arc = data.m_graph.arc_begin();
+  data.m_graph.arc_move_to(arc, fifth);
+  // erase the last node, which also erases the last arc
+  string_int_graph::iterator last = data.m_graph.begin();
+  for (unsigned i = 1; i < data.m_graph.size(); i++) last++;
+  data.m_graph.erase(last);
+  // add a new node with arcs to and from the first node
+  string_int_graph::iterator added = data.m_graph.insert("added");
+  data.m_graph.arc_insert(first, added, -1);
+  data.m_graph.arc_insert(added, first, -2);
+  // and change an arc in place
+  arc = data.m_graph.arc_begin();
+  arc++;
+  *arc = 42;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing deltas of " << NUMBER << " elements" << std::endl;
+
+  try
+  {
+    // build the sample data structure and then change it
+    std::cerr << "creating" << std::endl;
+    checkpoint data;
+    create(data.m_base);
+    create(data.m_data);
+    modify(data.m_data);
+
+    // compare the size of the delta with a full dump
+    size_t full_size = stlplus::dump_size(data.m_data, dump_state, 0);
+    std::string delta;
+    {
+      stlplus::dump_context context(delta);
+      dump_state_delta(context, data.m_base, data.m_data);
+    }
+    std::cerr << "full dump " << full_size << " bytes, delta " << delta.size() << " bytes" << std::endl;
+    if (delta.size() * 10 > full_size)
+    {
+      std::cerr << "error: delta is too large" << std::endl;
+      result = false;
+    }
+
+    // now dump to the file
+    std::cerr << "dumping" << std::endl;
+    stlplus::dump_to_file(data,DATA,dump_checkpoint,0);
+
+    // now restore the same file and compare
+    std::cerr << "restoring" << std::endl;
+    state restored;
+    stlplus::restore_from_file(DATA,restored,restore_checkpoint,0);
+    result &= compare(data.m_data,restored);
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      state master;
+      stlplus::restore_from_file(MASTER,master,restore_checkpoint,0);
+      result &= compare(data.m_data,master);
+    }
+
+    // an empty delta changes nothing
+    std::cerr << "restoring empty delta" << std::endl;
+    {
+      std::string image;
+      {
+        stlplus::dump_context context(image);
+        dump_state_delta(context, data.m_data, data.m_data);
+      }
+      stlplus::restore_context context(image);
+      restore_state_delta(context, restored);
+      result &= compare(data.m_data,restored);
+    }
+
+    // applying a delta to the wrong base is detected for graphs
+    std::cerr << "restoring delta to the wrong base" << std::endl;
+    try
+    {
+      state empty;
+      stlplus::restore_context context(delta);
+      restore_state_delta(context, empty);
+      std::cerr << "error: restored delta to the wrong base" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -132,6 +132,25 @@ void restore_string_int_graph(stlplus::restore_context& context, string_int_grap
   stlplus::restore_digraph(context, graph, stlplus::restore_string, stlplus::restore_int);
 }
 
+// write a graph of two nodes joined by an arc in the form used by dump_digraph but with
+// the given magic key for the second node - used to check that restoring a corrupt dump
+// neither crashes nor allocates a huge index
+
+void dump_magic_graph(stlplus::dump_context& context, const unsigned& magic)
+{
+  stlplus::dump_unsigned(context, 1);
+  stlplus::dump_unsigned(context, 2);
+  stlplus::dump_unsigned(context, 2);
+  stlplus::dump_string(context, "first");
+  stlplus::dump_unsigned(context, magic);
+  stlplus::dump_string(context, "second");
+  stlplus::dump_unsigned(context, 1);
+  stlplus::dump_unsigned(context, 3);
+  stlplus::dump_unsigned(context, 2);
+  stlplus::dump_unsigned(context, magic);
+  stlplus::dump_int(context, 42);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef std::vector<string_int_graph::iterator> node_vector;
@@ -373,6 +392,22 @@ int main(int argc, char* argv[])
       result = false;
     }
 
+    // node keys far beyond the first, including the largest possible, still restore correctly
+    const unsigned magics [] = {0xFFFFFFFF, 0x7FFFFFFF, 0x20000000, 5000};
+    for (unsigned i = 0; i < sizeof(magics)/sizeof(magics[0]); i++)
+    {
+      std::string image;
+      stlplus::dump_to_string(magics[i], image, dump_magic_graph, 0);
+      string_int_graph corrupt;
+      stlplus::restore_from_string(image, corrupt, restore_string_int_graph, 0);
+      if (corrupt.size() != 2 || corrupt.arc_size() != 1 ||
+          *corrupt.arc_from(corrupt.arc_begin()) != "first" || *corrupt.arc_to(corrupt.arc_begin()) != "second")
+      {
+        std::cout << "ERROR: graph with node key " << magics[i] << " restored wrongly:\n" << corrupt;
+        result = false;
+      }
+    }
+
     // clear the graph and check that safe iterators are handled correctly
     if (!source2_node1.valid())
     {
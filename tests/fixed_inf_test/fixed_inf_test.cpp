@@ -0,0 +1,246 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include "fixed_inf.hpp"
+#include "persistent_contexts.hpp"
+#include "persistent_fixed_inf.hpp"
+#include "persistent_vector.hpp"
+#include "persistent_shortcuts.hpp"
+#include "string_fixed_inf.hpp"
+#include "print_fixed_inf.hpp"
+#include "print_inf.hpp"
+#include "string_inf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 1000
+#define DATA "fixed_inf_test.tmp"
+#define MASTER "fixed_inf_test.dump"
+
+typedef stlplus::fixed_inf<128> int128;
+typedef stlplus::fixed_inf<200> int200;
+
+void dump_int128_vector(stlplus::dump_context& context, const std::vector<int128>& data)
+{
+  stlplus::dump_vector(context, data, stlplus::dump_fixed_inf<128>);
+}
+
+void restore_int128_vector(stlplus::restore_context& context, std::vector<int128>& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_fixed_inf<128>);
+}
+
+void restore_inf_vector(stlplus::restore_context& context, std::vector<stlplus::inf>& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_inf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// the value of an inf wrapped round to the given number of bits, the way fixed_inf does it
+static stlplus::inf wrap(const stlplus::inf& value, unsigned bits)
+{
+  stlplus::inf mask = (stlplus::inf(1) << bits) - stlplus::inf(1);
+  stlplus::inf sign = stlplus::inf(1) << (bits - 1);
+  return ((value & mask) ^ sign) - sign;
+}
+
+// a simple generator so that the values are the same on every run and platform
+static unsigned long random_state = 12345;
+
+static stlplus::inf random_inf(unsigned bits)
+{
+  stlplus::inf result(0);
+  for (unsigned i = 0; i < bits; i += 16)
+  {
+    random_state = random_state * 1103515245ul + 12345ul;
+    result <<= 16;
+    result |= stlplus::inf((unsigned)((random_state >> 8) & 0xffff));
+  }
+  return wrap(result, bits);
+}
+
+static bool check(const std::string& operation, const stlplus::inf& fixed, const stlplus::inf& expected)
+{
+  if (fixed == expected)
+    return true;
+  std::cerr << "error: " << operation << " gave " << fixed << " instead of " << expected << std::endl;
+  return false;
+}
+
+// test all the operations of a fixed_inf against inf
+template<unsigned Bits>
+bool test_operations(const stlplus::inf& left, const stlplus::inf& right)
+{
+  bool result = true;
+  stlplus::fixed_inf<Bits> l(left);
+  stlplus::fixed_inf<Bits> r(right);
+  result &= check("conversion", l.to_inf(), left);
+  result &= check("add", (l + r).to_inf(), wrap(left + right, Bits));
+  result &= check("subtract", (l - r).to_inf(), wrap(left - right, Bits));
+  result &= check("multiply", (l * r).to_inf(), wrap(left * right, Bits));
+  result &= check("negate", (-l).to_inf(), wrap(-left, Bits));
+  result &= check("and", (l & r).to_inf(), left & right);
+  result &= check("or", (l | r).to_inf(), left | right);
+  result &= check("xor", (l ^ r).to_inf(), left ^ right);
+  result &= check("shift left", (l << 37).to_inf(), wrap(left << 37, Bits));
+  result &= check("shift right", (l >> 37).to_inf(), left >> 37);
+  if (!right.zero())
+  {
+    result &= check("divide", (l / r).to_inf(), wrap(left / right, Bits));
+    result &= check("remainder", (l % r).to_inf(), left % right);
+  }
+  if ((l < r) != (left < right) || (l == r) != (left == right) || l.bits() != left.bits())
+  {
+    std::cerr << "error: comparison of " << left << " and " << right << " is wrong" << std::endl;
+    result = false;
+  }
+  result &= check("string", stlplus::string_to_fixed_inf<Bits>(stlplus::fixed_inf_to_string(l)).to_inf(), left);
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing fixed_inf" << std::endl;
+
+  try
+  {
+    std::cerr << "operations" << std::endl;
+    for (unsigned i = 0; i < NUMBER; i++)
+    {
+      // a mix of full-width values and small ones, which take the single-limb paths
+      unsigned bits = (i % 4 == 0) ? 32 : 128;
+      result &= test_operations<128>(random_inf(bits), random_inf(i % 3 == 0 ? 32 : bits));
+      result &= test_operations<200>(random_inf(bits + 72), random_inf(bits));
+      result &= test_operations<24>(random_inf(24), random_inf(i % 2 == 0 ? 8 : 24));
+    }
+
+    // the arithmetic wraps round at the limits like the C types
+    std::cerr << "limits" << std::endl;
+    int128 maximum = ~(int128(1) << 127);
+    int128 minimum = int128(1) << 127;
+    if (maximum + int128(1) != minimum || minimum - int128(1) != maximum || -minimum != minimum ||
+        maximum.to_string() != "170141183460469231731687303715884105727" ||
+        minimum.to_string() != "-170141183460469231731687303715884105728" ||
+        int128(-1).to_string(16) != (stlplus::inf(-1)).to_string(16) ||
+        int128("340282366920938463463374607431768211455") != int128(-1) ||
+        stlplus::fixed_inf<8>(300) != stlplus::fixed_inf<8>(44))
+    {
+      std::cerr << "error: arithmetic at the limits is wrong" << std::endl;
+      result = false;
+    }
+    unsigned long counter = 0;
+    for (int128 i(0); i < int128(1000); i++)
+      counter++;
+    if (counter != 1000 || int128(-1000).to_long() != -1000l)
+    {
+      std::cerr << "error: increment is wrong" << std::endl;
+      result = false;
+    }
+
+    // conversion between widths sign-extends and truncates
+    std::cerr << "widths" << std::endl;
+    if (int200(int128(-5)) != int200(-5) || int128(int200(minimum) << 1) != int128(0) ||
+        stlplus::fixed_inf<64>(int200(maximum)).to_long() != -1l)
+    {
+      std::cerr << "error: conversion between widths is wrong" << std::endl;
+      result = false;
+    }
+
+    // the bits outside the width cannot be accessed
+    try
+    {
+      stlplus::fixed_inf<24> value(0);
+      value.set(24);
+      std::cerr << "error: bit outside the width was set" << std::endl;
+      result = false;
+    }
+    catch(const std::out_of_range& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+    try
+    {
+      int128(1) / int128(0);
+      std::cerr << "error: divide by zero was not detected" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::divide_by_zero& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+
+    // print and stream I/O are the same as for inf
+    std::cerr << "printing" << std::endl;
+    int128 sample(int128(-123456789) * int128(1000000007) << 40);
+    std::ostringstream printed;
+    stlplus::print_fixed_inf(printed, sample, 16);
+    printed << " " << sample;
+    std::ostringstream expected;
+    stlplus::print_inf(expected, sample.to_inf(), 16);
+    expected << " " << sample.to_inf();
+    std::istringstream input(printed.str());
+    int128 first;
+    int128 second;
+    input >> std::hex >> first >> std::dec >> second;
+    if (printed.str() != expected.str() || first.to_inf() != stlplus::string_to_inf(expected.str().substr(0, expected.str().find(' '))) || second != sample)
+    {
+      std::cerr << "error: printed " << printed.str() << " instead of " << expected.str() << std::endl;
+      result = false;
+    }
+
+    // persistence uses the inf format, so fixed_inf and inf dumps can be exchanged
+    std::cerr << "dumping" << std::endl;
+    std::vector<int128> data;
+    for (unsigned i = 0; i < 100; i++)
+      data.push_back(int128(random_inf(i + 1)));
+    stlplus::dump_to_file(data, DATA, dump_int128_vector, 0);
+    std::vector<int128> restored;
+    stlplus::restore_from_file(DATA, restored, restore_int128_vector, 0);
+    std::vector<stlplus::inf> as_inf;
+    stlplus::restore_from_file(DATA, as_inf, restore_inf_vector, 0);
+    if (restored != data || as_inf.size() != data.size())
+    {
+      std::cerr << "error: restored data is different from the original" << std::endl;
+      result = false;
+    }
+    for (unsigned i = 0; i < as_inf.size() && i < data.size(); i++)
+      result &= check("restore as inf", as_inf[i], data[i].to_inf());
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      std::vector<int128> master;
+      stlplus::restore_from_file(MASTER, master, restore_int128_vector, 0);
+      if (master != data)
+      {
+        std::cerr << "error: master is different from the original" << std::endl;
+        result = false;
+      }
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -0,0 +1,307 @@
+// Speed benchmark for the infinite-precision integer inf
+// Times the basic arithmetic, the modular arithmetic and the string conversions over a range
+// of value sizes and reports the time per operation
+
+// usage: inf_benchmark [max_bits [seconds]]
+//   max_bits is the largest value size to measure (default 100000)
+//   seconds is the minimum time spent timing each operation, the operation is repeated to fill it (default 0.2)
+
+// Progress is reported on standard error. The results go to standard output as
+// comma-separated values with a header line, so they can be collected and compared over time:
+//   operation,bits,iterations,seconds,ns_per_op
+
+#include <string>
+#include <stdlib.h>
+#include <time.h>
+#include "inf.hpp"
+#include "dprintf.hpp"
+#include "build.hpp"
+#ifdef STLPLUS_HAS_CXX11
+#include <chrono>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// the value sizes measured, in bits
+static const unsigned sizes [] = {64, 256, 1024, 2048, 4096, 16384, 65536, 100000};
+
+// the modular operations cost the cube of the size so are only measured up to the sizes used in cryptography
+static const unsigned modular_bits = 4096;
+
+// wall-clock time in seconds - falls back to processor time without C++11
+static double now(void)
+{
+#ifdef STLPLUS_HAS_CXX11
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// test values
+
+// a simple generator so that the values are the same on every run and platform
+static unsigned long random_state = 12345;
+
+static unsigned random_digit(void)
+{
+  random_state = random_state * 1103515245ul + 12345ul;
+  return (unsigned)((random_state >> 16) & 0xf);
+}
+
+// a positive value with exactly the given number of significant bits, not counting the sign
+static stlplus::inf random_inf(unsigned bits)
+{
+  // the leading zero digit makes the hex pattern positive
+  std::string image = "0x0";
+  unsigned digits = (bits + 3) / 4;
+  for (unsigned i = 0; i < digits; i++)
+    image += "0123456789abcdef"[random_digit()];
+  stlplus::inf result(0);
+  result.from_string(image);
+  // trim or extend to the exact size
+  result >>= 4 * digits - bits;
+  result |= stlplus::inf(1) << (bits - 1);
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// timing
+
+// the operations are functors so that the timing loop is the same for all of them
+// each one keeps its result so that the work cannot be optimised away
+
+class add_operation
+{
+public:
+  const stlplus::inf& m_left;
+  const stlplus::inf& m_right;
+  stlplus::inf m_result;
+  add_operation(const stlplus::inf& left, const stlplus::inf& right) : m_left(left), m_right(right) {}
+  void operator()(void) {m_result = m_left + m_right;}
+};
+
+class subtract_operation
+{
+public:
+  const stlplus::inf& m_left;
+  const stlplus::inf& m_right;
+  stlplus::inf m_result;
+  subtract_operation(const stlplus::inf& left, const stlplus::inf& right) : m_left(left), m_right(right) {}
+  void operator()(void) {m_result = m_left - m_right;}
+};
+
+class multiply_operation
+{
+public:
+  const stlplus::inf& m_left;
+  const stlplus::inf& m_right;
+  stlplus::inf m_result;
+  multiply_operation(const stlplus::inf& left, const stlplus::inf& right) : m_left(left), m_right(right) {}
+  void operator()(void) {m_result = m_left * m_right;}
+};
+
+class square_operation
+{
+public:
+  const stlplus::inf& m_value;
+  stlplus::inf m_result;
+  square_operation(const stlplus::inf& value) : m_value(value) {}
+  void operator()(void) {m_result = m_value * m_value;}
+};
+
+// accumulating a sum of products, either with the operators or with the fused multiply-add
+class multiply_add_operation
+{
+public:
+  const stlplus::inf& m_left;
+  const stlplus::inf& m_right;
+  bool m_fused;
+  stlplus::inf m_result;
+  multiply_add_operation(const stlplus::inf& left, const stlplus::inf& right, bool fused) :
+    m_left(left), m_right(right), m_fused(fused) {}
+  void operator()(void) {if (m_fused) add_mul(m_result, m_left, m_right); else m_result += m_left * m_right;}
+};
+
+class divide_operation
+{
+public:
+  const stlplus::inf& m_left;
+  const stlplus::inf& m_right;
+  std::pair<stlplus::inf,stlplus::inf> m_result;
+  divide_operation(const stlplus::inf& left, const stlplus::inf& right) : m_left(left), m_right(right) {}
+  void operator()(void) {m_result = m_left.divide(m_right);}
+};
+
+class powmod_operation
+{
+public:
+  const stlplus::inf& m_base;
+  const stlplus::inf& m_exponent;
+  const stlplus::inf& m_modulus;
+  stlplus::inf m_result;
+  powmod_operation(const stlplus::inf& base, const stlplus::inf& exponent, const stlplus::inf& modulus) :
+    m_base(base), m_exponent(exponent), m_modulus(modulus) {}
+  void operator()(void) {m_result = powmod(m_base, m_exponent, m_modulus);}
+};
+
+class gcd_operation
+{
+public:
+  const stlplus::inf& m_left;
+  const stlplus::inf& m_right;
+  stlplus::inf m_result;
+  gcd_operation(const stlplus::inf& left, const stlplus::inf& right) : m_left(left), m_right(right) {}
+  void operator()(void) {m_result = gcd(m_left, m_right);}
+};
+
+class modinv_operation
+{
+public:
+  const stlplus::inf& m_value;
+  const stlplus::inf& m_modulus;
+  stlplus::inf m_result;
+  modinv_operation(const stlplus::inf& value, const stlplus::inf& modulus) : m_value(value), m_modulus(modulus) {}
+  void operator()(void) {m_result = modinv(m_value, m_modulus);}
+};
+
+class to_string_operation
+{
+public:
+  const stlplus::inf& m_value;
+  unsigned m_radix;
+  std::string m_result;
+  to_string_operation(const stlplus::inf& value, unsigned radix) : m_value(value), m_radix(radix) {}
+  void operator()(void) {m_result = m_value.to_string(m_radix);}
+};
+
+class from_string_operation
+{
+public:
+  const std::string& m_image;
+  unsigned m_radix;
+  stlplus::inf m_result;
+  from_string_operation(const std::string& image, unsigned radix) : m_image(image), m_radix(radix) {}
+  void operator()(void) {m_result.from_string(m_image, m_radix);}
+};
+
+// repeat the operation until the minimum time has been used, then report the average time per operation
+// the operation is timed in batches, doubling the batch size each time, so that the timer itself is not measured
+template<typename O>
+void measure(const std::string& operation, unsigned bits, O& function, double minimum)
+{
+  unsigned iterations = 1;
+  double elapsed = 0.0;
+  for (;;)
+  {
+    double start = now();
+    for (unsigned i = 0; i < iterations; i++)
+      function();
+    elapsed = now() - start;
+    if (elapsed >= minimum) break;
+    iterations *= 2;
+  }
+  double ns_per_op = elapsed * 1e9 / (double)iterations;
+  std::cout << stlplus::dformat("%s,%u,%u,%.6f,%.1f", operation.c_str(), bits, iterations, elapsed, ns_per_op) << std::endl;
+  std::cerr << stlplus::dformat("  %-16s %8u bits %14.1f ns/op", operation.c_str(), bits, ns_per_op) << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  unsigned max_bits = argc > 1 ? (unsigned)atoi(argv[1]) : 100000;
+  double minimum = argc > 2 ? atof(argv[2]) : 0.2;
+  std::cerr << stlplus::build() << " benchmarking inf up to " << max_bits << " bits" << std::endl;
+  std::cout << "operation,bits,iterations,seconds,ns_per_op" << std::endl;
+  bool result = true;
+
+  try
+  {
+    for (unsigned s = 0; s < sizeof(sizes)/sizeof(sizes[0]) && sizes[s] <= max_bits; s++)
+    {
+      unsigned bits = sizes[s];
+      std::cerr << bits << " bits" << std::endl;
+      stlplus::inf left = random_inf(bits);
+      stlplus::inf right = random_inf(bits);
+      // the division is of a double-length value by a single-length one, which gives a single-length quotient
+      stlplus::inf numerator = random_inf(2 * bits);
+
+      add_operation add(left, right);
+      measure("add", bits, add, minimum);
+      subtract_operation subtract(left, right);
+      measure("subtract", bits, subtract, minimum);
+      multiply_operation multiply(left, right);
+      measure("multiply", bits, multiply, minimum);
+      square_operation square(left);
+      measure("square", bits, square, minimum);
+      multiply_add_operation multiply_add(left, right, false);
+      measure("multiply_add", bits, multiply_add, minimum);
+      multiply_add_operation add_mul(left, right, true);
+      measure("add_mul", bits, add_mul, minimum);
+      divide_operation divide(numerator, right);
+      measure("divide", bits, divide, minimum);
+
+      // check the division so that a broken result is not reported as a fast one
+      if (divide.m_result.first * right + divide.m_result.second != numerator ||
+          divide.m_result.second.negative() || divide.m_result.second >= right)
+      {
+        std::cerr << "error: division of " << bits << " bit values is wrong" << std::endl;
+        result = false;
+      }
+
+      if (bits <= modular_bits)
+      {
+        // an odd modulus, which uses Montgomery reduction, and an even one, which uses division
+        stlplus::inf odd_modulus = right | stlplus::inf(1);
+        stlplus::inf even_modulus = right & ~stlplus::inf(1);
+        powmod_operation powmod_odd(left, right, odd_modulus);
+        measure("powmod_odd", bits, powmod_odd, minimum);
+        powmod_operation powmod_even(left, right, even_modulus);
+        measure("powmod_even", bits, powmod_even, minimum);
+        gcd_operation gcd_values(left, right);
+        measure("gcd", bits, gcd_values, minimum);
+        // the inverse only exists when the value is coprime with the modulus, so divide out any common factors first
+        stlplus::inf coprime = left;
+        for (stlplus::inf common = gcd(coprime, odd_modulus); common != stlplus::inf(1); common = gcd(coprime, odd_modulus))
+          coprime /= common;
+        modinv_operation modinv_value(coprime, odd_modulus);
+        measure("modinv", bits, modinv_value, minimum);
+        if ((coprime * modinv_value.m_result) % odd_modulus != stlplus::inf(1) ||
+            powmod_odd.m_result != powmod(left, right, odd_modulus * stlplus::inf(2)) % odd_modulus)
+        {
+          std::cerr << "error: modular arithmetic of " << bits << " bit values is wrong" << std::endl;
+          result = false;
+        }
+      }
+
+      to_string_operation to_decimal(left, 10);
+      measure("to_string_10", bits, to_decimal, minimum);
+      from_string_operation from_decimal(to_decimal.m_result, 10);
+      measure("from_string_10", bits, from_decimal, minimum);
+      to_string_operation to_hex(left, 16);
+      measure("to_string_16", bits, to_hex, minimum);
+      from_string_operation from_hex(to_hex.m_result, 16);
+      measure("from_string_16", bits, from_hex, minimum);
+
+      if (from_decimal.m_result != left || from_hex.m_result != left)
+      {
+        std::cerr << "error: string conversion of " << bits << " bit values is wrong" << std::endl;
+        result = false;
+      }
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  return result ? 0 : 1;
+}
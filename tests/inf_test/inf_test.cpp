@@ -81,6 +81,15 @@ static bool test (int a, int b)
     if (!compare((int_a % int_b), (inf_a % inf_b)))
       okay &= report(a, b, "%");
   }
+  bigint int_gcd = int_a < 0 ? -int_a : int_a;
+  for (bigint int_other = int_b < 0 ? -int_b : int_b; int_other != 0; )
+  {
+    bigint next = int_gcd % int_other;
+    int_gcd = int_other;
+    int_other = next;
+  }
+  if (!compare(int_gcd, gcd(inf_a, inf_b)))
+    okay &= report(a, b, "gcd");
   if (!compare((int_a | int_b), (inf_a | inf_b)))
     okay &= report(a, b, "|");
   if (!compare((int_a & int_b), (inf_a & inf_b)))
@@ -205,6 +214,108 @@ int main (int argc, char* argv[])
       }
     }
 
+    // test the fused arithmetic, which works directly in the result
+    std::cerr << "Testing fused arithmetic" << std::endl;
+    stlplus::inf accumulator(7);
+    add_mul(accumulator, googol, googol);
+    sub_mul(accumulator, googol, stlplus::inf(-3));
+    add_mul(accumulator, accumulator, stlplus::inf(2));
+    stlplus::inf product;
+    mul_into(product, googol, -googol);
+    mul_into(product, product, product);
+    if (accumulator != (googol * googol + googol * stlplus::inf(3) + stlplus::inf(7)) * stlplus::inf(3) ||
+        product != pow(googol, 4))
+    {
+      std::cerr << "ERROR: wrong result for fused arithmetic" << std::endl;
+      okay = false;
+    }
+
+    // test the arithmetic at the limits of 64-bit values, where the result overflows into a second word
+    std::cerr << "Testing 64-bit limits" << std::endl;
+    stlplus::inf largest("9223372036854775807");
+    stlplus::inf smallest("-9223372036854775808");
+    stlplus::inf minus_one(-1);
+    if ((largest + stlplus::inf(1)).to_string() != "9223372036854775808" ||
+        (smallest - stlplus::inf(1)).to_string() != "-9223372036854775809" ||
+        (smallest + smallest).to_string() != "-18446744073709551616" ||
+        (largest - smallest).to_string() != "18446744073709551615" ||
+        (smallest * smallest).to_string() != "85070591730234615865843651857942052864" ||
+        (largest * smallest).to_string() != "-85070591730234615856620279821087277056" ||
+        (smallest * minus_one).to_string() != "9223372036854775808" ||
+        (smallest / minus_one).to_string() != "9223372036854775808" ||
+        (smallest % minus_one).to_string() != "0" ||
+        (smallest / largest) != minus_one || (smallest % largest) != minus_one ||
+        !(smallest < largest) || !(minus_one < stlplus::inf(0)) || !(smallest < minus_one) || smallest == largest)
+    {
+      std::cerr << "ERROR: wrong result at the limits of 64-bit values" << std::endl;
+      okay = false;
+    }
+    // exchanging small and large values
+    stlplus::inf small(42);
+    stlplus::inf large = googol;
+    small.swap(large);
+    if (small != googol || large != stlplus::inf(42))
+    {
+      std::cerr << "ERROR: wrong result swapping values" << std::endl;
+      okay = false;
+    }
+
+    // test the division and number theory functions on large values
+    std::cerr << "Testing number theory" << std::endl;
+    if (pow(stlplus::inf(10), 100) != googol)
+    {
+      std::cerr << "ERROR: 10 to the power 100 is not a googol" << std::endl;
+      okay = false;
+    }
+    std::pair<stlplus::inf,stlplus::inf> divided = (googol * googol * googol + stlplus::inf(7)).divide(googol);
+    if (divided.first != googol * googol || divided.second != stlplus::inf(7))
+    {
+      std::cerr << "ERROR: wrong result dividing by a googol" << std::endl;
+      okay = false;
+    }
+    // a division where the estimate of a quotient limb is one too large and has to be corrected by adding back
+    stlplus::inf numerator("0x07fffffffffffffff800000000000000000000000000000000000000000000000");
+    stlplus::inf divisor("0x0800000000000000000000000000000000000000000000001");
+    divided = numerator.divide(divisor);
+    if (divided.first * divisor + divided.second != numerator || divided.second.negative() || divided.second >= divisor)
+    {
+      std::cerr << "ERROR: wrong result for add-back division" << std::endl;
+      okay = false;
+    }
+    if (gcd(googol * stlplus::inf(6), googol * stlplus::inf(-15)) != googol * stlplus::inf(3))
+    {
+      std::cerr << "ERROR: wrong gcd of multiples of a googol" << std::endl;
+      okay = false;
+    }
+    // 2^127-1 is prime, so by Fermat's little theorem any value not a multiple of it raised to the power 2^127-2 is 1
+    stlplus::inf prime = (stlplus::inf(1) << 127) - stlplus::inf(1);
+    if (powmod(googol, prime - stlplus::inf(1), prime) != stlplus::inf(1) ||
+        powmod(-googol, prime - stlplus::inf(1), -prime) != stlplus::inf(1))
+    {
+      std::cerr << "ERROR: wrong result for powmod with a prime modulus" << std::endl;
+      okay = false;
+    }
+    // an even modulus
+    if (powmod(stlplus::inf(3), stlplus::inf(100), googol) != pow(stlplus::inf(3), 100) % googol)
+    {
+      std::cerr << "ERROR: wrong result for powmod with an even modulus" << std::endl;
+      okay = false;
+    }
+    if ((googol * modinv(googol, prime)) % prime != stlplus::inf(1))
+    {
+      std::cerr << "ERROR: wrong result for modinv" << std::endl;
+      okay = false;
+    }
+    try
+    {
+      modinv(stlplus::inf(2), googol);
+      std::cerr << "ERROR: modinv found an inverse of 2 modulo a googol" << std::endl;
+      okay = false;
+    }
+    catch (std::invalid_argument&)
+    {
+    }
+
     // test the persistence
     std::cerr << "dumping" << std::endl;
     stlplus::dump_to_file(googol, DATA, stlplus::dump_inf, 0);
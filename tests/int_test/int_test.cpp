@@ -0,0 +1,237 @@
+#include <string>
+#include <vector>
+#include <limits.h>
+#include "persistent_contexts.hpp"
+#include "persistent_int.hpp"
+#include "persistent_vector.hpp"
+#include "persistent_shortcuts.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define DATA "int_test.tmp"
+#define MASTER "int_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// a spread of values around every power of two plus the limits of the type
+// the arithmetic is done in the unsigned type U of the same size so that it wraps rather than overflowing
+template<typename T, typename U>
+void add_values(std::vector<T>& values, T minimum, T maximum)
+{
+  values.push_back(minimum);
+  values.push_back(maximum);
+  values.push_back((T)0);
+  for (unsigned shift = 0; shift < 8 * sizeof(T); shift++)
+  {
+    U power = (U)((U)1 << shift);
+    values.push_back((T)power);
+    values.push_back((T)(U)(power - 1));
+    values.push_back((T)(U)(power + 1));
+    values.push_back((T)(U)(0 - power));
+    values.push_back((T)(U)(0 - power - 1));
+  }
+}
+
+class int_values
+{
+public:
+  std::vector<short> m_short;
+  std::vector<unsigned short> m_unsigned_short;
+  std::vector<int> m_int;
+  std::vector<unsigned> m_unsigned;
+  std::vector<long> m_long;
+  std::vector<unsigned long> m_unsigned_long;
+
+  void create(void)
+    {
+      add_values<short,unsigned short>(m_short, SHRT_MIN, SHRT_MAX);
+      add_values<unsigned short,unsigned short>(m_unsigned_short, 0, USHRT_MAX);
+      add_values<int,unsigned>(m_int, INT_MIN, INT_MAX);
+      add_values<unsigned,unsigned>(m_unsigned, 0, UINT_MAX);
+      // long and unsigned long are restricted to 32 bits so that the master dump is portable
+      m_long.resize(m_int.size());
+      for (unsigned i = 0; i < m_int.size(); i++)
+        m_long[i] = m_int[i];
+      m_unsigned_long.resize(m_unsigned.size());
+      for (unsigned i = 0; i < m_unsigned.size(); i++)
+        m_unsigned_long[i] = m_unsigned[i];
+    }
+
+  bool operator==(const int_values& right) const
+    {
+      return m_short == right.m_short &&
+        m_unsigned_short == right.m_unsigned_short &&
+        m_int == right.m_int &&
+        m_unsigned == right.m_unsigned &&
+        m_long == right.m_long &&
+        m_unsigned_long == right.m_unsigned_long;
+    }
+};
+
+// dump each element in turn
+void dump_int_values(stlplus::dump_context& context, const int_values& data)
+{
+  stlplus::dump_vector(context, data.m_short, stlplus::dump_short);
+  stlplus::dump_vector(context, data.m_unsigned_short, stlplus::dump_unsigned_short);
+  stlplus::dump_vector(context, data.m_int, stlplus::dump_int);
+  stlplus::dump_vector(context, data.m_unsigned, stlplus::dump_unsigned);
+  stlplus::dump_vector(context, data.m_long, stlplus::dump_long);
+  stlplus::dump_vector(context, data.m_unsigned_long, stlplus::dump_unsigned_long);
+}
+
+void restore_int_values(stlplus::restore_context& context, int_values& data)
+{
+  stlplus::restore_vector(context, data.m_short, stlplus::restore_short);
+  stlplus::restore_vector(context, data.m_unsigned_short, stlplus::restore_unsigned_short);
+  stlplus::restore_vector(context, data.m_int, stlplus::restore_int);
+  stlplus::restore_vector(context, data.m_unsigned, stlplus::restore_unsigned);
+  stlplus::restore_vector(context, data.m_long, stlplus::restore_long);
+  stlplus::restore_vector(context, data.m_unsigned_long, stlplus::restore_unsigned_long);
+}
+
+// the array functions give the same format as the vector dump, which is the size followed by the elements
+template<typename T, typename D>
+void dump_array(stlplus::dump_context& context, const std::vector<T>& data, D dump_fn)
+{
+  stlplus::dump_size_t(context, data.size());
+  if (!data.empty())
+    dump_fn(context, &data[0], data.size());
+}
+
+template<typename T, typename R>
+void restore_array(stlplus::restore_context& context, std::vector<T>& data, R restore_fn)
+{
+  size_t size = 0;
+  stlplus::restore_size_t(context, size);
+  data.resize(size);
+  if (!data.empty())
+    restore_fn(context, &data[0], data.size());
+}
+
+void dump_int_arrays(stlplus::dump_context& context, const int_values& data)
+{
+  dump_array(context, data.m_short, stlplus::dump_short_array);
+  dump_array(context, data.m_unsigned_short, stlplus::dump_unsigned_short_array);
+  dump_array(context, data.m_int, stlplus::dump_int_array);
+  dump_array(context, data.m_unsigned, stlplus::dump_unsigned_array);
+  dump_array(context, data.m_long, stlplus::dump_long_array);
+  dump_array(context, data.m_unsigned_long, stlplus::dump_unsigned_long_array);
+}
+
+void restore_int_arrays(stlplus::restore_context& context, int_values& data)
+{
+  restore_array(context, data.m_short, stlplus::restore_short_array);
+  restore_array(context, data.m_unsigned_short, stlplus::restore_unsigned_short_array);
+  restore_array(context, data.m_int, stlplus::restore_int_array);
+  restore_array(context, data.m_unsigned, stlplus::restore_unsigned_array);
+  restore_array(context, data.m_long, stlplus::restore_long_array);
+  restore_array(context, data.m_unsigned_long, stlplus::restore_unsigned_long_array);
+}
+
+void dump_long_vector(stlplus::dump_context& context, const std::vector<long>& data)
+{
+  stlplus::dump_vector(context, data, stlplus::dump_long);
+}
+
+void restore_short_vector(stlplus::restore_context& context, std::vector<short>& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_short);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing integers" << std::endl;
+
+  try
+  {
+    std::cerr << "creating" << std::endl;
+    int_values data;
+    data.create();
+
+    // now dump to the file
+    std::cerr << "dumping" << std::endl;
+    stlplus::dump_to_file(data,DATA,dump_int_values,0);
+
+    // now restore the same file and compare
+    std::cerr << "restoring" << std::endl;
+    int_values restored;
+    stlplus::restore_from_file(DATA,restored,restore_int_values,0);
+    if (!(restored == data))
+    {
+      std::cerr << "error: restored values are different" << std::endl;
+      result = false;
+    }
+
+    // compare with the master dump if present - this checks that the format has not changed
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      int_values master;
+      stlplus::restore_from_file(MASTER,master,restore_int_values,0);
+      if (!(master == data))
+      {
+        std::cerr << "error: master values are different" << std::endl;
+        result = false;
+      }
+    }
+
+    // the array functions must give exactly the same dump
+    std::cerr << "dumping arrays" << std::endl;
+    std::string elements;
+    stlplus::dump_to_string(data,elements,dump_int_values,0);
+    std::string arrays;
+    stlplus::dump_to_string(data,arrays,dump_int_arrays,0);
+    if (arrays != elements)
+    {
+      std::cerr << "error: array dump is different from element dump" << std::endl;
+      result = false;
+    }
+    std::cerr << "restoring arrays" << std::endl;
+    int_values from_arrays;
+    stlplus::restore_from_string(elements,from_arrays,restore_int_arrays,0);
+    if (!(from_arrays == data))
+    {
+      std::cerr << "error: restored arrays are different" << std::endl;
+      result = false;
+    }
+
+    // restoring a value that is too big for the type is an error
+    std::cerr << "restoring overflow" << std::endl;
+    try
+    {
+      std::string image;
+      stlplus::dump_to_string(data.m_long,image,dump_long_vector,0);
+      std::vector<short> overflow;
+      stlplus::restore_from_string(image,overflow,restore_short_vector,0);
+      std::cerr << "error: restored long into short" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -96,6 +96,20 @@ int main(int argc, char* argv[])
       stlplus::restore_from_file(MASTER,master,restore_int_string_map,0);
       result &= compare(data,master);
     }
+
+    // the string dump must be the same as the file dump and its size must be predicted exactly
+    std::cerr << "dumping to string" << std::endl;
+    std::string image;
+    stlplus::dump_to_string(data,image,dump_int_string_map,0);
+    size_t size = stlplus::dump_size(data,dump_int_string_map,0);
+    if (size != image.size() || size != stlplus::file_size(DATA))
+    {
+      std::cerr << "error: dump size " << size << " string size " << image.size() << " file size " << stlplus::file_size(DATA) << std::endl;
+      result = false;
+    }
+    int_string_map from_string;
+    stlplus::restore_from_string(image,from_string,restore_int_string_map,0);
+    result &= compare(data,from_string);
   }
   catch(std::exception& except)
   {
@@ -0,0 +1,685 @@
+// Throughput benchmark for the persistence library
+// Dumps and restores a set of representative large data structures and reports the
+// speed of each operation as MB/s and objects/s
+
+// usage: persistence_benchmark [scale [repeats]]
+//   scale multiplies the size of every workload (default 1)
+//   repeats is the number of times each operation is timed, the best time is reported (default 3)
+
+// Progress is reported on standard error. The results go to standard output as
+// comma-separated values with a header line, so they can be collected and compared over time:
+//   workload,operation,objects,bytes,seconds,mb_per_s,objects_per_s
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <stdlib.h>
+#include <time.h>
+#include "hash.hpp"
+#include "digraph.hpp"
+#include "ntree.hpp"
+#include "smart_ptr.hpp"
+#include "inf.hpp"
+#include "persistent_contexts.hpp"
+#include "persistent_shortcuts.hpp"
+#include "persistent_int.hpp"
+#include "persistent_string.hpp"
+#include "persistent_vector.hpp"
+#include "persistent_map.hpp"
+#include "persistent_hash.hpp"
+#include "persistent_digraph.hpp"
+#include "persistent_ntree.hpp"
+#include "persistent_inf.hpp"
+#include "persistent_smart_ptr.hpp"
+#include "persistent_callback.hpp"
+#include "persistent_pointer.hpp"
+#include "persistent_arena.hpp"
+#include "persistent_archive.hpp"
+#include "persistent_compression.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+#ifdef STLPLUS_HAS_CXX11
+#include <chrono>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define DATA "persistence_benchmark.tmp"
+
+// wall-clock time in seconds - falls back to processor time without C++11
+static double now(void)
+{
+#ifdef STLPLUS_HAS_CXX11
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// result reporting
+
+static void report(const std::string& workload, const std::string& operation, size_t objects, size_t bytes, double seconds)
+{
+  // guard against timer resolution giving a zero time
+  if (seconds <= 0.0) seconds = 1e-9;
+  double mb_per_s = (double)bytes / seconds / (1024.0 * 1024.0);
+  double objects_per_s = (double)objects / seconds;
+  std::cout << stlplus::dformat("%s,%s,%lu,%lu,%.6f,%.2f,%.0f",
+                                workload.c_str(), operation.c_str(),
+                                (unsigned long)objects, (unsigned long)bytes,
+                                seconds, mb_per_s, objects_per_s) << std::endl;
+  std::cerr << stlplus::dformat("  %-20s %8.2f MB/s %12.0f objects/s", operation.c_str(), mb_per_s, objects_per_s) << std::endl;
+}
+
+// time the four shortcut operations on one workload
+// the restored data is discarded after each timing, outside the timed region
+template<typename T, class D, class R>
+void measure(const std::string& workload, size_t objects, const T& data, D dump_fn, R restore_fn,
+             stlplus::dump_context::installer dump_installer, stlplus::restore_context::installer restore_installer,
+             unsigned repeats)
+{
+  std::cerr << workload << ": " << objects << " objects" << std::endl;
+  std::string image;
+  double best = 0.0;
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    double start = now();
+    stlplus::dump_to_string(data, image, dump_fn, dump_installer);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best) best = elapsed;
+  }
+  report(workload, "dump_to_string", objects, image.size(), best);
+
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    T* restored = new T;
+    double start = now();
+    stlplus::restore_from_string(image, *restored, restore_fn, restore_installer);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best) best = elapsed;
+    delete restored;
+  }
+  report(workload, "restore_from_string", objects, image.size(), best);
+
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    double start = now();
+    stlplus::dump_to_file(data, DATA, dump_fn, dump_installer);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best) best = elapsed;
+  }
+  report(workload, "dump_to_file", objects, stlplus::file_size(DATA), best);
+
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    T* restored = new T;
+    double start = now();
+    stlplus::restore_from_file(DATA, *restored, restore_fn, restore_installer);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best) best = elapsed;
+    delete restored;
+  }
+  report(workload, "restore_from_file", objects, stlplus::file_size(DATA), best);
+  stlplus::file_delete(DATA);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// integer vector
+
+typedef std::vector<int> int_vector;
+
+void dump_int_vector(stlplus::dump_context& context, const int_vector& data)
+{
+  stlplus::dump_vector(context, data, stlplus::dump_int);
+}
+
+void restore_int_vector(stlplus::restore_context& context, int_vector& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_int);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// string map
+
+typedef std::map<std::string,std::string> string_string_map;
+
+void dump_string_string_map(stlplus::dump_context& context, const string_string_map& data)
+{
+  stlplus::dump_map(context, data, stlplus::dump_string, stlplus::dump_string);
+}
+
+void restore_string_string_map(stlplus::restore_context& context, string_string_map& data)
+{
+  stlplus::restore_map(context, data, stlplus::restore_string, stlplus::restore_string);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// hash
+
+class hash_int
+{
+public:
+  unsigned operator () (int value) const
+    {return (unsigned)value;}
+};
+
+typedef stlplus::hash<int,std::string,hash_int> int_string_hash;
+
+void dump_int_string_hash(stlplus::dump_context& context, const int_string_hash& data)
+{
+  stlplus::dump_hash(context, data, stlplus::dump_int, stlplus::dump_string);
+}
+
+void restore_int_string_hash(stlplus::restore_context& context, int_string_hash& data)
+{
+  stlplus::restore_hash(context, data, stlplus::restore_int, stlplus::restore_string);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// digraph
+
+typedef stlplus::digraph<std::string,int> string_int_graph;
+
+void dump_string_int_graph(stlplus::dump_context& context, const string_int_graph& data)
+{
+  stlplus::dump_digraph(context, data, stlplus::dump_string, stlplus::dump_int);
+}
+
+void restore_string_int_graph(stlplus::restore_context& context, string_int_graph& data)
+{
+  stlplus::restore_digraph(context, data, stlplus::restore_string, stlplus::restore_int);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ntree
+
+typedef stlplus::ntree<int> int_ntree;
+
+void dump_int_ntree(stlplus::dump_context& context, const int_ntree& data)
+{
+  stlplus::dump_ntree(context, data, stlplus::dump_int);
+}
+
+void restore_int_ntree(stlplus::restore_context& context, int_ntree& data)
+{
+  stlplus::restore_ntree(context, data, stlplus::restore_int);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// inf
+
+typedef std::vector<stlplus::inf> inf_vector;
+
+void dump_inf_vector(stlplus::dump_context& context, const inf_vector& data)
+{
+  stlplus::dump_vector(context, data, stlplus::dump_inf);
+}
+
+void restore_inf_vector(stlplus::restore_context& context, inf_vector& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_inf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// smart pointers with shared targets
+
+typedef stlplus::smart_ptr<int> int_ptr;
+typedef std::vector<int_ptr> int_ptr_vector;
+
+void dump_int_ptr(stlplus::dump_context& context, const int_ptr& data)
+{
+  stlplus::dump_smart_ptr(context, data, stlplus::dump_int);
+}
+
+void restore_int_ptr(stlplus::restore_context& context, int_ptr& data)
+{
+  stlplus::restore_smart_ptr(context, data, stlplus::restore_int);
+}
+
+void dump_int_ptr_vector(stlplus::dump_context& context, const int_ptr_vector& data)
+{
+  stlplus::dump_vector(context, data, dump_int_ptr);
+}
+
+void restore_int_ptr_vector(stlplus::restore_context& context, int_ptr_vector& data)
+{
+  stlplus::restore_vector(context, data, restore_int_ptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// polymorphic objects using callbacks
+
+class base
+{
+public:
+  int m_value;
+
+  base(int value = 0) : m_value(value) {}
+  virtual ~base(void) {}
+  virtual base* clone(void) const {return new base(*this);}
+};
+
+class derived : public base
+{
+public:
+  std::string m_image;
+
+  derived(int value = 0) : base(value), m_image(stlplus::dformat("%d",value)) {}
+  virtual base* clone(void) const {return new derived(*this);}
+};
+
+void dump_base(stlplus::dump_context& context, const void* data)
+{
+  stlplus::dump_int(context,((const base*)data)->m_value);
+}
+
+void* create_base(void)
+{
+  return new base;
+}
+
+void restore_base(stlplus::restore_context& context, void* data)
+{
+  stlplus::restore_int(context,((base*)data)->m_value);
+}
+
+void dump_derived(stlplus::dump_context& context, const void* data)
+{
+  dump_base(context,data);
+  stlplus::dump_string(context,((const derived*)data)->m_image);
+}
+
+void* create_derived(void)
+{
+  return new derived;
+}
+
+void restore_derived(stlplus::restore_context& context, void* data)
+{
+  restore_base(context,data);
+  stlplus::restore_string(context,((derived*)data)->m_image);
+}
+
+void install_base_dump(stlplus::dump_context& context)
+{
+  context.register_callback(typeid(base),dump_base);
+  context.register_callback(typeid(derived),dump_derived);
+}
+
+void install_base_restore(stlplus::restore_context& context)
+{
+  context.register_callback(create_base,restore_base);
+  context.register_callback(create_derived,restore_derived);
+}
+
+typedef stlplus::smart_ptr_clone<base> base_ptr;
+typedef std::vector<base_ptr> base_vector;
+
+void dump_base_ptr(stlplus::dump_context& context, const base_ptr& data)
+{
+  stlplus::dump_smart_ptr_clone_callback(context, data);
+}
+
+void restore_base_ptr(stlplus::restore_context& context, base_ptr& data)
+{
+  stlplus::restore_smart_ptr_clone_callback(context, data);
+}
+
+void dump_base_vector(stlplus::dump_context& context, const base_vector& data)
+{
+  stlplus::dump_vector(context, data, dump_base_ptr);
+}
+
+void restore_base_vector(stlplus::restore_context& context, base_vector& data)
+{
+  stlplus::restore_vector(context, data, restore_base_ptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// plain pointers, restored either with new or into an arena
+// each node links back to earlier nodes so that the restore doesn't recurse deeply
+
+class node
+{
+public:
+  int m_value;
+  node* m_previous;
+  node* m_parent;
+
+  node(int value = 0) : m_value(value), m_previous(0), m_parent(0) {}
+};
+
+typedef std::vector<node*> node_vector;
+
+void dump_node(stlplus::dump_context& context, const node& data);
+void restore_node(stlplus::restore_context& context, node& data);
+
+void dump_node_ptr(stlplus::dump_context& context, node* const& data)
+{
+  stlplus::dump_pointer(context, data, dump_node);
+}
+
+void restore_node_ptr(stlplus::restore_context& context, node*& data)
+{
+  stlplus::restore_pointer(context, data, restore_node);
+}
+
+void dump_node(stlplus::dump_context& context, const node& data)
+{
+  stlplus::dump_int(context, data.m_value);
+  dump_node_ptr(context, data.m_previous);
+  dump_node_ptr(context, data.m_parent);
+}
+
+void restore_node(stlplus::restore_context& context, node& data)
+{
+  stlplus::restore_int(context, data.m_value);
+  restore_node_ptr(context, data.m_previous);
+  restore_node_ptr(context, data.m_parent);
+}
+
+void dump_node_vector(stlplus::dump_context& context, const node_vector& data)
+{
+  stlplus::dump_vector(context, data, dump_node_ptr);
+}
+
+void restore_node_vector(stlplus::restore_context& context, node_vector& data)
+{
+  stlplus::restore_vector(context, data, restore_node_ptr);
+}
+
+// compare a restore using new followed by deleting every node with a restore into an arena followed by a release
+void measure_arena(const std::string& workload, size_t objects, const node_vector& data, unsigned repeats)
+{
+  std::cerr << workload << ": " << objects << " objects" << std::endl;
+  std::string image;
+  stlplus::dump_to_string(data, image, dump_node_vector, 0);
+
+  double best_restore = 0.0;
+  double best_delete = 0.0;
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    node_vector restored;
+    double start = now();
+    stlplus::restore_from_string(image, restored, restore_node_vector, 0);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best_restore) best_restore = elapsed;
+    start = now();
+    for (unsigned i = 0; i < restored.size(); i++)
+      delete restored[i];
+    elapsed = now() - start;
+    if (r == 0 || elapsed < best_delete) best_delete = elapsed;
+  }
+  report(workload, "restore_from_string", objects, image.size(), best_restore);
+  report(workload, "delete", objects, image.size(), best_delete);
+
+  double best_arena = 0.0;
+  double best_release = 0.0;
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    stlplus::restore_arena arena;
+    node_vector restored;
+    double start = now();
+    {
+      stlplus::restore_context context(image);
+      context.set_arena(&arena);
+      restore_node_vector(context, restored);
+    }
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best_arena) best_arena = elapsed;
+    start = now();
+    arena.release();
+    elapsed = now() - start;
+    if (r == 0 || elapsed < best_release) best_release = elapsed;
+  }
+  report(workload, "restore_into_arena", objects, image.size(), best_arena);
+  report(workload, "release_arena", objects, image.size(), best_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// compressed dumps of a map dominated by repetitive strings, to compare with the uncompressed string_map workload
+
+// time the compressed string shortcuts - the bytes reported are the uncompressed size, so the speeds compare directly
+template<typename T, class D, class R>
+void measure_compressed(const std::string& workload, size_t objects, const T& data, D dump_fn, R restore_fn, unsigned repeats)
+{
+  std::cerr << workload << ": " << objects << " objects" << std::endl;
+  std::string plain;
+  stlplus::dump_to_string(data, plain, dump_fn, 0);
+  std::string image;
+  double best = 0.0;
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    double start = now();
+    stlplus::dump_to_compressed_string(data, image, dump_fn, 0);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best) best = elapsed;
+  }
+  std::cerr << stlplus::dformat("  compressed %lu bytes to %lu bytes, ratio %.2f",
+                                (unsigned long)plain.size(), (unsigned long)image.size(),
+                                (double)plain.size() / (double)image.size()) << std::endl;
+  report(workload, "dump_to_compressed_string", objects, plain.size(), best);
+
+  for (unsigned r = 0; r < repeats; r++)
+  {
+    T* restored = new T;
+    double start = now();
+    stlplus::restore_from_compressed_string(image, *restored, restore_fn, 0);
+    double elapsed = now() - start;
+    if (r == 0 || elapsed < best) best = elapsed;
+    delete restored;
+  }
+  report(workload, "restore_from_compressed_string", objects, plain.size(), best);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// an archive of independent sections, dumped and restored with different numbers of threads
+
+typedef std::map<int,std::string> int_string_map;
+
+void dump_int_string_map(stlplus::dump_context& context, const int_string_map& data)
+{
+  stlplus::dump_map(context, data, stlplus::dump_int, stlplus::dump_string);
+}
+
+void restore_int_string_map(stlplus::restore_context& context, int_string_map& data)
+{
+  stlplus::restore_map(context, data, stlplus::restore_int, stlplus::restore_string);
+}
+
+typedef std::vector<int_string_map> section_vector;
+
+void measure_archive(const std::string& workload, size_t objects, const section_vector& data, unsigned max_threads, unsigned repeats)
+{
+  std::cerr << workload << ": " << objects << " objects in " << data.size() << " sections" << std::endl;
+  for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+  {
+    std::string image;
+    double best = 0.0;
+    for (unsigned r = 0; r < repeats; r++)
+    {
+      stlplus::dump_archive archive;
+      for (unsigned i = 0; i < data.size(); i++)
+        archive.add(data[i], dump_int_string_map, 0);
+      std::ostringstream output(std::ios_base::out | std::ios_base::binary);
+      double start = now();
+      archive.dump(output, threads);
+      double elapsed = now() - start;
+      if (r == 0 || elapsed < best) best = elapsed;
+      image = output.str();
+    }
+    report(workload, stlplus::dformat("dump_%u_threads", threads), objects, image.size(), best);
+
+    for (unsigned r = 0; r < repeats; r++)
+    {
+      section_vector* restored = new section_vector(data.size());
+      stlplus::restore_archive archive;
+      for (unsigned i = 0; i < restored->size(); i++)
+        archive.add((*restored)[i], restore_int_string_map, 0);
+      std::istringstream input(image, std::ios_base::in | std::ios_base::binary);
+      double start = now();
+      archive.restore(input, threads);
+      double elapsed = now() - start;
+      if (r == 0 || elapsed < best) best = elapsed;
+      delete restored;
+    }
+    report(workload, stlplus::dformat("restore_%u_threads", threads), objects, image.size(), best);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  unsigned scale = argc > 1 ? (unsigned)atoi(argv[1]) : 1;
+  unsigned repeats = argc > 2 ? (unsigned)atoi(argv[2]) : 3;
+  if (scale == 0) scale = 1;
+  if (repeats == 0) repeats = 1;
+  std::cerr << stlplus::build() << " benchmarking persistence at scale " << scale << " with " << repeats << " repeats" << std::endl;
+  std::cout << "workload,operation,objects,bytes,seconds,mb_per_s,objects_per_s" << std::endl;
+
+  try
+  {
+    {
+      unsigned number = 1000000 * scale;
+      int_vector data;
+      data.reserve(number);
+      // mix small and large values so that the integer encoding sees all sizes
+      for (unsigned i = 0; i < number; i++)
+        data.push_back((int)(i * 2654435761u) >> (i % 32));
+      measure("int_vector", number, data, dump_int_vector, restore_int_vector, 0, 0, repeats);
+    }
+    {
+      unsigned number = 100000 * scale;
+      string_string_map data;
+      for (unsigned i = 0; i < number; i++)
+        data[stlplus::dformat("key %u", i)] = stlplus::dformat("value %u of the string map", i);
+      measure("string_map", number, data, dump_string_string_map, restore_string_string_map, 0, 0, repeats);
+    }
+    {
+      unsigned number = 100000 * scale;
+      int_string_hash data;
+      for (unsigned i = 0; i < number; i++)
+        data[(int)i] = stlplus::dformat("value %u of the hash", i);
+      measure("hash", number, data, dump_int_string_hash, restore_int_string_hash, 0, 0, repeats);
+    }
+    {
+      // a chain of nodes with an extra arc to a node further on from every node
+      unsigned number = 100000 * scale;
+      string_int_graph data;
+      std::vector<string_int_graph::iterator> nodes;
+      nodes.reserve(number);
+      for (unsigned i = 0; i < number; i++)
+        nodes.push_back(data.insert(stlplus::dformat("node %u", i)));
+      for (unsigned i = 0; i < number; i++)
+      {
+        data.arc_insert(nodes[i], nodes[(i+1) % number], (int)i);
+        data.arc_insert(nodes[i], nodes[(i*7+3) % number], -(int)i);
+      }
+      measure("digraph", number + data.arc_size(), data, dump_string_int_graph, restore_string_int_graph, 0, 0, repeats);
+    }
+    {
+      // a tree with a branching factor of 4
+      unsigned number = 100000 * scale;
+      int_ntree data;
+      std::vector<int_ntree::iterator> nodes;
+      nodes.reserve(number);
+      nodes.push_back(data.insert(0));
+      for (unsigned i = 1; i < number; i++)
+        nodes.push_back(data.append(nodes[(i-1)/4], (int)i));
+      measure("ntree", number, data, dump_int_ntree, restore_int_ntree, 0, 0, repeats);
+    }
+    {
+      // integers of around 60 decimal digits
+      unsigned number = 20000 * scale;
+      inf_vector data;
+      data.reserve(number);
+      for (unsigned i = 0; i < number; i++)
+      {
+        stlplus::inf value((unsigned long)i + 1);
+        for (unsigned j = 0; j < 6; j++)
+          value *= stlplus::inf(1234567891u);
+        data.push_back(value);
+      }
+      measure("inf", number, data, dump_inf_vector, restore_inf_vector, 0, 0, repeats);
+    }
+    {
+      // every object is shared by four pointers
+      unsigned number = 200000 * scale;
+      int_ptr_vector data;
+      data.reserve(number);
+      for (unsigned i = 0; i < number; i++)
+      {
+        if (i % 4 == 0)
+          data.push_back(int_ptr(new int((int)i)));
+        else
+          data.push_back(data[i - i % 4]);
+      }
+      measure("smart_ptr", number, data, dump_int_ptr_vector, restore_int_ptr_vector, 0, 0, repeats);
+    }
+    {
+      unsigned number = 200000 * scale;
+      base_vector data;
+      data.reserve(number);
+      for (unsigned i = 0; i < number; i++)
+      {
+        if (i % 2)
+          data.push_back(base_ptr(new base((int)i)));
+        else
+          data.push_back(base_ptr(new derived((int)i)));
+      }
+      measure("callback", number, data, dump_base_vector, restore_base_vector, install_base_dump, install_base_restore, repeats);
+    }
+    {
+      unsigned number = 1000000 * scale;
+      node_vector data;
+      data.reserve(number);
+      for (unsigned i = 0; i < number; i++)
+      {
+        data.push_back(new node((int)i));
+        if (i > 0)
+        {
+          data[i]->m_previous = data[i-1];
+          data[i]->m_parent = data[i/2];
+        }
+      }
+      measure_arena("pointer", number, data, repeats);
+      for (unsigned i = 0; i < number; i++)
+        delete data[i];
+    }
+    {
+      // eight sections, each big enough to be worth a thread of its own
+      unsigned number = 20000 * scale;
+      section_vector data(8);
+      for (unsigned s = 0; s < data.size(); s++)
+        for (unsigned i = 0; i < number; i++)
+          data[s][(int)i] = stlplus::dformat("section %u value %u", s, i);
+      measure_archive("archive", data.size() * number, data, 4, repeats);
+    }
+    {
+      // the same records with and without compression
+      unsigned number = 20000 * scale;
+      int_string_map data;
+      static const char* states[] = {"active", "suspended", "pending", "closed"};
+      for (unsigned i = 0; i < number; i++)
+        data[(int)i*7] = stlplus::dformat("record %u: state=%s owner=user%u group=staff path=/home/user%u/data/file%u.txt",
+                                          i, states[i % 4], i % 50, i % 50, i);
+      measure("records", number, data, dump_int_string_map, restore_int_string_map, 0, 0, repeats);
+      measure_compressed("records", number, data, dump_int_string_map, restore_int_string_map, repeats);
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    return 1;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    return 1;
+  }
+  return 0;
+}
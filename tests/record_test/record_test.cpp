@@ -0,0 +1,333 @@
+#include <string>
+#include <map>
+#include <vector>
+#include "persistent_contexts.hpp"
+#include "persistent_record.hpp"
+#include "persistent_map.hpp"
+#include "persistent_vector.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "persistent_shortcuts.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 100
+#define DATA "record_test.tmp"
+#define MASTER "record_test.dump"
+
+////////////////////////////////////////////////////////////////////////////////
+// two versions of a customer class - the later version has an extra field
+
+typedef std::map<int,std::string> int_string_map;
+
+class customer_v1
+{
+public:
+  int m_id;
+  std::string m_name;
+};
+
+class customer_v2
+{
+public:
+  int m_id;
+  std::string m_name;
+  int_string_map m_orders;
+};
+
+void dump_customer_v1(stlplus::dump_context& context, const customer_v1& data)
+{
+  stlplus::dump_int(context, data.m_id);
+  stlplus::dump_string(context, data.m_name);
+}
+
+void restore_customer_v1(stlplus::restore_context& context, customer_v1& data)
+{
+  stlplus::restore_int(context, data.m_id);
+  stlplus::restore_string(context, data.m_name);
+}
+
+void dump_customer_v2(stlplus::dump_context& context, const customer_v2& data)
+{
+  stlplus::dump_int(context, data.m_id);
+  stlplus::dump_string(context, data.m_name);
+  stlplus::dump_map(context, data.m_orders, stlplus::dump_int, stlplus::dump_string);
+}
+
+// a version 1 dump has no orders, which is detected by reaching the end of the record
+void restore_customer_v2(stlplus::restore_context& context, customer_v2& data)
+{
+  stlplus::restore_int(context, data.m_id);
+  stlplus::restore_string(context, data.m_name);
+  data.m_orders.clear();
+  if (!context.end_of_record())
+    stlplus::restore_map(context, data.m_orders, stlplus::restore_int, stlplus::restore_string);
+}
+
+// the framed versions of the customer dump
+
+void dump_customer_v1_record(stlplus::dump_context& context, const customer_v1& data)
+{
+  stlplus::dump_record(context, data, dump_customer_v1);
+}
+
+void restore_customer_v1_record(stlplus::restore_context& context, customer_v1& data)
+{
+  stlplus::restore_record(context, data, restore_customer_v1);
+}
+
+void dump_customer_v2_record(stlplus::dump_context& context, const customer_v2& data)
+{
+  stlplus::dump_record(context, data, dump_customer_v2);
+}
+
+void restore_customer_v2_record(stlplus::restore_context& context, customer_v2& data)
+{
+  stlplus::restore_record(context, data, restore_customer_v2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// a file is a vector of customers, then a large history section, then a count
+// the history is a record too, so that readers that don't need it can skip it
+
+typedef std::vector<std::string> string_vector;
+
+class file_v2
+{
+public:
+  std::vector<customer_v2> m_customers;
+  string_vector m_history;
+  int m_count;
+};
+
+void dump_history(stlplus::dump_context& context, const string_vector& data)
+{
+  stlplus::dump_vector(context, data, stlplus::dump_string);
+}
+
+void restore_history(stlplus::restore_context& context, string_vector& data)
+{
+  stlplus::restore_vector(context, data, stlplus::restore_string);
+}
+
+void dump_file_v2(stlplus::dump_context& context, const file_v2& data)
+{
+  stlplus::dump_vector(context, data.m_customers, dump_customer_v2_record);
+  stlplus::dump_record(context, data.m_history, dump_history);
+  stlplus::dump_int(context, data.m_count);
+}
+
+void restore_file_v2(stlplus::restore_context& context, file_v2& data)
+{
+  stlplus::restore_vector(context, data.m_customers, restore_customer_v2_record);
+  stlplus::restore_record(context, data.m_history, restore_history);
+  stlplus::restore_int(context, data.m_count);
+}
+
+// the old reader only knows about the version 1 customer and skips the history
+
+class file_v1
+{
+public:
+  std::vector<customer_v1> m_customers;
+  int m_count;
+};
+
+void dump_file_v1(stlplus::dump_context& context, const file_v1& data)
+{
+  stlplus::dump_vector(context, data.m_customers, dump_customer_v1_record);
+  stlplus::dump_record(context, string_vector(), dump_history);
+  stlplus::dump_int(context, data.m_count);
+}
+
+void restore_file_v1(stlplus::restore_context& context, file_v1& data)
+{
+  stlplus::restore_vector(context, data.m_customers, restore_customer_v1_record);
+  stlplus::skip_record(context);
+  stlplus::restore_int(context, data.m_count);
+}
+
+// a restore that reads more than the record holds
+
+void restore_too_much(stlplus::restore_context& context, customer_v1& data)
+{
+  restore_customer_v1(context, data);
+  context.get();
+}
+
+void restore_file_too_much(stlplus::restore_context& context, file_v1& data)
+{
+  size_t size = 0;
+  stlplus::restore_size_t(context, size);
+  data.m_customers.resize(1);
+  stlplus::restore_record(context, data.m_customers[0], restore_too_much);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool compare(const file_v2& left, const file_v2& right)
+{
+  bool result = true;
+  if (left.m_customers.size() != right.m_customers.size())
+  {
+    std::cerr << "different number of customers" << std::endl;
+    return false;
+  }
+  for (unsigned i = 0; i < left.m_customers.size(); i++)
+  {
+    if (left.m_customers[i].m_id != right.m_customers[i].m_id ||
+        left.m_customers[i].m_name != right.m_customers[i].m_name ||
+        left.m_customers[i].m_orders != right.m_customers[i].m_orders)
+    {
+      std::cerr << "customer " << i << " is different" << std::endl;
+      result = false;
+    }
+  }
+  if (left.m_history != right.m_history)
+  {
+    std::cerr << "history is different" << std::endl;
+    result = false;
+  }
+  if (left.m_count != right.m_count)
+  {
+    std::cerr << "count is different" << std::endl;
+    result = false;
+  }
+  return result;
+}
+
+bool compare(const file_v2& left, const file_v1& right)
+{
+  bool result = true;
+  if (left.m_customers.size() != right.m_customers.size())
+  {
+    std::cerr << "different number of customers" << std::endl;
+    return false;
+  }
+  for (unsigned i = 0; i < left.m_customers.size(); i++)
+  {
+    if (left.m_customers[i].m_id != right.m_customers[i].m_id ||
+        left.m_customers[i].m_name != right.m_customers[i].m_name)
+    {
+      std::cerr << "customer " << i << " is different" << std::endl;
+      result = false;
+    }
+  }
+  if (left.m_count != right.m_count)
+  {
+    std::cerr << "count is different" << std::endl;
+    result = false;
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing records of " << NUMBER << " customers" << std::endl;
+
+  try
+  {
+    // build the sample data structure
+    std::cerr << "creating" << std::endl;
+    file_v2 data;
+    for (int i = 0; i < NUMBER; i++)
+    {
+      customer_v2 customer;
+      customer.m_id = i;
+      customer.m_name = stlplus::dformat("customer %d", i);
+      for (int j = 0; j < i % 5; j++)
+        customer.m_orders[j] = stlplus::dformat("order %d/%d", i, j);
+      data.m_customers.push_back(customer);
+      data.m_history.push_back(stlplus::dformat("history %d", i));
+    }
+    data.m_count = NUMBER;
+
+    // now dump to the file
+    std::cerr << "dumping" << std::endl;
+    stlplus::dump_to_file(data,DATA,dump_file_v2,0);
+
+    // now restore the same file and compare
+    std::cerr << "restoring" << std::endl;
+    file_v2 restored;
+    stlplus::restore_from_file(DATA,restored,restore_file_v2,0);
+    result &= compare(data,restored);
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      file_v2 master;
+      stlplus::restore_from_file(MASTER,master,restore_file_v2,0);
+      result &= compare(data,master);
+    }
+
+    // the size of a dump with records must be predicted exactly
+    std::string image;
+    stlplus::dump_to_string(data,image,dump_file_v2,0);
+    size_t size = stlplus::dump_size(data,dump_file_v2,0);
+    if (size != image.size() || size != stlplus::file_size(DATA))
+    {
+      std::cerr << "error: dump size " << size << " string size " << image.size() << " file size " << stlplus::file_size(DATA) << std::endl;
+      result = false;
+    }
+
+    // an old reader skips the new fields and the history, from a file and from a string
+    std::cerr << "restoring with the old reader" << std::endl;
+    file_v1 old_file;
+    stlplus::restore_from_file(DATA,old_file,restore_file_v1,0);
+    result &= compare(data,old_file);
+    file_v1 old_string;
+    stlplus::restore_from_string(image,old_string,restore_file_v1,0);
+    result &= compare(data,old_string);
+
+    // a new reader restores an old file without the new fields
+    std::cerr << "restoring an old file with the new reader" << std::endl;
+    std::string old_image;
+    stlplus::dump_to_string(old_file,old_image,dump_file_v1,0);
+    file_v2 upgraded;
+    stlplus::restore_from_string(old_image,upgraded,restore_file_v2,0);
+    file_v2 expected = data;
+    for (unsigned i = 0; i < expected.m_customers.size(); i++)
+      expected.m_customers[i].m_orders.clear();
+    expected.m_history.clear();
+    result &= compare(expected,upgraded);
+
+    // reading past the end of a record is detected - the old file's customer records have no spare bytes
+    std::cerr << "restoring too much" << std::endl;
+    try
+    {
+      file_v1 bad;
+      stlplus::restore_from_string(old_image,bad,restore_file_too_much,0);
+      std::cerr << "error: restored past the end of a record" << std::endl;
+      result = false;
+    }
+    catch(const stlplus::persistent_restore_failed& except)
+    {
+      std::cerr << "caught expected exception " << except.what() << std::endl;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+#include <string>
+#include <map>
+#include <time.h>
+#include "persistent_contexts.hpp"
+#include "persistent_snapshot.hpp"
+#include "persistent_map.hpp"
+#include "persistent_string.hpp"
+#include "persistent_int.hpp"
+#include "persistent_shortcuts.hpp"
+#include "strings.hpp"
+#include "dprintf.hpp"
+#include "file_system.hpp"
+#include "build.hpp"
+#ifdef STLPLUS_HAS_CXX11
+#include <chrono>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUMBER 20000
+#define DATA "snapshot_test.tmp"
+#define MASTER "snapshot_test.dump"
+#define BAD_DATA "no_such_folder/snapshot_test.tmp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<int,std::string> int_string_map;
+
+void dump_int_string_map(stlplus::dump_context& context, const int_string_map& data)
+{
+  stlplus::dump_map(context, data, stlplus::dump_int, stlplus::dump_string);
+}
+
+void restore_int_string_map(stlplus::restore_context& context, int_string_map& data)
+{
+  stlplus::restore_map(context, data, stlplus::restore_int, stlplus::restore_string);
+}
+
+// completion callback records the result in the argument, which points to a count of completions
+static std::string last_error;
+
+void snapshot_done(const std::string&, const std::string& error, void* argument)
+{
+  last_error = error;
+  (*(unsigned*)argument)++;
+}
+
+// wall-clock time in seconds - only fine-grained if C++11 is available
+static double now(void)
+{
+#ifdef STLPLUS_HAS_CXX11
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return (double)time(0);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  bool result = true;
+  std::cerr << stlplus::build() << " testing snapshots of " << NUMBER << " mappings" << std::endl;
+
+  try
+  {
+    // build the sample data structure
+    std::cerr << "creating" << std::endl;
+    int_string_map data;
+    for (unsigned i = 0; i < NUMBER; i++)
+      data[i] = stlplus::dformat("%d",i);
+    int_string_map original = data;
+
+    // the blocking dump for comparison
+    double start = now();
+    stlplus::dump_to_file(data,DATA,dump_int_string_map,0);
+    std::cerr << "blocking dump " << stlplus::dformat("%.3f", now() - start) << "s" << std::endl;
+    stlplus::file_delete(DATA);
+
+    // start a snapshot and immediately change the data - the snapshot must not see the change
+    std::cerr << "snapshot" << std::endl;
+    unsigned completions = 0;
+    stlplus::dump_snapshot snapshot;
+    start = now();
+    snapshot.start(data, DATA, dump_int_string_map, 0, snapshot_done, &completions);
+    std::cerr << "snapshot started after " << stlplus::dformat("%.3f", now() - start) << "s" << std::endl;
+    for (unsigned i = 0; i < NUMBER; i += 2)
+      data[i] = "changed";
+    if (!snapshot.wait())
+    {
+      std::cerr << "error: snapshot failed: " << snapshot.error() << std::endl;
+      result = false;
+    }
+    std::cerr << "snapshot finished after " << stlplus::dformat("%.3f", now() - start) << "s" << std::endl;
+    if (snapshot.busy() || completions != 1 || !last_error.empty())
+    {
+      std::cerr << "error: snapshot did not complete correctly" << std::endl;
+      result = false;
+    }
+
+    // now restore the snapshot and compare with the data as it was when started
+    std::cerr << "restoring" << std::endl;
+    int_string_map restored;
+    stlplus::restore_from_file(DATA,restored,restore_int_string_map,0);
+    if (restored != original)
+    {
+      std::cerr << "error: restored snapshot is different from the original" << std::endl;
+      result = false;
+    }
+
+    // compare with the master dump if present
+    if (!stlplus::file_exists(MASTER))
+      stlplus::file_copy(DATA,MASTER);
+    else
+    {
+      std::cerr << "restoring master" << std::endl;
+      int_string_map master;
+      stlplus::restore_from_file(MASTER,master,restore_int_string_map,0);
+      if (master != original)
+      {
+        std::cerr << "error: master is different from the original" << std::endl;
+        result = false;
+      }
+    }
+
+    // a second snapshot replaces the first
+    std::cerr << "second snapshot" << std::endl;
+    snapshot.start(data, DATA, dump_int_string_map, 0, snapshot_done, &completions);
+    snapshot.wait();
+    stlplus::restore_from_file(DATA,restored,restore_int_string_map,0);
+    if (restored != data || completions != 2)
+    {
+      std::cerr << "error: second snapshot is different from the data" << std::endl;
+      result = false;
+    }
+
+    // a checked snapshot can only be restored with a checked restore
+    std::cerr << "checked snapshot" << std::endl;
+    snapshot.start_checked(data, DATA, dump_int_string_map, 0, snapshot_done, &completions);
+    snapshot.wait();
+    stlplus::restore_from_checked_file(DATA,restored,restore_int_string_map,0);
+    if (restored != data || completions != 3)
+    {
+      std::cerr << "error: checked snapshot is different from the data" << std::endl;
+      result = false;
+    }
+
+    // a failed snapshot reports the error through the callback and wait
+    std::cerr << "failing snapshot" << std::endl;
+    snapshot.start(data, BAD_DATA, dump_int_string_map, 0, snapshot_done, &completions);
+    if (snapshot.wait() || completions != 4 || last_error.empty() || last_error != snapshot.error())
+    {
+      std::cerr << "error: failed snapshot was not reported" << std::endl;
+      result = false;
+    }
+    else
+      std::cerr << "caught expected error " << last_error << std::endl;
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  if (!result)
+    std::cerr << "test failed" << std::endl;
+  else
+    std::cerr << "test passed" << std::endl;
+  return result ? 0 : 1;
+}
@@ -0,0 +1,349 @@
+// Speed benchmark for the number to string conversions of string_int and string_float
+// Times int_to_string, the allocation-free int_to_chars and the C library's sprintf
+// for every radix display option over a spread of values and reports the time per conversion
+// Then times the reverse conversions, comparing the throwing string_to_int and string_to_double
+// with the non-throwing chars_to_int and chars_to_double and the C library's strtol and strtod
+
+// usage: string_benchmark [seconds]
+//   seconds is the minimum time spent timing each operation, the operation is repeated to fill it (default 0.2)
+
+// Progress is reported on standard error. The results go to standard output as
+// comma-separated values with a header line, so they can be collected and compared over time:
+//   operation,radix,display,iterations,seconds,ns_per_op
+
+#include <string>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "string_int.hpp"
+#include "string_float.hpp"
+#include "dprintf.hpp"
+#include "build.hpp"
+#ifdef STLPLUS_HAS_CXX11
+#include <chrono>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// the radices measured - the powers of two and decimal have their own fast paths, 36 uses division
+static const unsigned radices [] = {2, 8, 10, 16, 36};
+
+static const stlplus::radix_display_t displays [] = {
+  stlplus::radix_none, stlplus::radix_hash_style, stlplus::radix_hash_style_all,
+  stlplus::radix_c_style, stlplus::radix_c_style_or_hash};
+static const char* display_names [] = {
+  "none", "hash", "hash_all", "c", "c_or_hash"};
+
+// each conversion is of a batch of values, so that the spread of value sizes is measured together
+static const unsigned batch = 64;
+
+// wall-clock time in seconds - falls back to processor time without C++11
+static double now(void)
+{
+#ifdef STLPLUS_HAS_CXX11
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// test values
+
+// a simple generator so that the values are the same on every run and platform
+static unsigned long random_state = 12345;
+
+// values spread over all sizes from one digit up to the full range, with a mix of signs
+static int random_int(void)
+{
+  random_state = random_state * 1103515245ul + 12345ul;
+  unsigned bits = (unsigned)((random_state >> 16) % 31) + 1;
+  random_state = random_state * 1103515245ul + 12345ul;
+  int magnitude = (int)((random_state >> 1) & ((1ul << bits) - 1));
+  return (random_state & 0x10000) ? -magnitude : magnitude;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// timing
+
+// the operations are functors so that the timing loop is the same for all of them
+// each one keeps a checksum of its results so that the work cannot be optimised away
+
+class to_string_operation
+{
+public:
+  const int* m_values;
+  unsigned m_radix;
+  stlplus::radix_display_t m_display;
+  unsigned long m_check;
+  to_string_operation(const int* values, unsigned radix, stlplus::radix_display_t display) :
+    m_values(values), m_radix(radix), m_display(display), m_check(0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+      m_check += stlplus::int_to_string(m_values[i], m_radix, m_display).size();
+  }
+};
+
+class to_chars_operation
+{
+public:
+  const int* m_values;
+  unsigned m_radix;
+  stlplus::radix_display_t m_display;
+  unsigned long m_check;
+  to_chars_operation(const int* values, unsigned radix, stlplus::radix_display_t display) :
+    m_values(values), m_radix(radix), m_display(display), m_check(0) {}
+  void operator()(void)
+  {
+    char buffer[stlplus::max_integer_chars];
+    for (unsigned i = 0; i < batch; i++)
+      m_check += stlplus::int_to_chars(buffer, buffer + sizeof(buffer), m_values[i], m_radix, m_display) - buffer;
+  }
+};
+
+// the C library only does octal, decimal and hex, so it is the baseline for those radices
+class sprintf_operation
+{
+public:
+  const int* m_values;
+  const char* m_format;
+  unsigned long m_check;
+  sprintf_operation(const int* values, const char* format) : m_values(values), m_format(format), m_check(0) {}
+  void operator()(void)
+  {
+    char buffer[stlplus::max_integer_chars];
+    for (unsigned i = 0; i < batch; i++)
+      m_check += (unsigned long)sprintf(buffer, m_format, m_values[i]);
+  }
+};
+
+// the parsing operations read a batch of images made by int_to_string or double_to_string
+
+class string_to_int_operation
+{
+public:
+  const std::string* m_images;
+  unsigned m_radix;
+  unsigned long m_check;
+  string_to_int_operation(const std::string* images, unsigned radix) : m_images(images), m_radix(radix), m_check(0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+      m_check += (unsigned long)stlplus::string_to_int(m_images[i], m_radix);
+  }
+};
+
+class chars_to_int_operation
+{
+public:
+  const std::string* m_images;
+  unsigned m_radix;
+  unsigned long m_check;
+  chars_to_int_operation(const std::string* images, unsigned radix) : m_images(images), m_radix(radix), m_check(0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+    {
+      int value = 0;
+      const char* image = m_images[i].data();
+      if (stlplus::chars_to_int(image, image + m_images[i].size(), value, m_radix) == stlplus::parse_ok)
+        m_check += (unsigned long)value;
+    }
+  }
+};
+
+class strtol_operation
+{
+public:
+  const std::string* m_images;
+  unsigned m_radix;
+  unsigned long m_check;
+  strtol_operation(const std::string* images, unsigned radix) : m_images(images), m_radix(radix), m_check(0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+      m_check += (unsigned long)strtol(m_images[i].c_str(), 0, (int)m_radix);
+  }
+};
+
+class string_to_double_operation
+{
+public:
+  const std::string* m_images;
+  double m_check;
+  string_to_double_operation(const std::string* images) : m_images(images), m_check(0.0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+      m_check += stlplus::string_to_double(m_images[i]);
+  }
+};
+
+class chars_to_double_operation
+{
+public:
+  const std::string* m_images;
+  double m_check;
+  chars_to_double_operation(const std::string* images) : m_images(images), m_check(0.0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+    {
+      double value = 0.0;
+      const char* image = m_images[i].data();
+      if (stlplus::chars_to_double(image, image + m_images[i].size(), value) == stlplus::parse_ok)
+        m_check += value;
+    }
+  }
+};
+
+class strtod_operation
+{
+public:
+  const std::string* m_images;
+  double m_check;
+  strtod_operation(const std::string* images) : m_images(images), m_check(0.0) {}
+  void operator()(void)
+  {
+    for (unsigned i = 0; i < batch; i++)
+      m_check += strtod(m_images[i].c_str(), 0);
+  }
+};
+
+// repeat the operation until the minimum time has been used, then report the average time per conversion
+// the operation is timed in batches, doubling the batch size each time, so that the timer itself is not measured
+template<typename O>
+void measure(const std::string& operation, unsigned radix, const char* display, O& function, double minimum)
+{
+  unsigned iterations = 1;
+  double elapsed = 0.0;
+  for (;;)
+  {
+    double start = now();
+    for (unsigned i = 0; i < iterations; i++)
+      function();
+    elapsed = now() - start;
+    if (elapsed >= minimum) break;
+    iterations *= 2;
+  }
+  double ns_per_op = elapsed * 1e9 / ((double)iterations * (double)batch);
+  std::cout << stlplus::dformat("%s,%u,%s,%u,%.6f,%.1f", operation.c_str(), radix, display, iterations, elapsed, ns_per_op) << std::endl;
+  std::cerr << stlplus::dformat("  %-16s %2u %-10s %10.1f ns/op", operation.c_str(), radix, display, ns_per_op) << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  double minimum = argc > 1 ? atof(argv[1]) : 0.2;
+  std::cerr << stlplus::build() << " benchmarking integer conversions" << std::endl;
+  std::cout << "operation,radix,display,iterations,seconds,ns_per_op" << std::endl;
+  bool result = true;
+
+  try
+  {
+    int values[batch];
+    for (unsigned i = 0; i < batch; i++)
+      values[i] = random_int();
+
+    for (unsigned r = 0; r < sizeof(radices)/sizeof(radices[0]); r++)
+    {
+      unsigned radix = radices[r];
+      for (unsigned d = 0; d < sizeof(displays)/sizeof(displays[0]); d++)
+      {
+        to_string_operation to_string(values, radix, displays[d]);
+        measure("int_to_string", radix, display_names[d], to_string, minimum);
+        to_chars_operation to_chars(values, radix, displays[d]);
+        measure("int_to_chars", radix, display_names[d], to_chars, minimum);
+
+        // check that the two forms agree so that a broken result is not reported as a fast one
+        char buffer[stlplus::max_integer_chars];
+        for (unsigned i = 0; i < batch; i++)
+        {
+          char* end = stlplus::int_to_chars(buffer, buffer + sizeof(buffer), values[i], radix, displays[d]);
+          if (!end || std::string(buffer, end) != stlplus::int_to_string(values[i], radix, displays[d]) ||
+              stlplus::string_to_int(std::string(buffer, end), radix) != values[i])
+          {
+            std::cerr << "error: conversion of " << values[i] << " to radix " << radix << " is wrong" << std::endl;
+            result = false;
+          }
+        }
+      }
+      const char* format = radix == 8 ? "%o" : radix == 10 ? "%d" : radix == 16 ? "%x" : 0;
+      if (format)
+      {
+        sprintf_operation print(values, format);
+        measure("sprintf", radix, "none", print, minimum);
+      }
+    }
+
+    // parsing decimal and hex, both plain and with the C-style prefix
+    // the throwing functions are given ready-made strings, so the cost of making a string from a field is not included
+    for (unsigned r = 0; r < sizeof(radices)/sizeof(radices[0]); r++)
+    {
+      unsigned radix = radices[r];
+      if (radix != 10 && radix != 16) continue;
+      for (unsigned d = 0; d < sizeof(displays)/sizeof(displays[0]); d++)
+      {
+        if (displays[d] != stlplus::radix_none && displays[d] != stlplus::radix_c_style) continue;
+        if (radix == 10 && displays[d] != stlplus::radix_none) continue;
+        // a C-style prefix gives the radix, otherwise it must be specified
+        unsigned parse_radix = displays[d] == stlplus::radix_c_style ? 0 : radix;
+        std::string images[batch];
+        for (unsigned i = 0; i < batch; i++)
+          images[i] = stlplus::int_to_string(values[i], radix, displays[d]);
+        string_to_int_operation string_to(images, parse_radix);
+        measure("string_to_int", radix, display_names[d], string_to, minimum);
+        chars_to_int_operation chars_to(images, parse_radix);
+        measure("chars_to_int", radix, display_names[d], chars_to, minimum);
+        if (displays[d] == stlplus::radix_none)
+        {
+          strtol_operation strtol_values(images, radix);
+          measure("strtol", radix, display_names[d], strtol_values, minimum);
+        }
+        // check that both forms read the same values so that a broken result is not reported as a fast one
+        string_to_int_operation string_check(images, parse_radix);
+        string_check();
+        chars_to_int_operation chars_check(images, parse_radix);
+        chars_check();
+        if (chars_check.m_check != string_check.m_check)
+        {
+          std::cerr << "error: parsing radix " << radix << " gives different results" << std::endl;
+          result = false;
+        }
+      }
+    }
+    std::string real_images[batch];
+    for (unsigned i = 0; i < batch; i++)
+      real_images[i] = stlplus::double_to_string((double)values[i] / 1024.0, stlplus::display_mixed, 0, 15);
+    string_to_double_operation string_to_double(real_images);
+    measure("string_to_double", 10, "none", string_to_double, minimum);
+    chars_to_double_operation chars_to_double(real_images);
+    measure("chars_to_double", 10, "none", chars_to_double, minimum);
+    strtod_operation strtod_values(real_images);
+    measure("strtod", 10, "none", strtod_values, minimum);
+    string_to_double_operation string_to_double_check(real_images);
+    string_to_double_check();
+    chars_to_double_operation chars_to_double_check(real_images);
+    chars_to_double_check();
+    if (chars_to_double_check.m_check != string_to_double_check.m_check)
+    {
+      std::cerr << "error: parsing real numbers gives different results" << std::endl;
+      result = false;
+    }
+  }
+  catch(std::exception& except)
+  {
+    std::cerr << "caught standard exception " << except.what() << std::endl;
+    result = false;
+  }
+  catch(...)
+  {
+    std::cerr << "caught unknown exception" << std::endl;
+    result = false;
+  }
+
+  return result ? 0 : 1;
+}
@@ -4,7 +4,20 @@
 #include "string_utilities.hpp"
 #include "string_float.hpp"
 #include "string_int.hpp"
+#include "string_inf.hpp"
+#include "string_bool.hpp"
+#include "string_cstring.hpp"
+#include "string_vector.hpp"
+#include "string_map.hpp"
+#include "print_int.hpp"
+#include "print_vector.hpp"
+#include "print_map.hpp"
 #include "version.hpp"
+#include "dprintf.hpp"
+#include <limits.h>
+#include <string.h>
+#include <sstream>
+#include <algorithm>
 
 #define DATA "string_test.tmp"
 #define MASTER "string_test.dump"
@@ -20,6 +33,58 @@ static std::string print_bytes (const std::string& val)
   return result;
 }
 
+// element functions in the three styles for a map of int vectors
+
+static std::string local_int_to_string(const int& value)
+{
+  return stlplus::int_to_string(value);
+}
+
+static std::string int_vector_to_string(const std::vector<int>& values)
+{
+  return stlplus::vector_to_string(values, local_int_to_string, ":");
+}
+
+static void local_append_int(std::string& result, const int& value)
+{
+  stlplus::append_int(result, value);
+}
+
+static void append_int_vector(std::string& result, const std::vector<int>& values)
+{
+  stlplus::append_vector(result, values, local_append_int, ":");
+}
+
+static std::string local_double_to_string(const double& value)
+{
+  return stlplus::double_to_string(value);
+}
+
+static void local_append_double(std::string& result, const double& value)
+{
+  stlplus::append_double(result, value);
+}
+
+static std::string local_inf_to_string(const stlplus::inf& value)
+{
+  return stlplus::inf_to_string(value, 16);
+}
+
+static void local_append_inf(std::string& result, const stlplus::inf& value)
+{
+  stlplus::append_inf(result, value, 16);
+}
+
+static void local_print_int(std::ostream& device, const int& value)
+{
+  stlplus::print_int(device, value);
+}
+
+static void print_int_vector(std::ostream& device, const std::vector<int>& values)
+{
+  stlplus::print_vector(device, values, local_print_int, ":");
+}
+
 int main(int argc, char* argv[])
 {
   std::cerr << stlplus::build() << std::endl;
@@ -82,6 +147,217 @@ int main(int argc, char* argv[])
     // display of bytes and multiples
     for (long bytes = 1; bytes <= 1000000000; bytes *= 4)
       std::cerr << "bytes = " << bytes << ", display = " << stlplus::display_bytes(bytes) << std::endl;
+
+    // integer images, including the extremes of the range and the 2's-complement patterns of negative values
+    struct integer_image {long value; unsigned radix; stlplus::radix_display_t display; unsigned width; const char* image;};
+    static const integer_image integer_images [] = {
+      {0, 10, stlplus::radix_c_style_or_hash, 0, "0"},
+      {1234567890, 10, stlplus::radix_c_style_or_hash, 0, "1234567890"},
+      {-1234567890, 10, stlplus::radix_c_style_or_hash, 0, "-1234567890"},
+      {42, 10, stlplus::radix_c_style_or_hash, 6, "000042"},
+      {-42, 10, stlplus::radix_c_style_or_hash, 6, "-000042"},
+      {255, 16, stlplus::radix_c_style_or_hash, 0, "0x0ff"},
+      {255, 16, stlplus::radix_none, 0, "ff"},
+      {255, 16, stlplus::radix_hash_style, 0, "16#ff"},
+      {5, 2, stlplus::radix_c_style, 8, "0b00000101"},
+      {8, 8, stlplus::radix_c_style, 0, "010"},
+      {35, 36, stlplus::radix_hash_style_all, 0, "36#z"},
+      {-35, 7, stlplus::radix_c_style_or_hash, 0, "7#-50"},
+      {-1, 16, stlplus::radix_c_style_or_hash, 0, "0x0ffffffff"},
+      {-1, 16, stlplus::radix_none, 0, "-1"},
+    };
+    for (unsigned i = 0; i < sizeof(integer_images)/sizeof(integer_images[0]); i++)
+    {
+      const integer_image& test = integer_images[i];
+      std::string image = stlplus::int_to_string((int)test.value, test.radix, test.display, test.width);
+      char buffer[stlplus::max_integer_chars+8];
+      char* end = stlplus::int_to_chars(buffer, buffer+sizeof(buffer), (int)test.value, test.radix, test.display, test.width);
+      std::cerr << "int " << test.value << " radix " << test.radix << " = " << image << std::endl;
+      if (image != test.image || !end || std::string(buffer, end) != image || (int)stlplus::string_to_int(image, test.radix) != (int)test.value)
+      {
+        std::cerr << "ERROR: int image of " << test.value << " is " << image << ", expected " << test.image << std::endl;
+        result = false;
+      }
+      // a buffer one character too small must be reported rather than overrun
+      if (stlplus::int_to_chars(buffer, buffer+image.size()-1, (int)test.value, test.radix, test.display, test.width))
+      {
+        std::cerr << "ERROR: int image of " << test.value << " overran the buffer" << std::endl;
+        result = false;
+      }
+    }
+    // the non-throwing parse reads the same images back, reports where it stopped and detects overflow
+    for (unsigned i = 0; i < sizeof(integer_images)/sizeof(integer_images[0]); i++)
+    {
+      const integer_image& test = integer_images[i];
+      std::string field = std::string(test.image) + ",";
+      int value = 0;
+      const char* stop = 0;
+      stlplus::parse_status_t status = stlplus::chars_to_int(field.data(), field.data() + field.size(), value, test.radix, &stop);
+      if (status != stlplus::parse_ok || value != (int)test.value || stop != field.data() + field.size() - 1)
+      {
+        std::cerr << "ERROR: chars_to_int of " << test.image << " gives " << value << " status " << status << std::endl;
+        result = false;
+      }
+    }
+    struct integer_parse {const char* image; unsigned radix; stlplus::parse_status_t status; int value;};
+    static const integer_parse integer_parses [] = {
+      {"2147483647", 10, stlplus::parse_ok, 2147483647},
+      {"-2147483648", 10, stlplus::parse_ok, INT_MIN},
+      {"2147483648", 10, stlplus::parse_overflow, 0},
+      {"123456789012345678901234567890", 0, stlplus::parse_overflow, 0},
+      {"0x1ffffffff", 0, stlplus::parse_overflow, 0},
+      {"7FFFffff", 16, stlplus::parse_ok, 2147483647},
+      {"36#-zz", 0, stlplus::parse_ok, -1295},
+      {"12x", 10, stlplus::parse_invalid, 0},
+      {"", 10, stlplus::parse_invalid, 0},
+      {"-", 10, stlplus::parse_invalid, 0},
+      {"10", 37, stlplus::parse_invalid, 0},
+      // the C prefix overrides the radix even where it could be read as digits, as with string_to_int
+      {"0b0101", 16, stlplus::parse_ok, 5},
+      {"0b7", 16, stlplus::parse_invalid, 0},
+      {"0x", 16, stlplus::parse_ok, 0},
+      {"0b", 36, stlplus::parse_ok, 0},
+    };
+    for (unsigned i = 0; i < sizeof(integer_parses)/sizeof(integer_parses[0]); i++)
+    {
+      const integer_parse& test = integer_parses[i];
+      int value = 0;
+      stlplus::parse_status_t status = stlplus::chars_to_int(test.image, test.image + strlen(test.image), value, test.radix);
+      if (status != test.status || value != test.value)
+      {
+        std::cerr << "ERROR: chars_to_int of " << test.image << " gives " << value << " status " << status << std::endl;
+        result = false;
+      }
+      // the throwing parse must agree on the C prefix, though it has no way of reporting overflow
+      if (test.image[0] == '0' && (test.image[1] == 'b' || test.image[1] == 'x') && test.status != stlplus::parse_overflow)
+      {
+        bool thrown = false;
+        int converted = 0;
+        try
+        {
+          converted = stlplus::string_to_int(test.image, test.radix);
+        }
+        catch(const std::exception&)
+        {
+          thrown = true;
+        }
+        if (thrown != (test.status == stlplus::parse_invalid) || (!thrown && converted != test.value))
+        {
+          std::cerr << "ERROR: string_to_int of " << test.image << " disagrees with chars_to_int" << std::endl;
+          result = false;
+        }
+      }
+    }
+    unsigned unsigned_value = 0;
+    double double_value = 0.0;
+    const char* negative = "-1";
+    const char* real = "-1.5e3;";
+    const char* real_stop = 0;
+    if (stlplus::chars_to_unsigned(negative, negative + 2, unsigned_value) != stlplus::parse_invalid ||
+        stlplus::chars_to_double(real, real + 7, double_value, &real_stop) != stlplus::parse_ok ||
+        double_value != -1500.0 || real_stop != real + 6 ||
+        stlplus::chars_to_double(real, real + 7, double_value) != stlplus::parse_invalid)
+    {
+      std::cerr << "ERROR: chars_to_unsigned or chars_to_double failed" << std::endl;
+      result = false;
+    }
+
+    // nested containers give the same image whether converted to a string, appended or printed
+    std::map<int,std::vector<int> > nested;
+    for (int key = -2; key <= 2; key++)
+      for (int element = 0; element < key + 3; element++)
+        nested[key].push_back(key * 1000 + element);
+    nested[9];
+    std::string converted = stlplus::map_to_string(nested, local_int_to_string, int_vector_to_string, "=", ",");
+    std::string appended = "[";
+    stlplus::append_map(appended, nested, local_append_int, append_int_vector, "=", ",");
+    std::ostringstream printed;
+    printed << "[";
+    stlplus::print_map(printed, nested, local_print_int, print_int_vector, "=", ",");
+    std::cerr << "nested map = " << converted << std::endl;
+    if (appended != "[" + converted || printed.str() != appended ||
+        converted != "-2=-2000,-1=-1000:-999,0=0:1:2,1=1000:1001:1002:1003,2=2000:2001:2002:2003:2004,9=")
+    {
+      std::cerr << "ERROR: nested map appended as " << appended << " and printed as " << printed.str() << std::endl;
+      result = false;
+    }
+
+    // wildcards, including a final * matching a single character and an expression that used to take exponential time
+    struct wildcard_match {const char* wild; const char* match; bool matches;};
+    static const wildcard_match wildcard_matches [] = {
+      {"*.cpp", "string_test.cpp", true},
+      {"*.cpp", ".cpp", false},
+      {"a*", "ab", true},
+      {"*a*", "xay", true},
+      {"?[a-c]\\*", "xb*", true},
+      {"?[a-c]\\*", "xd*", false},
+      {"[\\]x]*", "]yz", true},
+      {"[a-z", "a", false},
+      {"*a*a*a*a*a*a*a*a*a*a*b", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", false},
+    };
+    for (unsigned i = 0; i < sizeof(wildcard_matches)/sizeof(wildcard_matches[0]); i++)
+    {
+      const wildcard_match& test = wildcard_matches[i];
+      if (stlplus::match_wildcard(test.wild, test.match) != test.matches)
+      {
+        std::cerr << "ERROR: wildcard " << test.wild << " applied to " << test.match << " should give " << test.matches << std::endl;
+        result = false;
+      }
+    }
+
+    // a set of wildcards reports the same matches as matching each wildcard separately
+    std::vector<std::string> wilds;
+    for (unsigned i = 0; i < sizeof(wildcard_matches)/sizeof(wildcard_matches[0]); i++)
+      wilds.push_back(wildcard_matches[i].wild);
+    wilds.push_back("string_test.*");
+    wilds.push_back("");
+    stlplus::wildcard_set wildcards(wilds);
+    for (unsigned i = 0; i < sizeof(wildcard_matches)/sizeof(wildcard_matches[0]); i++)
+    {
+      std::vector<unsigned> expected;
+      for (unsigned w = 0; w < wilds.size(); w++)
+        if (stlplus::wildcard(wilds[w], wildcard_matches[i].match))
+          expected.push_back(w);
+      std::vector<unsigned> matches;
+      if (wildcards.match(wildcard_matches[i].match, matches) != !expected.empty() || matches != expected)
+      {
+        std::cerr << "ERROR: wildcard set applied to " << wildcard_matches[i].match << " matched " << matches.size() << " wildcards" << std::endl;
+        result = false;
+      }
+    }
+    std::vector<std::string> found = stlplus::folder_wildcard(".", wildcards, false, true);
+    if (std::find(found.begin(), found.end(), DATA) == found.end() || !wildcards.match("") || wildcards.match("string_test"))
+    {
+      std::cerr << "ERROR: wildcard set did not find " << DATA << std::endl;
+      result = false;
+    }
+
+    // the leaf append functions give the same images as the conversions to string
+    std::vector<double> doubles;
+    doubles.push_back(-1.5);
+    doubles.push_back(1e100);
+    std::vector<stlplus::inf> infs;
+    infs.push_back(stlplus::inf(-255));
+    infs.push_back(stlplus::inf("123456789012345678901234567890"));
+    std::string leaves;
+    stlplus::append_vector(leaves, doubles, local_append_double, ",");
+    leaves += "/";
+    stlplus::append_vector(leaves, infs, local_append_inf, ",");
+    stlplus::append_bool(leaves, true);
+    stlplus::append_cstring(leaves, "!");
+    if (leaves != stlplus::vector_to_string(doubles, local_double_to_string, ",") + "/" +
+                  stlplus::vector_to_string(infs, local_inf_to_string, ",") + "1!")
+    {
+      std::cerr << "ERROR: leaf append functions gave " << leaves << std::endl;
+      result = false;
+    }
+
+    if (stlplus::long_to_string(LONG_MIN) != stlplus::dformat("%ld", LONG_MIN) ||
+        stlplus::unsigned_long_to_string(ULONG_MAX) != stlplus::dformat("%lu", ULONG_MAX))
+    {
+      std::cerr << "ERROR: long extremes are " << stlplus::long_to_string(LONG_MIN) << " and " << stlplus::unsigned_long_to_string(ULONG_MAX) << std::endl;
+      result = false;
+    }
   }
   catch(std::exception& except)
   {